@@ -29,6 +29,8 @@
 
 #include "APICast.h"
 #include "CallFrame.h"
+#include "CodeCache.h"
+#include "GCEventLog.h"
 #include "InitializeThreading.h"
 #include "JSCallbackObject.h"
 #include "JSClassRef.h"
@@ -112,6 +114,106 @@ void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group)
         vm.watchdog()->setTimeLimit(Watchdog::noTimeLimit);
 }
 
+void JSContextGroupSetBytecodeCachePath(JSContextGroupRef group, const char* path)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    vm.codeCache()->setBytecodeCachePath(path ? String::fromUTF8(path) : String());
+}
+
+void JSContextGroupWriteBytecodeCache(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    vm.codeCache()->writeBytecodeCache(vm);
+}
+
+bool JSContextGroupGetBytecodeCacheStatistics(JSContextGroupRef group, unsigned* hits, unsigned* misses, unsigned* stores, unsigned* failures)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    BytecodeCache* bytecodeCache = vm.codeCache()->bytecodeCache();
+    if (!bytecodeCache)
+        return false;
+
+    const BytecodeCache::Statistics& statistics = bytecodeCache->statistics();
+    if (hits)
+        *hits = statistics.hits;
+    if (misses)
+        *misses = statistics.misses;
+    if (stores)
+        *stores = statistics.stores;
+    if (failures)
+        *failures = statistics.failures;
+    return true;
+}
+
+bool JSContextGroupPrecompileScript(JSContextGroupRef group, JSStringRef script, JSStringRef sourceURL, int startingLineNumber)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+
+    startingLineNumber = std::max(1, startingLineNumber);
+    auto sourceURLString = sourceURL ? sourceURL->string() : String();
+    SourceCode source = makeSource(script->string(), SourceOrigin { sourceURLString }, sourceURLString, TextPosition(OrdinalNumber::fromOneBasedInt(startingLineNumber), OrdinalNumber()));
+    return vm.codeCache()->precompile(vm, source, SourceCodeType::ProgramType);
+}
+
+void JSContextGroupSetGarbageCollectionEventCallback(JSContextGroupRef group, JSGarbageCollectionEventCallback callback, void* userData)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    if (!callback) {
+        vm.heap.eventLog().setCallback(nullptr);
+        return;
+    }
+    vm.heap.eventLog().setCallback(
+        [group, callback, userData] (const char* event) {
+            callback(group, event, userData);
+        });
+}
+
+bool JSContextGroupGetGarbageCollectionPauseStatistics(JSContextGroupRef group, unsigned* count, double* p50, double* p99, double* max)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    GCEventLog::PauseStatistics statistics = vm.heap.eventLog().pauseStatistics();
+    if (!statistics.count)
+        return false;
+
+    if (count)
+        *count = statistics.count;
+    if (p50)
+        *p50 = statistics.p50;
+    if (p99)
+        *p99 = statistics.p99;
+    if (max)
+        *max = statistics.max;
+    return true;
+}
+
+void JSContextGroupSetHeapLimits(JSContextGroupRef group, size_t softLimit, size_t hardLimit, JSHeapLimitCallback softLimitCallback, void* userData)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    if (!softLimitCallback) {
+        vm.heap.setHeapLimits(softLimit, hardLimit, nullptr);
+        return;
+    }
+    vm.heap.setHeapLimits(
+        softLimit, hardLimit,
+        [group, softLimitCallback, userData] (size_t heapSize) {
+            softLimitCallback(group, heapSize, userData);
+        });
+}
+
+size_t JSContextGroupGetHeapSize(JSContextGroupRef group)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    return vm.heap.sizeForHeapLimits();
+}
+
 // From the API's perspective, a global context remains alive iff it has been JSGlobalContextRetained.
 
 JSGlobalContextRef JSGlobalContextCreate(JSClassRef globalObjectClass)
@@ -94,6 +94,121 @@ JS_EXPORT void JSContextGroupSetExecutionTimeLimit(JSContextGroupRef group, doub
 */
 JS_EXPORT void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group) CF_AVAILABLE(10_6, 7_0);
 
+/*!
+@function
+@abstract Sets the directory used to persist bytecode for the context group.
+@param group The JavaScript context group whose bytecode cache you want to set.
+@param path A UTF-8 path to an existing directory, or NULL to stop using the on-disk bytecode cache.
+@discussion Scripts and modules evaluated in the group are looked up in this directory before
+ they are parsed. Bytecode for the scripts and modules the group has evaluated is written back to
+ the directory when the group is destroyed, or when JSContextGroupWriteBytecodeCache is called.
+*/
+JS_EXPORT void JSContextGroupSetBytecodeCachePath(JSContextGroupRef group, const char* path);
+
+/*!
+@function
+@abstract Writes the bytecode the context group has generated so far to its bytecode cache directory.
+@param group The JavaScript context group whose bytecode you want to write.
+*/
+JS_EXPORT void JSContextGroupWriteBytecodeCache(JSContextGroupRef group);
+
+/*!
+@function
+@abstract Gets the usage statistics of the context group's bytecode cache.
+@param group The JavaScript context group whose statistics you want to get.
+@param hits Set to the number of scripts and modules that were loaded from the cache. May be NULL.
+@param misses Set to the number of scripts and modules that were not in the cache. May be NULL.
+@param stores Set to the number of entries written to the cache. May be NULL.
+@param failures Set to the number of entries that could not be read or written. May be NULL.
+@result false if the group has no bytecode cache directory, otherwise true.
+*/
+JS_EXPORT bool JSContextGroupGetBytecodeCacheStatistics(JSContextGroupRef group, unsigned* hits, unsigned* misses, unsigned* stores, unsigned* failures);
+
+/*!
+@function
+@abstract Starts parsing and generating bytecode for a script on a helper thread.
+@param group The JavaScript context group that will evaluate the script.
+@param script A JSString containing the script.
+@param sourceURL A JSString containing a URL for the script's source file. Pass NULL if you do not care to include source file information.
+@param startingLineNumber An integer value specifying the script's starting line number in the file located at sourceURL.
+@result true if the script was queued, false if it was already compiled or queued.
+@discussion When a context in the group later evaluates the same script text, the compiled
+ bytecode is used instead of parsing the script again, waiting for the helper thread if it is
+ still busy with the script. Scripts with syntax errors are reported when they are evaluated.
+*/
+JS_EXPORT bool JSContextGroupPrecompileScript(JSContextGroupRef group, JSStringRef script, JSStringRef sourceURL, int startingLineNumber);
+
+/*!
+@typedef JSGarbageCollectionEventCallback
+@abstract The callback invoked when a garbage collection in a context group has finished.
+@param group The JavaScript context group that collected garbage.
+@param event A UTF-8 JSON object describing the collection: its scope, the phases it went through
+ and which thread ran each of them, the times the group's thread was paused, the number of bytes
+ visited and the number of bytes each heap subspace freed. Times are in milliseconds.
+@param userData The userData that was passed to JSContextGroupSetGarbageCollectionEventCallback.
+*/
+typedef void (*JSGarbageCollectionEventCallback)(JSContextGroupRef group, const char* event, void* userData);
+
+/*!
+@function
+@abstract Sets the callback that is told about each garbage collection in a context group.
+@param group The JavaScript context group whose collections you want to observe.
+@param callback The callback to invoke, or NULL to stop observing collections.
+@param userData A pointer that is passed to the callback.
+@discussion The callback is invoked on the thread that is using the group, once the collection
+ has been finalized. It must not call back into the JavaScript API.
+*/
+JS_EXPORT void JSContextGroupSetGarbageCollectionEventCallback(JSContextGroupRef group, JSGarbageCollectionEventCallback callback, void* userData);
+
+/*!
+@function
+@abstract Gets statistics about the most recent pauses that garbage collection caused in a context group.
+@param group The JavaScript context group whose pauses you want to know about.
+@param count Set to the number of pauses the statistics cover. May be NULL.
+@param p50 Set to the median pause, in milliseconds. May be NULL.
+@param p99 Set to the 99th percentile pause, in milliseconds. May be NULL.
+@param max Set to the longest pause, in milliseconds. May be NULL.
+@result false if the group has not paused for garbage collection yet, otherwise true.
+@discussion The statistics cover the last gcPauseHistogramSize pauses, 1000 by default.
+*/
+JS_EXPORT bool JSContextGroupGetGarbageCollectionPauseStatistics(JSContextGroupRef group, unsigned* count, double* p50, double* p99, double* max);
+
+/*!
+@typedef JSHeapLimitCallback
+@abstract The callback invoked when the heap of a context group grows past its soft limit.
+@param group The JavaScript context group whose heap is over its soft limit.
+@param heapSize The size of the heap, in bytes, after the collection that found it over the limit.
+@param userData The userData that was passed to JSContextGroupSetHeapLimits.
+*/
+typedef void (*JSHeapLimitCallback)(JSContextGroupRef group, size_t heapSize, void* userData);
+
+/*!
+@function
+@abstract Sets memory limits for the heap of a context group.
+@param group The JavaScript context group whose heap you want to limit.
+@param softLimit The heap size, in bytes, past which the callback is invoked, or 0 for no soft limit.
+@param hardLimit The heap size, in bytes, that the heap must not stay above, or 0 for no hard limit.
+@param softLimitCallback The callback to invoke when the heap grows past the soft limit. May be NULL.
+@param userData A pointer that is passed to the callback.
+@discussion The heap size covers the objects in the heap and the memory that their owners reported
+ as being held by them, such as the contents of array buffers. It is checked after each garbage
+ collection. The callback is invoked on the thread that is using the group, once each time the heap
+ goes from being under the soft limit to being over it. It must not call back into the JavaScript API.
+
+ As the heap approaches the hard limit, the group collects garbage more often. If a full collection
+ leaves the heap over the hard limit, the JavaScript code that is running throws an out of memory
+ error, which it can catch.
+*/
+JS_EXPORT void JSContextGroupSetHeapLimits(JSContextGroupRef group, size_t softLimit, size_t hardLimit, JSHeapLimitCallback softLimitCallback, void* userData);
+
+/*!
+@function
+@abstract Gets the size of the heap of a context group, as used by its heap limits.
+@param group The JavaScript context group whose heap size you want to know.
+@result The size of the heap, in bytes.
+*/
+JS_EXPORT size_t JSContextGroupGetHeapSize(JSContextGroupRef group);
+
 /*!
 @function
 @abstract Gets a whether or not remote inspection is enabled on the context.
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSStreamingJSONParserPrivate.h"
+
+#include "APICast.h"
+#include "APIUtils.h"
+#include "JSCInlines.h"
+#include "OpaqueJSString.h"
+#include "StreamingJSONParser.h"
+#include "StrongInlines.h"
+
+using namespace JSC;
+
+struct OpaqueJSStreamingJSONParser {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    OpaqueJSStreamingJSONParser(VM& vm, JSGlobalObject* globalObject)
+        : vm(&vm)
+        , globalObject(vm, globalObject)
+    {
+    }
+
+    RefPtr<VM> vm;
+    Strong<JSGlobalObject> globalObject;
+    StreamingJSONParser parser;
+};
+
+JSStreamingJSONParserRef JSStreamingJSONParserCreate(JSContextRef ctx)
+{
+    if (!ctx) {
+        ASSERT_NOT_REACHED();
+        return nullptr;
+    }
+    ExecState* exec = toJS(ctx);
+    JSLockHolder locker(exec);
+    return new OpaqueJSStreamingJSONParser(exec->vm(), exec->lexicalGlobalObject());
+}
+
+bool JSStreamingJSONParserAppendUTF8(JSStreamingJSONParserRef parser, const char* bytes, size_t length)
+{
+    ExecState* exec = parser->globalObject->globalExec();
+    JSLockHolder locker(exec);
+    bool result = parser->parser.appendUTF8(exec, bytes, length);
+    handleExceptionIfNeeded(exec, nullptr);
+    return result;
+}
+
+bool JSStreamingJSONParserAppendString(JSStreamingJSONParserRef parser, JSStringRef string)
+{
+    ExecState* exec = parser->globalObject->globalExec();
+    JSLockHolder locker(exec);
+    bool result = parser->parser.append(exec, string->string());
+    handleExceptionIfNeeded(exec, nullptr);
+    return result;
+}
+
+JSValueRef JSStreamingJSONParserFinish(JSStreamingJSONParserRef parser, JSStringRef* errorMessage)
+{
+    ExecState* exec = parser->globalObject->globalExec();
+    JSLockHolder locker(exec);
+    JSValue result = parser->parser.finish(exec);
+    if (handleExceptionIfNeeded(exec, nullptr) == ExceptionStatus::DidThrow)
+        return nullptr;
+    if (!result) {
+        if (errorMessage)
+            *errorMessage = OpaqueJSString::create(parser->parser.errorMessage()).leakRef();
+        return nullptr;
+    }
+    return toRef(exec, result);
+}
+
+void JSStreamingJSONParserRelease(JSStreamingJSONParserRef parser)
+{
+    RefPtr<VM> vm = parser->vm;
+    JSLockHolder locker(vm.get());
+    delete parser;
+}
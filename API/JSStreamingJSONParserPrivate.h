@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JSStreamingJSONParserPrivate_h
+#define JSStreamingJSONParserPrivate_h
+
+#include <JavaScriptCore/JSContextRef.h>
+#include <JavaScriptCore/JSStringRef.h>
+#include <JavaScriptCore/JSValueRef.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*! @typedef JSStreamingJSONParserRef A JSON parser that is given its input in pieces. */
+typedef struct OpaqueJSStreamingJSONParser* JSStreamingJSONParserRef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ @function
+ @abstract Creates a parser for a JSON document that will be appended in pieces.
+ @param ctx The execution context in which the parsed value is created.
+ @result A JSStreamingJSONParserRef. Ownership follows the Create Rule.
+ @discussion The parser builds the value as each piece is appended, so the document never needs to be held in memory as a whole. It keeps the context's group alive, and must be released with JSStreamingJSONParserRelease.
+ */
+JS_EXPORT JSStreamingJSONParserRef JSStreamingJSONParserCreate(JSContextRef ctx);
+
+/*!
+ @function
+ @abstract Appends the next piece of the document, encoded in UTF-8.
+ @param parser The parser to append to.
+ @param bytes The bytes to append. A piece may end in the middle of a token or of a UTF-8 sequence.
+ @param length The number of bytes to append.
+ @result false if the document is already known to be malformed, otherwise true.
+ */
+JS_EXPORT bool JSStreamingJSONParserAppendUTF8(JSStreamingJSONParserRef parser, const char* bytes, size_t length);
+
+/*!
+ @function
+ @abstract Appends the next piece of the document.
+ @param parser The parser to append to.
+ @param string The string to append. A piece may end in the middle of a token.
+ @result false if the document is already known to be malformed, otherwise true.
+ */
+JS_EXPORT bool JSStreamingJSONParserAppendString(JSStreamingJSONParserRef parser, JSStringRef string);
+
+/*!
+ @function
+ @abstract Ends the document and returns the value it describes.
+ @param parser The parser to finish.
+ @param errorMessage A pointer to a JSStringRef in which to store the parse error message if the document is not valid JSON. Pass NULL if you do not care to store an error message.
+ @result The parsed value, or NULL if the document is not valid JSON.
+ */
+JS_EXPORT JSValueRef JSStreamingJSONParserFinish(JSStreamingJSONParserRef parser, JSStringRef* errorMessage);
+
+/*!
+ @function
+ @abstract Releases a parser.
+ @param parser The parser to release.
+ */
+JS_EXPORT void JSStreamingJSONParserRelease(JSStreamingJSONParserRef parser);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSStreamingJSONParserPrivate_h */
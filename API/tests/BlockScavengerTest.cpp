@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BlockScavengerTest.h"
+
+#include "APICast.h"
+#include "BlockScavenger.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "MarkedSpace.h"
+#include "Options.h"
+#include "VM.h"
+
+using namespace JSC;
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+static double evaluateNumber(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (!result || exception)
+        return -1;
+    return JSValueToNumber(context, result, nullptr);
+}
+
+int testBlockScavenger()
+{
+    bool overallResult = true;
+
+    printf("BlockScavengerTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    bool usedBlockScavenger = Options::useBlockScavenger();
+    Options::useBlockScavenger() = true;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    VM& vm = toJS(context)->vm();
+    MarkedSpace& space = vm.heap.objectSpace();
+
+    // Fill a lot of blocks with objects that don't need destruction, then let them all die.
+    evaluateNumber(context,
+        "var garbage = [];\n"
+        "for (var i = 0; i < 200000; ++i) garbage.push({ a: i, b: i });\n"
+        "garbage = null;\n"
+        "0;\n");
+
+    size_t committedWhileIdle;
+    size_t committedAfterFirstVisit;
+    size_t committedAfterSecondVisit;
+    size_t decommittedAfterSecondVisit;
+    {
+        JSLockHolder locker(vm);
+
+        // A full collection that doesn't shrink the heap, like the ones that the scavenger follows.
+        vm.heap.collectSync(CollectionScope::Full);
+        committedWhileIdle = space.numberOfCommittedBlocks();
+
+        // Blocks have to stay empty from one visit to the next before their pages are given back.
+        vm.heap.blockScavenger().doWork();
+        committedAfterFirstVisit = space.numberOfCommittedBlocks();
+        vm.heap.blockScavenger().doWork();
+        committedAfterSecondVisit = space.numberOfCommittedBlocks();
+        decommittedAfterSecondVisit = space.numberOfDecommittedBlocks();
+    }
+    test("the first visit only notes the empty blocks", committedAfterFirstVisit == committedWhileIdle);
+    test("the second visit gives them back", committedAfterSecondVisit < committedWhileIdle);
+
+    // Allocating in the decommitted blocks has to recommit them before their cells are used.
+    double sum = evaluateNumber(context,
+        "var live = [];\n"
+        "for (var i = 0; i < 200000; ++i) live.push({ a: i, b: i });\n"
+        "var sum = 0;\n"
+        "for (var i = 0; i < live.length; ++i) sum += live[i].a + live[i].b;\n"
+        "sum;\n");
+    test("objects allocated in scavenged blocks are intact", sum == 200000.0 * 199999.0);
+    test("allocating recommits decommitted blocks", !decommittedAfterSecondVisit || space.numberOfDecommittedBlocks() < decommittedAfterSecondVisit);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+    double sumAfterCollection = evaluateNumber(context,
+        "var sum = 0;\n"
+        "for (var i = 0; i < live.length; ++i) sum += live[i].a + live[i].b;\n"
+        "sum;\n");
+    test("objects in recommitted blocks survive a collection", sumAfterCollection == 200000.0 * 199999.0);
+
+    JSGlobalContextRelease(context);
+
+    Options::useBlockScavenger() = usedBlockScavenger;
+
+    printf("BlockScavengerTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "BytecodeCacheTest.h"
+
+#include "APICast.h"
+#include "BytecodeCache.h"
+#include "CodeCache.h"
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include "VM.h"
+#include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
+
+#if OS(UNIX)
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#if OS(UNIX)
+
+static const char* bytecodeCacheTestScript =
+    "function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\n"
+    "class Point { constructor(x, y) { this.x = x; this.y = y; } sum() { return this.x + this.y; } }\n"
+    "function tag(strings) { return strings.raw.join('|'); }\n"
+    "var kind = (function(v) { switch (v) { case 'a': return 1; case 'b': return 2; default: return 3; } })('b');\n"
+    "let values = [fib(10), new Point(1, 2).sum(), /a+b/g.test('aab'), kind, tag`x${1}y`, [1, 2.5, 'str']];\n"
+    "function rarelyUsed() { return 7; }\n"
+    "if (typeof callRarelyUsed !== 'undefined') rarelyUsed();\n"
+    "values.join(',');\n";
+
+static const char* bytecodeCacheTestExpectedResult = "55,3,true,2,x|y,1,2.5,str";
+
+struct BytecodeCacheRun {
+    bool resultIsCorrect { false };
+    bool hasStatistics { false };
+    unsigned hits { 0 };
+    unsigned misses { 0 };
+    unsigned stores { 0 };
+    unsigned failures { 0 };
+    unsigned unchanged { 0 };
+    unsigned functionCodeBlocksDecodedWhileWriting { 0 };
+};
+
+static unsigned functionCodeBlocksDecoded(JSContextGroupRef group)
+{
+    JSC::BytecodeCache* bytecodeCache = toJS(group)->codeCache()->bytecodeCache();
+    return bytecodeCache ? bytecodeCache->statistics().functionCodeBlocksDecoded : 0;
+}
+
+static BytecodeCacheRun runScriptWithBytecodeCache(const char* path, bool callRarelyUsed = false)
+{
+    BytecodeCacheRun run;
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSContextGroupSetBytecodeCachePath(group, path);
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+
+    if (callRarelyUsed) {
+        JSStringRef name = JSStringCreateWithUTF8CString("callRarelyUsed");
+        JSObjectSetProperty(context, JSContextGetGlobalObject(context), name, JSValueMakeBoolean(context, true), kJSPropertyAttributeNone, nullptr);
+        JSStringRelease(name);
+    }
+
+    JSStringRef script = JSStringCreateWithUTF8CString(bytecodeCacheTestScript);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+
+    if (result && !exception) {
+        JSStringRef resultString = JSValueToStringCopy(context, result, nullptr);
+        run.resultIsCorrect = JSStringIsEqualToUTF8CString(resultString, bytecodeCacheTestExpectedResult);
+        JSStringRelease(resultString);
+    }
+
+    unsigned decodedBeforeWriting = functionCodeBlocksDecoded(group);
+    JSContextGroupWriteBytecodeCache(group);
+    run.functionCodeBlocksDecodedWhileWriting = functionCodeBlocksDecoded(group) - decodedBeforeWriting;
+    run.hasStatistics = JSContextGroupGetBytecodeCacheStatistics(group, &run.hits, &run.misses, &run.stores, &run.failures);
+    if (JSC::BytecodeCache* bytecodeCache = toJS(group)->codeCache()->bytecodeCache())
+        run.unchanged = bytecodeCache->statistics().unchanged;
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+    return run;
+}
+
+static void removeDirectory(const char* path)
+{
+    if (DIR* directory = opendir(path)) {
+        while (struct dirent* entry = readdir(directory)) {
+            if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+                continue;
+            StringBuilder filePath;
+            filePath.append(path);
+            filePath.append('/');
+            filePath.append(entry->d_name);
+            unlink(filePath.toString().utf8().data());
+        }
+        closedir(directory);
+    }
+    rmdir(path);
+}
+
+#endif // OS(UNIX)
+
+int testBytecodeCache()
+{
+    bool overallResult = true;
+
+    printf("BytecodeCacheTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    test("group without a cache path has no statistics", !JSContextGroupGetBytecodeCacheStatistics(group, nullptr, nullptr, nullptr, nullptr));
+    JSContextGroupRelease(group);
+
+#if OS(UNIX)
+    char path[] = "/tmp/JSCBytecodeCacheTest.XXXXXX";
+    if (!mkdtemp(path)) {
+        printf("BytecodeCacheTest: FAIL (could not create a temporary directory)\n");
+        return 1;
+    }
+
+    BytecodeCacheRun cold = runScriptWithBytecodeCache(path);
+    test("cold run computes the right result", cold.resultIsCorrect);
+    test("cold run has statistics", cold.hasStatistics);
+    test("cold run misses the cache", !cold.hits && cold.misses == 1);
+    test("cold run stores the script", cold.stores == 1 && !cold.failures);
+
+    BytecodeCacheRun warm = runScriptWithBytecodeCache(path);
+    test("warm run computes the right result", warm.resultIsCorrect);
+    test("warm run hits the cache", warm.hits == 1 && !warm.misses && !warm.failures);
+    test("warm run does not rewrite an unchanged entry", !warm.stores && warm.unchanged == 1);
+    test("warm run decodes nothing while writing", !warm.functionCodeBlocksDecodedWhileWriting);
+
+    // Calling a function that the earlier runs never compiled changes the entry. The warm run only
+    // decoded the functions it called; rewriting its entry must not lose any.
+    BytecodeCacheRun changed = runScriptWithBytecodeCache(path, true);
+    test("run with new code computes the right result", changed.resultIsCorrect);
+    test("run with new code rewrites the entry", changed.stores == 1 && !changed.unchanged);
+
+    BytecodeCacheRun rewritten = runScriptWithBytecodeCache(path);
+    test("run from a rewritten entry computes the right result", rewritten.resultIsCorrect);
+    test("run from a rewritten entry hits the cache", rewritten.hits == 1 && !rewritten.failures);
+    test("run from a rewritten entry does not rewrite it", !rewritten.stores && rewritten.unchanged == 1);
+
+    removeDirectory(path);
+#endif
+
+    printf("BytecodeCacheTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
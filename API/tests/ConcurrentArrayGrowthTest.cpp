@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ConcurrentArrayGrowthTest.h"
+
+#include "JavaScript.h"
+#include "Options.h"
+
+using namespace JSC;
+
+// An indexed accessor on Array.prototype makes every array in the global object use array storage,
+// whose vector the collector scans up to its vector length. Growing large arrays while a collection
+// is always running makes the collector scan butterflies that grow in place under it.
+static const char* concurrentArrayGrowthScript =
+    "Array.prototype.__defineGetter__(1000000, function() { return 0; });\n"
+    "var survivors = [];\n"
+    "var correct = true;\n"
+    "for (var round = 0; round < 20; ++round) {\n"
+    "    var array = [];\n"
+    "    for (var i = 0; i < 50000; ++i) {\n"
+    "        array.push({ value: i });\n"
+    "        if (!(i % 1000))\n"
+    "            new Array(100).fill(round);\n"
+    "    }\n"
+    "    for (var i = 0; i < array.length; ++i)\n"
+    "        correct = correct && array[i].value === i;\n"
+    "    survivors.push(array);\n"
+    "    if (survivors.length > 4)\n"
+    "        survivors.shift();\n"
+    "}\n"
+    "for (var j = 0; j < survivors.length; ++j) {\n"
+    "    for (var i = 0; i < survivors[j].length; ++i)\n"
+    "        correct = correct && survivors[j][i].value === i;\n"
+    "}\n"
+    "correct;\n";
+
+int testConcurrentArrayGrowth()
+{
+    bool overallResult = true;
+
+    printf("ConcurrentArrayGrowthTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    // The VM only starts collecting continuously if the option is set when it is created.
+    bool collectedContinuously = Options::collectContinuously();
+    Options::collectContinuously() = true;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSStringRef script = JSStringCreateWithUTF8CString(concurrentArrayGrowthScript);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    test("large array storage grows correctly during concurrent marking", result && !exception && JSValueToBoolean(context, result));
+    JSGlobalContextRelease(context);
+
+    Options::collectContinuously() = collectedContinuously;
+
+    printf("ConcurrentArrayGrowthTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "GarbageCollectionEventsTest.h"
+
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+static void recordEvent(JSContextGroupRef, const char* event, void* userData)
+{
+    static_cast<Vector<CString>*>(userData)->append(CString(event));
+}
+
+static void collectGarbage(JSGlobalContextRef context)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString("var garbage = []; for (var i = 0; i < 10000; ++i) garbage.push({ i }); garbage = null;");
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+
+    // The events of a collection are delivered when the group's thread next finalizes, which the
+    // second collection guarantees has happened for the first.
+    JSSynchronousGarbageCollectForDebugging(context);
+    JSSynchronousGarbageCollectForDebugging(context);
+}
+
+int testGarbageCollectionEvents()
+{
+    bool overallResult = true;
+
+    printf("GarbageCollectionEventsTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+
+    Vector<CString> events;
+    JSContextGroupSetGarbageCollectionEventCallback(group, recordEvent, &events);
+    collectGarbage(context);
+    test("collections are reported", !events.isEmpty());
+
+    bool allParse = true;
+    bool allFull = true;
+    for (const CString& event : events) {
+        JSStringRef json = JSStringCreateWithUTF8CString(event.data());
+        JSValueRef value = JSValueMakeFromJSONString(context, json);
+        JSStringRelease(json);
+        allParse &= value && JSValueIsObject(context, value);
+        allFull &= !!strstr(event.data(), "\"scope\":\"Full\"");
+    }
+    test("events are JSON objects", allParse);
+    test("synchronous collections are full collections", allFull);
+    test("events list the phases", !events.isEmpty() && strstr(events[0].data(), "\"phases\":[{\"phase\":\"Begin\""));
+    test("events list the pauses", !events.isEmpty() && strstr(events[0].data(), "\"pauses\":[{"));
+
+    unsigned count = 0;
+    double p50 = -1;
+    double p99 = -1;
+    double max = -1;
+    test("pause statistics are available", JSContextGroupGetGarbageCollectionPauseStatistics(group, &count, &p50, &p99, &max));
+    test("pause statistics cover the pauses", count >= events.size());
+    test("pause percentiles are ordered", 0 <= p50 && p50 <= p99 && p99 <= max);
+
+    JSContextGroupSetGarbageCollectionEventCallback(group, nullptr, nullptr);
+    size_t numberOfEvents = events.size();
+    collectGarbage(context);
+    test("collections are not reported after the callback is cleared", events.size() == numberOfEvents);
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    JSContextGroupRef freshGroup = JSContextGroupCreate();
+    test("a group that has not collected has no pause statistics", !JSContextGroupGetGarbageCollectionPauseStatistics(freshGroup, nullptr, nullptr, nullptr, nullptr));
+    JSContextGroupRelease(freshGroup);
+
+    printf("GarbageCollectionEventsTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapLimitsTest.h"
+
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+static const size_t MB = 1024 * 1024;
+
+struct SoftLimitRecord {
+    unsigned count { 0 };
+    size_t heapSize { 0 };
+};
+
+static void recordSoftLimit(JSContextGroupRef, size_t heapSize, void* userData)
+{
+    SoftLimitRecord* record = static_cast<SoftLimitRecord*>(userData);
+    record->count++;
+    record->heapSize = heapSize;
+}
+
+static void collectGarbage(JSGlobalContextRef context)
+{
+    // The limits are checked when the group's thread finalizes a collection, which the second
+    // collection guarantees has happened for the first.
+    JSSynchronousGarbageCollectForDebugging(context);
+    JSSynchronousGarbageCollectForDebugging(context);
+}
+
+static CString evaluateToString(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (!result)
+        return CString("uncaught exception");
+
+    JSStringRef string = JSValueToStringCopy(context, result, nullptr);
+    size_t size = JSStringGetMaximumUTF8CStringSize(string);
+    Vector<char> buffer(size);
+    JSStringGetUTF8CString(string, buffer.data(), size);
+    JSStringRelease(string);
+    return CString(buffer.data());
+}
+
+int testHeapLimits()
+{
+    bool overallResult = true;
+
+    printf("HeapLimitsTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    {
+        JSContextGroupRef group = JSContextGroupCreate();
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+
+        SoftLimitRecord record;
+        JSContextGroupSetHeapLimits(group, 4 * MB, 0, recordSoftLimit, &record);
+        collectGarbage(context);
+        test("a small heap is under the soft limit", !record.count);
+
+        evaluateToString(context, "var retained = []; for (var i = 0; i < 1000; ++i) retained.push(new Array(1000).fill(i)); 0");
+        collectGarbage(context);
+        test("crossing the soft limit calls the callback", record.count == 1);
+        test("the callback gets the heap size", record.heapSize > 4 * MB);
+        test("the heap size is reported", JSContextGroupGetHeapSize(group) > 4 * MB);
+
+        collectGarbage(context);
+        test("staying over the soft limit does not call the callback again", record.count == 1);
+
+        evaluateToString(context, "retained = null; 0");
+        collectGarbage(context);
+        evaluateToString(context, "retained = []; for (var i = 0; i < 1000; ++i) retained.push(new Array(1000).fill(i)); 0");
+        collectGarbage(context);
+        test("crossing the soft limit again calls the callback again", record.count == 2);
+
+        JSGlobalContextRelease(context);
+        JSContextGroupRelease(group);
+    }
+
+    {
+        JSContextGroupRef group = JSContextGroupCreate();
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+        JSContextGroupSetHeapLimits(group, 0, 16 * MB, nullptr, nullptr);
+
+        CString result = evaluateToString(context,
+            "var caught = 'nothing';"
+            "(function () {"
+            "    var arrays = [];"
+            "    try {"
+            "        for (var i = 0; i < 20000; ++i)"
+            "            arrays.push(new Array(1000).fill(i));"
+            "    } catch (e) {"
+            "        caught = String(e);"
+            "    }"
+            "})();"
+            "caught");
+        test("growing past the hard limit throws a catchable error", strstr(result.data(), "Out of memory"));
+
+        collectGarbage(context);
+        test("the heap is back under the hard limit once the garbage is collected", JSContextGroupGetHeapSize(group) < 16 * MB);
+        test("the group keeps running code afterwards", evaluateToString(context, "40 + 2") == "42");
+
+        JSGlobalContextRelease(context);
+        JSContextGroupRelease(group);
+    }
+
+    printf("HeapLimitsTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
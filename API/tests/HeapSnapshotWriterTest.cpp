@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshotWriterTest.h"
+
+#include "APICast.h"
+#include "HeapProfiler.h"
+#include "HeapSnapshotBuilder.h"
+#include "HeapSnapshotWriter.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "VM.h"
+#include <wtf/HashSet.h>
+#include <wtf/text/CString.h>
+
+#if OS(UNIX)
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+using namespace JSC;
+
+namespace {
+
+struct RecordedNode {
+    unsigned identifier;
+    uint64_t sizeInBytes;
+    String className;
+    bool isInternal;
+};
+
+struct RecordedEdge {
+    unsigned fromIdentifier;
+    unsigned toIdentifier;
+    unsigned type;
+    unsigned extraData;
+};
+
+struct RecordedSnapshot {
+    Vector<String> classNames;
+    Vector<String> edgeNames;
+    Vector<RecordedNode> nodes;
+    Vector<RecordedEdge> edges;
+    bool isValid { true };
+};
+
+// Records what HeapSnapshotBuilder hands it and passes every call on to the other writers, so that
+// they all see the same snapshot. A snapshot can only be written once.
+class RecordingWriter : public HeapSnapshotWriter {
+public:
+    RecordingWriter(Vector<HeapSnapshotWriter*>&& writers)
+        : HeapSnapshotWriter(nullptr)
+        , m_writers(WTFMove(writers))
+    {
+    }
+
+    void appendClassName(unsigned index, const char* className) override
+    {
+        m_snapshot.isValid &= index == m_snapshot.classNames.size();
+        m_snapshot.classNames.append(String(className));
+        for (auto* writer : m_writers)
+            writer->appendClassName(index, className);
+    }
+
+    void appendNode(unsigned identifier, size_t sizeInBytes, unsigned classNameIndex, bool isInternal) override
+    {
+        m_snapshot.isValid &= classNameIndex < m_snapshot.classNames.size();
+        if (m_snapshot.isValid)
+            m_snapshot.nodes.append(RecordedNode { identifier, sizeInBytes, m_snapshot.classNames[classNameIndex], isInternal });
+        for (auto* writer : m_writers)
+            writer->appendNode(identifier, sizeInBytes, classNameIndex, isInternal);
+    }
+
+    void didAppendNodes() override
+    {
+        for (auto* writer : m_writers)
+            writer->didAppendNodes();
+    }
+
+    void appendEdgeName(unsigned index, UniquedStringImpl* edgeName) override
+    {
+        m_snapshot.isValid &= index == m_snapshot.edgeNames.size();
+        m_snapshot.edgeNames.append(String(edgeName));
+        for (auto* writer : m_writers)
+            writer->appendEdgeName(index, edgeName);
+    }
+
+    void appendEdge(unsigned fromIdentifier, unsigned toIdentifier, EdgeType type, unsigned extraData) override
+    {
+        m_snapshot.edges.append(RecordedEdge { fromIdentifier, toIdentifier, static_cast<unsigned>(type), extraData });
+        for (auto* writer : m_writers)
+            writer->appendEdge(fromIdentifier, toIdentifier, type, extraData);
+    }
+
+    void didAppendEdges() override
+    {
+        for (auto* writer : m_writers)
+            writer->didAppendEdges();
+    }
+
+    const RecordedSnapshot& snapshot() const { return m_snapshot; }
+
+private:
+    Vector<HeapSnapshotWriter*> m_writers;
+    RecordedSnapshot m_snapshot;
+};
+
+class BinaryReader {
+public:
+    BinaryReader(const Vector<char>& data)
+        : m_data(data)
+    {
+    }
+
+    bool atEnd() const { return m_position >= m_data.size(); }
+    bool didFail() const { return m_didFail; }
+
+    uint8_t readByte()
+    {
+        if (atEnd()) {
+            m_didFail = true;
+            return 0;
+        }
+        return static_cast<uint8_t>(m_data[m_position++]);
+    }
+
+    uint64_t readNumber()
+    {
+        uint64_t result = 0;
+        for (unsigned shift = 0; shift < 64 && !m_didFail; shift += 7) {
+            uint8_t byte = readByte();
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return result;
+        }
+        m_didFail = true;
+        return 0;
+    }
+
+    int64_t readSignedNumber()
+    {
+        int64_t result = 0;
+        for (unsigned shift = 0; shift < 64 && !m_didFail; shift += 7) {
+            uint8_t byte = readByte();
+            result |= static_cast<int64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                if ((byte & 0x40) && shift + 7 < 64)
+                    result |= -(static_cast<int64_t>(1) << (shift + 7));
+                return result;
+            }
+        }
+        m_didFail = true;
+        return 0;
+    }
+
+    String readString()
+    {
+        uint64_t length = readNumber();
+        if (m_didFail || length > m_data.size() - m_position) {
+            m_didFail = true;
+            return String();
+        }
+        String result = String::fromUTF8(m_data.data() + m_position, length);
+        m_position += length;
+        return result;
+    }
+
+private:
+    const Vector<char>& m_data;
+    size_t m_position { 0 };
+    bool m_didFail { false };
+};
+
+// Decodes the binary format described in HeapSnapshotWriter.cpp. Fails if a name is defined more
+// than once, or used before it is defined.
+static RecordedSnapshot decodeBinarySnapshot(const Vector<char>& data)
+{
+    RecordedSnapshot snapshot;
+    BinaryReader reader(data);
+
+    static const char magic[] = { 'J', 'S', 'C', 'H', 'e', 'a', 'p', 0 };
+    for (char expected : magic)
+        snapshot.isValid &= reader.readByte() == static_cast<uint8_t>(expected);
+    snapshot.isValid &= reader.readNumber() == 1;
+
+    HashSet<String> classNames;
+    HashSet<String> edgeNames;
+    int64_t lastNodeIdentifier = 0;
+    uint64_t lastFromIdentifier = 0;
+    bool sawEnd = false;
+    while (snapshot.isValid && !reader.didFail() && !sawEnd) {
+        switch (reader.readByte()) {
+        case 0:
+            sawEnd = true;
+            break;
+        case 1: {
+            String className = reader.readString();
+            snapshot.isValid &= classNames.add(className).isNewEntry;
+            snapshot.classNames.append(className);
+            break;
+        }
+        case 2: {
+            lastNodeIdentifier += reader.readSignedNumber();
+            uint64_t sizeInBytes = reader.readNumber();
+            uint64_t classNameAndInternal = reader.readNumber();
+            uint64_t classNameIndex = classNameAndInternal >> 1;
+            snapshot.isValid &= classNameIndex < snapshot.classNames.size();
+            if (snapshot.isValid)
+                snapshot.nodes.append(RecordedNode { static_cast<unsigned>(lastNodeIdentifier), sizeInBytes, snapshot.classNames[classNameIndex], !!(classNameAndInternal & 1) });
+            break;
+        }
+        case 3: {
+            String edgeName = reader.readString();
+            snapshot.isValid &= edgeNames.add(edgeName).isNewEntry;
+            snapshot.edgeNames.append(edgeName);
+            break;
+        }
+        case 4: {
+            lastFromIdentifier += reader.readNumber();
+            RecordedEdge edge;
+            edge.fromIdentifier = static_cast<unsigned>(lastFromIdentifier);
+            edge.toIdentifier = static_cast<unsigned>(reader.readNumber());
+            edge.type = static_cast<unsigned>(reader.readNumber());
+            edge.extraData = static_cast<unsigned>(reader.readNumber());
+            if (edge.type == static_cast<unsigned>(EdgeType::Property) || edge.type == static_cast<unsigned>(EdgeType::Variable))
+                snapshot.isValid &= edge.extraData < snapshot.edgeNames.size();
+            snapshot.edges.append(edge);
+            break;
+        }
+        default:
+            snapshot.isValid = false;
+            break;
+        }
+    }
+    snapshot.isValid &= sawEnd && reader.atEnd() && !reader.didFail();
+    return snapshot;
+}
+
+static bool snapshotsAreEqual(const RecordedSnapshot& a, const RecordedSnapshot& b)
+{
+    if (!a.isValid || !b.isValid)
+        return false;
+    if (a.classNames != b.classNames || a.edgeNames != b.edgeNames)
+        return false;
+    if (a.nodes.size() != b.nodes.size() || a.edges.size() != b.edges.size())
+        return false;
+    for (size_t i = 0; i < a.nodes.size(); ++i) {
+        const RecordedNode& nodeA = a.nodes[i];
+        const RecordedNode& nodeB = b.nodes[i];
+        if (nodeA.identifier != nodeB.identifier || nodeA.sizeInBytes != nodeB.sizeInBytes || nodeA.className != nodeB.className || nodeA.isInternal != nodeB.isInternal)
+            return false;
+    }
+    for (size_t i = 0; i < a.edges.size(); ++i) {
+        const RecordedEdge& edgeA = a.edges[i];
+        const RecordedEdge& edgeB = b.edges[i];
+        if (edgeA.fromIdentifier != edgeB.fromIdentifier || edgeA.toIdentifier != edgeB.toIdentifier || edgeA.type != edgeB.type || edgeA.extraData != edgeB.extraData)
+            return false;
+    }
+    return true;
+}
+
+static HeapSnapshotWriter::Output chunkCollector(Vector<Vector<char>>& chunks)
+{
+    return [&chunks] (const char* data, size_t length) -> bool {
+        Vector<char> chunk;
+        chunk.append(data, length);
+        chunks.append(WTFMove(chunk));
+        return true;
+    };
+}
+
+static Vector<char> concatenate(const Vector<Vector<char>>& chunks)
+{
+    Vector<char> result;
+    for (auto& chunk : chunks)
+        result.appendVector(chunk);
+    return result;
+}
+
+// Every chunk but the last one is at least chunkSize bytes, and no chunk carries more than one
+// record past that.
+static bool isChunkedCorrectly(const Vector<Vector<char>>& chunks, size_t largestRecord)
+{
+    if (chunks.size() < 2)
+        return false;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (i + 1 < chunks.size() && chunks[i].size() < HeapSnapshotWriter::chunkSize)
+            return false;
+        if (chunks[i].size() >= HeapSnapshotWriter::chunkSize + largestRecord)
+            return false;
+    }
+    return true;
+}
+
+static unsigned jsonArrayLength(JSContextRef context, JSObjectRef object, const char* name)
+{
+    JSStringRef propertyName = JSStringCreateWithUTF8CString(name);
+    JSValueRef array = JSObjectGetProperty(context, object, propertyName, nullptr);
+    JSStringRelease(propertyName);
+    if (!JSValueIsObject(context, array))
+        return 0;
+    JSStringRef lengthName = JSStringCreateWithUTF8CString("length");
+    JSValueRef length = JSObjectGetProperty(context, JSValueToObject(context, array, nullptr), lengthName, nullptr);
+    JSStringRelease(lengthName);
+    return static_cast<unsigned>(JSValueToNumber(context, length, nullptr));
+}
+
+} // anonymous namespace
+
+int testHeapSnapshotWriter()
+{
+    bool overallResult = true;
+
+    printf("HeapSnapshotWriterTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    VM& vm = toJS(context)->vm();
+
+    // Enough objects, with enough shared property names, that both formats need several chunks.
+    JSStringRef script = JSStringCreateWithUTF8CString(
+        "var keep = [];\n"
+        "for (var i = 0; i < 20000; ++i) { var o = {}; o['p' + (i % 100)] = { i }; keep.push(o); }\n");
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+
+    Vector<Vector<char>> binaryChunks;
+    Vector<Vector<char>> jsonChunks;
+    HeapSnapshotBinaryWriter binaryWriter(chunkCollector(binaryChunks));
+    HeapSnapshotJSONWriter jsonWriter(chunkCollector(jsonChunks));
+    Vector<HeapSnapshotWriter*> writers { &binaryWriter, &jsonWriter };
+
+#if OS(UNIX)
+    char path[] = "/tmp/JSCHeapSnapshotWriterTest.XXXXXX";
+    int fileDescriptor = mkstemp(path);
+    std::unique_ptr<HeapSnapshotBinaryWriter> fileWriter;
+    if (fileDescriptor >= 0) {
+        fileWriter = std::make_unique<HeapSnapshotBinaryWriter>(HeapSnapshotWriter::fileDescriptorOutput(fileDescriptor));
+        writers.append(fileWriter.get());
+    }
+#endif
+
+    RecordingWriter recordingWriter(WTFMove(writers));
+    bool didWrite;
+    {
+        JSLockHolder locker(vm);
+        HeapSnapshotBuilder builder(vm.ensureHeapProfiler());
+        builder.buildSnapshot();
+        didWrite = builder.write(recordingWriter);
+    }
+    const RecordedSnapshot& recorded = recordingWriter.snapshot();
+    test("the snapshot is written", didWrite && recorded.isValid && !binaryWriter.didFail() && !jsonWriter.didFail());
+
+    Vector<char> binary = concatenate(binaryChunks);
+    RecordedSnapshot decoded = decodeBinarySnapshot(binary);
+    test("the binary format decodes to the snapshot that was written", snapshotsAreEqual(recorded, decoded));
+    test("each class name and edge name is written once", decoded.isValid && decoded.classNames.size() == recorded.classNames.size() && decoded.edgeNames.size() == recorded.edgeNames.size());
+
+    // The largest binary record is a name; other records are a few bytes.
+    size_t largestBinaryRecord = KB;
+    for (auto& name : recorded.classNames)
+        largestBinaryRecord = std::max<size_t>(largestBinaryRecord, name.utf8().length() + 16);
+    for (auto& name : recorded.edgeNames)
+        largestBinaryRecord = std::max<size_t>(largestBinaryRecord, name.utf8().length() + 16);
+    test("the binary format is written in chunks", isChunkedCorrectly(binaryChunks, largestBinaryRecord));
+
+    // The JSON writer writes its name lists in one go at the end of the nodes and of the edges.
+    size_t largestJSONRecord = KB;
+    for (auto& name : recorded.classNames)
+        largestJSONRecord += name.utf8().length() * 6 + 3;
+    for (auto& name : recorded.edgeNames)
+        largestJSONRecord += name.utf8().length() * 6 + 3;
+    test("the JSON format is written in chunks", isChunkedCorrectly(jsonChunks, largestJSONRecord));
+
+    Vector<char> json = concatenate(jsonChunks);
+    json.append(0);
+    JSStringRef jsonString = JSStringCreateWithUTF8CString(json.data());
+    JSValueRef parsed = JSValueMakeFromJSONString(context, jsonString);
+    JSStringRelease(jsonString);
+    bool jsonMatches = parsed && JSValueIsObject(context, parsed);
+    if (jsonMatches) {
+        JSObjectRef object = JSValueToObject(context, parsed, nullptr);
+        jsonMatches = jsonArrayLength(context, object, "nodes") == recorded.nodes.size() * 4
+            && jsonArrayLength(context, object, "edges") == recorded.edges.size() * 4
+            && jsonArrayLength(context, object, "nodeClassNames") == recorded.classNames.size()
+            && jsonArrayLength(context, object, "edgeNames") == recorded.edgeNames.size();
+    }
+    test("the JSON chunks make up the whole snapshot", jsonMatches);
+
+#if OS(UNIX)
+    bool fileMatches = false;
+    if (fileDescriptor >= 0) {
+        Vector<char> contents;
+        char buffer[4096];
+        ssize_t length;
+        if (lseek(fileDescriptor, 0, SEEK_SET) == 0) {
+            while ((length = read(fileDescriptor, buffer, sizeof(buffer))) > 0)
+                contents.append(buffer, length);
+        }
+        fileMatches = !fileWriter->didFail() && contents == binary;
+        close(fileDescriptor);
+        unlink(path);
+    }
+    test("a file descriptor output writes every chunk", fileMatches);
+
+    HeapSnapshotBinaryWriter badFileWriter(HeapSnapshotWriter::fileDescriptorOutput(-1));
+    badFileWriter.didAppendEdges();
+    test("a file descriptor output reports write errors", badFileWriter.didFail());
+#endif
+
+    // After the output fails once, the writer stops writing.
+    unsigned numberOfOutputCalls = 0;
+    HeapSnapshotBinaryWriter failingWriter([&] (const char*, size_t) -> bool {
+        ++numberOfOutputCalls;
+        return false;
+    });
+    failingWriter.appendClassName(0, "Object");
+    for (unsigned i = 0; i < 3 * HeapSnapshotWriter::chunkSize; ++i)
+        failingWriter.appendNode(i, 16, 0, false);
+    failingWriter.didAppendNodes();
+    failingWriter.didAppendEdges();
+    test("a writer stops writing after its output fails", failingWriter.didFail() && numberOfOutputCalls == 1);
+
+    JSGlobalContextRelease(context);
+
+    printf("HeapSnapshotWriterTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -26,14 +26,241 @@
 #include "config.h"
 #include "JSONParseTest.h"
 
+#include "Completion.h"
 #include "JSCInlines.h"
 #include "JSGlobalObject.h"
 #include "JSONObject.h"
+#include "SourceCode.h"
 #include "VM.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
 #include <wtf/RefPtr.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringConcatenate.h>
 
 using namespace JSC;
 
+static String upconvert(const String& string)
+{
+    Vector<UChar> characters;
+    for (unsigned i = 0; i < string.length(); ++i)
+        characters.append(string[i]);
+    return String(characters.data(), characters.size());
+}
+
+// Runs each JSON text as an 8-bit string, when it fits, and as a 16-bit one.
+static Vector<String> inputsFor(const String& text)
+{
+    Vector<String> inputs;
+    if (text.is8Bit())
+        inputs.append(text);
+    inputs.append(upconvert(text));
+    return inputs;
+}
+
+// Makes the parsed value available to the check as `parsed`, and returns whether the check
+// evaluated to true.
+static bool checkParsedValue(ExecState* exec, JSValue parsed, const char* check)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+    JSGlobalObject* globalObject = exec->lexicalGlobalObject();
+    globalObject->putDirect(vm, Identifier::fromString(&vm, "parsed"), parsed);
+    NakedPtr<Exception> exception;
+    JSValue result = evaluate(exec, makeSource(check, SourceOrigin()), JSValue(), exception);
+    scope.clearException();
+    return !exception && result.isTrue();
+}
+
+// Key sequences for the transition cache test. Objects whose keys come in the same order must
+// end up with the same structure, and the rest with different ones, however their structures
+// collide in the parser's small cache.
+static Vector<String> keysForObject(unsigned index)
+{
+    Vector<String> keys;
+    keys.append(makeString("k", String::number(index % 40)));
+    unsigned second = (index * 7 + 3) % 40;
+    if (second != index % 40)
+        keys.append(makeString("k", String::number(second)));
+    keys.append(index % 3 ? "shared" : "0");
+    if (index % 5 == 1)
+        std::swap(keys.first(), keys.last());
+    return keys;
+}
+
+static bool testPropertyTransitionCache(ExecState* exec)
+{
+    static const unsigned numberOfObjects = 600;
+
+    StringBuilder builder;
+    builder.append('[');
+    for (unsigned i = 0; i < numberOfObjects; ++i) {
+        if (i)
+            builder.append(',');
+        builder.append('{');
+        Vector<String> keys = keysForObject(i);
+        for (unsigned j = 0; j < keys.size(); ++j) {
+            if (j)
+                builder.append(',');
+            builder.append(makeString("\"", keys[j], "\":", String::number(i)));
+        }
+        builder.append('}');
+    }
+    builder.append(']');
+
+    bool result = true;
+    for (const String& input : inputsFor(builder.toString())) {
+        JSValue parsed = JSONParse(exec, input);
+        if (!parsed.isObject())
+            return false;
+
+        HashMap<String, StructureID> structureIDs;
+        HashSet<StructureID> distinctStructureIDs;
+        JSObject* array = asObject(parsed);
+        for (unsigned i = 0; i < numberOfObjects; ++i) {
+            JSObject* object = asObject(array->getIndex(exec, i));
+            // An index property changes the structure too, so where it comes matters.
+            StringBuilder shape;
+            for (const String& key : keysForObject(i))
+                shape.append(makeString(key, ","));
+            auto addResult = structureIDs.add(shape.toString(), object->structureID());
+            if (addResult.isNewEntry)
+                distinctStructureIDs.add(object->structureID());
+            else
+                result &= addResult.iterator->value == object->structureID();
+        }
+        result &= distinctStructureIDs.size() == structureIDs.size();
+
+        result &= checkParsedValue(exec, parsed,
+            "(function () {\n"
+            "    for (var i = 0; i < 600; ++i) {\n"
+            "        var keys = ['k' + (i % 40)];\n"
+            "        var second = (i * 7 + 3) % 40;\n"
+            "        if (second != i % 40)\n"
+            "            keys.push('k' + second);\n"
+            "        keys.push(i % 3 ? 'shared' : '0');\n"
+            "        if (i % 5 == 1) {\n"
+            "            var first = keys[0];\n"
+            "            keys[0] = keys[keys.length - 1];\n"
+            "            keys[keys.length - 1] = first;\n"
+            "        }\n"
+            "        var names = keys.filter(function (key) { return key != '0'; });\n"
+            "        if (keys.indexOf('0') != -1)\n"
+            "            names.unshift('0');\n"
+            "        var object = parsed[i];\n"
+            "        if (Object.keys(object).join() !== names.join())\n"
+            "            return false;\n"
+            "        if (!Object.keys(object).every(function (key) { return object[key] === i; }))\n"
+            "            return false;\n"
+            "    }\n"
+            "    return true;\n"
+            "})()");
+    }
+    return result;
+}
+
+static bool testDuplicateAndSpecialKeys(ExecState* exec)
+{
+    struct Case {
+        const char* text;
+        const char* check;
+    };
+    static const Case cases[] = {
+        { "[{\"a\":1,\"b\":2},{\"a\":1,\"a\":2,\"b\":3},{\"a\":1,\"b\":2,\"a\":3}]",
+            "Object.keys(parsed[1]).join() === 'a,b' && parsed[1].a === 2 && parsed[1].b === 3"
+            " && Object.keys(parsed[2]).join() === 'a,b' && parsed[2].a === 3 && parsed[2].b === 2"
+            " && Object.keys(parsed[0]).join() === 'a,b' && parsed[0].a === 1" },
+        { "[{\"a\":1,\"b\":{\"a\":2,\"a\":3}},{\"a\":4,\"b\":{\"a\":5}}]",
+            "parsed[0].b.a === 3 && parsed[1].b.a === 5 && Object.keys(parsed[0].b).join() === 'a'" },
+        { "[{\"__proto__\":1,\"a\":2},{\"__proto__\":{\"x\":1},\"a\":2},{\"a\":3,\"__proto__\":[]}]",
+            "parsed.every(function (object) { return Object.getPrototypeOf(object) === Object.prototype"
+            " && Object.getOwnPropertyNames(object).indexOf('__proto__') != -1; })"
+            " && parsed[0].__proto__ === 1 && parsed[1].x === undefined && parsed[1].__proto__.x === 1"
+            " && Array.isArray(parsed[2].__proto__) && Object.keys(parsed[2]).join() === 'a,__proto__'" },
+        { "[{\"__proto__\":1,\"__proto__\":2},{\"__proto__\":3}]",
+            "parsed[0].__proto__ === 2 && parsed[1].__proto__ === 3 && Object.getOwnPropertyNames(parsed[0]).length === 1" },
+        { "[{\"0\":\"x\",\"a\":1},{\"a\":2,\"0\":\"y\"},{\"0\":\"z\",\"0\":\"w\",\"a\":3}]",
+            "parsed[0][0] === 'x' && parsed[1][0] === 'y' && parsed[2][0] === 'w'"
+            " && parsed[0].a === 1 && parsed[1].a === 2 && parsed[2].a === 3" },
+    };
+
+    bool result = true;
+    for (const Case& testCase : cases) {
+        for (const String& input : inputsFor(testCase.text)) {
+            JSValue parsed = JSONParse(exec, input);
+            bool caseResult = parsed.isObject() && checkParsedValue(exec, parsed, testCase.check);
+            if (!caseResult)
+                printf("FAIL: JSONParse of %s\n", input.utf8().data());
+            result &= caseResult;
+        }
+    }
+    return result;
+}
+
+// Puts escapes, non-ASCII characters, control characters and the closing quote at every position
+// around the 16-byte blocks that string scanning works on, in both keys and values.
+static bool testStringScanning(ExecState* exec)
+{
+    static const UChar latin1Character = 0xE9;
+    static const UChar nonLatin1Character = 0x101;
+
+    bool result = true;
+    for (unsigned offset = 0; offset <= 16; ++offset) {
+        StringBuilder prefixBuilder;
+        for (unsigned i = 0; i < offset; ++i)
+            prefixBuilder.append('a');
+        String prefix = prefixBuilder.toString();
+
+        std::pair<String, String> validCases[] = {
+            { prefix, prefix },
+            { makeString(prefix, "\\\"bb"), makeString(prefix, "\"bb") },
+            { makeString(prefix, "\\\\bb"), makeString(prefix, "\\bb") },
+            { makeString(prefix, "\\nbb"), makeString(prefix, "\nbb") },
+            { makeString(prefix, "\\u0041bb"), makeString(prefix, "Abb") },
+            { makeString(prefix, "\\u2028bb"), makeString(prefix, static_cast<UChar>(0x2028), "bb") },
+            { makeString(prefix, latin1Character, "bb"), makeString(prefix, latin1Character, "bb") },
+            { makeString(prefix, nonLatin1Character, "bb"), makeString(prefix, nonLatin1Character, "bb") },
+            { makeString(prefix, "'bb"), makeString(prefix, "'bb") },
+        };
+        for (auto& validCase : validCases) {
+            String text = makeString("{\"", validCase.first, "\":\"", validCase.first, "\"}");
+            for (const String& input : inputsFor(text)) {
+                JSValue parsed = JSONParse(exec, input);
+                bool caseResult = false;
+                if (parsed.isObject()) {
+                    JSObject* object = asObject(parsed);
+                    Identifier key = Identifier::fromString(exec, validCase.second);
+                    JSValue value = object->getDirect(exec->vm(), key);
+                    caseResult = value.isString() && asString(value)->value(exec) == validCase.second;
+                }
+                if (!caseResult)
+                    printf("FAIL: JSONParse of %s-bit %s\n", input.is8Bit() ? "8" : "16", input.utf8().data());
+                result &= caseResult;
+            }
+        }
+
+        String invalidCases[] = {
+            makeString("\"", prefix),
+            makeString("\"", prefix, "\\"),
+            makeString("\"", prefix, "\nbb\""),
+            makeString("\"", prefix, "\tbb\""),
+            makeString("\"", prefix, static_cast<UChar>(1), "bb\""),
+            makeString("\"", prefix, "\\xbb\""),
+        };
+        for (const String& text : invalidCases) {
+            for (const String& input : inputsFor(text)) {
+                auto scope = DECLARE_CATCH_SCOPE(exec->vm());
+                bool caseResult = !JSONParse(exec, input);
+                scope.clearException();
+                if (!caseResult)
+                    printf("FAIL: JSONParse accepted %s-bit %s\n", input.is8Bit() ? "8" : "16", input.utf8().data());
+                result &= caseResult;
+            }
+        }
+    }
+    return result;
+}
+
 int testJSONParse()
 {
     bool failed = false;
@@ -58,12 +285,20 @@ int testJSONParse()
     failed = failed || (v3 != v4);
     failed = failed || (v4 == v5);
 
-    vm = nullptr;
-
     if (failed)
         printf("FAIL: JSONParse String test.\n");
     else
         printf("PASS: JSONParse String test.\n");
 
+    auto report = [&] (const char* name, bool result) {
+        printf("%s: JSONParse %s test.\n", result ? "PASS" : "FAIL", name);
+        failed = failed || !result;
+    };
+    report("property transition cache", testPropertyTransitionCache(exec));
+    report("duplicate and special keys", testDuplicateAndSpecialKeys(exec));
+    report("string scanning", testStringScanning(exec));
+
+    vm = nullptr;
+
     return failed;
 }
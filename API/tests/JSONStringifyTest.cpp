@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSONStringifyTest.h"
+
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/Vector.h>
+
+using namespace JSC;
+
+// JSON.stringify serializes plain objects straight from their structure. Each case builds fresh
+// objects and stringifies them, and must give the same result with and without that fast path.
+static const char* setup =
+    "function make(i) {\n"
+    "    var object = { a: i, [Symbol('s')]: i, b: i };\n"
+    "    Object.defineProperty(object, 'hidden', { value: i, enumerable: false, writable: true, configurable: true });\n"
+    "    object.c = i;\n"
+    "    return object;\n"
+    "}\n"
+    "function K() { this.a = 1; this.b = 2; }\n"
+    "K.prototype = { get inherited() { return 3; } };\n";
+
+static const struct {
+    const char* description;
+    const char* script;
+} cases[] = {
+    { "toJSON that adds, deletes and changes later siblings",
+        "var o = { a: 1, b: { toJSON: function () { o.c = 'changed'; delete o.d; o.added = 1; return 'B'; } }, c: 3, d: 4, e: 5 };\n"
+        "JSON.stringify(o)" },
+    { "toJSON that changes a later sibling without changing the structure",
+        "var o = { a: { toJSON: function () { o.b = 'changed'; return 'A'; } }, b: 2 };\n"
+        "JSON.stringify([o, o])" },
+    { "toJSON that deletes and re-adds a later sibling",
+        "var o = { a: { toJSON: function () { delete o.b; o.b = 'again'; return 'A'; } }, b: 2, c: 3 };\n"
+        "JSON.stringify(o)" },
+    { "getter that reconfigures later siblings",
+        "var o = { first: { get g() {\n"
+        "    Object.defineProperty(o, 'second', { enumerable: false });\n"
+        "    Object.defineProperty(o, 'third', { get: function () { return 'getter'; } });\n"
+        "    return 1;\n"
+        "} }, second: 2, third: 3, fourth: 4 };\n"
+        "JSON.stringify(o)" },
+    { "toJSON that changes an object with the same structure",
+        "var list = [{ x: 1, y: { toJSON: function () { list[1].x = 'late'; list[2].z = 3; delete list[3].x; Object.defineProperty(list[4], 'y', { get: function () { return 'getter'; } }); return 2; } } }, { x: 1, y: 2 }, { x: 1, y: 2 }, { x: 1, y: 2 }, { x: 1, y: 2 }];\n"
+        "JSON.stringify(list)" },
+    { "replacer that changes its holder",
+        "var o = { a: 1, b: 2, c: 3 };\n"
+        "JSON.stringify(o, function (key, value) { if (key === 'a') { delete this.b; this.c = 'replaced'; this.d = 4; } return value; })" },
+    { "DontEnum and Symbol keys",
+        "JSON.stringify([make(1), make(2), { [Symbol.iterator]: 1, d: 1 }, Object.defineProperty({ e: 1 }, 'f', { value: 2 })])" },
+    { "objects sharing a structure with different gaps",
+        "[JSON.stringify([make(1), { n: make(2) }], null, 2), JSON.stringify([make(1), make(2)], null, '--'),\n"
+        " JSON.stringify(make(3)), JSON.stringify({ x: make(4) }, null, 10), JSON.stringify([make(5)], ['c', 'a'], 1)].join('|')" },
+    { "structures with accessors",
+        "var withAccessor = { a: 1, get b() { return this.a + 1; }, set c(value) { }, d: 4 };\n"
+        "JSON.stringify([withAccessor, withAccessor, new K, new K, Object.create({ p: 1 }, { own: { value: 2, enumerable: true } })])" },
+    { "keys that need quoting",
+        "var o = { 'q\"uote': 1, '\\u2028': 2, '\\u00e9': 3, '\\\\': 4 };\n"
+        "JSON.stringify([o, o], null, 1)" },
+};
+
+static JSStringRef evaluateToString(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (!result || exception || !JSValueIsString(context, result))
+        return nullptr;
+    return JSValueToStringCopy(context, result, nullptr);
+}
+
+int testJSONStringify()
+{
+    bool overallResult = true;
+
+    printf("JSONStringifyTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    bool oldUseJSONStringifyStructureCache = Options::useJSONStringifyStructureCache();
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSStringRef setupScript = JSStringCreateWithUTF8CString(setup);
+    JSEvaluateScript(context, setupScript, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(setupScript);
+
+    for (auto& testCase : cases) {
+        Options::useJSONStringifyStructureCache() = true;
+        JSStringRef withCache = evaluateToString(context, testCase.script);
+        Options::useJSONStringifyStructureCache() = false;
+        JSStringRef withoutCache = evaluateToString(context, testCase.script);
+
+        bool result = withCache && withoutCache && JSStringIsEqual(withCache, withoutCache);
+        if (!result && withCache && withoutCache) {
+            size_t withCacheSize = JSStringGetMaximumUTF8CStringSize(withCache);
+            size_t withoutCacheSize = JSStringGetMaximumUTF8CStringSize(withoutCache);
+            Vector<char> withCacheBuffer(withCacheSize);
+            Vector<char> withoutCacheBuffer(withoutCacheSize);
+            JSStringGetUTF8CString(withCache, withCacheBuffer.data(), withCacheSize);
+            JSStringGetUTF8CString(withoutCache, withoutCacheBuffer.data(), withoutCacheSize);
+            printf("        %s\n        rather than %s\n", withCacheBuffer.data(), withoutCacheBuffer.data());
+        }
+        test(testCase.description, result);
+
+        if (withCache)
+            JSStringRelease(withCache);
+        if (withoutCache)
+            JSStringRelease(withoutCache);
+    }
+
+    JSGlobalContextRelease(context);
+    Options::useJSONStringifyStructureCache() = oldUseJSONStringifyStructureCache;
+
+    printf("JSONStringifyTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
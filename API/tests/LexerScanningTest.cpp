@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "LexerScanningTest.h"
+
+#include "Completion.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "ParserError.h"
+#include "SourceCode.h"
+#include "VM.h"
+#include <wtf/RefPtr.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringConcatenate.h>
+
+using namespace JSC;
+
+// The lexer skips over identifiers, string and template literals and comments a block of 16 bytes
+// at a time before falling back to its scalar loop. These cases put the character that ends each
+// fast scan at every offset within and just past the first block, in both 8-bit and 16-bit
+// sources, and check that the tokens, line numbers and source positions come out the same.
+
+static const unsigned maximumOffset = 16;
+
+static const UChar latin1Letter = 0xE9;
+static const UChar nonLatin1Letter = 0x101;
+static const UChar lineSeparator = 0x2028;
+
+static String repeatedA(unsigned count)
+{
+    StringBuilder builder;
+    for (unsigned i = 0; i < count; ++i)
+        builder.append('a');
+    return builder.toString();
+}
+
+static String upconvert(const String& string)
+{
+    Vector<UChar> characters;
+    for (unsigned i = 0; i < string.length(); ++i)
+        characters.append(string[i]);
+    return String(characters.data(), characters.size());
+}
+
+// Only cases whose text fits in 8 bits are run as 8-bit sources; every case is run as a 16-bit one.
+static Vector<String> sourcesFor(const String& text)
+{
+    Vector<String> sources;
+    if (text.is8Bit())
+        sources.append(text);
+    sources.append(upconvert(text));
+    return sources;
+}
+
+static String describe(const String& source)
+{
+    return makeString(source.is8Bit() ? "8-bit" : "16-bit", " source: ", source);
+}
+
+struct TokenCase {
+    // Must set `value` and must not end in the middle of a token.
+    String setup;
+    String expectedValue;
+    unsigned lineTerminators;
+};
+
+// A function declared right after the case, and an Error created on the next line, show that the
+// lexer's notion of where it is in the source survived the case.
+static String probe(const String& setup)
+{
+    return makeString(setup, " function probe() { return 1 }\n[value, new Error().line, probe].join('|')");
+}
+
+static String expectedProbeResult(const TokenCase& tokenCase)
+{
+    return makeString(tokenCase.expectedValue, '|', String::number(tokenCase.lineTerminators + 2), "|function probe() { return 1 }");
+}
+
+static Vector<TokenCase> identifierCases(const String& p)
+{
+    return {
+        { makeString("var ", p, "z = 3; var value = Object.keys({ ", p, "z: 0 })[0] + ", p, "z;"), makeString(p, "z3"), 0 },
+        { makeString("var ", p, "\\u0062c = 3; var value = Object.keys({ ", p, "bc: 0 })[0] + ", p, "bc;"), makeString(p, "bc3"), 0 },
+        { makeString("var ", p, latin1Letter, "c = 3; var value = Object.keys({ ", p, latin1Letter, "c: 0 })[0] + ", p, latin1Letter, "c;"), makeString(p, latin1Letter, "c3"), 0 },
+        { makeString("var ", p, nonLatin1Letter, "c = 3; var value = Object.keys({ ", p, nonLatin1Letter, "c: 0 })[0] + ", p, nonLatin1Letter, "c;"), makeString(p, nonLatin1Letter, "c3"), 0 },
+        { makeString("var ", p, "z = 3\nvar value = ", p, "z\n"), "3", 2 },
+    };
+}
+
+static Vector<TokenCase> stringCases(const String& p)
+{
+    return {
+        { makeString("var value = \"", p, "\";"), p, 0 },
+        { makeString("var value = '", p, "';"), p, 0 },
+        { makeString("var value = \"", p, "\\nbb\";"), makeString(p, "\nbb"), 0 },
+        { makeString("var value = \"", p, "\\x41bb\";"), makeString(p, "Abb"), 0 },
+        { makeString("var value = \"", p, "\\u2028bb\";"), makeString(p, lineSeparator, "bb"), 0 },
+        { makeString("var value = \"", p, "\\\nbb\";"), makeString(p, "bb"), 1 },
+        { makeString("var value = \"", p, "\\\r\nbb\";"), makeString(p, "bb"), 1 },
+        { makeString("var value = '", p, "\"bb';"), makeString(p, "\"bb"), 0 },
+        { makeString("var value = \"", p, latin1Letter, "bb\";"), makeString(p, latin1Letter, "bb"), 0 },
+        { makeString("var value = \"", p, nonLatin1Letter, "bb\";"), makeString(p, nonLatin1Letter, "bb"), 0 },
+    };
+}
+
+static Vector<TokenCase> templateCases(const String& p)
+{
+    return {
+        { makeString("var value = `", p, "`;"), p, 0 },
+        { makeString("var value = `", p, "$bb`;"), makeString(p, "$bb"), 0 },
+        { makeString("var value = `", p, "${1}bb`;"), makeString(p, "1bb"), 0 },
+        { makeString("var value = `", p, "\\nbb`;"), makeString(p, "\nbb"), 0 },
+        { makeString("var value = `", p, "\nbb`;"), makeString(p, "\nbb"), 1 },
+        { makeString("var value = `", p, "\r\nbb`;"), makeString(p, "\nbb"), 1 },
+        { makeString("var value = `", p, latin1Letter, "bb`;"), makeString(p, latin1Letter, "bb"), 0 },
+        { makeString("var value = `", p, nonLatin1Letter, "bb`;"), makeString(p, nonLatin1Letter, "bb"), 0 },
+    };
+}
+
+static Vector<TokenCase> commentCases(const String& p)
+{
+    return {
+        { makeString("var value = 0; /*", p, "*/"), "0", 0 },
+        { makeString("var value = 0; /*", p, "\nbb*/"), "0", 1 },
+        { makeString("var value = 0; /*", p, "\r\nbb*/"), "0", 1 },
+        { makeString("var value = 0; /*", p, "\rbb*/"), "0", 1 },
+        { makeString("var value = 0; /*", p, lineSeparator, "bb*/"), "0", 1 },
+        { makeString("var value = 0; /*", p, "*bb*/"), "0", 0 },
+        { makeString("var value = 0; /*", p, latin1Letter, "bb*/"), "0", 0 },
+        { makeString("var value = 0; /*", p, nonLatin1Letter, "bb*/"), "0", 0 },
+        { makeString("var value = 0; //", p, "\nvalue = 1;\n"), "1", 2 },
+        { makeString("var value = 0; //", p, "\r\nvalue = 1;\n"), "1", 2 },
+        { makeString("var value = 0; //", p, "\rvalue = 1;\n"), "1", 2 },
+        { makeString("var value = 0; //", p, lineSeparator, "value = 1;\n"), "1", 2 },
+        { makeString("var value = 0; //", p, "*/value = 1;\n"), "0", 1 },
+        { makeString("var value = 0; //", p, latin1Letter, "value = 1;\n"), "0", 1 },
+        { makeString("var value = 0; //", p, nonLatin1Letter, "value = 1;\n"), "0", 1 },
+    };
+}
+
+// Cases that end the source in the middle of the scanned token, so that its end is the end of input.
+static Vector<std::pair<String, String>> endOfInputCases(const String& p)
+{
+    return {
+        { makeString("var ", p, "z = 5;\n", p, "z"), "5" },
+        { makeString("\"", p, "\""), p },
+        { makeString("`", p, "`"), p },
+        { makeString("1;//", p), "1" },
+        { makeString("1;//", p, latin1Letter), "1" },
+        { makeString("1;//", p, nonLatin1Letter), "1" },
+        { makeString("1;/*", p, "*/"), "1" },
+    };
+}
+
+// Unterminated tokens, which must be reported on the line they run off the end of.
+static Vector<String> unterminatedCases(const String& p)
+{
+    return {
+        makeString("\n\nvar value = \"", p),
+        makeString("\n\nvar value = '", p, latin1Letter),
+        makeString("\n\nvar value = `", p),
+        makeString("\n\nvar value = 0; /*", p),
+        makeString("\n\nvar value = 0; /*", p, '*'),
+    };
+}
+
+int testLexerScanning()
+{
+    bool overallResult = true;
+
+    printf("LexerScanningTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    RefPtr<VM> vm = VM::create();
+
+    {
+        JSLockHolder locker(vm.get());
+        auto scope = DECLARE_CATCH_SCOPE(*vm);
+        JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+        ExecState* exec = globalObject->globalExec();
+
+        auto evaluateToString = [&] (const String& source) -> String {
+            NakedPtr<Exception> exception;
+            JSValue result = evaluate(exec, makeSource(source, SourceOrigin()), JSValue(), exception);
+            if (exception) {
+                scope.clearException();
+                return String();
+            }
+            String string = result.toWTFString(exec);
+            scope.clearException();
+            return string;
+        };
+
+        auto checkResult = [&] (const String& source, const String& expected) {
+            String result = evaluateToString(source);
+            if (result == expected)
+                return true;
+            printf("        %s\n        produced \"%s\" rather than \"%s\"\n", describe(source).utf8().data(), result.utf8().data(), expected.utf8().data());
+            return false;
+        };
+
+        auto checkTokenCases = [&] (Vector<TokenCase> (*casesFor)(const String&)) {
+            bool result = true;
+            for (unsigned offset = 0; offset <= maximumOffset; ++offset) {
+                for (const TokenCase& tokenCase : casesFor(repeatedA(offset))) {
+                    for (const String& source : sourcesFor(probe(tokenCase.setup)))
+                        result &= checkResult(source, expectedProbeResult(tokenCase));
+                }
+            }
+            return result;
+        };
+
+        test("identifiers", checkTokenCases(identifierCases));
+        test("string literals", checkTokenCases(stringCases));
+        test("template literals", checkTokenCases(templateCases));
+        test("comments", checkTokenCases(commentCases));
+
+        bool endOfInputResult = true;
+        bool unterminatedResult = true;
+        for (unsigned offset = 0; offset <= maximumOffset; ++offset) {
+            for (auto& endOfInputCase : endOfInputCases(repeatedA(offset))) {
+                for (const String& source : sourcesFor(endOfInputCase.first))
+                    endOfInputResult &= checkResult(source, endOfInputCase.second);
+            }
+            for (const String& text : unterminatedCases(repeatedA(offset))) {
+                for (const String& source : sourcesFor(text)) {
+                    ParserError error;
+                    if (!checkSyntax(*vm, makeSource(source, SourceOrigin()), error) && error.line() == 3)
+                        continue;
+                    printf("        %s\n        was not reported as a syntax error on line 3\n", describe(source).utf8().data());
+                    unterminatedResult = false;
+                }
+            }
+        }
+        test("tokens that end at the end of input", endOfInputResult);
+        test("tokens that run off the end of input", unterminatedResult);
+    }
+
+    vm = nullptr;
+
+    printf("LexerScanningTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "MegamorphicCacheTest.h"
+
+#include "APICast.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringConcatenate.h>
+
+using namespace JSC;
+
+// The get and put sites below see more structures than an inline cache can hold, so once they are
+// compiled they give up and call the generic operations, which use the VM's MegamorphicCache. The
+// objects include a frozen one, whose puts must not go through, and one with an accessor, which
+// must not be cached. Halfway through, one object has its property turned into an accessor and
+// another is frozen, so that their new structures have to miss the entries of their old ones.
+static const char* definitions =
+    "function getX(o) { return o.x; }\n"
+    "function getXAgain(o) { return o.x; }\n"
+    "function putX(o, value) { o.x = value; }\n"
+    "var accessorValue = 1000;\n"
+    "var objects = [];\n"
+    "for (var i = 0; i < shapeCount; ++i) { var o = {}; o['p' + i] = i; o.x = i; objects.push(o); }\n"
+    "var frozen = Object.freeze({ frozenOnly: true, x: 100 });\n"
+    "objects.push(frozen);\n"
+    "var accessor = { accessorOnly: true, get x() { return accessorValue; }, set x(value) { accessorValue = value + 10; } };\n"
+    "objects.push(accessor);\n"
+    "var sum = 0;\n"
+    "function run(iterations) {\n"
+    "    for (var iteration = 0; iteration < iterations; ++iteration) {\n"
+    "        for (var i = 0; i < objects.length; ++i) {\n"
+    "            var value = getX(objects[i]);\n"
+    "            sum += value + getXAgain(objects[i]);\n"
+    "            putX(objects[i], value + 1);\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "run(1000);\n"
+    "var laterAccessorValue = 0;\n"
+    "Object.defineProperty(objects[0], 'x', { get() { return laterAccessorValue; }, set(value) { laterAccessorValue = value + 5; } });\n"
+    "Object.freeze(objects[1]);\n"
+    "run(1000);\n";
+
+static const char* resultExpression =
+    "[sum, accessorValue, laterAccessorValue, objects.map((o) => getX(o)).join()].join('|')";
+
+static String evaluateToString(JSGlobalContextRef context, const String& source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source.utf8().data());
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (!result || exception)
+        return "exception";
+
+    ExecState* exec = toJS(context);
+    JSLockHolder locker(exec);
+    return toJS(exec, result).toWTFString(exec);
+}
+
+int testMegamorphicCache()
+{
+    bool overallResult = true;
+
+    printf("MegamorphicCacheTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    bool oldUseMegamorphicCache = Options::useMegamorphicCache();
+    String setup = makeString("var shapeCount = ", String::number(Options::maxAccessVariantListSize() + 4), ";\n", definitions);
+
+    struct Run {
+        String result;
+        bool canUseJIT;
+        bool usedCache;
+        bool frozenObjectsKeptTheirValues;
+    };
+
+    auto runWithMegamorphicCache = [&] (bool useMegamorphicCache) {
+        Options::useMegamorphicCache() = useMegamorphicCache;
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+        evaluateToString(context, setup);
+
+        Run run;
+        run.result = evaluateToString(context, resultExpression);
+        VM& vm = toJS(context)->vm();
+        run.canUseJIT = vm.canUseJIT();
+        run.usedCache = !!vm.megamorphicCache();
+        run.frozenObjectsKeptTheirValues = evaluateToString(context, "frozen.x === 100 && objects[1].x === 1001") == "true";
+
+        JSGlobalContextRelease(context);
+        return run;
+    };
+
+    Run withCache = runWithMegamorphicCache(true);
+    // The sites only give up on their inline caches once they are compiled.
+    if (withCache.canUseJIT)
+        test("sites that gave up on their inline caches use the megamorphic cache", withCache.usedCache);
+    test("puts to frozen objects are ignored with the megamorphic cache", withCache.frozenObjectsKeptTheirValues);
+
+    Run withoutCache = runWithMegamorphicCache(false);
+    test("the megamorphic cache is not used when it is disabled", !withoutCache.usedCache);
+    test("puts to frozen objects are ignored without the megamorphic cache", withoutCache.frozenObjectsKeptTheirValues);
+
+    bool sameResults = withCache.result == withoutCache.result && withCache.result != "exception";
+    if (!sameResults)
+        printf("        gave %s with the megamorphic cache rather than %s\n", withCache.result.utf8().data(), withoutCache.result.utf8().data());
+    test("gets and puts give the same results with and without the megamorphic cache", sameResults);
+
+    Options::useMegamorphicCache() = oldUseMegamorphicCache;
+
+    printf("MegamorphicCacheTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PipelinedModuleLoadingTest.h"
+
+#include "APICast.h"
+#include "CodeCache.h"
+#include "Completion.h"
+#include "JSCInlines.h"
+#include "JSInternalPromise.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "ParserWorklist.h"
+#include "VM.h"
+
+using namespace JSC;
+
+static bool loadAndEvaluate(ExecState* exec, const char* source, const char* url)
+{
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    JSInternalPromise* promise = loadAndEvaluateModule(exec, makeSource(source, SourceOrigin { url }, url, TextPosition(), SourceProviderSourceType::Module));
+    vm.drainMicrotasks();
+    return promise->status(vm) == JSPromise::Status::Fulfilled;
+}
+
+static double moduleResult(JSGlobalContextRef context)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString("moduleResult");
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+    return result ? JSValueToNumber(context, result, nullptr) : 0;
+}
+
+int testPipelinedModuleLoading()
+{
+    bool overallResult = true;
+
+    printf("PipelinedModuleLoadingTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    bool wasPipelined = Options::usePipelinedModuleLoading();
+    Options::usePipelinedModuleLoading() = true;
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+    ExecState* exec = toJS(context);
+    ParserWorklist& worklist = exec->vm().codeCache()->parserWorklist();
+
+    JSStringRef declaration = JSStringCreateWithUTF8CString("var moduleResult = 0;");
+    JSEvaluateScript(context, declaration, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(declaration);
+
+    // The helper thread analyzes the module and generates its bytecode from one parse, and the
+    // client takes both products, leaving nothing behind on the worklist.
+    bool loaded = loadAndEvaluate(exec,
+        "let squares = [1, 2, 3].map((x) => x * x);\n"
+        "export let total = squares.reduce((a, b) => a + b);\n"
+        "moduleResult = total;\n", "pipelined.js");
+    test("a pipelined module evaluates", loaded && moduleResult(context) == 14);
+    test("its record comes from a helper thread", worklist.numberOfModuleRecordsFromHelperThreads() == 1);
+    test("its bytecode comes from the same job", worklist.isEmpty());
+
+    // A module that fails to parse on the helper thread is parsed again by the client, which
+    // reports the error.
+    loaded = loadAndEvaluate(exec, "export let = 1;\n", "syntax-error.js");
+    test("a pipelined module with a syntax error is rejected", !loaded);
+    test("its record comes from the client", worklist.numberOfModuleRecordsFromHelperThreads() == 1);
+    test("its job is dropped", worklist.isEmpty());
+
+    Options::usePipelinedModuleLoading() = false;
+    loaded = loadAndEvaluate(exec, "export let total = 6 * 7;\nmoduleResult = total;\n", "not-pipelined.js");
+    test("a module that is not pipelined evaluates", loaded && moduleResult(context) == 42);
+    test("its record comes from the client", worklist.numberOfModuleRecordsFromHelperThreads() == 1);
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    Options::usePipelinedModuleLoading() = wasPipelined;
+
+    printf("PipelinedModuleLoadingTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "PrecompileScriptTest.h"
+
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include <wtf/text/StringBuilder.h>
+
+static const unsigned numberOfPrecompiledScripts = 8;
+
+static JSStringRef createPrecompiledScript(unsigned index)
+{
+    StringBuilder builder;
+    builder.appendLiteral("function sum(n) { var result = 0; for (var i = 0; i <= n; ++i) result += i; return result; }\n");
+    builder.appendLiteral("var squares = [1, 2, 3].map((x) => x * x);\n");
+    builder.appendLiteral("sum(");
+    builder.appendNumber(index);
+    builder.appendLiteral(") + squares.length;\n");
+    return JSStringCreateWithUTF8CString(builder.toString().utf8().data());
+}
+
+static bool evaluateAndCheck(JSGlobalContextRef context, JSStringRef script, JSStringRef sourceURL, double expectedResult)
+{
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, sourceURL, 1, &exception);
+    if (!result || exception)
+        return false;
+    return JSValueToNumber(context, result, nullptr) == expectedResult;
+}
+
+int testPrecompileScript()
+{
+    bool overallResult = true;
+
+    printf("PrecompileScriptTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+    JSStringRef sourceURL = JSStringCreateWithUTF8CString("precompiled.js");
+
+    JSStringRef scripts[numberOfPrecompiledScripts];
+    bool allQueued = true;
+    for (unsigned i = 0; i < numberOfPrecompiledScripts; ++i) {
+        scripts[i] = createPrecompiledScript(i);
+        allQueued &= JSContextGroupPrecompileScript(group, scripts[i], sourceURL, 1);
+    }
+    test("scripts are queued", allQueued);
+    test("a queued script is not queued again", !JSContextGroupPrecompileScript(group, scripts[0], sourceURL, 1));
+
+    bool allCorrect = true;
+    for (unsigned i = 0; i < numberOfPrecompiledScripts; ++i)
+        allCorrect &= evaluateAndCheck(context, scripts[i], sourceURL, i * (i + 1) / 2 + 3);
+    test("precompiled scripts compute the right results", allCorrect);
+    test("an evaluated script is not queued again", !JSContextGroupPrecompileScript(group, scripts[0], sourceURL, 1));
+
+    for (unsigned i = 0; i < numberOfPrecompiledScripts; ++i)
+        JSStringRelease(scripts[i]);
+
+    JSStringRef badScript = JSStringCreateWithUTF8CString("var x = ;");
+    test("a script with a syntax error is queued", JSContextGroupPrecompileScript(group, badScript, sourceURL, 1));
+    JSValueRef exception = nullptr;
+    JSEvaluateScript(context, badScript, nullptr, sourceURL, 1, &exception);
+    test("a precompiled script with a syntax error throws", exception && JSValueIsObject(context, exception));
+    JSStringRelease(badScript);
+
+    // Scripts that are never evaluated must not keep the group alive or leak their helper thread results.
+    JSStringRef unusedScript = createPrecompiledScript(numberOfPrecompiledScripts);
+    test("an unused script is queued", JSContextGroupPrecompileScript(group, unusedScript, sourceURL, 1));
+    JSStringRelease(unusedScript);
+
+    JSStringRelease(sourceURL);
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("PrecompileScriptTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
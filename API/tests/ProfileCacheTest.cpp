@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProfileCacheTest.h"
+
+#include "APICast.h"
+#include "CodeBlock.h"
+#include "FunctionCodeBlock.h"
+#include "FunctionExecutable.h"
+#include "JSCInlines.h"
+#include "JSFunction.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "ProfileCache.h"
+#include "VM.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <wtf/Vector.h>
+
+using namespace JSC;
+
+// Only profiled() runs in the first VM, so control() has no entry in the cache and shows what an
+// unseeded CodeBlock of the same shape looks like.
+static const char* definitions =
+    "function profiled(o) { return o.x + o.y; }\n"
+    "function control(o) { return o.y + o.x; }\n";
+
+static void evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+}
+
+static CodeBlock* codeBlockForFunction(JSGlobalContextRef context, const char* name)
+{
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    JSValue value = exec->lexicalGlobalObject()->get(exec, Identifier::fromString(exec, name));
+    JSFunction* function = jsDynamicCast<JSFunction*>(vm, value);
+    if (!function || function->isHostOrBuiltinFunction())
+        return nullptr;
+    CodeBlock* codeBlock = function->jsExecutable()->codeBlockFor(CodeForCall);
+    return codeBlock ? codeBlock->baselineAlternative() : nullptr;
+}
+
+static bool hasValueProfileWith(CodeBlock* codeBlock, SpeculatedType type)
+{
+    for (unsigned i = 0; i < codeBlock->numberOfValueProfiles(); ++i) {
+        if (codeBlock->valueProfile(i)->m_prediction & type)
+            return true;
+    }
+    return false;
+}
+
+static bool readFile(const char* path, Vector<uint8_t>& data)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    uint8_t buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)))
+        data.append(buffer, size);
+    fclose(file);
+    return !data.isEmpty();
+}
+
+static bool writeFile(const char* path, const uint8_t* data, size_t size)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+    bool result = fwrite(data, 1, size, file) == size;
+    return !fclose(file) && result;
+}
+
+template<typename T>
+static T readAt(const Vector<uint8_t>& data, size_t offset)
+{
+    T result;
+    memcpy(&result, data.data() + offset, sizeof(T));
+    return result;
+}
+
+// Walks the file format written by ProfileCache::encode() and returns the offset of the
+// instruction count of the entry for the given hash, or 0 if there is none.
+static size_t instructionCountOffsetForHash(const Vector<uint8_t>& data, unsigned hash)
+{
+    static const size_t headerSize = 4 * sizeof(uint32_t);
+    if (data.size() < headerSize)
+        return 0;
+
+    uint32_t entryCount = readAt<uint32_t>(data, headerSize - sizeof(uint32_t));
+    size_t offset = headerSize;
+    auto skipProfiles = [&] (size_t profileSize) {
+        uint32_t count = readAt<uint32_t>(data, offset);
+        offset += sizeof(uint32_t) + count * profileSize;
+    };
+    for (uint32_t i = 0; i < entryCount && offset + 9 <= data.size(); ++i) {
+        if (readAt<uint32_t>(data, offset) == hash)
+            return offset + sizeof(uint32_t);
+        offset += 2 * sizeof(uint32_t) + sizeof(uint8_t);
+        skipProfiles(sizeof(uint64_t)); // Argument predictions.
+        skipProfiles(sizeof(uint32_t) + sizeof(uint64_t)); // Value profiles.
+        skipProfiles(2 * sizeof(uint32_t) + sizeof(uint8_t)); // Array profiles.
+        skipProfiles(3 * sizeof(uint32_t)); // Arith profiles.
+    }
+    return 0;
+}
+
+int testProfileCache()
+{
+    bool overallResult = true;
+
+    printf("ProfileCacheTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    char path[] = "/tmp/JSCProfileCacheTest.XXXXXX";
+    int fileDescriptor = mkstemp(path);
+    if (fileDescriptor == -1) {
+        test("creating the cache file", false);
+        printf("ProfileCacheTest: FAIL\n");
+        return 1;
+    }
+    close(fileDescriptor);
+    unlink(path);
+
+    const char* oldProfileCachePath = Options::profileCachePath();
+    int32_t oldThresholdForOptimizeSoon = Options::thresholdForOptimizeSoon();
+    Options::profileCachePath() = path;
+    // The defaults make "soon" and "after warm-up" the same threshold.
+    Options::thresholdForOptimizeSoon() = Options::thresholdForOptimizeAfterWarmUp() / 10;
+
+    unsigned hash = 0;
+    {
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+        evaluate(context, definitions);
+        evaluate(context, "for (var i = 0; i < 1000; ++i) profiled({ x: 1.5, y: 2.5 });");
+
+        {
+            VM& vm = toJS(context)->vm();
+            JSLockHolder locker(vm);
+            CodeBlock* codeBlock = codeBlockForFunction(context, "profiled");
+            test("the first run has a profile cache", !!vm.profileCache());
+            test("the first run compiled profiled()", !!codeBlock);
+            if (codeBlock && vm.profileCache()) {
+                hash = codeBlock->hash().hash();
+                // Stand in for a DFG compile, which this test can't count on having.
+                codeBlock->unlinkedCodeBlock()->setDidOptimize(TrueTriState);
+                test("saving the profile cache succeeds", vm.profileCache()->write(vm));
+                test("saving the profile cache stores entries", !!vm.profileCache()->statistics().storedEntries);
+            }
+        }
+        JSGlobalContextRelease(context);
+    }
+
+    Vector<uint8_t> data;
+    test("the profile cache file was written", readFile(path, data));
+    size_t instructionCountOffset = instructionCountOffsetForHash(data, hash);
+    test("the profile cache file has an entry for profiled()", !!instructionCountOffset);
+
+    // Each run below starts from what the first run wrote, since every VM writes the file back
+    // when it is destroyed.
+    auto runWithCacheFile = [&] (const uint8_t* fileData, size_t fileSize, const auto& check) {
+        if (!writeFile(path, fileData, fileSize)) {
+            test("rewriting the profile cache file", false);
+            return;
+        }
+        JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+        evaluate(context, definitions);
+        // A string argument leaves profiles that differ from the first run's in every respect.
+        evaluate(context, "profiled(''); control('');");
+        {
+            VM& vm = toJS(context)->vm();
+            JSLockHolder locker(vm);
+            CodeBlock* profiledBlock = codeBlockForFunction(context, "profiled");
+            CodeBlock* controlBlock = codeBlockForFunction(context, "control");
+            if (vm.profileCache() && profiledBlock && controlBlock)
+                check(*vm.profileCache(), profiledBlock, controlBlock);
+            else
+                test("the run has a profile cache and CodeBlocks", false);
+        }
+        JSGlobalContextRelease(context);
+    };
+
+    runWithCacheFile(data.data(), data.size(), [&] (ProfileCache& cache, CodeBlock* profiled, CodeBlock* control) {
+        test("a fresh VM loads the saved entries", cache.statistics().loadedEntries && !cache.statistics().failures);
+        test("a fresh VM seeds profiled()", cache.statistics().seeds && !cache.statistics().mismatches);
+        test("seeded argument predictions are kept", !!(profiled->valueProfileForArgument(1)->m_prediction & SpecFinalObject));
+        test("unseeded argument predictions start empty", !(control->valueProfileForArgument(1)->m_prediction & SpecFinalObject));
+        test("seeded value predictions are kept", hasValueProfileWith(profiled, SpecBytecodeDouble));
+        test("unseeded value predictions start empty", !hasValueProfileWith(control, SpecBytecodeDouble));
+        test("the tier reached by the first run is kept", profiled->tierReachedInPreviousRun() >= JITCode::DFGJIT);
+        test("unseeded code has no previous tier", control->tierReachedInPreviousRun() == JITCode::None);
+#if ENABLE(DFG_JIT)
+        test("seeded code gets the threshold for optimizing soon",
+            profiled->jitExecuteCounter().m_activeThreshold < control->jitExecuteCounter().m_activeThreshold);
+#endif
+    });
+
+    if (instructionCountOffset) {
+        Vector<uint8_t> mismatched = data;
+        uint32_t instructionCount = readAt<uint32_t>(mismatched, instructionCountOffset) + 1;
+        memcpy(mismatched.data() + instructionCountOffset, &instructionCount, sizeof(instructionCount));
+        runWithCacheFile(mismatched.data(), mismatched.size(), [&] (ProfileCache& cache, CodeBlock* profiled, CodeBlock*) {
+            test("an entry with a different instruction count is rejected", cache.statistics().mismatches == 1);
+            test("a rejected entry does not seed predictions", !hasValueProfileWith(profiled, SpecBytecodeDouble));
+            test("a rejected entry does not seed the tier", profiled->tierReachedInPreviousRun() == JITCode::None);
+        });
+    }
+
+    runWithCacheFile(data.data(), data.size() / 2, [&] (ProfileCache& cache, CodeBlock* profiled, CodeBlock*) {
+        test("a truncated file is counted as a failure", cache.statistics().failures == 1);
+        test("a truncated file loads no entries", !cache.statistics().loadedEntries && !cache.statistics().seeds);
+        test("a truncated file does not seed the tier", profiled->tierReachedInPreviousRun() == JITCode::None);
+    });
+
+    unlink(path);
+    Options::profileCachePath() = oldProfileCachePath;
+    Options::thresholdForOptimizeSoon() = oldThresholdForOptimizeSoon;
+
+    printf("ProfileCacheTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StreamingJSONParserTest.h"
+
+#include "JSStreamingJSONParserPrivate.h"
+#include "JavaScript.h"
+#include <string.h>
+
+static const char* document = "{\"name\": \"caf\xC3\xA9 \xE2\x98\x83 \xF0\x9F\x98\x80\", \"escapes\": \"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\u2603\","
+    " \"numbers\": [0, -0, 12, -345, 6.75, 1e3, -2.5E-3, 123456789012], \"literals\": [true, false, null],"
+    " \"nested\": {\"1\": [], \"empty\": {}, \"deep\": [[[{\"x\": \"y\"}]]]}}";
+
+static JSStringRef stringify(JSContextRef context, JSValueRef value)
+{
+    if (!value)
+        return nullptr;
+    return JSValueCreateJSONString(context, value, 0, nullptr);
+}
+
+static bool isSameJSON(JSStringRef expected, JSContextRef context, JSValueRef value)
+{
+    JSStringRef actual = stringify(context, value);
+    if (!actual)
+        return false;
+    bool result = JSStringIsEqual(expected, actual);
+    JSStringRelease(actual);
+    return result;
+}
+
+static JSValueRef parseInPieces(JSContextRef context, const char* text, size_t pieceLength, JSStringRef* errorMessage)
+{
+    JSStreamingJSONParserRef parser = JSStreamingJSONParserCreate(context);
+    size_t length = strlen(text);
+    for (size_t offset = 0; offset < length; offset += pieceLength) {
+        size_t remaining = length - offset;
+        JSStreamingJSONParserAppendUTF8(parser, text + offset, remaining < pieceLength ? remaining : pieceLength);
+    }
+    JSValueRef result = JSStreamingJSONParserFinish(parser, errorMessage);
+    JSStreamingJSONParserRelease(parser);
+    return result;
+}
+
+int testStreamingJSONParser()
+{
+    bool overallResult = true;
+
+    printf("StreamingJSONParserTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    JSGlobalContextRef context = JSGlobalContextCreate(nullptr);
+
+    JSStringRef documentString = JSStringCreateWithUTF8CString(document);
+    JSStringRef expected = stringify(context, JSValueMakeFromJSONString(context, documentString));
+    test("JSON.parse accepts the document", !!expected);
+
+    bool allPieceLengthsMatch = true;
+    for (size_t pieceLength = 1; pieceLength <= 16; ++pieceLength)
+        allPieceLengthsMatch &= isSameJSON(expected, context, parseInPieces(context, document, pieceLength, nullptr));
+    test("UTF-8 pieces of any length give the same value as JSON.parse", allPieceLengthsMatch);
+
+    JSStreamingJSONParserRef parser = JSStreamingJSONParserCreate(context);
+    size_t length = JSStringGetLength(documentString);
+    const JSChar* characters = JSStringGetCharactersPtr(documentString);
+    bool allAppended = true;
+    for (size_t offset = 0; offset < length; offset += 7) {
+        JSStringRef piece = JSStringCreateWithCharacters(characters + offset, length - offset < 7 ? length - offset : 7);
+        allAppended &= JSStreamingJSONParserAppendString(parser, piece);
+        JSStringRelease(piece);
+    }
+    test("string pieces are accepted", allAppended);
+    test("string pieces give the same value as JSON.parse", isSameJSON(expected, context, JSStreamingJSONParserFinish(parser, nullptr)));
+    JSStreamingJSONParserRelease(parser);
+
+    test("a top-level number split across pieces is parsed", JSValueToNumber(context, parseInPieces(context, " 1234.5e1 ", 2, nullptr), nullptr) == 12345);
+
+    JSStringRef errorMessage = nullptr;
+    test("a malformed document is rejected", !parseInPieces(context, "{\"a\": [1, 2,]}", 3, &errorMessage));
+    test("a malformed document reports an error", errorMessage && JSStringGetLength(errorMessage));
+    if (errorMessage)
+        JSStringRelease(errorMessage);
+
+    test("an incomplete document is rejected", !parseInPieces(context, "{\"a\": [1, 2", 3, nullptr));
+    test("an unterminated string is rejected", !parseInPieces(context, "\"abc", 1, nullptr));
+    test("trailing tokens are rejected", !parseInPieces(context, "[] []", 1, nullptr));
+    test("invalid UTF-8 is rejected", !parseInPieces(context, "\"\xC3\x28\"", 1, nullptr));
+    test("non-strict JSON is rejected", !parseInPieces(context, "{a: 1}", 1, nullptr));
+
+    JSStringRelease(expected);
+    JSStringRelease(documentString);
+    JSGlobalContextRelease(context);
+
+    printf("StreamingJSONParserTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
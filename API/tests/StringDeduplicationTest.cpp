@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "StringDeduplicationTest.h"
+
+#include "APICast.h"
+#include "JSArray.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/HashSet.h>
+
+using namespace JSC;
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+// Array.prototype.join gives us resolved strings that are not atoms, each with its own StringImpl.
+static const char* definitions =
+    "function makeString(part) { return Array(11).join(part); }\n"
+    "var eightBit = [makeString('duplicate-'), makeString('duplicate-'), makeString('duplicate-')];\n"
+    "var sixteenBit = [makeString('\\u0101duplicate-'), makeString('\\u0101duplicate-'), makeString('\\u0101duplicate-')];\n"
+    "var unique = [makeString('unique-')];\n";
+
+static const char* contentsCheck =
+    "eightBit.every((string) => string === makeString('duplicate-'))"
+    " && sixteenBit.every((string) => string === makeString('\\u0101duplicate-'))"
+    " && unique[0] === makeString('unique-')"
+    " && eightBit[0].length === 100 && sixteenBit[0].charCodeAt(0) === 0x101";
+
+static bool evaluateToBoolean(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (!result || exception)
+        return false;
+    return JSValueToBoolean(context, result);
+}
+
+// Returns how many different StringImpls the strings in the named array use, or -1 if the array
+// could not be found or holds something other than resolved strings. Kept out of line so that no
+// pointer to the strings is left on the stack for the conservative scan to find, since the
+// deduplicator leaves those alone.
+static NEVER_INLINE int numberOfStringImpls(JSGlobalContextRef context, const char* name)
+{
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    JSValue value = exec->lexicalGlobalObject()->get(exec, Identifier::fromString(exec, name));
+    JSArray* array = jsDynamicCast<JSArray*>(vm, value);
+    if (!array)
+        return -1;
+
+    HashSet<const StringImpl*> impls;
+    for (unsigned i = 0; i < array->length(); ++i) {
+        JSValue element = array->getIndex(exec, i);
+        if (!element.isString())
+            return -1;
+        const StringImpl* impl = asString(element)->tryGetValueImpl();
+        if (!impl)
+            return -1;
+        impls.add(impl);
+    }
+    return impls.size();
+}
+
+int testStringDeduplication()
+{
+    bool overallResult = true;
+
+    printf("StringDeduplicationTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    bool oldUseStringDeduplication = Options::useStringDeduplication();
+    Options::useStringDeduplication() = true;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    evaluateToBoolean(context, definitions);
+
+    test("each string starts with its own StringImpl", numberOfStringImpls(context, "eightBit") == 3 && numberOfStringImpls(context, "sixteenBit") == 3);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("a full collection makes duplicate 8-bit strings share a StringImpl", numberOfStringImpls(context, "eightBit") == 1);
+    test("a full collection makes duplicate 16-bit strings share a StringImpl", numberOfStringImpls(context, "sixteenBit") == 1);
+    test("strings keep their contents after deduplication", evaluateToBoolean(context, contentsCheck));
+
+    // The second collection frees the StringImpls that the first one replaced.
+    JSSynchronousGarbageCollectForDebugging(context);
+    JSSynchronousGarbageCollectForDebugging(context);
+    test("strings still share a StringImpl after more collections", numberOfStringImpls(context, "eightBit") == 1 && numberOfStringImpls(context, "sixteenBit") == 1);
+    test("strings keep their contents after the replaced StringImpls are freed", evaluateToBoolean(context, contentsCheck));
+
+    JSGlobalContextRelease(context);
+
+    Options::useStringDeduplication() = oldUseStringDeduplication;
+
+    printf("StringDeduplicationTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
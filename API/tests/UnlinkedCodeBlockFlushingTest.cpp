@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "UnlinkedCodeBlockFlushingTest.h"
+
+#include "APICast.h"
+#include "FunctionExecutable.h"
+#include "JSCInlines.h"
+#include "JSFunction.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "UnlinkedFunctionExecutable.h"
+
+using namespace JSC;
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+static const char* definitions =
+    "var captured = 10;\n"
+    "function add(a, b = 2) { return a + b + captured; }\n"
+    "function Point(x, y) { this.x = x; this.y = y; }\n"
+    "Point.prototype.sum = function() { return this.x + this.y; };\n"
+    "function either(x) { if (new.target) { this.x = x * 2; return; } return x * 3; }\n"
+    "class Base { constructor(value) { this.value = value; } }\n"
+    "class Derived extends Base { constructor(value) { super(value + 1); } get doubled() { return this.value * 2; } }\n"
+    "function makeCounter() { var count = 0; return function() { return ++count; }; }\n"
+    "var counter = makeCounter();\n"
+    "function* range(n) { for (var i = 0; i < n; ++i) yield i; }\n";
+
+// Each check runs both before and after the bytecode is flushed, and must give the same answer.
+static const char* checks[] = {
+    "add(1)",
+    "add(1, 5)",
+    "new Point(3, 4).sum()",
+    "new Point(3, 4) instanceof Point",
+    "either(2)",
+    "new either(2).x",
+    "new Derived(4).value",
+    "new Derived(4).doubled",
+    "new Derived(4) instanceof Base",
+    "[...range(4)].join()",
+    "typeof counter()",
+};
+
+static String evaluateToString(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (!result || exception)
+        return "exception";
+
+    ExecState* exec = toJS(context);
+    JSLockHolder locker(exec);
+    return toJS(exec, result).toWTFString(exec);
+}
+
+static UnlinkedFunctionExecutable* unlinkedExecutableFor(JSGlobalContextRef context, const char* name)
+{
+    ExecState* exec = toJS(context);
+    VM& vm = exec->vm();
+    JSLockHolder locker(vm);
+    JSValue value = exec->lexicalGlobalObject()->get(exec, Identifier::fromString(exec, name));
+    JSFunction* function = jsDynamicCast<JSFunction*>(vm, value);
+    if (!function || function->isHostOrBuiltinFunction())
+        return nullptr;
+    return function->jsExecutable()->unlinkedExecutable();
+}
+
+// Kept out of line so that no pointer to a code block is left on the stack for the conservative
+// scan to find.
+static NEVER_INLINE Vector<String> runChecks(JSGlobalContextRef context)
+{
+    Vector<String> results;
+    for (const char* check : checks)
+        results.append(evaluateToString(context, check));
+    return results;
+}
+
+static const int numberOfWatchedCodeBlocks = 4;
+
+// Returns how many of the code blocks that the checks use are still around, or -1 if the
+// functions could not be found.
+static NEVER_INLINE int numberOfUnlinkedCodeBlocks(JSGlobalContextRef context)
+{
+    UnlinkedFunctionExecutable* add = unlinkedExecutableFor(context, "add");
+    UnlinkedFunctionExecutable* point = unlinkedExecutableFor(context, "Point");
+    UnlinkedFunctionExecutable* either = unlinkedExecutableFor(context, "either");
+    if (!add || !point || !either)
+        return -1;
+    return add->hasUnlinkedCodeBlockFor(CodeForCall)
+        + point->hasUnlinkedCodeBlockFor(CodeForConstruct)
+        + either->hasUnlinkedCodeBlockFor(CodeForCall)
+        + either->hasUnlinkedCodeBlockFor(CodeForConstruct);
+}
+
+int testUnlinkedCodeBlockFlushing()
+{
+    bool overallResult = true;
+
+    printf("UnlinkedCodeBlockFlushingTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    bool oldUseUnlinkedCodeBlockFlushing = Options::useUnlinkedCodeBlockFlushing();
+    bool oldForceCodeBlockToJettisonDueToOldAge = Options::forceCodeBlockToJettisonDueToOldAge();
+    Options::useUnlinkedCodeBlockFlushing() = true;
+    // Jettisons every CodeBlock that is not running, so that nothing resets the age of the
+    // unlinked code blocks it was linked from.
+    Options::forceCodeBlockToJettisonDueToOldAge() = true;
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    evaluateToString(context, definitions);
+
+    Vector<String> expected = runChecks(context);
+    test("the functions have bytecode after running", numberOfUnlinkedCodeBlocks(context) == numberOfWatchedCodeBlocks);
+
+    // An unlinked code block stays marked while its age is at most the maximum, so it takes one
+    // more collection than that for it to be dropped.
+    for (unsigned i = 0; i < Options::maximumUnlinkedCodeBlockAge() + 2; ++i)
+        JSSynchronousGarbageCollectForDebugging(context);
+    test("cold bytecode is flushed", !numberOfUnlinkedCodeBlocks(context));
+
+    Vector<String> flushed = runChecks(context);
+    bool sameResults = true;
+    for (unsigned i = 0; i < WTF_ARRAY_LENGTH(checks); ++i) {
+        if (flushed[i] == expected[i])
+            continue;
+        printf("        %s gave %s rather than %s\n", checks[i], flushed[i].utf8().data(), expected[i].utf8().data());
+        sameResults = false;
+    }
+    test("calls and constructs give the same results after a flush", sameResults);
+    // The counter ran once in each round of checks.
+    test("closures keep their state across a flush", evaluateToString(context, "counter()") == "3");
+    test("the functions have bytecode again after running", numberOfUnlinkedCodeBlocks(context) == numberOfWatchedCodeBlocks);
+
+    JSGlobalContextRelease(context);
+
+    Options::useUnlinkedCodeBlockFlushing() = oldUseUnlinkedCodeBlockFlushing;
+    Options::forceCodeBlockToJettisonDueToOldAge() = oldForceCodeBlockToJettisonDueToOldAge;
+
+    printf("UnlinkedCodeBlockFlushingTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WeakMapEphemeronTest.h"
+
+#include "JavaScript.h"
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+static const unsigned numberOfCycles = 1000;
+static const unsigned chainLength = 100;
+
+static unsigned numberOfFinalizedCycleKeys;
+static unsigned numberOfFinalizedChainKeys;
+
+static void finalizeCycleKey(JSObjectRef)
+{
+    numberOfFinalizedCycleKeys++;
+}
+
+static void finalizeChainKey(JSObjectRef)
+{
+    numberOfFinalizedChainKeys++;
+}
+
+static JSClassRef createKeyClass(JSObjectFinalizeCallback finalize)
+{
+    JSClassDefinition definition = kJSClassDefinitionEmpty;
+    definition.finalize = finalize;
+    return JSClassCreate(&definition);
+}
+
+static JSObjectRef evaluateFunction(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+    return result ? JSValueToObject(context, result, nullptr) : nullptr;
+}
+
+// Kept out of line so that no key is left on the stack for the conservative scan to find.
+static NEVER_INLINE void addCycles(JSGlobalContextRef context, JSObjectRef addCycle, JSClassRef keyClass)
+{
+    for (unsigned i = 0; i < numberOfCycles; ++i) {
+        JSValueRef key = JSObjectMake(context, keyClass, nullptr);
+        JSObjectCallAsFunction(context, addCycle, nullptr, 1, &key, nullptr);
+    }
+}
+
+static NEVER_INLINE void addChain(JSGlobalContextRef context, JSObjectRef addChainLink, JSClassRef keyClass)
+{
+    for (unsigned i = 0; i < chainLength; ++i) {
+        JSValueRef key = JSObjectMake(context, keyClass, nullptr);
+        JSObjectCallAsFunction(context, addChainLink, nullptr, 1, &key, nullptr);
+    }
+}
+
+int testWeakMapEphemerons()
+{
+    bool overallResult = true;
+
+    printf("WeakMapEphemeronTest:\n");
+
+    auto test = [&] (const char* description, bool currentResult) {
+        printf("    %s: %s\n", description, currentResult ? "PASS" : "FAIL");
+        overallResult &= currentResult;
+    };
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSClassRef cycleKeyClass = createKeyClass(finalizeCycleKey);
+    JSClassRef chainKeyClass = createKeyClass(finalizeChainKey);
+
+    JSStringRef setup = JSStringCreateWithUTF8CString(
+        "var map = new WeakMap();\n"
+        "var chainHead = null;\n"
+        "var chainTail = null;\n");
+    JSEvaluateScript(context, setup, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(setup);
+
+    // Each value holds its own key, so the map is the only thing keeping either of them alive.
+    JSObjectRef addCycle = evaluateFunction(context, "(function (key) { map.set(key, { key: key }); })");
+    // Only the first key is held by the global object. Each value holds the next key, which is
+    // reachable only once the previous entry's value has been visited.
+    JSObjectRef addChainLink = evaluateFunction(context,
+        "(function (key) {\n"
+        "    if (!chainHead) chainHead = key; else map.set(chainTail, { next: key });\n"
+        "    chainTail = key;\n"
+        "    map.set(key, { next: null });\n"
+        "})");
+    JSObjectRef checkChain = evaluateFunction(context,
+        "(function () {\n"
+        "    var length = 0;\n"
+        "    for (var key = chainHead; key; key = map.get(key).next)\n"
+        "        length++;\n"
+        "    return length;\n"
+        "})");
+    JSValueProtect(context, addCycle);
+    JSValueProtect(context, addChainLink);
+    JSValueProtect(context, checkChain);
+
+    addCycles(context, addCycle, cycleKeyClass);
+    addChain(context, addChainLink, chainKeyClass);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+
+    // The conservative scan may still find a few of the keys.
+    test("entries whose values hold their own keys are collected", numberOfFinalizedCycleKeys >= numberOfCycles * 9 / 10);
+    test("a chain of entries reachable from a live key survives", !numberOfFinalizedChainKeys);
+    JSValueRef length = JSObjectCallAsFunction(context, checkChain, nullptr, 0, nullptr, nullptr);
+    test("every value in the chain is still in the map", length && JSValueToNumber(context, length, nullptr) == chainLength);
+
+    JSValueUnprotect(context, addCycle);
+    JSValueUnprotect(context, addChainLink);
+    JSValueUnprotect(context, checkChain);
+    JSGlobalContextRelease(context);
+    JSClassRelease(cycleKeyClass);
+    JSClassRelease(chainKeyClass);
+
+    printf("WeakMapEphemeronTest: %s\n", overallResult ? "PASS" : "FAIL");
+    return !overallResult;
+}
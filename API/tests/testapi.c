@@ -51,16 +51,32 @@
 #include <windows.h>
 #endif
 
+#include "BlockScavengerTest.h"
+#include "BytecodeCacheTest.h"
 #include "CompareAndSwapTest.h"
+#include "ConcurrentArrayGrowthTest.h"
 #include "CustomGlobalObjectClassTest.h"
 #include "ExecutionTimeLimitTest.h"
 #include "FunctionOverridesTest.h"
+#include "GarbageCollectionEventsTest.h"
 #include "GlobalContextWithFinalizerTest.h"
+#include "HeapLimitsTest.h"
+#include "HeapSnapshotWriterTest.h"
 #include "JSONParseTest.h"
+#include "JSONStringifyTest.h"
 #include "JSObjectGetProxyTargetTest.h"
+#include "LexerScanningTest.h"
+#include "MegamorphicCacheTest.h"
 #include "MultithreadedMultiVMExecutionTest.h"
 #include "PingPongStackOverflowTest.h"
+#include "PipelinedModuleLoadingTest.h"
+#include "PrecompileScriptTest.h"
+#include "ProfileCacheTest.h"
+#include "StreamingJSONParserTest.h"
+#include "StringDeduplicationTest.h"
 #include "TypedArrayCTest.h"
+#include "UnlinkedCodeBlockFlushingTest.h"
+#include "WeakMapEphemeronTest.h"
 
 #if JSC_OBJC_API_ENABLED
 void testObjectiveCAPI(void);
@@ -2040,6 +2056,22 @@ int main(int argc, char* argv[])
     failed = testPingPongStackOverflow() || failed;
     failed = testJSONParse() || failed;
     failed = testJSObjectGetProxyTarget() || failed;
+    failed = testBytecodeCache() || failed;
+    failed = testPrecompileScript() || failed;
+    failed = testPipelinedModuleLoading() || failed;
+    failed = testStreamingJSONParser() || failed;
+    failed = testGarbageCollectionEvents() || failed;
+    failed = testHeapLimits() || failed;
+    failed = testHeapSnapshotWriter() || failed;
+    failed = testBlockScavenger() || failed;
+    failed = testConcurrentArrayGrowth() || failed;
+    failed = testWeakMapEphemerons() || failed;
+    failed = testProfileCache() || failed;
+    failed = testLexerScanning() || failed;
+    failed = testUnlinkedCodeBlockFlushing() || failed;
+    failed = testJSONStringify() || failed;
+    failed = testStringDeduplication() || failed;
+    failed = testMegamorphicCache() || failed;
 
     // Clear out local variables pointing at JSObjectRefs to allow their values to be collected
     function = NULL;
@@ -59,7 +59,16 @@ LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithDisassembly(const char* format,
 {
     CodeRef result = finalizeCodeWithoutDisassembly();
 
-    if (m_alreadyDisassembled)
+    if (PerfLog::isEnabled()) {
+        StringPrintStream name;
+        va_list argList;
+        va_start(argList, format);
+        name.vprintf(format, argList);
+        va_end(argList);
+        PerfLog::log(name.toCString(), result.code().executableAddress(), result.size(), m_codeBlockForPerfLog);
+    }
+
+    if (!m_shouldDumpDisassembly || m_alreadyDisassembled)
         return result;
     
     StringPrintStream out;
@@ -36,6 +36,7 @@
 
 #include "JITCompilationEffort.h"
 #include "MacroAssembler.h"
+#include "PerfLog.h"
 #include <wtf/DataLog.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/Noncopyable.h>
@@ -250,6 +251,19 @@ public:
     bool wasAlreadyDisassembled() const { return m_alreadyDisassembled; }
     void didAlreadyDisassemble() { m_alreadyDisassembled = true; }
 
+    // finalizeCodeWithDisassembly() also runs when only the PerfLog wants the code's name.
+    LinkBuffer& setShouldDumpDisassembly(bool shouldDumpDisassembly)
+    {
+        m_shouldDumpDisassembly = shouldDumpDisassembly;
+        return *this;
+    }
+    
+    LinkBuffer& setCodeBlockForPerfLog(CodeBlock* codeBlock)
+    {
+        m_codeBlockForPerfLog = codeBlock;
+        return *this;
+    }
+
 private:
 #if ENABLE(BRANCH_COMPACTION)
     int executableOffsetFor(int location)
@@ -304,18 +318,20 @@ private:
     bool m_completed;
 #endif
     bool m_alreadyDisassembled { false };
+    bool m_shouldDumpDisassembly { true };
+    CodeBlock* m_codeBlockForPerfLog { nullptr };
     Vector<RefPtr<SharedTask<void(LinkBuffer&)>>> m_linkTasks;
 };
 
 #define FINALIZE_CODE_IF(condition, linkBufferReference, dataLogFArgumentsForHeading)  \
-    (UNLIKELY((condition))                                              \
-     ? ((linkBufferReference).finalizeCodeWithDisassembly dataLogFArgumentsForHeading) \
+    (UNLIKELY((condition) || JSC::PerfLog::isEnabled())                 \
+     ? ((linkBufferReference).setShouldDumpDisassembly(condition).finalizeCodeWithDisassembly dataLogFArgumentsForHeading) \
      : (linkBufferReference).finalizeCodeWithoutDisassembly())
 
 bool shouldDumpDisassemblyFor(CodeBlock*);
 
 #define FINALIZE_CODE_FOR(codeBlock, linkBufferReference, dataLogFArgumentsForHeading)  \
-    FINALIZE_CODE_IF(shouldDumpDisassemblyFor(codeBlock) || Options::asyncDisassembly(), linkBufferReference, dataLogFArgumentsForHeading)
+    FINALIZE_CODE_IF(shouldDumpDisassemblyFor(codeBlock) || Options::asyncDisassembly(), (linkBufferReference).setCodeBlockForPerfLog(codeBlock), dataLogFArgumentsForHeading)
 
 // Use this to finalize code, like so:
 //
@@ -331,7 +347,8 @@ bool shouldDumpDisassemblyFor(CodeBlock*);
 // ... and so on.
 //
 // Note that the dataLogFArgumentsForHeading are only evaluated when dumpDisassembly
-// is true, so you can hide expensive disassembly-only computations inside there.
+// or the PerfLog is enabled, so you can hide expensive disassembly-only computations
+// inside there.
 
 #define FINALIZE_CODE(linkBufferReference, dataLogFArgumentsForHeading)  \
     FINALIZE_CODE_IF(JSC::Options::asyncDisassembly() || JSC::Options::dumpDisassembly(), linkBufferReference, dataLogFArgumentsForHeading)
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PerfLog.h"
+
+#if ENABLE(ASSEMBLER)
+
+#include "CodeBlock.h"
+#include "JSCInlines.h"
+#include <wtf/NeverDestroyed.h>
+#include <wtf/StringPrintStream.h>
+
+#if OS(LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+#if OS(LINUX)
+
+namespace JITDump {
+
+// See tools/perf/Documentation/jitdump-specification.txt in the Linux sources.
+static const uint32_t magic = 0x4A695444;
+static const uint32_t version = 1;
+
+enum RecordType : uint32_t {
+    CodeLoad = 0,
+    CodeDebugInfo = 2,
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMachine;
+    uint32_t padding;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+
+struct RecordHeader {
+    uint32_t type;
+    uint32_t totalSize;
+    uint64_t timestamp;
+};
+
+// Followed by the null terminated name and the code bytes.
+struct CodeLoadRecord {
+    RecordHeader header;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddress;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+};
+
+// Followed by the entries.
+struct CodeDebugInfoRecord {
+    RecordHeader header;
+    uint64_t codeAddress;
+    uint64_t numberOfEntries;
+};
+
+// Followed by the null terminated file name.
+struct DebugEntry {
+    uint64_t codeAddress;
+    int32_t line;
+    int32_t discriminator;
+};
+
+static uint32_t elfMachine()
+{
+#if CPU(X86_64)
+    return 62; // EM_X86_64
+#elif CPU(X86)
+    return 3; // EM_386
+#elif CPU(ARM64)
+    return 183; // EM_AARCH64
+#elif CPU(ARM)
+    return 40; // EM_ARM
+#elif CPU(MIPS)
+    return 8; // EM_MIPS
+#else
+    return 0;
+#endif
+}
+
+// perf record has to be run with "-k mono" for these to line up with its own samples.
+static uint64_t timestamp()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+} // namespace JITDump
+
+PerfLog::PerfLog()
+{
+    if (Options::logJITCodeForPerf()) {
+        CString path = toCString("/tmp/perf-", getpid(), ".map");
+        m_mapFile = fopen(path.data(), "w");
+        if (!m_mapFile)
+            dataLog("Could not open ", path, " for writing JIT code addresses.\n");
+    }
+    
+    if (Options::dumpJITCodeForPerf()) {
+        CString path = toCString("/tmp/jit-", getpid(), ".dump");
+        m_jitDumpFD = open(path.data(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+        if (m_jitDumpFD < 0) {
+            dataLog("Could not open ", path, " for writing JIT code.\n");
+            return;
+        }
+        
+        // perf finds the file through this mapping, which shows up in its record of the process's
+        // executable mappings.
+        void* marker = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, m_jitDumpFD, 0);
+        if (marker == MAP_FAILED) {
+            dataLog("Could not map ", path, ", perf will not find it.\n");
+            close(m_jitDumpFD);
+            m_jitDumpFD = -1;
+            return;
+        }
+        
+        JITDump::FileHeader header;
+        header.magic = JITDump::magic;
+        header.version = JITDump::version;
+        header.totalSize = sizeof(header);
+        header.elfMachine = JITDump::elfMachine();
+        header.padding = 0;
+        header.pid = getpid();
+        header.timestamp = JITDump::timestamp();
+        header.flags = 0;
+        write(&header, sizeof(header));
+    }
+}
+
+PerfLog& PerfLog::singleton()
+{
+    static LazyNeverDestroyed<PerfLog> perfLog;
+    static std::once_flag onceKey;
+    std::call_once(onceKey, [] {
+        perfLog.construct();
+    });
+    return perfLog;
+}
+
+void PerfLog::log(const CString& name, const void* executableAddress, size_t size, CodeBlock* codeBlock)
+{
+    PerfLog& perfLog = singleton();
+    auto locker = holdLock(perfLog.m_lock);
+    if (perfLog.m_mapFile)
+        perfLog.writeMapEntry(name, executableAddress, size);
+    if (perfLog.m_jitDumpFD >= 0)
+        perfLog.writeJITDumpRecords(name, executableAddress, size, codeBlock);
+}
+
+void PerfLog::writeMapEntry(const CString& name, const void* executableAddress, size_t size)
+{
+    fprintf(m_mapFile, "%" PRIxPTR " %zx %s\n", reinterpret_cast<uintptr_t>(executableAddress), size, name.data());
+    fflush(m_mapFile);
+}
+
+void PerfLog::writeJITDumpRecords(const CString& name, const void* executableAddress, size_t size, CodeBlock* codeBlock)
+{
+    uint64_t timestamp = JITDump::timestamp();
+    uint64_t codeAddress = reinterpret_cast<uintptr_t>(executableAddress);
+    
+    // The debug info has to come before the code it describes.
+    if (codeBlock) {
+        ScriptExecutable* executable = codeBlock->ownerScriptExecutable();
+        CString sourceURL = executable->sourceURL().utf8();
+        if (sourceURL.length()) {
+            JITDump::CodeDebugInfoRecord record;
+            record.header.type = JITDump::CodeDebugInfo;
+            record.header.totalSize = sizeof(record) + sizeof(JITDump::DebugEntry) + sourceURL.length() + 1;
+            record.header.timestamp = timestamp;
+            record.codeAddress = codeAddress;
+            record.numberOfEntries = 1;
+            
+            JITDump::DebugEntry entry;
+            entry.codeAddress = codeAddress;
+            entry.line = executable->firstLine();
+            entry.discriminator = 0;
+            
+            write(&record, sizeof(record));
+            write(&entry, sizeof(entry));
+            write(sourceURL.data(), sourceURL.length() + 1);
+        }
+    }
+    
+    JITDump::CodeLoadRecord record;
+    record.header.type = JITDump::CodeLoad;
+    record.header.totalSize = sizeof(record) + name.length() + 1 + size;
+    record.header.timestamp = timestamp;
+    record.pid = getpid();
+    record.tid = syscall(__NR_gettid);
+    record.vma = codeAddress;
+    record.codeAddress = codeAddress;
+    record.codeSize = size;
+    record.codeIndex = m_codeIndex++;
+    
+    write(&record, sizeof(record));
+    write(name.data(), name.length() + 1);
+    write(executableAddress, size);
+}
+
+void PerfLog::write(const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size) {
+        ssize_t result = ::write(m_jitDumpFD, bytes, size);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            dataLog("Could not write to the jitdump file, closing it.\n");
+            close(m_jitDumpFD);
+            m_jitDumpFD = -1;
+            return;
+        }
+        bytes += result;
+        size -= result;
+    }
+}
+
+#else // OS(LINUX)
+
+PerfLog::PerfLog()
+{
+}
+
+void PerfLog::log(const CString&, const void*, size_t, CodeBlock*)
+{
+}
+
+#endif // OS(LINUX)
+
+} // namespace JSC
+
+#endif // ENABLE(ASSEMBLER)
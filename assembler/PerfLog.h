@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(ASSEMBLER)
+
+#include "Options.h"
+#include <stdio.h>
+#include <wtf/Lock.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class CodeBlock;
+
+// Tells Linux perf about the code we generate, so that system-wide profiles can name it. Every
+// piece of code that LinkBuffer finalizes with a name, from thunks and inline cache stubs to
+// baseline, DFG, FTL, Yarr and WebAssembly code, gets a line in /tmp/perf-<pid>.map when
+// logJITCodeForPerf is set. With dumpJITCodeForPerf it also gets a load record in
+// /tmp/jit-<pid>.dump, the jitdump format that "perf inject --jit" reads, which carries a copy of
+// the code bytes so that perf can annotate it. Code that belongs to a CodeBlock gets a debug info
+// record pointing at the source of the CodeBlock's function.
+//
+// Neither format can say that code was freed. jitdump orders records by time, so when the
+// ExecutableAllocator hands freed memory out again, the newer load record wins.
+class PerfLog {
+    WTF_MAKE_NONCOPYABLE(PerfLog);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static bool isEnabled() { return Options::logJITCodeForPerf() || Options::dumpJITCodeForPerf(); }
+    
+    // This may be called from any thread that finalizes code.
+    static void log(const CString& name, const void* executableAddress, size_t size, CodeBlock* = nullptr);
+    
+private:
+    PerfLog();
+    
+    static PerfLog& singleton();
+    
+    void writeMapEntry(const CString& name, const void* executableAddress, size_t size);
+    void writeJITDumpRecords(const CString& name, const void* executableAddress, size_t size, CodeBlock*);
+    void write(const void*, size_t);
+    
+    Lock m_lock;
+    FILE* m_mapFile { nullptr };
+    int m_jitDumpFD { -1 };
+    uint64_t m_codeIndex { 0 };
+};
+
+} // namespace JSC
+
+#endif // ENABLE(ASSEMBLER)
@@ -41,7 +41,7 @@ void demoteValues(Procedure&, const IndexSet<Value*>&);
 
 // This fixes SSA for you. Use this after you have done demoteValues() and you have performed
 // whatever evil transformation you needed.
-bool fixSSA(Procedure&);
+JS_EXPORT_PRIVATE bool fixSSA(Procedure&);
 
 } } // namespace JSC::B3
 
@@ -36,6 +36,7 @@
 #include "B3EliminateCommonSubexpressions.h"
 #include "B3FixSSA.h"
 #include "B3FoldPathConstants.h"
+#include "B3HoistLoopInvariantValues.h"
 #include "B3InferSwitches.h"
 #include "B3LegalizeMemoryOffsets.h"
 #include "B3LowerMacros.h"
@@ -47,6 +48,7 @@
 #include "B3ReduceDoubleToFloat.h"
 #include "B3ReduceStrength.h"
 #include "B3TimingScope.h"
+#include "B3UnrollLoops.h"
 #include "B3Validate.h"
 #include "PCToCodeOriginMap.h"
 
@@ -84,7 +86,11 @@ void generateToAir(Procedure& procedure)
         reduceDoubleToFloat(procedure);
         reduceStrength(procedure);
         eliminateCommonSubexpressions(procedure);
+        if (Options::useB3LoopInvariantCodeMotion())
+            hoistLoopInvariantValues(procedure);
         inferSwitches(procedure);
+        if (Options::useB3LoopUnrolling())
+            unrollLoops(procedure);
         duplicateTails(procedure);
         fixSSA(procedure);
         foldPathConstants(procedure);
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "B3HoistLoopInvariantValues.h"
+
+#if ENABLE(B3_JIT)
+
+#include "B3BasicBlockInlines.h"
+#include "B3BlockInsertionSet.h"
+#include "B3Dominators.h"
+#include "B3InsertionSetInlines.h"
+#include "B3NaturalLoops.h"
+#include "B3PhaseScope.h"
+#include "B3ProcedureInlines.h"
+#include "B3ValueInlines.h"
+#include <wtf/IndexSet.h>
+#include <wtf/RangeSet.h>
+
+namespace JSC { namespace B3 {
+
+namespace {
+
+const bool verbose = false;
+
+class HoistLoopInvariantValues {
+public:
+    HoistLoopInvariantValues(Procedure& proc)
+        : m_proc(proc)
+        , m_insertionSet(proc)
+    {
+    }
+
+    bool run()
+    {
+        if (!createPreHeaders()) {
+            if (verbose)
+                dataLog("No loops to hoist out of.\n");
+            return false;
+        }
+
+        m_proc.resetValueOwners();
+
+        NaturalLoops& loops = m_proc.naturalLoops();
+        
+        // Visit inner loops first. Anything we hoist out of an inner loop lands in its pre-header,
+        // which belongs to the enclosing loop, so it gets another chance to be hoisted from there.
+        Vector<const NaturalLoop*> loopsInnerMostFirst;
+        for (unsigned loopIndex = loops.numLoops(); loopIndex--;)
+            loopsInnerMostFirst.append(&loops.loop(loopIndex));
+        std::sort(
+            loopsInnerMostFirst.begin(), loopsInnerMostFirst.end(),
+            [&] (const NaturalLoop* a, const NaturalLoop* b) -> bool {
+                return a->size() < b->size();
+            });
+
+        bool changed = false;
+        for (const NaturalLoop* loop : loopsInnerMostFirst)
+            changed |= hoist(*loop);
+        return changed;
+    }
+    
+private:
+    BasicBlock* preHeaderOf(const NaturalLoop& loop)
+    {
+        BasicBlock* result = nullptr;
+        for (BasicBlock* predecessor : loop.header()->predecessors()) {
+            if (m_proc.naturalLoops().belongsTo(predecessor, loop))
+                continue;
+            if (result)
+                return nullptr;
+            result = predecessor;
+        }
+        if (!result || result->numSuccessors() != 1)
+            return nullptr;
+        ASSERT(result->successorBlock(0) == loop.header());
+        return result;
+    }
+
+    // Makes sure that every loop header has exactly one predecessor from outside the loop, and that
+    // this predecessor just jumps to the header. Returns false if there are no loops.
+    bool createPreHeaders()
+    {
+        NaturalLoops& loops = m_proc.naturalLoops();
+        if (!loops.numLoops())
+            return false;
+
+        BlockInsertionSet blockInsertionSet(m_proc);
+        for (unsigned loopIndex = loops.numLoops(); loopIndex--;) {
+            const NaturalLoop& loop = loops.loop(loopIndex);
+            BasicBlock* header = loop.header();
+            if (preHeaderOf(loop))
+                continue;
+
+            Vector<BasicBlock*, 4> outsidePredecessors;
+            double frequency = 0;
+            for (BasicBlock* predecessor : header->predecessors()) {
+                if (loops.belongsTo(predecessor, loop) || outsidePredecessors.contains(predecessor))
+                    continue;
+                outsidePredecessors.append(predecessor);
+                frequency += predecessor->frequency();
+            }
+
+            // A loop with no way in is one whose header is the root. There is nowhere to hoist to.
+            if (outsidePredecessors.isEmpty())
+                continue;
+
+            BasicBlock* preHeader = blockInsertionSet.insertBefore(header, frequency);
+            preHeader->appendNew<Value>(m_proc, Jump, header->at(0)->origin());
+            preHeader->setSuccessors(FrequentedBlock(header));
+
+            for (BasicBlock* predecessor : outsidePredecessors) {
+                for (BasicBlock*& successor : predecessor->successorBlocks()) {
+                    if (successor == header)
+                        successor = preHeader;
+                }
+            }
+
+            if (verbose)
+                dataLog("Created pre-header ", *preHeader, " for ", loop, "\n");
+        }
+
+        if (blockInsertionSet.execute()) {
+            m_proc.resetReachability();
+            m_proc.invalidateCFG();
+        }
+        return true;
+    }
+
+    bool hoist(const NaturalLoop& loop)
+    {
+        BasicBlock* preHeader = preHeaderOf(loop);
+        if (!preHeader)
+            return false;
+
+        IndexSet<BasicBlock*> loopBlocks;
+        RangeSet<HeapRange> writes;
+        bool writesPinned = false;
+        bool fence = false;
+        for (unsigned blockIndex = loop.size(); blockIndex--;) {
+            BasicBlock* block = loop[blockIndex];
+            loopBlocks.add(block);
+            for (Value* value : *block) {
+                Effects effects = value->effects();
+                writes.add(effects.writes);
+                writesPinned |= effects.writesPinned;
+                fence |= effects.fence;
+            }
+        }
+
+        // Values that are control-dependent may only be hoisted if they would have executed every
+        // time the loop is entered. We only prove this for the run of values at the top of the
+        // header that precedes anything that could exit.
+        IndexSet<Value*> safeToExecute;
+        for (Value* value : *loop.header()) {
+            Effects effects = value->effects();
+            if (effects.terminal || effects.exitsSideways)
+                break;
+            safeToExecute.add(value);
+        }
+
+        auto canHoist = [&] (Value* value) -> bool {
+            if (value->type() == Void || value->isConstant())
+                return false;
+            switch (value->opcode()) {
+            case Nop:
+            case Phi:
+            case Patchpoint:
+                return false;
+            default:
+                break;
+            }
+
+            Effects effects = value->effects();
+            if (effects.mustExecute() || effects.readsLocalState)
+                return false;
+            if (effects.controlDependent && !safeToExecute.contains(value))
+                return false;
+            if (effects.readsPinned && writesPinned)
+                return false;
+            if (effects.reads && (fence || writes.overlaps(effects.reads)))
+                return false;
+
+            for (Value* child : value->children()) {
+                if (loopBlocks.contains(child->owner))
+                    return false;
+            }
+            return true;
+        };
+
+        // Hoisting one value may make its users hoistable, so iterate to fixpoint. Since a value is
+        // only hoisted after all of its children have been, the pre-header gets them in a valid order.
+        Vector<Value*> hoisted;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (unsigned blockIndex = 0; blockIndex < loop.size(); ++blockIndex) {
+                BasicBlock* block = loop[blockIndex];
+                for (Value* value : *block) {
+                    if (value->owner != block || !canHoist(value))
+                        continue;
+                    if (verbose)
+                        dataLog("Hoisting ", *value, " from ", *block, " into ", *preHeader, "\n");
+                    value->owner = preHeader;
+                    m_insertionSet.insertValue(preHeader->size() - 1, value);
+                    hoisted.append(value);
+                    changed = true;
+                }
+            }
+        }
+
+        if (hoisted.isEmpty())
+            return false;
+
+        for (unsigned blockIndex = loop.size(); blockIndex--;) {
+            BasicBlock* block = loop[blockIndex];
+            block->values().removeAllMatching(
+                [&] (Value* value) -> bool {
+                    return value->owner != block;
+                });
+        }
+        m_insertionSet.execute(preHeader);
+        return true;
+    }
+
+    Procedure& m_proc;
+    InsertionSet m_insertionSet;
+};
+
+} // anonymous namespace
+
+bool hoistLoopInvariantValues(Procedure& proc)
+{
+    PhaseScope phaseScope(proc, "hoistLoopInvariantValues");
+    HoistLoopInvariantValues hoistLoopInvariantValues(proc);
+    return hoistLoopInvariantValues.run();
+}
+
+} } // namespace JSC::B3
+
+#endif // ENABLE(B3_JIT)
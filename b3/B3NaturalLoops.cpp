@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "B3NaturalLoops.h"
+
+#if ENABLE(B3_JIT)
+
+#include "B3BasicBlockInlines.h"
+#include "B3Dominators.h"
+#include "B3ProcedureInlines.h"
+#include <wtf/CommaPrinter.h>
+#include <wtf/IndexSet.h>
+#include <wtf/StdLibExtras.h>
+
+namespace JSC { namespace B3 {
+
+namespace {
+
+const bool verbose = false;
+
+} // anonymous namespace
+
+void NaturalLoop::dump(PrintStream& out) const
+{
+    out.print("[Header: ", *header(), ", Body:");
+    for (unsigned i = 0; i < m_body.size(); ++i)
+        out.print(" ", *m_body[i]);
+    out.print("]");
+}
+
+NaturalLoops::NaturalLoops(Procedure& proc)
+    : m_innerMostLoopIndices(proc.size())
+{
+    Dominators& dominators = proc.dominators();
+
+    // Implement the classic dominator-based natural loop finder. The first step is to find all
+    // control flow edges A -> B where B dominates A. Then B is a loop header and A is a backward
+    // branching block. We accumulate, for each loop header, all of its backward branching blocks.
+    // Then we search the graph backwards from the backward branching blocks to their loop header,
+    // which gives us all of the blocks in the loop body.
+    
+    if (verbose) {
+        dataLog("Dominators:\n");
+        dominators.dump(WTF::dataFile());
+    }
+    
+    for (unsigned blockIndex = proc.size(); blockIndex--;) {
+        BasicBlock* block = proc[blockIndex];
+        if (!block)
+            continue;
+        
+        for (BasicBlock* successor : block->successorBlocks()) {
+            if (!dominators.dominates(successor, block))
+                continue;
+            bool found = false;
+            for (unsigned j = m_loops.size(); j--;) {
+                if (m_loops[j].header() == successor) {
+                    if (!m_loops[j].contains(block))
+                        m_loops[j].addBlock(block);
+                    found = true;
+                    break;
+                }
+            }
+            if (found)
+                continue;
+            NaturalLoop loop(successor, m_loops.size());
+            loop.addBlock(block);
+            m_loops.append(loop);
+        }
+    }
+    
+    if (verbose)
+        dataLog("After bootstrap: ", *this, "\n");
+    
+    Vector<BasicBlock*, 4> blockWorklist;
+    
+    for (unsigned i = m_loops.size(); i--;) {
+        NaturalLoop& loop = m_loops[i];
+        
+        IndexSet<BasicBlock*> seenBlocks;
+        ASSERT(blockWorklist.isEmpty());
+        
+        if (verbose)
+            dataLog("Dealing with loop ", loop, "\n");
+        
+        for (unsigned j = loop.size(); j--;) {
+            seenBlocks.add(loop[j]);
+            blockWorklist.append(loop[j]);
+        }
+        
+        while (!blockWorklist.isEmpty()) {
+            BasicBlock* block = blockWorklist.takeLast();
+            
+            if (verbose)
+                dataLog("    Dealing with ", *block, "\n");
+            
+            if (block == loop.header())
+                continue;
+            
+            for (BasicBlock* predecessor : block->predecessors()) {
+                if (!seenBlocks.add(predecessor))
+                    continue;
+                
+                loop.addBlock(predecessor);
+                blockWorklist.append(predecessor);
+            }
+        }
+    }
+
+    // Figure out reverse mapping from blocks to loops.
+    for (BasicBlock* block : proc)
+        m_innerMostLoopIndices[block].fill(UINT_MAX);
+    for (unsigned loopIndex = m_loops.size(); loopIndex--;) {
+        NaturalLoop& loop = m_loops[loopIndex];
+        
+        for (unsigned blockIndexInLoop = loop.size(); blockIndexInLoop--;) {
+            BasicBlock* block = loop[blockIndexInLoop];
+            std::array<unsigned, numberOfInnerMostLoopIndices>& indices = m_innerMostLoopIndices[block];
+            
+            for (unsigned i = 0; i < numberOfInnerMostLoopIndices; ++i) {
+                unsigned thisIndex = indices[i];
+                if (thisIndex == UINT_MAX || loop.size() < m_loops[thisIndex].size()) {
+                    insertIntoBoundedVector(indices, numberOfInnerMostLoopIndices, loopIndex, i);
+                    break;
+                }
+            }
+        }
+    }
+    
+    // Now each block knows its inner-most loop and its next-to-inner-most loop. Use this to figure
+    // out loop parenting.
+    for (unsigned i = m_loops.size(); i--;) {
+        NaturalLoop& loop = m_loops[i];
+        RELEASE_ASSERT(m_innerMostLoopIndices[loop.header()][0] == i);
+        
+        loop.m_outerLoopIndex = m_innerMostLoopIndices[loop.header()][1];
+    }
+    
+    if (verbose)
+        dataLog("Results: ", *this, "\n");
+}
+
+NaturalLoops::~NaturalLoops()
+{
+}
+
+Vector<const NaturalLoop*> NaturalLoops::loopsOf(BasicBlock* block) const
+{
+    Vector<const NaturalLoop*> result;
+    for (const NaturalLoop* loop = innerMostLoopOf(block); loop; loop = innerMostOuterLoop(*loop))
+        result.append(loop);
+    return result;
+}
+
+void NaturalLoops::dump(PrintStream& out) const
+{
+    out.print("NaturalLoops:{");
+    CommaPrinter comma;
+    for (unsigned i = 0; i < m_loops.size(); ++i)
+        out.print(comma, m_loops[i]);
+    out.print("}");
+}
+
+} } // namespace JSC::B3
+
+#endif // ENABLE(B3_JIT)
@@ -35,6 +35,7 @@
 #include "B3CFG.h"
 #include "B3DataSection.h"
 #include "B3Dominators.h"
+#include "B3NaturalLoops.h"
 #include "B3OpaqueByproducts.h"
 #include "B3PhiChildren.h"
 #include "B3StackSlot.h"
@@ -200,6 +201,7 @@ void Procedure::resetReachability()
 void Procedure::invalidateCFG()
 {
     m_dominators = nullptr;
+    m_naturalLoops = nullptr;
 }
 
 void Procedure::dump(PrintStream& out) const
@@ -291,6 +293,13 @@ Dominators& Procedure::dominators()
     return *m_dominators;
 }
 
+NaturalLoops& Procedure::naturalLoops()
+{
+    if (!m_naturalLoops)
+        m_naturalLoops = std::make_unique<NaturalLoops>(*this);
+    return *m_naturalLoops;
+}
+
 void Procedure::addFastConstant(const ValueKey& constant)
 {
     RELEASE_ASSERT(constant.isConstant());
@@ -52,6 +52,7 @@ class BasicBlock;
 class BlockInsertionSet;
 class CFG;
 class Dominators;
+class NaturalLoops;
 class StackSlot;
 class Value;
 class Variable;
@@ -175,6 +176,7 @@ public:
     CFG& cfg() const { return *m_cfg; }
 
     Dominators& dominators();
+    JS_EXPORT_PRIVATE NaturalLoops& naturalLoops();
 
     void addFastConstant(const ValueKey&);
     bool isFastConstant(const ValueKey&);
@@ -271,6 +273,7 @@ private:
     SparseCollection<Value> m_values;
     std::unique_ptr<CFG> m_cfg;
     std::unique_ptr<Dominators> m_dominators;
+    std::unique_ptr<NaturalLoops> m_naturalLoops;
     HashSet<ValueKey> m_fastConstants;
     unsigned m_numEntrypoints { 1 };
     const char* m_lastPhaseName;
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "B3UnrollLoops.h"
+
+#if ENABLE(B3_JIT)
+
+#include "B3BasicBlockInlines.h"
+#include "B3BlockInsertionSet.h"
+#include "B3FixSSA.h"
+#include "B3NaturalLoops.h"
+#include "B3PhaseScope.h"
+#include "B3ProcedureInlines.h"
+#include "B3ValueInlines.h"
+#include <wtf/HashMap.h>
+#include <wtf/IndexSet.h>
+
+namespace JSC { namespace B3 {
+
+namespace {
+
+const bool verbose = false;
+
+class UnrollLoops {
+public:
+    UnrollLoops(Procedure& proc)
+        : m_proc(proc)
+        , m_blockInsertionSet(proc)
+        , m_maxSize(Options::maxB3UnrollBlockSize())
+        , m_factor(Options::b3UnrollFactor())
+    {
+    }
+
+    bool run()
+    {
+        if (m_factor < 2)
+            return false;
+
+        NaturalLoops& loops = m_proc.naturalLoops();
+
+        Vector<BasicBlock*> candidates;
+        for (unsigned loopIndex = loops.numLoops(); loopIndex--;) {
+            const NaturalLoop& loop = loops.loop(loopIndex);
+            if (loop.size() != 1)
+                continue;
+
+            BasicBlock* block = loop.header();
+            if (block->size() > m_maxSize)
+                continue;
+            if (block->last()->opcode() != Branch) // Demoting doesn't handle terminals with values.
+                continue;
+
+            bool ok = true;
+            for (Value* value : *block) {
+                // We don't know if it's OK to run a patchpoint's generator more than once.
+                if (value->opcode() == Patchpoint) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (ok)
+                candidates.append(block);
+        }
+
+        if (candidates.isEmpty())
+            return false;
+
+        m_proc.resetValueOwners();
+
+        IndexSet<BasicBlock*> candidateSet;
+        for (BasicBlock* block : candidates)
+            candidateSet.add(block);
+
+        // Collect the set of values that must be de-SSA'd. That's the loop's Phis, and anything that
+        // is used outside of the loop, since after unrolling the loop has more than one exit.
+        IndexSet<Value*> valuesToDemote;
+        for (BasicBlock* block : m_proc) {
+            for (Value* value : *block) {
+                if (value->opcode() == Phi && candidateSet.contains(block))
+                    valuesToDemote.add(value);
+                for (Value* child : value->children()) {
+                    if (child->owner != block && candidateSet.contains(child->owner))
+                        valuesToDemote.add(child);
+                }
+            }
+        }
+        demoteValues(m_proc, valuesToDemote);
+        if (verbose) {
+            dataLog("Procedure after value demotion:\n");
+            dataLog(m_proc);
+        }
+
+        for (BasicBlock* block : candidates) {
+            if (verbose)
+                dataLog("Unrolling ", *block, " ", m_factor, " times\n");
+
+            BasicBlock::SuccessorList successors = block->successors();
+            BasicBlock* previous = block;
+            for (unsigned copyIndex = 1; copyIndex < m_factor; ++copyIndex) {
+                BasicBlock* copy = m_blockInsertionSet.insertAfter(block);
+
+                HashMap<Value*, Value*> map;
+                for (Value* value : *block) {
+                    Value* clone = m_proc.clone(value);
+                    for (Value*& child : clone->children()) {
+                        if (Value* replacement = map.get(child))
+                            child = replacement;
+                    }
+                    if (value->type() != Void)
+                        map.add(value, clone);
+                    copy->append(clone);
+                }
+                copy->successors() = successors;
+
+                // The previous copy now continues into this one, and this one loops back around to
+                // the original block.
+                for (BasicBlock*& successor : previous->successorBlocks()) {
+                    if (successor == block)
+                        successor = copy;
+                }
+                previous = copy;
+            }
+        }
+
+        m_blockInsertionSet.execute();
+        m_proc.resetReachability();
+        m_proc.invalidateCFG();
+        return true;
+    }
+
+private:
+    Procedure& m_proc;
+    BlockInsertionSet m_blockInsertionSet;
+    unsigned m_maxSize;
+    unsigned m_factor;
+};
+
+} // anonymous namespace
+
+bool unrollLoops(Procedure& proc)
+{
+    PhaseScope phaseScope(proc, "unrollLoops");
+    UnrollLoops unrollLoops(proc);
+    return unrollLoops.run();
+}
+
+} } // namespace JSC::B3
+
+#endif // ENABLE(B3_JIT)
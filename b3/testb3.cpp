@@ -40,18 +40,22 @@
 #include "B3ConstPtrValue.h"
 #include "B3Effects.h"
 #include "B3FenceValue.h"
+#include "B3FixSSA.h"
 #include "B3Generate.h"
+#include "B3HoistLoopInvariantValues.h"
 #include "B3LowerToAir.h"
 #include "B3MathExtras.h"
 #include "B3MemoryValue.h"
 #include "B3MoveConstants.h"
 #include "B3NativeTraits.h"
+#include "B3NaturalLoops.h"
 #include "B3Procedure.h"
 #include "B3ReduceStrength.h"
 #include "B3SlotBaseValue.h"
 #include "B3StackSlot.h"
 #include "B3StackmapGenerationParams.h"
 #include "B3SwitchValue.h"
+#include "B3UnrollLoops.h"
 #include "B3UpsilonValue.h"
 #include "B3UseCounts.h"
 #include "B3Validate.h"
@@ -14173,6 +14177,205 @@ void testMoveConstants()
     }
 }
 
+void testNaturalLoops()
+{
+    Procedure proc;
+    BasicBlock* root = proc.addBlock();
+    BasicBlock* outerHeader = proc.addBlock();
+    BasicBlock* innerHeader = proc.addBlock();
+    BasicBlock* outerFooter = proc.addBlock();
+    BasicBlock* end = proc.addBlock();
+
+    Value* arg = root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0);
+    root->appendNewControlValue(proc, Jump, Origin(), FrequentedBlock(outerHeader));
+    outerHeader->appendNewControlValue(proc, Jump, Origin(), FrequentedBlock(innerHeader));
+    innerHeader->appendNewControlValue(
+        proc, Branch, Origin(), arg, FrequentedBlock(innerHeader), FrequentedBlock(outerFooter));
+    outerFooter->appendNewControlValue(
+        proc, Branch, Origin(), arg, FrequentedBlock(outerHeader), FrequentedBlock(end));
+    end->appendNewControlValue(proc, Return, Origin(), arg);
+
+    proc.resetReachability();
+    NaturalLoops& loops = proc.naturalLoops();
+
+    CHECK(loops.numLoops() == 2);
+    CHECK(!loops.innerMostLoopOf(root));
+    CHECK(!loops.innerMostLoopOf(end));
+    CHECK(loops.headerOf(outerHeader));
+    CHECK(loops.headerOf(innerHeader));
+    CHECK(!loops.headerOf(outerFooter));
+    CHECK(loops.headerOf(outerHeader)->size() == 3);
+    CHECK(loops.headerOf(innerHeader)->size() == 1);
+    CHECK(loops.innerMostOuterLoop(*loops.headerOf(innerHeader)) == loops.headerOf(outerHeader));
+    CHECK(loops.headerOf(outerHeader)->isOuterMostLoop());
+    CHECK(loops.loopDepth(innerHeader) == 2);
+    CHECK(loops.loopDepth(outerFooter) == 1);
+    CHECK(loops.belongsTo(innerHeader, *loops.headerOf(outerHeader)));
+    CHECK(!loops.belongsTo(outerFooter, *loops.headerOf(innerHeader)));
+}
+
+// Builds a do-while loop that runs max(n, 1) times and returns the sum of a * b over all iterations.
+// The Mul is loop-invariant.
+static Value* addLoopWithInvariantMul(Procedure& proc)
+{
+    BasicBlock* root = proc.addBlock();
+    BasicBlock* loop = proc.addBlock();
+    BasicBlock* end = proc.addBlock();
+
+    Value* a = root->appendNew<Value>(
+        proc, Trunc, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0));
+    Value* b = root->appendNew<Value>(
+        proc, Trunc, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR1));
+    Value* n = root->appendNew<Value>(
+        proc, Trunc, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR2));
+    UpsilonValue* initialIndex = root->appendNew<UpsilonValue>(
+        proc, Origin(), root->appendNew<Const32Value>(proc, Origin(), 0));
+    UpsilonValue* initialSum = root->appendNew<UpsilonValue>(
+        proc, Origin(), root->appendNew<Const32Value>(proc, Origin(), 0));
+    root->appendNewControlValue(proc, Jump, Origin(), FrequentedBlock(loop));
+
+    Value* index = loop->appendNew<Value>(proc, Phi, Int32, Origin());
+    Value* sum = loop->appendNew<Value>(proc, Phi, Int32, Origin());
+    initialIndex->setPhi(index);
+    initialSum->setPhi(sum);
+    Value* product = loop->appendNew<Value>(proc, Mul, Origin(), a, b);
+    Value* newSum = loop->appendNew<Value>(proc, Add, Origin(), sum, product);
+    Value* newIndex = loop->appendNew<Value>(
+        proc, Add, Origin(), index, loop->appendNew<Const32Value>(proc, Origin(), 1));
+    loop->appendNew<UpsilonValue>(proc, Origin(), newIndex, index);
+    loop->appendNew<UpsilonValue>(proc, Origin(), newSum, sum);
+    loop->appendNewControlValue(
+        proc, Branch, Origin(),
+        loop->appendNew<Value>(proc, LessThan, Origin(), newIndex, n),
+        FrequentedBlock(loop), FrequentedBlock(end));
+
+    end->appendNewControlValue(proc, Return, Origin(), newSum);
+
+    return product;
+}
+
+void testHoistLoopInvariantArithmetic()
+{
+    {
+        Procedure proc;
+        Value* product = addLoopWithInvariantMul(proc);
+        proc.resetReachability();
+        CHECK(hoistLoopInvariantValues(proc));
+        validate(proc);
+        CHECK(product->owner == proc[0]);
+    }
+
+    Procedure proc;
+    addLoopWithInvariantMul(proc);
+    auto code = compileProc(proc);
+    CHECK(invoke<int>(*code, 3, 4, 0) == 12);
+    CHECK(invoke<int>(*code, 3, 4, 1) == 12);
+    CHECK(invoke<int>(*code, 3, 4, 2) == 24);
+    CHECK(invoke<int>(*code, 3, 4, 7) == 84);
+    CHECK(invoke<int>(*code, -5, 6, 10) == -300);
+}
+
+// Builds a do-while loop that runs max(n, 1) times. Each iteration loads from p and adds what it
+// loaded to *q. If p == q, then the load is not loop-invariant.
+static Value* addLoopWithLoad(Procedure& proc)
+{
+    BasicBlock* root = proc.addBlock();
+    BasicBlock* loop = proc.addBlock();
+    BasicBlock* end = proc.addBlock();
+
+    Value* p = root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR0);
+    Value* q = root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR1);
+    Value* n = root->appendNew<Value>(
+        proc, Trunc, Origin(),
+        root->appendNew<ArgumentRegValue>(proc, Origin(), GPRInfo::argumentGPR2));
+    UpsilonValue* initialIndex = root->appendNew<UpsilonValue>(
+        proc, Origin(), root->appendNew<Const32Value>(proc, Origin(), 0));
+    root->appendNewControlValue(proc, Jump, Origin(), FrequentedBlock(loop));
+
+    Value* index = loop->appendNew<Value>(proc, Phi, Int32, Origin());
+    initialIndex->setPhi(index);
+    Value* load = loop->appendNew<MemoryValue>(proc, Load, Int32, Origin(), p);
+    loop->appendNew<MemoryValue>(
+        proc, Store, Origin(),
+        loop->appendNew<Value>(
+            proc, Add, Origin(), load,
+            loop->appendNew<MemoryValue>(proc, Load, Int32, Origin(), q)),
+        q);
+    Value* newIndex = loop->appendNew<Value>(
+        proc, Add, Origin(), index, loop->appendNew<Const32Value>(proc, Origin(), 1));
+    loop->appendNew<UpsilonValue>(proc, Origin(), newIndex, index);
+    loop->appendNewControlValue(
+        proc, Branch, Origin(),
+        loop->appendNew<Value>(proc, LessThan, Origin(), newIndex, n),
+        FrequentedBlock(loop), FrequentedBlock(end));
+
+    end->appendNewControlValue(proc, Return, Origin());
+
+    return load;
+}
+
+void testHoistLoopInvariantLoad()
+{
+    {
+        // The store to q might alias p, so the load of p must stay put.
+        Procedure proc;
+        Value* load = addLoopWithLoad(proc);
+        proc.resetReachability();
+        hoistLoopInvariantValues(proc);
+        validate(proc);
+        CHECK(load->owner == proc[1]);
+    }
+
+    {
+        // If q's heap is disjoint from p's, then the load of p is hoisted.
+        Procedure proc;
+        Value* load = addLoopWithLoad(proc);
+        load->as<MemoryValue>()->setRange(HeapRange(0, 1));
+        for (Value* value : *proc[1]) {
+            if (value != load && value->as<MemoryValue>())
+                value->as<MemoryValue>()->setRange(HeapRange(1, 2));
+        }
+        proc.resetReachability();
+        CHECK(hoistLoopInvariantValues(proc));
+        validate(proc);
+        CHECK(load->owner == proc[0]);
+    }
+
+    Procedure proc;
+    addLoopWithLoad(proc);
+    auto code = compileProc(proc);
+    int32_t source = 5;
+    int32_t destination = 1;
+    invoke<void>(*code, &source, &destination, 3);
+    CHECK(source == 5);
+    CHECK(destination == 16);
+    invoke<void>(*code, &destination, &destination, 3);
+    CHECK(destination == 128);
+}
+
+void testUnrollSelfLoop()
+{
+    {
+        Procedure proc;
+        addLoopWithInvariantMul(proc);
+        proc.resetReachability();
+        unsigned numBlocks = proc.size();
+        CHECK(unrollLoops(proc));
+        fixSSA(proc);
+        validate(proc);
+        CHECK(proc.size() == numBlocks + Options::b3UnrollFactor() - 1);
+    }
+
+    Procedure proc;
+    addLoopWithInvariantMul(proc);
+    auto code = compileProc(proc);
+    for (int32_t n = 0; n < 10; ++n)
+        CHECK(invoke<int>(*code, 2, 3, n) == 6 * std::max(n, 1));
+}
+
 void testPCOriginMapDoesntInsertNops()
 {
     Procedure proc;
@@ -17118,6 +17321,10 @@ void run(const char* filter)
     RUN(testTrappingLoadDCE());
     RUN(testTrappingStoreElimination());
     RUN(testMoveConstants());
+    RUN(testNaturalLoops());
+    RUN(testHoistLoopInvariantArithmetic());
+    RUN(testHoistLoopInvariantLoad());
+    RUN(testUnrollSelfLoop());
     RUN(testPCOriginMapDoesntInsertNops());
     RUN(testPinRegisters());
     RUN(testReduceStrengthReassociation(true));
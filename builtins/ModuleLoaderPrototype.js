@@ -137,6 +137,9 @@ function fulfillFetch(entry, source)
         entry.fetch = @newPromiseCapability(@InternalPromise).@promise;
     this.forceFulfillPromise(entry.fetch, source);
     @setStateToMax(entry, @ModuleInstantiate);
+    // Provided sources skip requestFetch(), so start parsing them here.
+    if (source !== @undefined)
+        this.parseModuleConcurrently(entry.key, source);
 }
 
 function fulfillInstantiate(entry, optionalInstance, source)
@@ -222,6 +225,8 @@ function requestFetch(key, fetcher)
     //     from the local file system.
     var fetchPromise = this.fetch(key, fetcher).then((source) => {
         @setStateToMax(entry, @ModuleInstantiate);
+        // Start parsing the module on a helper thread while the other fetches complete.
+        this.parseModuleConcurrently(key, source);
         return source;
     });
     entry.fetch = fetchPromise;
@@ -226,6 +226,15 @@ public:
     
     bool usesOriginalArrayStructures(const ConcurrentJSLocker&) const { return m_usesOriginalArrayStructures; }
     
+    // Adds what an earlier run of this code observed. See ProfileCache.
+    void seed(const ConcurrentJSLocker&, ArrayModes observedArrayModes, bool mayStoreToHole, bool outOfBounds)
+    {
+        m_observedArrayModes |= observedArrayModes;
+        m_mayStoreToHole |= mayStoreToHole;
+        m_outOfBounds |= outOfBounds;
+        m_didPerformFirstRunPruning = true;
+    }
+    
     CString briefDescription(const ConcurrentJSLocker&, CodeBlock*);
     CString briefDescriptionWithoutUpdating(const ConcurrentJSLocker&);
     
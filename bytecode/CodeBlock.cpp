@@ -68,6 +68,7 @@
 #include "ModuleProgramCodeBlock.h"
 #include "PCToCodeOriginMap.h"
 #include "PolymorphicAccess.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "ReduceWhitespace.h"
@@ -816,6 +817,9 @@ bool CodeBlock::finishCreation(VM& vm, ScriptExecutable* ownerExecutable, Unlink
 
     m_instructions = WTFMove(instructions);
 
+    if (ProfileCache* profileCache = vm.profileCache())
+        profileCache->seed(this);
+
     // Set optimization thresholds only after m_instructions is initialized, since these
     // rely on the instruction count (and are in theory permitted to also inspect the
     // instruction stream to more accurate assess the cost of tier-up).
@@ -1583,6 +1587,7 @@ void CodeBlock::stronglyVisitStrongReferences(const ConcurrentJSLocker& locker,
     visitor.append(m_globalObject);
     visitor.append(m_ownerExecutable);
     visitor.append(m_unlinkedCode);
+    m_unlinkedCode->resetAge();
     if (m_rareData)
         m_rareData->m_directEvalCodeCache.visitAggregate(visitor);
     visitor.appendValues(m_constantRegisters.data(), m_constantRegisters.size());
@@ -2304,8 +2309,12 @@ void CodeBlock::optimizeAfterWarmUp()
     if (Options::verboseOSR())
         dataLog(*this, ": Optimizing after warm-up.\n");
 #if ENABLE(DFG_JIT)
-    m_jitExecuteCounter.setNewThreshold(
-        adjustedCounterValue(Options::thresholdForOptimizeAfterWarmUp()), this);
+    // Code that an earlier run optimized gets there again quickly, unless it has already had to
+    // be reoptimized in this one.
+    int32_t threshold = Options::thresholdForOptimizeAfterWarmUp();
+    if (m_tierReachedInPreviousRun >= JITCode::DFGJIT && !reoptimizationRetryCounter())
+        threshold = Options::thresholdForOptimizeSoon();
+    m_jitExecuteCounter.setNewThreshold(adjustedCounterValue(threshold), this);
 #endif
 }
 
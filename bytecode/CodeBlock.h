@@ -99,6 +99,7 @@ class CodeBlock : public JSCell {
     friend class BytecodeLivenessAnalysis;
     friend class JIT;
     friend class LLIntOffsetsExtractor;
+    friend class ProfileCache;
 
     class UnconditionalFinalizer : public JSC::UnconditionalFinalizer { 
         void finalizeUnconditionally() override;
@@ -130,9 +131,13 @@ public:
     UnlinkedCodeBlock* unlinkedCodeBlock() const { return m_unlinkedCode.get(); }
 
     CString inferredName() const;
-    CodeBlockHash hash() const;
+    JS_EXPORT_PRIVATE CodeBlockHash hash() const;
     bool hasHash() const;
     bool isSafeToComputeHash() const;
+    // The highest tier an earlier run of this code reached, according to the ProfileCache.
+    JITCode::JITType tierReachedInPreviousRun() const { return m_tierReachedInPreviousRun; }
+    void setTierReachedInPreviousRun(JITCode::JITType tier) { m_tierReachedInPreviousRun = tier; }
+    bool hasBeenCompiledWithFTL() const { return m_hasBeenCompiledWithFTL; }
     CString hashAsStringIfPossible() const;
     CString sourceCodeForTools() const; // Not quite the actual source we parsed; this will do things like prefix the source for a function with a reified signature.
     CString sourceCodeOnOneLine() const; // As sourceCodeForTools(), but replaces all whitespace runs with a single space.
@@ -971,6 +976,7 @@ private:
     VirtualRegister m_thisRegister;
     VirtualRegister m_scopeRegister;
     mutable CodeBlockHash m_hash;
+    JITCode::JITType m_tierReachedInPreviousRun { JITCode::None };
 
     RefPtr<SourceProvider> m_source;
     unsigned m_sourceOffset;
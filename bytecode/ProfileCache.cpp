@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProfileCache.h"
+
+#include "ArithProfile.h"
+#include "CodeBlock.h"
+#include "Interpreter.h"
+#include "JSCInlines.h"
+#include <wtf/StdLibExtras.h>
+
+#if OS(UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+static const uint32_t profileCacheMagic = 0x5043534a; // "JSCP"
+
+// Bump this whenever the meaning of SpeculatedType, ArrayModes or ArithProfile bits changes.
+static const uint32_t profileCacheVersion = 1;
+
+namespace {
+
+class Encoder {
+public:
+    template<typename T>
+    void append(T value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values go in the profile cache.");
+        m_data.append(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+    }
+
+    Vector<uint8_t> takeData() { return WTFMove(m_data); }
+
+private:
+    Vector<uint8_t> m_data;
+};
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size)
+        : m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    template<typename T>
+    bool read(T& result)
+    {
+        if (static_cast<size_t>(m_end - m_cursor) < sizeof(T))
+            return false;
+        memcpy(&result, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return true;
+    }
+
+    bool atEnd() const { return m_cursor == m_end; }
+
+private:
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+};
+
+} // anonymous namespace
+
+ProfileCache::ProfileCache(const String& path)
+    : m_path(path)
+{
+    load();
+}
+
+void ProfileCache::load()
+{
+#if OS(UNIX)
+    CString path = m_path.utf8();
+    int fd = open(path.data(), O_RDONLY);
+    if (fd == -1)
+        return;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || fileStat.st_size <= 0) {
+        close(fd);
+        m_statistics.failures++;
+        return;
+    }
+
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        m_statistics.failures++;
+        return;
+    }
+
+    if (!decode(static_cast<const uint8_t*>(data), size))
+        m_statistics.failures++;
+    munmap(data, size);
+#endif
+}
+
+static void seedValueProfile(ValueProfile* profile, SpeculatedType prediction)
+{
+    if (prediction == SpecNone)
+        return;
+    mergeSpeculation(profile->m_prediction, prediction);
+
+    // Count the old profile as full, so that shouldOptimizeNow() does not hold tier-up back until
+    // this run has seen as many values.
+    if (profile->m_numberOfSamplesInPrediction < ValueProfile::numberOfBuckets)
+        profile->m_numberOfSamplesInPrediction = ValueProfile::numberOfBuckets;
+}
+
+void ProfileCache::seed(CodeBlock* codeBlock)
+{
+    if (!codeBlock->isSafeToComputeHash())
+        return;
+
+    unsigned hash = codeBlock->hash().hash();
+    if (!EntryMap::isValidKey(hash))
+        return;
+
+    auto iter = m_entries.find(hash);
+    if (iter == m_entries.end())
+        return;
+
+    const Entry& entry = iter->value;
+    if (entry.instructionCount != codeBlock->instructionCount()
+        || entry.argumentPredictions.size() != codeBlock->numberOfArgumentValueProfiles()) {
+        m_statistics.mismatches++;
+        return;
+    }
+
+    {
+        ConcurrentJSLocker locker(codeBlock->m_lock);
+
+        for (unsigned i = 0; i < entry.argumentPredictions.size(); ++i)
+            seedValueProfile(codeBlock->valueProfileForArgument(i), entry.argumentPredictions[i]);
+
+        for (unsigned i = 0; i < codeBlock->numberOfValueProfiles(); ++i) {
+            ValueProfile* profile = codeBlock->valueProfile(i);
+            const ValueProfileEntry* valueProfileEntry = tryBinarySearch<const ValueProfileEntry, unsigned>(
+                entry.valueProfiles, entry.valueProfiles.size(), profile->m_bytecodeOffset,
+                [] (const ValueProfileEntry* candidate) { return candidate->bytecodeOffset; });
+            if (valueProfileEntry)
+                seedValueProfile(profile, valueProfileEntry->prediction);
+        }
+
+        for (unsigned i = 0; i < codeBlock->m_arrayProfiles.size(); ++i) {
+            ArrayProfile& profile = codeBlock->m_arrayProfiles[i];
+            const ArrayProfileEntry* arrayProfileEntry = tryBinarySearch<const ArrayProfileEntry, unsigned>(
+                entry.arrayProfiles, entry.arrayProfiles.size(), profile.bytecodeOffset(),
+                [] (const ArrayProfileEntry* candidate) { return candidate->bytecodeOffset; });
+            if (arrayProfileEntry)
+                profile.seed(locker, arrayProfileEntry->observedArrayModes, arrayProfileEntry->mayStoreToHole, arrayProfileEntry->outOfBounds);
+        }
+    }
+
+    // Arith profiles live in the instruction stream. Only trust an entry that lands on the same
+    // opcode, in case the bytecode changed under the same source.
+    Instruction* begin = codeBlock->instructions().begin();
+    Instruction* end = codeBlock->instructions().end();
+    for (Instruction* it = begin; it != end;) {
+        OpcodeID opcodeID = Interpreter::getOpcodeID(*it);
+        if (ArithProfile* profile = codeBlock->arithProfileForPC(it)) {
+            const ArithProfileEntry* arithProfileEntry = tryBinarySearch<const ArithProfileEntry, unsigned>(
+                entry.arithProfiles, entry.arithProfiles.size(), static_cast<unsigned>(it - begin),
+                [] (const ArithProfileEntry* candidate) { return candidate->bytecodeOffset; });
+            if (arithProfileEntry && arithProfileEntry->opcodeID == static_cast<unsigned>(opcodeID))
+                *profile = ArithProfile::fromInt(profile->bits() | arithProfileEntry->bits);
+        }
+        it += opcodeLengths[opcodeID];
+    }
+
+    codeBlock->setTierReachedInPreviousRun(entry.tier);
+    if (entry.tier >= JITCode::DFGJIT && codeBlock->unlinkedCodeBlock()->didOptimize() == MixedTriState)
+        codeBlock->unlinkedCodeBlock()->setDidOptimize(TrueTriState);
+
+    m_statistics.seeds++;
+}
+
+bool ProfileCache::record(CodeBlock* codeBlock)
+{
+    if (!codeBlock->isSafeToComputeHash())
+        return false;
+
+    unsigned hash = codeBlock->hash().hash();
+    if (!EntryMap::isValidKey(hash))
+        return false;
+
+    codeBlock->updateAllPredictions();
+
+    Entry entry;
+    entry.instructionCount = codeBlock->instructionCount();
+
+    // Keep the tier from earlier runs even if this one did not get as far, since a short run
+    // should not undo the warm-up of a long one.
+    JITCode::JITType tier = std::max(codeBlock->jitType(), codeBlock->tierReachedInPreviousRun());
+#if ENABLE(JIT)
+    if (CodeBlock* replacement = codeBlock->replacement())
+        tier = std::max(tier, replacement->jitType());
+#endif
+    if (codeBlock->hasBeenCompiledWithFTL())
+        tier = JITCode::FTLJIT;
+    else if (codeBlock->unlinkedCodeBlock()->didOptimize() == TrueTriState)
+        tier = std::max(tier, JITCode::DFGJIT);
+    entry.tier = tier;
+
+    {
+        ConcurrentJSLocker locker(codeBlock->m_lock);
+
+        for (unsigned i = 0; i < codeBlock->numberOfArgumentValueProfiles(); ++i)
+            entry.argumentPredictions.append(codeBlock->valueProfileForArgument(i)->m_prediction);
+
+        for (unsigned i = 0; i < codeBlock->numberOfValueProfiles(); ++i) {
+            ValueProfile* profile = codeBlock->valueProfile(i);
+            if (profile->m_prediction != SpecNone)
+                entry.valueProfiles.append({ static_cast<unsigned>(profile->m_bytecodeOffset), profile->m_prediction });
+        }
+
+        for (unsigned i = 0; i < codeBlock->m_arrayProfiles.size(); ++i) {
+            ArrayProfile& profile = codeBlock->m_arrayProfiles[i];
+            ArrayModes observedArrayModes = profile.observedArrayModes(locker);
+            bool mayStoreToHole = profile.mayStoreToHole(locker);
+            bool outOfBounds = profile.outOfBounds(locker);
+            if (observedArrayModes || mayStoreToHole || outOfBounds)
+                entry.arrayProfiles.append({ profile.bytecodeOffset(), observedArrayModes, mayStoreToHole, outOfBounds });
+        }
+    }
+
+    Instruction* begin = codeBlock->instructions().begin();
+    Instruction* end = codeBlock->instructions().end();
+    for (Instruction* it = begin; it != end;) {
+        OpcodeID opcodeID = Interpreter::getOpcodeID(*it);
+        if (ArithProfile* profile = codeBlock->arithProfileForPC(it))
+            entry.arithProfiles.append({ static_cast<unsigned>(it - begin), static_cast<unsigned>(opcodeID), profile->bits() });
+        it += opcodeLengths[opcodeID];
+    }
+
+    auto byBytecodeOffset = [] (const auto& a, const auto& b) { return a.bytecodeOffset < b.bytecodeOffset; };
+    std::sort(entry.valueProfiles.begin(), entry.valueProfiles.end(), byBytecodeOffset);
+    std::sort(entry.arrayProfiles.begin(), entry.arrayProfiles.end(), byBytecodeOffset);
+
+    m_entries.set(hash, WTFMove(entry));
+    return true;
+}
+
+bool ProfileCache::write(VM& vm)
+{
+#if OS(UNIX)
+    // Only baseline CodeBlocks carry the profiles; optimized ones are found through replacement().
+    unsigned recorded = 0;
+    vm.heap.forEachCodeBlock([&] (CodeBlock* codeBlock) {
+        if (!codeBlock->alternative() && record(codeBlock))
+            recorded++;
+        return false;
+    });
+
+    // A VM that never ran anything, like a parser worklist helper's, has nothing to add and
+    // should not clobber what others wrote.
+    if (!recorded)
+        return false;
+
+    Vector<uint8_t> data = encode();
+
+    // Write to a private temporary file and rename it into place, so that a concurrent reader
+    // never sees a partially written cache.
+    CString path = m_path.utf8();
+    CString temporaryPath = String::format("%s.%d.tmp", path.data(), static_cast<int>(getpid())).utf8();
+    int fd = open(temporaryPath.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        m_statistics.failures++;
+        return false;
+    }
+
+    const uint8_t* cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining) {
+        ssize_t written = ::write(fd, cursor, remaining);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        cursor += written;
+        remaining -= written;
+    }
+
+    if (close(fd) || remaining || rename(temporaryPath.data(), path.data())) {
+        unlink(temporaryPath.data());
+        m_statistics.failures++;
+        return false;
+    }
+
+    m_statistics.storedEntries = m_entries.size();
+    return true;
+#else
+    UNUSED_PARAM(vm);
+    return false;
+#endif
+}
+
+Vector<uint8_t> ProfileCache::encode() const
+{
+    Encoder encoder;
+    encoder.append<uint32_t>(profileCacheMagic);
+    encoder.append<uint32_t>(profileCacheVersion);
+    encoder.append<uint32_t>(numOpcodeIDs);
+    encoder.append<uint32_t>(m_entries.size());
+
+    for (auto& pair : m_entries) {
+        const Entry& entry = pair.value;
+        encoder.append<uint32_t>(pair.key);
+        encoder.append<uint32_t>(entry.instructionCount);
+        encoder.append<uint8_t>(entry.tier);
+
+        encoder.append<uint32_t>(entry.argumentPredictions.size());
+        for (SpeculatedType prediction : entry.argumentPredictions)
+            encoder.append<uint64_t>(prediction);
+
+        encoder.append<uint32_t>(entry.valueProfiles.size());
+        for (const ValueProfileEntry& profile : entry.valueProfiles) {
+            encoder.append<uint32_t>(profile.bytecodeOffset);
+            encoder.append<uint64_t>(profile.prediction);
+        }
+
+        encoder.append<uint32_t>(entry.arrayProfiles.size());
+        for (const ArrayProfileEntry& profile : entry.arrayProfiles) {
+            encoder.append<uint32_t>(profile.bytecodeOffset);
+            encoder.append<uint32_t>(profile.observedArrayModes);
+            encoder.append<uint8_t>(profile.mayStoreToHole | (profile.outOfBounds << 1));
+        }
+
+        encoder.append<uint32_t>(entry.arithProfiles.size());
+        for (const ArithProfileEntry& profile : entry.arithProfiles) {
+            encoder.append<uint32_t>(profile.bytecodeOffset);
+            encoder.append<uint32_t>(profile.opcodeID);
+            encoder.append<uint32_t>(profile.bits);
+        }
+    }
+
+    return encoder.takeData();
+}
+
+bool ProfileCache::decode(const uint8_t* data, size_t size)
+{
+    Decoder decoder(data, size);
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t opcodeCount;
+    uint32_t entryCount;
+    if (!decoder.read(magic) || magic != profileCacheMagic
+        || !decoder.read(version) || version != profileCacheVersion
+        || !decoder.read(opcodeCount) || opcodeCount != numOpcodeIDs
+        || !decoder.read(entryCount))
+        return false;
+
+    // Decode into a separate map, so that a truncated file leaves us with nothing rather than
+    // with half an entry.
+    EntryMap entries;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        uint32_t hash;
+        uint8_t tier;
+        Entry entry;
+        if (!decoder.read(hash) || !EntryMap::isValidKey(hash)
+            || !decoder.read(entry.instructionCount)
+            || !decoder.read(tier) || tier > JITCode::FTLJIT)
+            return false;
+        entry.tier = static_cast<JITCode::JITType>(tier);
+
+        uint32_t count;
+        if (!decoder.read(count))
+            return false;
+        for (uint32_t j = 0; j < count; ++j) {
+            uint64_t prediction;
+            if (!decoder.read(prediction))
+                return false;
+            entry.argumentPredictions.append(prediction);
+        }
+
+        if (!decoder.read(count))
+            return false;
+        for (uint32_t j = 0; j < count; ++j) {
+            ValueProfileEntry profile;
+            uint64_t prediction;
+            if (!decoder.read(profile.bytecodeOffset) || !decoder.read(prediction))
+                return false;
+            profile.prediction = prediction;
+            entry.valueProfiles.append(profile);
+        }
+
+        if (!decoder.read(count))
+            return false;
+        for (uint32_t j = 0; j < count; ++j) {
+            ArrayProfileEntry profile;
+            uint32_t observedArrayModes;
+            uint8_t flags;
+            if (!decoder.read(profile.bytecodeOffset) || !decoder.read(observedArrayModes) || !decoder.read(flags))
+                return false;
+            profile.observedArrayModes = observedArrayModes;
+            profile.mayStoreToHole = flags & 1;
+            profile.outOfBounds = flags & 2;
+            entry.arrayProfiles.append(profile);
+        }
+
+        if (!decoder.read(count))
+            return false;
+        for (uint32_t j = 0; j < count; ++j) {
+            ArithProfileEntry profile;
+            if (!decoder.read(profile.bytecodeOffset) || !decoder.read(profile.opcodeID) || !decoder.read(profile.bits))
+                return false;
+            entry.arithProfiles.append(profile);
+        }
+
+        entries.set(hash, WTFMove(entry));
+    }
+
+    if (!decoder.atEnd())
+        return false;
+
+    m_entries = WTFMove(entries);
+    m_statistics.loadedEntries = m_entries.size();
+    return true;
+}
+
+void ProfileCache::dumpStatistics(PrintStream& out) const
+{
+    out.print("Profile cache (", m_path, "): ",
+        m_statistics.loadedEntries, " loaded, ",
+        m_statistics.seeds, " seeded, ",
+        m_statistics.mismatches, " mismatched, ",
+        m_statistics.storedEntries, " stored, ",
+        m_statistics.failures, " failures\n");
+}
+
+} // namespace JSC
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ArrayProfile.h"
+#include "JITCode.h"
+#include "SpeculatedType.h"
+#include <wtf/HashMap.h>
+#include <wtf/PrintStream.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class CodeBlock;
+class VM;
+
+// An on-disk store of profiling state, so that a fresh process can tier up its hot code without
+// first relearning everything about it. Entries are keyed by CodeBlockHash, which covers the
+// source text and the specialization kind, and hold the value, array and arith profiles of the
+// baseline CodeBlock by bytecode offset, along with the highest tier that code reached.
+//
+// The file is read when the VM is created and written back when it is destroyed, or whenever
+// someone calls write(). CodeBlocks are seeded as they are linked: their profiles start out with
+// the old predictions, and code that an earlier run optimized gets the "soon" thresholds for
+// tiering up again. If several VMs share a path, the last one to write wins.
+class ProfileCache {
+    WTF_MAKE_NONCOPYABLE(ProfileCache);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Statistics {
+        unsigned loadedEntries { 0 };
+        unsigned seeds { 0 };
+        unsigned mismatches { 0 };
+        unsigned storedEntries { 0 };
+        unsigned failures { 0 };
+    };
+
+    explicit ProfileCache(const String& path);
+
+    const String& path() const { return m_path; }
+
+    // Called for each baseline CodeBlock before its tier-up thresholds are set.
+    void seed(CodeBlock*);
+
+    // Folds in the profiles of all live baseline CodeBlocks and writes the file.
+    JS_EXPORT_PRIVATE bool write(VM&);
+
+    const Statistics& statistics() const { return m_statistics; }
+    void dumpStatistics(PrintStream&) const;
+
+private:
+    struct ValueProfileEntry {
+        unsigned bytecodeOffset;
+        SpeculatedType prediction;
+    };
+
+    struct ArrayProfileEntry {
+        unsigned bytecodeOffset;
+        ArrayModes observedArrayModes;
+        bool mayStoreToHole;
+        bool outOfBounds;
+    };
+
+    struct ArithProfileEntry {
+        unsigned bytecodeOffset;
+        unsigned opcodeID;
+        uint32_t bits;
+    };
+
+    // The profile vectors are sorted by bytecode offset.
+    struct Entry {
+        unsigned instructionCount { 0 };
+        JITCode::JITType tier { JITCode::None };
+        Vector<SpeculatedType> argumentPredictions;
+        Vector<ValueProfileEntry> valueProfiles;
+        Vector<ArrayProfileEntry> arrayProfiles;
+        Vector<ArithProfileEntry> arithProfiles;
+    };
+
+    typedef HashMap<unsigned, Entry> EntryMap;
+
+    void load();
+    bool record(CodeBlock*);
+    bool decode(const uint8_t*, size_t);
+    Vector<uint8_t> encode() const;
+
+    String m_path;
+    EntryMap m_entries;
+    Statistics m_statistics;
+};
+
+} // namespace JSC
@@ -389,6 +389,19 @@ void UnlinkedCodeBlock::applyModification(BytecodeRewriter& rewriter)
     recomputePreciseJumpTargets(this, graph.instructions().begin(), graph.instructions().size(), m_jumpTargets);
 }
 
+bool UnlinkedCodeBlock::hasFunctionCodeBlocksMissingFromCachedBytecode()
+{
+    for (auto& executable : m_functionDecls) {
+        if (executable->hasCodeBlocksMissingFromCachedBytecode())
+            return true;
+    }
+    for (auto& executable : m_functionExprs) {
+        if (executable->hasCodeBlocksMissingFromCachedBytecode())
+            return true;
+    }
+    return false;
+}
+
 void UnlinkedCodeBlock::shrinkToFit()
 {
     auto locker = holdLock(*this);
@@ -38,6 +38,7 @@
 #include "UnlinkedFunctionExecutable.h"
 #include "VirtualRegister.h"
 #include <algorithm>
+#include <atomic>
 #include <wtf/BitVector.h>
 #include <wtf/HashSet.h>
 #include <wtf/TriState.h>
@@ -289,6 +290,10 @@ public:
     UnlinkedFunctionExecutable* functionExpr(int index) { return m_functionExprs[index].get(); }
     size_t numberOfFunctionExprs() { return m_functionExprs.size(); }
 
+    // True if a function nested in this code block has a code block that did not come from the
+    // bytecode cache entry that the function was decoded from.
+    bool hasFunctionCodeBlocksMissingFromCachedBytecode();
+
     // Exception handling support
     size_t numberOfExceptionHandlers() const { return m_rareData ? m_rareData->m_exceptionHandlers.size() : 0; }
     void addExceptionHandler(const UnlinkedHandlerInfo& handler) { createRareDataIfNecessary(); return m_rareData->m_exceptionHandlers.append(handler); }
@@ -393,6 +398,24 @@ public:
     TriState didOptimize() const { return m_didOptimize; }
     void setDidOptimize(TriState didOptimize) { m_didOptimize = didOptimize; }
 
+    // The number of full collections since a CodeBlock linked from this one was last live.
+    // UnlinkedFunctionExecutable uses it to decide when to drop the bytecode of a cold function.
+    // Parallel markers reset the age while others read it, so it is accessed atomically. Only the
+    // finalizer increments it, after marking is done.
+    unsigned age() const { return m_age.load(std::memory_order_relaxed); }
+    void incrementAge()
+    {
+        uint8_t age = m_age.load(std::memory_order_relaxed);
+        if (age < std::numeric_limits<uint8_t>::max())
+            m_age.store(age + 1, std::memory_order_relaxed);
+    }
+    void resetAge()
+    {
+        // Most live code blocks are visited with an age of zero, so avoid dirtying their cache line.
+        if (m_age.load(std::memory_order_relaxed))
+            m_age.store(0, std::memory_order_relaxed);
+    }
+
     void dump(PrintStream&) const;
 
 protected:
@@ -405,6 +428,8 @@ protected:
     }
 
 private:
+    friend class BytecodeCacheDecoder;
+    friend class BytecodeCacheEncoder;
     friend class BytecodeRewriter;
     void applyModification(BytecodeRewriter&);
 
@@ -446,6 +471,8 @@ private:
     unsigned m_endColumn;
 
     TriState m_didOptimize;
+    // Updated concurrently by the collector, so it does not share a word with the bit fields above.
+    std::atomic<uint8_t> m_age { 0 };
     SourceParseMode m_parseMode;
     CodeFeatures m_features;
     CodeType m_codeType;
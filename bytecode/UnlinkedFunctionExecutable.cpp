@@ -116,6 +116,41 @@ UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* struct
     m_parentScopeTDZVariables.swap(parentScopeTDZVariables);
 }
 
+UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* structure)
+    : Base(*vm, structure)
+    , m_firstLineOffset(0)
+    , m_lineCount(0)
+    , m_unlinkedFunctionNameStart(0)
+    , m_unlinkedBodyStartColumn(0)
+    , m_unlinkedBodyEndColumn(0)
+    , m_startOffset(0)
+    , m_sourceLength(0)
+    , m_parametersStartOffset(0)
+    , m_typeProfilingStartOffset(0)
+    , m_typeProfilingEndOffset(0)
+    , m_parameterCount(0)
+    , m_features(0)
+    , m_sourceParseMode(SourceParseMode::NormalFunctionMode)
+    , m_isInStrictContext(false)
+    , m_hasCapturedVariables(false)
+    , m_isBuiltinFunction(false)
+    , m_constructAbility(0)
+    , m_constructorKind(0)
+    , m_functionMode(0)
+    , m_scriptMode(0)
+    , m_superBinding(0)
+    , m_derivedContextType(0)
+{
+}
+
+UnlinkedFunctionExecutable* UnlinkedFunctionExecutable::createUninitialized(VM& vm)
+{
+    UnlinkedFunctionExecutable* instance = new (NotNull, allocateCell<UnlinkedFunctionExecutable>(vm.heap))
+        UnlinkedFunctionExecutable(&vm, vm.unlinkedFunctionExecutableStructure.get());
+    instance->finishCreation(vm);
+    return instance;
+}
+
 void UnlinkedFunctionExecutable::destroy(JSCell* cell)
 {
     static_cast<UnlinkedFunctionExecutable*>(cell)->~UnlinkedFunctionExecutable();
@@ -126,8 +161,56 @@ void UnlinkedFunctionExecutable::visitChildren(JSCell* cell, SlotVisitor& visito
     UnlinkedFunctionExecutable* thisObject = jsCast<UnlinkedFunctionExecutable*>(cell);
     ASSERT_GC_OBJECT_INHERITS(thisObject, info());
     Base::visitChildren(thisObject, visitor);
-    visitor.append(thisObject->m_unlinkedCodeBlockForCall);
-    visitor.append(thisObject->m_unlinkedCodeBlockForConstruct);
+
+    if (!thisObject->canFlushCodeBlocks(visitor)) {
+        visitor.append(thisObject->m_unlinkedCodeBlockForCall);
+        visitor.append(thisObject->m_unlinkedCodeBlockForConstruct);
+        return;
+    }
+
+    // A code block that is too old is only kept alive by a CodeBlock that was linked from it,
+    // which CodeBlock::visitChildren() also uses to reset its age. The finalizer forgets it if
+    // nothing marked it, and then unlinkedCodeBlockFor() generates it again on the next call.
+    visitor.addUnconditionalFinalizer(&thisObject->m_unconditionalFinalizer);
+    unsigned maximumAge = Options::maximumUnlinkedCodeBlockAge();
+    if (thisObject->m_unlinkedCodeBlockForCall && thisObject->m_unlinkedCodeBlockForCall->age() <= maximumAge)
+        visitor.append(thisObject->m_unlinkedCodeBlockForCall);
+    if (thisObject->m_unlinkedCodeBlockForConstruct && thisObject->m_unlinkedCodeBlockForConstruct->age() <= maximumAge)
+        visitor.append(thisObject->m_unlinkedCodeBlockForConstruct);
+}
+
+bool UnlinkedFunctionExecutable::canFlushCodeBlocks(SlotVisitor& visitor) const
+{
+    if (!Options::useUnlinkedCodeBlockFlushing())
+        return false;
+
+    // Builtins are small and shared by every global object, so they are not worth regenerating.
+    if (isBuiltinFunction())
+        return false;
+
+    if (!m_unlinkedCodeBlockForCall && !m_unlinkedCodeBlockForConstruct)
+        return false;
+
+    // Eden collections do not visit most code blocks, so they would not age them evenly.
+    return visitor.heap()->collectionScope() == CollectionScope::Full;
+}
+
+void UnlinkedFunctionExecutable::UnconditionalFinalizer::finalizeUnconditionally()
+{
+    UnlinkedFunctionExecutable* executable = bitwise_cast<UnlinkedFunctionExecutable*>(
+        bitwise_cast<char*>(this) - OBJECT_OFFSETOF(UnlinkedFunctionExecutable, m_unconditionalFinalizer));
+
+    auto finalize = [] (WriteBarrier<UnlinkedFunctionCodeBlock>& codeBlock) {
+        if (!codeBlock)
+            return;
+        if (!Heap::isMarked(codeBlock.get())) {
+            codeBlock.clear();
+            return;
+        }
+        codeBlock->incrementAge();
+    };
+    finalize(executable->m_unlinkedCodeBlockForCall);
+    finalize(executable->m_unlinkedCodeBlockForConstruct);
 }
 
 FunctionExecutable* UnlinkedFunctionExecutable::link(VM& vm, const SourceCode& passedParentSource, std::optional<int> overrideLineNumber, Intrinsic intrinsic)
@@ -206,6 +289,9 @@ UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::unlinkedCodeBlockFor(
         break;
     }
 
+    if (UnlinkedFunctionCodeBlock* codeBlock = decodeCachedCodeBlock(vm, specializationKind))
+        return codeBlock;
+
     UnlinkedFunctionCodeBlock* result = generateUnlinkedFunctionCodeBlock(
         vm, this, source, specializationKind, debuggerMode, 
         isBuiltinFunction() ? UnlinkedBuiltinFunction : UnlinkedNormalFunction, 
@@ -231,4 +317,55 @@ void UnlinkedFunctionExecutable::setInvalidTypeProfilingOffsets()
     m_typeProfilingEndOffset = std::numeric_limits<unsigned>::max();
 }
 
+UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::decodeCachedCodeBlock(VM& vm, CodeSpecializationKind specializationKind)
+{
+    if (!m_cachedBytecode)
+        return nullptr;
+
+    CachedCodeBlockLocation location = specializationKind == CodeForCall ? m_cachedCodeBlockForCall : m_cachedCodeBlockForConstruct;
+    if (!location)
+        return nullptr;
+
+    // The location is kept after decoding, so that a code block that is later cleared can be
+    // decoded again rather than regenerated.
+    UnlinkedFunctionCodeBlock* result = decodeFunctionCodeBlock(vm, *m_cachedBytecode, location);
+    if (!result)
+        return nullptr;
+
+    switch (specializationKind) {
+    case CodeForCall:
+        m_unlinkedCodeBlockForCall.set(vm, this, result);
+        break;
+    case CodeForConstruct:
+        m_unlinkedCodeBlockForConstruct.set(vm, this, result);
+        break;
+    }
+    if (BytecodeCache* bytecodeCache = vm.codeCache()->bytecodeCache())
+        bytecodeCache->didDecodeFunctionCodeBlock();
+    return result;
+}
+
+bool UnlinkedFunctionExecutable::hasCodeBlocksMissingFromCachedBytecode()
+{
+    auto isMissing = [&] (UnlinkedFunctionCodeBlock* codeBlock, const CachedCodeBlockLocation& location) -> bool {
+        if (!codeBlock)
+            return false;
+        if (!m_cachedBytecode || !location)
+            return true;
+        // Functions that were never decoded have no code blocks of their own, so this only walks
+        // the part of the tree that ran.
+        return codeBlock->hasFunctionCodeBlocksMissingFromCachedBytecode();
+    };
+    return isMissing(m_unlinkedCodeBlockForCall.get(), m_cachedCodeBlockForCall)
+        || isMissing(m_unlinkedCodeBlockForConstruct.get(), m_cachedCodeBlockForConstruct);
+}
+
+void UnlinkedFunctionExecutable::decodeCachedCodeBlocks(VM& vm)
+{
+    if (!m_unlinkedCodeBlockForCall)
+        decodeCachedCodeBlock(vm, CodeForCall);
+    if (!m_unlinkedCodeBlockForConstruct)
+        decodeCachedCodeBlock(vm, CodeForConstruct);
+}
+
 } // namespace JSC
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "CachedTypes.h"
 #include "CodeSpecializationKind.h"
 #include "ConstructAbility.h"
 #include "ExecutableInfo.h"
@@ -35,6 +36,7 @@
 #include "ParserModes.h"
 #include "RegExp.h"
 #include "SourceCode.h"
+#include "UnconditionalFinalizer.h"
 #include "VariableEnvironment.h"
 
 namespace JSC {
@@ -52,6 +54,8 @@ enum UnlinkedFunctionKind {
 
 class UnlinkedFunctionExecutable final : public JSCell {
 public:
+    friend class BytecodeCacheDecoder;
+    friend class BytecodeCacheEncoder;
     friend class CodeCache;
     friend class VM;
 
@@ -105,12 +109,21 @@ public:
 
     JS_EXPORT_PRIVATE FunctionExecutable* link(VM&, const SourceCode& parentSource, std::optional<int> overrideLineNumber = std::nullopt, Intrinsic = NoIntrinsic);
 
+    bool hasUnlinkedCodeBlockFor(CodeSpecializationKind kind) const
+    {
+        return kind == CodeForCall ? !!m_unlinkedCodeBlockForCall : !!m_unlinkedCodeBlockForConstruct;
+    }
+
     void clearCode()
     {
         m_unlinkedCodeBlockForCall.clear();
         m_unlinkedCodeBlockForConstruct.clear();
     }
 
+    // True if this function, or a function nested in it, has a code block that did not come from
+    // the bytecode cache entry that this executable was decoded from.
+    bool hasCodeBlocksMissingFromCachedBytecode();
+
     void recordParse(CodeFeatures features, bool hasCapturedVariables)
     {
         m_features = features;
@@ -141,6 +154,20 @@ public:
 private:
     UnlinkedFunctionExecutable(VM*, Structure*, const SourceCode&, SourceCode&& parentSourceOverride, FunctionMetadataNode*, UnlinkedFunctionKind, ConstructAbility, JSParserScriptMode, VariableEnvironment&,  JSC::DerivedContextType);
 
+    // Creates an executable with blank fields, for the BytecodeCacheDecoder to fill in.
+    static UnlinkedFunctionExecutable* createUninitialized(VM&);
+    UnlinkedFunctionExecutable(VM*, Structure*);
+
+    UnlinkedFunctionCodeBlock* decodeCachedCodeBlock(VM&, CodeSpecializationKind);
+    void decodeCachedCodeBlocks(VM&);
+
+    bool canFlushCodeBlocks(SlotVisitor&) const;
+
+    // Ages the code blocks that survived a full collection, and forgets the ones that did not.
+    class UnconditionalFinalizer : public JSC::UnconditionalFinalizer {
+        void finalizeUnconditionally() override;
+    };
+
     unsigned m_firstLineOffset;
     unsigned m_lineCount;
     unsigned m_unlinkedFunctionNameStart;
@@ -167,6 +194,11 @@ private:
     WriteBarrier<UnlinkedFunctionCodeBlock> m_unlinkedCodeBlockForCall;
     WriteBarrier<UnlinkedFunctionCodeBlock> m_unlinkedCodeBlockForConstruct;
 
+    // Set if this executable was loaded from the bytecode cache, which still holds the code blocks.
+    RefPtr<CachedBytecode> m_cachedBytecode;
+    CachedCodeBlockLocation m_cachedCodeBlockForCall;
+    CachedCodeBlockLocation m_cachedCodeBlockForConstruct;
+
     Identifier m_name;
     Identifier m_ecmaName;
     Identifier m_inferredName;
@@ -178,6 +210,8 @@ private:
 
     VariableEnvironment m_parentScopeTDZVariables;
 
+    UnconditionalFinalizer m_unconditionalFinalizer;
+
 protected:
     static void visitChildren(JSCell*, SlotVisitor&);
 
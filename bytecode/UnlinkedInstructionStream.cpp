@@ -104,6 +104,40 @@ UnlinkedInstructionStream::UnlinkedInstructionStream(const Vector<UnlinkedInstru
     m_data = RefCountedArray<unsigned char>(buffer);
 }
 
+UnlinkedInstructionStream::UnlinkedInstructionStream(const unsigned char* packedData, size_t packedSize, unsigned instructionCount)
+    : m_data(packedSize)
+    , m_instructionCount(instructionCount)
+{
+    ASSERT(isValidPackedData(packedData, packedSize, instructionCount));
+    memcpy(m_data.data(), packedData, packedSize);
+}
+
+bool UnlinkedInstructionStream::isValidPackedData(const unsigned char* packedData, size_t packedSize, unsigned instructionCount)
+{
+    static const unsigned packedValueSizes[] = { 1, 1, 2, 2, 1, 2, 5 };
+
+    size_t index = 0;
+    unsigned count = 0;
+    while (index < packedSize) {
+        unsigned opcode = packedData[index++];
+        if (opcode >= static_cast<unsigned>(numOpcodeIDs))
+            return false;
+        unsigned opLength = opcodeLength(static_cast<OpcodeID>(opcode));
+        for (unsigned j = 1; j < opLength; ++j) {
+            if (index >= packedSize)
+                return false;
+            unsigned type = packedData[index] >> 5;
+            if (type > Full32Bit)
+                return false;
+            index += packedValueSizes[type];
+        }
+        if (index > packedSize)
+            return false;
+        count += opLength;
+    }
+    return count == instructionCount;
+}
+
 size_t UnlinkedInstructionStream::sizeInBytes() const
 {
     return m_data.size() * sizeof(unsigned char);
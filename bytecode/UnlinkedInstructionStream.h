@@ -37,8 +37,16 @@ class UnlinkedInstructionStream {
 public:
     explicit UnlinkedInstructionStream(const Vector<UnlinkedInstruction, 0, UnsafeVectorOverflow>&);
 
+    // Reconstitutes a stream from the packed bytes of another stream. This is used by the bytecode
+    // cache, which stores packedData() verbatim.
+    UnlinkedInstructionStream(const unsigned char* packedData, size_t packedSize, unsigned instructionCount);
+
     unsigned count() const { return m_instructionCount; }
     size_t sizeInBytes() const;
+    const unsigned char* packedData() const { return m_data.data(); }
+
+    // Returns true if the bytes form exactly instructionCount instructions of known opcodes.
+    static bool isValidPackedData(const unsigned char* packedData, size_t packedSize, unsigned instructionCount);
 
     class Reader {
     public:
@@ -149,9 +149,10 @@ void JITCode::optimizeAfterWarmUp(CodeBlock* codeBlock)
     if (Options::verboseOSR())
         dataLog(*codeBlock, ": FTL-optimizing after warm-up.\n");
     CodeBlock* baseline = codeBlock->baselineVersion();
-    tierUpCounter.setNewThreshold(
-        baseline->adjustedCounterValue(Options::thresholdForFTLOptimizeAfterWarmUp()),
-        baseline);
+    int32_t threshold = Options::thresholdForFTLOptimizeAfterWarmUp();
+    if (baseline->tierReachedInPreviousRun() == JITCode::FTLJIT && !baseline->reoptimizationRetryCounter())
+        threshold = Options::thresholdForFTLOptimizeSoon();
+    tierUpCounter.setNewThreshold(baseline->adjustedCounterValue(threshold), baseline);
 }
 
 void JITCode::optimizeSoon(CodeBlock* codeBlock)
@@ -56,6 +56,7 @@ size_t JITFinalizer::codeSize()
 
 bool JITFinalizer::finalize()
 {
+    m_linkBuffer->setCodeBlockForPerfLog(m_plan.codeBlock);
     m_jitCode->initializeCodeRef(
         FINALIZE_DFG_CODE(*m_linkBuffer, ("DFG JIT code for %s", toCString(CodeBlockWithJITType(m_plan.codeBlock, JITCode::DFGJIT)).data())),
         MacroAssemblerCodePtr());
@@ -70,6 +71,7 @@ bool JITFinalizer::finalize()
 bool JITFinalizer::finalizeFunction()
 {
     RELEASE_ASSERT(!m_withArityCheck.isEmptyValue());
+    m_linkBuffer->setCodeBlockForPerfLog(m_plan.codeBlock);
     m_jitCode->initializeCodeRef(
         FINALIZE_DFG_CODE(*m_linkBuffer, ("DFG JIT code for %s", toCString(CodeBlockWithJITType(m_plan.codeBlock, JITCode::DFGJIT)).data())),
         m_withArityCheck);
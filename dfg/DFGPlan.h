@@ -37,6 +37,7 @@
 #include "Operands.h"
 #include "ProfilerCompilation.h"
 #include <wtf/HashMap.h>
+#include <wtf/MonotonicTime.h>
 #include <wtf/ThreadSafeRefCounted.h>
 
 namespace JSC {
@@ -115,6 +116,11 @@ struct Plan : public ThreadSafeRefCounted<Plan> {
 
     RefPtr<DeferredCompilationCallback> callback;
 
+    // The Worklist orders its queue by these. They are guarded by the Worklist's lock.
+    MonotonicTime enqueueTime;
+    MonotonicTime lastTierUpRequestTime;
+    unsigned tierUpRequests { 0 };
+
 private:
     bool computeCompileTimes() const;
     bool reportCompileTimes() const;
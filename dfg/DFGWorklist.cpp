@@ -53,7 +53,7 @@ protected:
         if (m_worklist.m_queue.isEmpty())
             return PollResult::Wait;
         
-        m_plan = m_worklist.m_queue.takeFirst();
+        m_plan = m_worklist.takeNextPlan(locker);
         if (!m_plan) {
             if (Options::verboseCompilationQueue()) {
                 m_worklist.dump(locker, WTF::dataFile());
@@ -227,6 +227,8 @@ void Worklist::enqueue(Ref<Plan>&& plan)
         dataLog(": Enqueueing plan to optimize ", plan->key(), "\n");
     }
     ASSERT(m_plans.find(plan->key()) == m_plans.end());
+    plan->enqueueTime = MonotonicTime::now();
+    plan->lastTierUpRequestTime = plan->enqueueTime;
     m_plans.add(plan->key(), plan.copyRef());
     m_queue.append(WTFMove(plan));
     m_planEnqueued->notifyOne(locker);
@@ -238,7 +240,107 @@ Worklist::State Worklist::compilationState(CompilationKey key)
     PlanMap::iterator iter = m_plans.find(key);
     if (iter == m_plans.end())
         return NotKnown;
-    return iter->value->stage == Plan::Ready ? Compiled : Compiling;
+    if (iter->value->stage == Plan::Ready)
+        return Compiled;
+    noteTierUpRequest(locker, *iter->value);
+    return Compiling;
+}
+
+RefPtr<Plan> Worklist::takeNextPlan(const AbstractLocker& locker)
+{
+    // A plan is cold if its code has not asked to tier up for a while. Warm plans go first, then
+    // the ones whose code asked most often. Ties go to the plan that was enqueued first.
+    MonotonicTime now = MonotonicTime::now();
+    Seconds coldAge = Seconds::fromMilliseconds(Options::compilationPlanColdMilliseconds());
+    auto isWarm = [&] (Plan& plan) { return now - plan.lastTierUpRequestTime <= coldAge; };
+    
+    size_t bestIndex = 0;
+    for (size_t i = 0; i < m_queue.size(); ++i) {
+        Plan* plan = m_queue[i].get();
+        
+        // A null plan tells a thread to shut down, and that has to happen promptly.
+        if (!plan) {
+            bestIndex = i;
+            break;
+        }
+        
+        if (!i)
+            continue;
+        
+        Plan& best = *m_queue[bestIndex];
+        bool planIsWarm = isWarm(*plan);
+        bool bestIsWarm = isWarm(best);
+        if (planIsWarm != bestIsWarm) {
+            if (planIsWarm)
+                bestIndex = i;
+            continue;
+        }
+        if (plan->tierUpRequests > best.tierUpRequests)
+            bestIndex = i;
+    }
+    
+    RefPtr<Plan> result = m_queue[bestIndex];
+    m_queue.remove(bestIndex);
+    
+    if (result) {
+        Seconds latency = now - result->enqueueTime;
+        m_statistics.startedPlans++;
+        m_statistics.totalQueueLatency += latency;
+        m_statistics.maximumQueueLatency = std::max(m_statistics.maximumQueueLatency, latency);
+        if (Options::verboseCompilationQueue()) {
+            dump(locker, WTF::dataFile());
+            dataLog(": Starting ", result->key(), " after ", latency.milliseconds(), " ms in the queue and ", result->tierUpRequests, " tier-up requests\n");
+        }
+    }
+    return result;
+}
+
+void Worklist::noteTierUpRequest(const AbstractLocker&, Plan& plan)
+{
+    // Only queued plans care. Once a thread has the plan, asking again cannot make it go faster.
+    if (plan.stage != Plan::Preparing)
+        return;
+    plan.tierUpRequests++;
+    plan.lastTierUpRequestTime = MonotonicTime::now();
+}
+
+static bool isStale(Plan& plan)
+{
+    // If the code that the plan was profiled from is no longer installed, because it was jettisoned
+    // or replaced, then the result would be thrown away as soon as we tried to install it.
+    CodeBlock* baseline = plan.codeBlock->alternative();
+    CodeBlock* installed = baseline->replacement();
+    if (plan.profiledDFGCodeBlock)
+        return installed != plan.profiledDFGCodeBlock;
+    return installed != baseline;
+}
+
+void Worklist::cancelStalePlansForVM(VM& vm)
+{
+    LockHolder locker(*m_lock);
+    Vector<RefPtr<Plan>> stalePlans;
+    for (RefPtr<Plan>& plan : m_queue) {
+        if (!plan || plan->vm != &vm || plan->stage != Plan::Preparing)
+            continue;
+        if (isStale(*plan))
+            stalePlans.append(plan);
+    }
+    if (stalePlans.isEmpty())
+        return;
+    
+    for (RefPtr<Plan>& plan : stalePlans) {
+        if (Options::verboseCompilationQueue()) {
+            dump(locker, WTF::dataFile());
+            dataLog(": Cancelling stale plan for ", plan->key(), "\n");
+        }
+        m_plans.remove(plan->key());
+        plan->cancel();
+    }
+    m_queue.removeAllMatching(
+        [&] (RefPtr<Plan>& plan) -> bool {
+            return plan && plan->stage == Plan::Cancelled;
+        });
+    m_statistics.cancelledStalePlans += stalePlans.size();
 }
 
 void Worklist::waitUntilAllPlansForVMAreReady(VM& vm)
@@ -311,6 +413,7 @@ Worklist::State Worklist::completeAllReadyPlansForVM(VM& vm, CompilationKey requ
     DeferGC deferGC(vm.heap);
     Vector<RefPtr<Plan>, 8> myReadyPlans;
     
+    cancelStalePlansForVM(vm);
     removeAllReadyPlansForVM(vm, myReadyPlans);
     
     State resultingState = NotKnown;
@@ -324,6 +427,14 @@ Worklist::State Worklist::completeAllReadyPlansForVM(VM& vm, CompilationKey requ
         
         RELEASE_ASSERT(plan->stage == Plan::Ready);
         
+        {
+            LockHolder locker(*m_lock);
+            Seconds latency = MonotonicTime::now() - plan->enqueueTime;
+            m_statistics.installedPlans++;
+            m_statistics.totalInstallLatency += latency;
+            m_statistics.maximumInstallLatency = std::max(m_statistics.maximumInstallLatency, latency);
+        }
+        
         plan->finalizeAndNotifyCallback();
         
         if (currentKey == requestedKey)
@@ -332,8 +443,11 @@ Worklist::State Worklist::completeAllReadyPlansForVM(VM& vm, CompilationKey requ
     
     if (!!requestedKey && resultingState == NotKnown) {
         LockHolder locker(*m_lock);
-        if (m_plans.contains(requestedKey))
+        PlanMap::iterator iter = m_plans.find(requestedKey);
+        if (iter != m_plans.end()) {
+            noteTierUpRequest(locker, *iter->value);
             resultingState = Compiling;
+        }
     }
     
     return resultingState;
@@ -402,13 +516,10 @@ void Worklist::removeDeadPlans(VM& vm)
         if (!deadPlanKeys.isEmpty()) {
             for (HashSet<CompilationKey>::iterator iter = deadPlanKeys.begin(); iter != deadPlanKeys.end(); ++iter)
                 m_plans.take(*iter)->cancel();
-            Deque<RefPtr<Plan>> newQueue;
-            while (!m_queue.isEmpty()) {
-                RefPtr<Plan> plan = m_queue.takeFirst();
-                if (plan->stage != Plan::Cancelled)
-                    newQueue.append(plan);
-            }
-            m_queue.swap(newQueue);
+            m_queue.removeAllMatching(
+                [&] (RefPtr<Plan>& plan) -> bool {
+                    return plan && plan->stage == Plan::Cancelled;
+                });
             for (unsigned i = 0; i < m_readyPlans.size(); ++i) {
                 if (m_readyPlans[i]->stage != Plan::Cancelled)
                     continue;
@@ -448,13 +559,10 @@ void Worklist::removeNonCompilingPlansForVM(VM& vm)
     }
     for (CompilationKey key : deadPlanKeys)
         m_plans.remove(key);
-    Deque<RefPtr<Plan>> newQueue;
-    while (!m_queue.isEmpty()) {
-        RefPtr<Plan> plan = m_queue.takeFirst();
-        if (!deadPlanKeys.contains(plan->key()))
-            newQueue.append(WTFMove(plan));
-    }
-    m_queue = WTFMove(newQueue);
+    m_queue.removeAllMatching(
+        [&] (RefPtr<Plan>& plan) -> bool {
+            return plan && deadPlanKeys.contains(plan->key());
+        });
     m_readyPlans.removeAllMatching(
         [&] (RefPtr<Plan>& plan) -> bool {
             return deadPlanKeys.contains(plan->key());
@@ -469,6 +577,12 @@ size_t Worklist::queueLength()
     return m_queue.size();
 }
 
+Worklist::Statistics Worklist::statistics()
+{
+    LockHolder locker(*m_lock);
+    return m_statistics;
+}
+
 void Worklist::dump(PrintStream& out) const
 {
     LockHolder locker(*m_lock);
@@ -483,6 +597,24 @@ void Worklist::dump(const AbstractLocker&, PrintStream& out) const
         ", Num Active Threads = ", m_numberOfActiveThreads, "/", m_threads.size(), "]");
 }
 
+void Worklist::dumpStatistics(PrintStream& out)
+{
+    Statistics statistics = this->statistics();
+    out.print(m_threadName, ": ", statistics.startedPlans, " started");
+    if (statistics.startedPlans) {
+        out.print(
+            " after ", statistics.totalQueueLatency.milliseconds() / statistics.startedPlans, " ms in the queue on average",
+            " (max ", statistics.maximumQueueLatency.milliseconds(), " ms)");
+    }
+    out.print(", ", statistics.installedPlans, " installed");
+    if (statistics.installedPlans) {
+        out.print(
+            " ", statistics.totalInstallLatency.milliseconds() / statistics.installedPlans, " ms after being enqueued on average",
+            " (max ", statistics.maximumInstallLatency.milliseconds(), " ms)");
+    }
+    out.print(", ", statistics.cancelledStalePlans, " stale plans cancelled\n");
+}
+
 static Worklist* theGlobalDFGWorklist;
 
 Worklist& ensureGlobalDFGWorklist()
@@ -29,9 +29,9 @@
 #include "DFGThreadData.h"
 #include <wtf/AutomaticThread.h>
 #include <wtf/Condition.h>
-#include <wtf/Deque.h>
 #include <wtf/HashMap.h>
 #include <wtf/Lock.h>
+#include <wtf/Seconds.h>
 
 namespace JSC {
 
@@ -45,6 +45,16 @@ class Worklist : public RefCounted<Worklist> {
 public:
     enum State { NotKnown, Compiling, Compiled };
 
+    struct Statistics {
+        unsigned startedPlans { 0 };
+        unsigned installedPlans { 0 };
+        unsigned cancelledStalePlans { 0 };
+        Seconds totalQueueLatency;
+        Seconds maximumQueueLatency;
+        Seconds totalInstallLatency;
+        Seconds maximumInstallLatency;
+    };
+
     ~Worklist();
     
     static Ref<Worklist> create(CString worklistName, unsigned numberOfThreads, int relativePriority = 0);
@@ -66,6 +76,7 @@ public:
     State compilationState(CompilationKey);
     
     size_t queueLength();
+    Statistics statistics();
     
     void suspendAllThreads();
     void resumeAllThreads();
@@ -79,6 +90,7 @@ public:
     void removeNonCompilingPlansForVM(VM&);
     
     void dump(PrintStream&) const;
+    void dumpStatistics(PrintStream&);
     
 private:
     Worklist(CString worklistName);
@@ -91,13 +103,18 @@ private:
     static void threadFunction(void* argument);
     
     void removeAllReadyPlansForVM(VM&, Vector<RefPtr<Plan>, 8>&);
+    
+    RefPtr<Plan> takeNextPlan(const AbstractLocker&);
+    void noteTierUpRequest(const AbstractLocker&, Plan&);
+    void cancelStalePlansForVM(VM&);
 
     void dump(const AbstractLocker&, PrintStream&) const;
     
     CString m_threadName;
     
-    // Used to inform the thread about what work there is left to do.
-    Deque<RefPtr<Plan>> m_queue;
+    // Used to inform the thread about what work there is left to do. This is in the order that
+    // plans were enqueued, but threads take the hottest plan first; see takeNextPlan().
+    Vector<RefPtr<Plan>> m_queue;
     
     // Used to answer questions about the current state of a code block. This
     // is particularly great for the cti_optimize OSR slow path, which wants
@@ -118,6 +135,8 @@ private:
     
     Vector<std::unique_ptr<ThreadData>> m_threads;
     unsigned m_numberOfActiveThreads;
+    
+    Statistics m_statistics;
 };
 
 // For DFGMode compilations.
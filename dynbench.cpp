@@ -25,6 +25,8 @@
 
 #include "config.h"
 
+#include "Completion.h"
+#include "Exception.h"
 #include "Identifier.h"
 #include "InitializeThreading.h"
 #include "JSCInlines.h"
@@ -32,8 +34,10 @@
 #include "JSGlobalObject.h"
 #include "JSLock.h"
 #include "JSObject.h"
+#include "ParserError.h"
 #include "VM.h"
 #include <wtf/MainThread.h>
+#include <wtf/text/StringBuilder.h>
 
 using namespace JSC;
 
@@ -42,6 +46,7 @@ namespace {
 StaticLock crashLock;
 const char* nameFilter;
 unsigned requestedIterationCount;
+const char* scriptFileName;
 
 #define CHECK(x) do {                                                   \
         if (!!(x))                                                      \
@@ -66,13 +71,50 @@ NEVER_INLINE void benchmarkImpl(const char* name, unsigned iterationCount, const
     dataLog(name, ": ", after - before, " ms.\n");
 }
 
+// Resembles the output of a minifier: long identifiers and string literals on few lines, with
+// license comments and template literals in between.
+String makeMinifiedBundle(bool is8Bit)
+{
+    StringBuilder builder;
+    builder.appendLiteral("/*! A license header that minifiers keep, which is long enough to be worth skipping quickly. */\n");
+    if (!is8Bit) {
+        // A character outside Latin-1 makes the whole source 16-bit.
+        builder.appendLiteral("// ");
+        builder.append(static_cast<UChar>(0x2603));
+        builder.append('\n');
+    }
+    for (unsigned i = 0; i < 2000; ++i) {
+        builder.appendLiteral("var moduleExportsDefinition");
+        builder.appendNumber(i);
+        builder.appendLiteral("=function(exportsObjectReference,requireFunctionReference){\"use strict\";");
+        builder.appendLiteral("var errorMessage='The component could not be rendered because its properties were invalid, see the documentation';");
+        builder.appendLiteral("var templateString=`<div class=\"container-fluid component-wrapper\">${errorMessage}</div>`;");
+        builder.appendLiteral("// A single line comment that a minifier configured to keep comments left in the bundle.\n");
+        builder.appendLiteral("return exportsObjectReference.renderComponentWithProperties(requireFunctionReference,errorMessage,templateString)};\n");
+    }
+    return builder.toString();
+}
+
+String readScript(const char* fileName)
+{
+    FILE* file = fopen(fileName, "r");
+    if (!file)
+        return String();
+    Vector<char> buffer;
+    char chunk[4096];
+    while (size_t size = fread(chunk, 1, sizeof(chunk), file))
+        buffer.append(chunk, size);
+    fclose(file);
+    return String::fromUTF8WithLatin1Fallback(buffer.data(), buffer.size());
+}
+
 } // anonymous namespace
 
 int main(int argc, char** argv)
 {
     if (argc >= 2) {
         if (argv[1][0] == '-') {
-            dataLog("Usage: dynbench [<filter> [<iteration count>]]\n");
+            dataLog("Usage: dynbench [<filter> [<iteration count> [<script to parse>]]]\n");
             return 1;
         }
 
@@ -84,6 +126,9 @@ int main(int argc, char** argv)
                 return 1;
             }
         }
+
+        if (argc >= 4)
+            scriptFileName = argv[3];
     }
     
     WTF::initializeMainThread();
@@ -234,6 +279,58 @@ int main(int argc, char** argv)
                     }
                 }
             });
+
+        // Churning arrays whose butterflies are large allocations, growing each one element at a time:
+        benchmarkImpl(
+            "Large Array Churn",
+            200,
+            [&] (unsigned iterationCount) {
+                StringBuilder builder;
+                builder.appendLiteral("for (var i = 0; i < ");
+                builder.appendNumber(iterationCount);
+                builder.appendLiteral("; ++i) { var array = []; for (var j = 0; j < 30000; ++j) array.push(j); }");
+                NakedPtr<Exception> exception;
+                evaluate(exec, makeSource(builder.toString(), SourceOrigin { }), JSValue(), exception);
+                CHECK(!exception);
+            });
+
+        // A hot helper that reads and writes one property of objects with many different shapes, so
+        // that its inline caches give up:
+        benchmarkImpl(
+            "Megamorphic Get and Put",
+            200,
+            [&] (unsigned iterationCount) {
+                StringBuilder builder;
+                builder.appendLiteral("var objects = []; for (var i = 0; i < 64; ++i) { var o = {}; o['p' + i] = i; o.x = 0; objects.push(o); } ");
+                builder.appendLiteral("function touch(o) { o.x = o.x + 1; } ");
+                builder.appendLiteral("for (var i = 0; i < ");
+                builder.appendNumber(iterationCount * 1000);
+                builder.appendLiteral("; ++i) touch(objects[i & 63]);");
+                NakedPtr<Exception> exception;
+                evaluate(exec, makeSource(builder.toString(), SourceOrigin { }), JSValue(), exception);
+                CHECK(!exception);
+            });
+
+        // Parsing, which is dominated by lexing identifiers, strings and comments:
+        auto benchmarkParse = [&] (const char* name, const String& script) {
+            SourceCode source = makeSource(script, SourceOrigin { });
+            benchmarkImpl(
+                name,
+                20,
+                [&] (unsigned iterationCount) {
+                    for (unsigned i = iterationCount; i--;) {
+                        ParserError error;
+                        CHECK(checkSyntax(*vm, source, error));
+                    }
+                });
+        };
+        benchmarkParse("Parse 8-bit Minified Bundle", makeMinifiedBundle(true));
+        benchmarkParse("Parse 16-bit Minified Bundle", makeMinifiedBundle(false));
+        if (scriptFileName) {
+            String script = readScript(scriptFileName);
+            CHECK(!script.isNull());
+            benchmarkParse("Parse Script File", script);
+        }
     }
 
     crashLock.lock();
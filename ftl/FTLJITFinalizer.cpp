@@ -75,12 +75,14 @@ bool JITFinalizer::finalizeCommon()
 {
     bool dumpDisassembly = shouldDumpDisassembly() || Options::asyncDisassembly();
     
+    b3CodeLinkBuffer->setCodeBlockForPerfLog(m_plan.codeBlock);
     jitCode->initializeB3Code(
         FINALIZE_CODE_IF(
             dumpDisassembly, *b3CodeLinkBuffer,
             ("FTL B3 code for %s", toCString(CodeBlockWithJITType(m_plan.codeBlock, JITCode::FTLJIT)).data())));
 
     if (entrypointLinkBuffer) {
+        entrypointLinkBuffer->setCodeBlockForPerfLog(m_plan.codeBlock);
         jitCode->initializeArityCheckEntrypoint(
             FINALIZE_CODE_IF(
                 dumpDisassembly, *entrypointLinkBuffer,
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AllocationSamplingProfiler.h"
+
+#include "HeapCellInlines.h"
+#include "JSCInlines.h"
+#include "StackVisitor.h"
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+AllocationSamplingProfiler::AllocationSamplingProfiler(VM& vm, size_t samplingInterval)
+    : m_vm(vm)
+    , m_samplingInterval(std::max<size_t>(samplingInterval, 1))
+{
+}
+
+AllocationSamplingProfiler::~AllocationSamplingProfiler()
+{
+}
+
+void AllocationSamplingProfiler::didAllocate(HeapCell* cell, size_t bytes)
+{
+    m_bytesSinceLastSample += bytes;
+    if (m_bytesSinceLastSample < m_samplingInterval)
+        return;
+    
+    size_t sampledBytes = m_bytesSinceLastSample;
+    m_bytesSinceLastSample = 0;
+    takeSample(cell, sampledBytes);
+}
+
+void AllocationSamplingProfiler::takeSample(HeapCell* cell, size_t bytes)
+{
+    Vector<Frame> frames;
+    StringBuilder key;
+    if (CallFrame* callFrame = m_vm.topCallFrame) {
+        unsigned maxDepth = Options::allocationSamplingStackDepth();
+        StackVisitor::visit(callFrame, &m_vm, [&] (StackVisitor& visitor) -> StackVisitor::Status {
+            if (frames.size() >= maxDepth)
+                return StackVisitor::Done;
+            Frame frame;
+            frame.functionName = visitor->functionName();
+            frame.sourceURL = visitor->sourceURL();
+            if (visitor->hasLineAndColumnInfo())
+                visitor->computeLineAndColumn(frame.line, frame.column);
+            key.append(frame.functionName);
+            key.append('\t');
+            key.append(frame.sourceURL);
+            key.append('\t');
+            key.appendNumber(frame.line);
+            key.append(':');
+            key.appendNumber(frame.column);
+            key.append('\n');
+            frames.append(WTFMove(frame));
+            return StackVisitor::Continue;
+        });
+    }
+    
+    auto locker = holdLock(m_lock);
+    
+    auto result = m_siteIndices.add(key.toString(), m_sites.size());
+    if (result.isNewEntry) {
+        Site site;
+        site.frames = WTFMove(frames);
+        m_sites.append(WTFMove(site));
+    }
+    unsigned siteIndex = result.iterator->value;
+    Site& site = m_sites[siteIndex];
+    site.samples++;
+    site.totalBytes += bytes;
+    site.liveBytes += bytes;
+    
+    // A cell is only sampled once per life, but the slow path can hand out a cell that we sampled
+    // before if that cell died and a collection hasn't pruned it yet.
+    auto sampleResult = m_liveSamples.add(cell, Sample { siteIndex, bytes });
+    if (!sampleResult.isNewEntry) {
+        m_sites[sampleResult.iterator->value.siteIndex].liveBytes -= sampleResult.iterator->value.bytes;
+        sampleResult.iterator->value = Sample { siteIndex, bytes };
+    }
+}
+
+void AllocationSamplingProfiler::pruneDeadSamples()
+{
+    auto locker = holdLock(m_lock);
+    
+    Vector<HeapCell*> deadCells;
+    for (auto& entry : m_liveSamples) {
+        if (entry.key->isLive())
+            continue;
+        m_sites[entry.value.siteIndex].liveBytes -= entry.value.bytes;
+        deadCells.append(entry.key);
+    }
+    for (HeapCell* cell : deadCells)
+        m_liveSamples.remove(cell);
+}
+
+String AllocationSamplingProfiler::json()
+{
+    auto locker = holdLock(m_lock);
+    
+    Vector<const Site*> sites;
+    sites.reserveInitialCapacity(m_sites.size());
+    for (const Site& site : m_sites)
+        sites.uncheckedAppend(&site);
+    std::sort(
+        sites.begin(), sites.end(),
+        [] (const Site* a, const Site* b) -> bool {
+            return a->totalBytes > b->totalBytes;
+        });
+    
+    StringBuilder json;
+    json.appendLiteral("{\"interval\":");
+    json.appendNumber(m_samplingInterval);
+    json.appendLiteral(",\"sites\":[");
+    bool firstSite = true;
+    for (const Site* site : sites) {
+        if (!firstSite)
+            json.append(',');
+        firstSite = false;
+        json.appendLiteral("{\"samples\":");
+        json.appendNumber(site->samples);
+        json.appendLiteral(",\"totalBytes\":");
+        json.appendNumber(site->totalBytes);
+        json.appendLiteral(",\"liveBytes\":");
+        json.appendNumber(site->liveBytes);
+        json.appendLiteral(",\"frames\":[");
+        bool firstFrame = true;
+        for (const Frame& frame : site->frames) {
+            if (!firstFrame)
+                json.append(',');
+            firstFrame = false;
+            json.appendLiteral("{\"functionName\":");
+            json.appendQuotedJSONString(frame.functionName);
+            json.appendLiteral(",\"sourceURL\":");
+            json.appendQuotedJSONString(frame.sourceURL);
+            json.appendLiteral(",\"line\":");
+            json.appendNumber(frame.line);
+            json.appendLiteral(",\"column\":");
+            json.appendNumber(frame.column);
+            json.append('}');
+        }
+        json.appendLiteral("]}");
+    }
+    json.appendLiteral("]}");
+    return json.toString();
+}
+
+} // namespace JSC
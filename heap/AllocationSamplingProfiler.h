@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class HeapCell;
+class VM;
+
+// Attributes allocation to the JavaScript stacks that did it, without looking at every allocation.
+// The allocators tell the profiler how many bytes they handed out whenever they take their slow
+// path, which is once per free list for MarkedBlocks and once per object for large allocations.
+// Each time another samplingInterval bytes have gone by, the profiler walks the stack and charges
+// the bytes since the last sample to that stack's allocation site, along with the cell that the
+// slow path is about to return.
+//
+// A site's total bytes only grow. Its live bytes are the bytes charged to its samples whose cells
+// are still alive: at the end of each collection, the samples whose cells died are taken off their
+// sites.
+class AllocationSamplingProfiler {
+    WTF_MAKE_NONCOPYABLE(AllocationSamplingProfiler);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Frame {
+        String functionName;
+        String sourceURL;
+        unsigned line { 0 };
+        unsigned column { 0 };
+    };
+    
+    struct Site {
+        Vector<Frame> frames;
+        size_t samples { 0 };
+        size_t totalBytes { 0 };
+        size_t liveBytes { 0 };
+    };
+    
+    AllocationSamplingProfiler(VM&, size_t samplingInterval);
+    ~AllocationSamplingProfiler();
+    
+    size_t samplingInterval() const { return m_samplingInterval; }
+    
+    // Called by the allocators on the mutator, with the number of bytes allocated since the last
+    // call and the cell that is about to be returned.
+    void didAllocate(HeapCell*, size_t bytes);
+    
+    // Called at the end of a collection, with the world stopped and before the dead cells are swept.
+    void pruneDeadSamples();
+    
+    // {"interval": bytes, "sites": [{"samples", "totalBytes", "liveBytes", "frames": [{"functionName",
+    // "sourceURL", "line", "column"}]}]}, with the sites sorted by decreasing total bytes.
+    String json();
+    
+private:
+    struct Sample {
+        unsigned siteIndex;
+        size_t bytes;
+    };
+    
+    void takeSample(HeapCell*, size_t bytes);
+    
+    VM& m_vm;
+    size_t m_samplingInterval;
+    size_t m_bytesSinceLastSample { 0 };
+    
+    Lock m_lock;
+    Vector<Site> m_sites;
+    HashMap<String, unsigned> m_siteIndices;
+    HashMap<HeapCell*, Sample> m_liveSamples;
+};
+
+} // namespace JSC
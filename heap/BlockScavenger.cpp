@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BlockScavenger.h"
+
+#include "Heap.h"
+#include "JSCInlines.h"
+#include "MarkedSpace.h"
+
+namespace JSC {
+
+BlockScavenger::BlockScavenger(Heap* heap)
+    : Base(heap->vm())
+{
+}
+
+void BlockScavenger::didFinishCollection()
+{
+    if (!Options::useBlockScavenger() || isScheduled())
+        return;
+    scheduleTimer(Seconds(Options::blockScavengerDelay()));
+}
+
+void BlockScavenger::doWork()
+{
+    Heap& heap = m_vm->heap;
+    heap.stopIfNecessary();
+    
+    // Blocks that look empty during a collection may not be empty once it's done. We'll come back.
+    if (heap.collectionScope()) {
+        scheduleTimer(Seconds(Options::blockScavengerDelay()));
+        return;
+    }
+    
+    MonotonicTime before;
+    if (Options::logGC())
+        before = MonotonicTime::now();
+    
+    size_t numberOfDecommittedBlocks = 0;
+    size_t numberOfFreedBlocks = 0;
+    bool hasIdleBlocks = heap.objectSpace().scavenge(numberOfDecommittedBlocks, numberOfFreedBlocks);
+    
+    if (Options::logGC()) {
+        MarkedSpace& space = heap.objectSpace();
+        dataLog("[GC<", RawPointer(&heap), ">: scavenged ", numberOfDecommittedBlocks, " decommitted ", numberOfFreedBlocks, " freed, ", space.numberOfCommittedBlocks(), " committed ", space.numberOfDecommittedBlocks(), " decommitted blocks, ", (MonotonicTime::now() - before).milliseconds(), "ms]\n");
+    }
+    
+    if (hasIdleBlocks)
+        scheduleTimer(Seconds(Options::blockScavengerDelay()));
+    else
+        cancelTimer();
+}
+
+} // namespace JSC
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ConcurrentSweeper.h"
+
+#include "Heap.h"
+#include "HeapHelperPool.h"
+#include "JSCInlines.h"
+#include "MarkedAllocator.h"
+
+namespace JSC {
+
+ConcurrentSweeper::ConcurrentSweeper(Heap& heap)
+    : m_heap(heap)
+    , m_helperClient(&heapHelperPool())
+{
+    m_nextBlockIndex.store(0);
+    m_shouldStop.store(false);
+    m_isDone.store(false);
+}
+
+ConcurrentSweeper::~ConcurrentSweeper()
+{
+    RELEASE_ASSERT(!m_isSweeping);
+}
+
+void ConcurrentSweeper::startSweeping()
+{
+    RELEASE_ASSERT(!m_isSweeping);
+    
+    // With a single marker there are no helper threads to do the work. Scribbling is a debugging
+    // mode that the prepared free lists don't bother to support.
+    if (!Options::useConcurrentSweeping() || Options::numberOfGCMarkers() <= 1 || Options::scribbleFreeCells())
+        return;
+    
+    for (MarkedAllocator* allocator = m_heap.objectSpace().firstAllocator(); allocator; allocator = allocator->nextAllocator())
+        allocator->requestPreparedFreeLists(m_blocks);
+    
+    if (m_blocks.isEmpty())
+        return;
+    
+    m_isSweeping = true;
+    m_nextBlockIndex.store(0);
+    m_shouldStop.store(false);
+    m_isDone.store(false);
+    m_hasHelperTask = true;
+    m_helperClient.setFunction(
+        [this] () {
+            sweepBlocks();
+        });
+}
+
+void ConcurrentSweeper::stopSweeping()
+{
+    if (!m_isSweeping)
+        return;
+    
+    m_shouldStop.store(true);
+    if (m_hasHelperTask)
+        releaseHelpers();
+    
+    // Whatever the mutator hasn't picked up yet was built from this cycle's mark bits, so it
+    // cannot survive into the next one.
+    for (MarkedBlock::Handle* block : m_blocks)
+        block->clearPreparedFreeList();
+    m_blocks.clear();
+    m_isSweeping = false;
+}
+
+void ConcurrentSweeper::releaseHelpers()
+{
+    m_helperClient.finish();
+    m_hasHelperTask = false;
+}
+
+void ConcurrentSweeper::sweepBlocks()
+{
+    for (;;) {
+        // The task stays installed until the mutator releases it, so helpers that come back for
+        // more after the last block must not keep claiming indices.
+        if (m_shouldStop.load() || m_isDone.load())
+            return;
+        
+        unsigned index = m_nextBlockIndex.exchangeAdd(1);
+        if (index >= m_blocks.size()) {
+            m_isDone.store(true);
+            return;
+        }
+        
+        m_blocks[index]->prepareFreeList();
+    }
+}
+
+} // namespace JSC
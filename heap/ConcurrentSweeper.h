@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "MarkedBlock.h"
+#include <wtf/Atomics.h>
+#include <wtf/ParallelHelperPool.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class Heap;
+
+// Sweeps blocks on the heap helper threads while the mutator runs. Once a collection has finished
+// marking, the allocator will sweep every block that has free cells before allocating in it. For
+// blocks that don't need destruction that sweep only builds a free list, which doesn't need the
+// mutator, so this has the helper threads build them ahead of time. MarkedBlock::Handle::sweep()
+// adopts a prepared free list if there is one and sweeps the block itself if there isn't.
+//
+// The sweeper has to be stopped before the next collection starts marking, since marking changes
+// the mark bits that the free lists were built from.
+class ConcurrentSweeper {
+    WTF_MAKE_NONCOPYABLE(ConcurrentSweeper);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    ConcurrentSweeper(Heap&);
+    ~ConcurrentSweeper();
+    
+    // Call this at the end of a collection, with the world stopped.
+    void startSweeping();
+    
+    // Call this before the next collection begins marking, or before the heap is torn down.
+    void stopSweeping();
+    
+    // The mutator calls this now and then. Once the helpers have run out of blocks, it takes their
+    // task back so that the pool's threads stop picking it up. The free lists they prepared stay
+    // until stopSweeping().
+    void releaseHelpersIfDone()
+    {
+        if (m_hasHelperTask && m_isDone.load())
+            releaseHelpers();
+    }
+    
+private:
+    void sweepBlocks();
+    void releaseHelpers();
+    
+    Heap& m_heap;
+    ParallelHelperClient m_helperClient;
+    Vector<MarkedBlock::Handle*> m_blocks;
+    Atomic<unsigned> m_nextBlockIndex;
+    Atomic<bool> m_shouldStop;
+    Atomic<bool> m_isDone;
+    bool m_isSweeping { false };
+    bool m_hasHelperTask { false };
+};
+
+} // namespace JSC
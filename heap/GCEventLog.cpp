@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "GCEventLog.h"
+
+#include "Heap.h"
+#include "JSCInlines.h"
+#include "MarkedSpaceInlines.h"
+#include "SubspaceInlines.h"
+#include <wtf/DataLog.h>
+#include <wtf/FilePrintStream.h>
+#include <wtf/StringPrintStream.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+static void appendMilliseconds(StringBuilder& json, Seconds duration)
+{
+    json.appendNumber(duration.milliseconds());
+}
+
+GCEventLog::GCEventLog(Heap& heap)
+    : m_heap(heap)
+{
+}
+
+GCEventLog::~GCEventLog()
+{
+}
+
+void GCEventLog::setCallback(Callback&& callback)
+{
+    auto locker = holdLock(m_lock);
+    m_callback = WTFMove(callback);
+}
+
+bool GCEventLog::isEnabled()
+{
+    if (Options::logGCEvents())
+        return true;
+    auto locker = holdLock(m_lock);
+    return !!m_callback;
+}
+
+void GCEventLog::didChangePhase(GCConductor conn, CollectorPhase phase, MonotonicTime now)
+{
+    if (!m_currentCollection) {
+        if (phase != CollectorPhase::Begin || !isEnabled())
+            return;
+        m_currentCollection = std::make_unique<CollectionRecord>();
+        // The world was stopped for the Begin phase before we got here.
+        m_currentCollection->start = m_pauseStart ? std::min(*m_pauseStart, now) : now;
+    }
+    
+    Vector<PhaseRecord>& phases = m_currentCollection->phases;
+    if (!phases.isEmpty()) {
+        phases.last().end = now;
+        if (phases.last().conductor != conn)
+            m_currentCollection->handoffs++;
+    }
+    phases.append(PhaseRecord { phase, conn, now, now });
+}
+
+void GCEventLog::willStartCollection(CollectionScope scope)
+{
+    if (m_currentCollection)
+        m_currentCollection->scope = scope;
+}
+
+void GCEventLog::didStopTheWorld(MonotonicTime now)
+{
+    m_pauseStart = now;
+}
+
+void GCEventLog::didResumeTheWorld(MonotonicTime now)
+{
+    // The last pause of a collection is ended by didFinishCollection().
+    if (!m_pauseStart)
+        return;
+    didPause(*m_pauseStart, now);
+    m_pauseStart = std::nullopt;
+}
+
+void GCEventLog::didPause(MonotonicTime start, MonotonicTime end)
+{
+    if (m_currentCollection)
+        m_currentCollection->pauses.append(PauseRecord { start, end });
+    
+    auto locker = holdLock(m_lock);
+    unsigned windowSize = std::max(1u, Options::gcPauseHistogramSize());
+    double pauseMS = (end - start).milliseconds();
+    if (m_recentPauses.size() < windowSize) {
+        m_recentPauses.append(pauseMS);
+        return;
+    }
+    m_recentPauses[m_nextPauseIndex] = pauseMS;
+    m_nextPauseIndex = (m_nextPauseIndex + 1) % windowSize;
+}
+
+void GCEventLog::didFinishCollection(MonotonicTime now, size_t bytesVisited)
+{
+    // This is the same point that logGC measures the final pause to.
+    if (m_pauseStart) {
+        didPause(*m_pauseStart, now);
+        m_pauseStart = std::nullopt;
+    }
+    
+    m_collectionNumber++;
+    
+    std::unique_ptr<CollectionRecord> collection = WTFMove(m_currentCollection);
+    if (!collection)
+        return;
+    
+    collection->end = now;
+    if (!collection->phases.isEmpty())
+        collection->phases.last().end = now;
+    collection->bytesVisited = bytesVisited;
+    collection->committedBlocks = m_heap.objectSpace().numberOfCommittedBlocks();
+    collection->decommittedBlocks = m_heap.objectSpace().numberOfDecommittedBlocks();
+    recordSubspaces(*collection);
+    
+    CString json = toJSON(*collection);
+    auto locker = holdLock(m_lock);
+    m_pendingEvents.append(WTFMove(json));
+}
+
+void GCEventLog::recordSubspaces(CollectionRecord& collection)
+{
+    // The mark bits are still those of this collection, so the marked bytes are what survived it.
+    // Whatever was live after the previous collection, plus what has been allocated since, minus
+    // what survived is what this collection freed. Eden collections leave the old objects marked,
+    // so this works for them too.
+    m_heap.objectSpace().forEachSubspace(
+        [&] (Subspace& subspace) {
+            size_t liveBytes = 0;
+            subspace.forEachMarkedBlock(
+                [&] (MarkedBlock::Handle* handle) {
+                    if (!handle->areMarksStale())
+                        liveBytes += handle->size();
+                });
+            subspace.forEachLargeAllocation(
+                [&] (LargeAllocation* allocation) {
+                    if (allocation->isMarked())
+                        liveBytes += allocation->cellSize();
+                });
+            
+            SubspaceRecord record { subspace.name(), liveBytes, subspace.takeBytesAllocatedSinceLastCollection(), std::nullopt };
+            auto iter = m_liveBytesAfterLastCollection.find(&subspace);
+            if (iter != m_liveBytesAfterLastCollection.end()) {
+                size_t bytesBefore = iter->value + record.allocatedBytes;
+                record.freedBytes = bytesBefore > liveBytes ? bytesBefore - liveBytes : 0;
+            }
+            m_liveBytesAfterLastCollection.set(&subspace, liveBytes);
+            
+            if (record.allocatedBytes || record.liveBytes || record.freedBytes.value_or(0))
+                collection.subspaces.append(record);
+        });
+}
+
+CString GCEventLog::toJSON(const CollectionRecord& collection)
+{
+    StringBuilder json;
+    json.appendLiteral("{\"collection\":");
+    json.appendNumber(m_collectionNumber);
+    json.appendLiteral(",\"scope\":");
+    json.appendQuotedJSONString(collection.scope == CollectionScope::Full ? "Full" : "Eden");
+    json.appendLiteral(",\"duration\":");
+    appendMilliseconds(json, collection.end - collection.start);
+    json.appendLiteral(",\"bytesVisited\":");
+    json.appendNumber(collection.bytesVisited);
+    json.appendLiteral(",\"committedBlocks\":");
+    json.appendNumber(collection.committedBlocks);
+    json.appendLiteral(",\"decommittedBlocks\":");
+    json.appendNumber(collection.decommittedBlocks);
+    json.appendLiteral(",\"handoffs\":");
+    json.appendNumber(collection.handoffs);
+    
+    json.appendLiteral(",\"phases\":[");
+    for (unsigned i = 0; i < collection.phases.size(); ++i) {
+        const PhaseRecord& phase = collection.phases[i];
+        if (i)
+            json.append(',');
+        json.appendLiteral("{\"phase\":");
+        json.appendQuotedJSONString(toCString(phase.phase).data());
+        json.appendLiteral(",\"conductor\":");
+        json.appendQuotedJSONString(toCString(phase.conductor).data());
+        json.appendLiteral(",\"start\":");
+        appendMilliseconds(json, phase.start - collection.start);
+        json.appendLiteral(",\"duration\":");
+        appendMilliseconds(json, phase.end - phase.start);
+        json.append('}');
+    }
+    
+    json.appendLiteral("],\"pauses\":[");
+    for (unsigned i = 0; i < collection.pauses.size(); ++i) {
+        const PauseRecord& pause = collection.pauses[i];
+        if (i)
+            json.append(',');
+        json.appendLiteral("{\"start\":");
+        appendMilliseconds(json, pause.start - collection.start);
+        json.appendLiteral(",\"duration\":");
+        appendMilliseconds(json, pause.end - pause.start);
+        json.append('}');
+    }
+    
+    json.appendLiteral("],\"subspaces\":[");
+    for (unsigned i = 0; i < collection.subspaces.size(); ++i) {
+        const SubspaceRecord& subspace = collection.subspaces[i];
+        if (i)
+            json.append(',');
+        json.appendLiteral("{\"name\":");
+        json.appendQuotedJSONString(subspace.name);
+        json.appendLiteral(",\"liveBytes\":");
+        json.appendNumber(subspace.liveBytes);
+        json.appendLiteral(",\"allocatedBytes\":");
+        json.appendNumber(subspace.allocatedBytes);
+        if (subspace.freedBytes) {
+            json.appendLiteral(",\"freedBytes\":");
+            json.appendNumber(*subspace.freedBytes);
+        }
+        json.append('}');
+    }
+    json.appendLiteral("]}");
+    
+    return json.toString().utf8();
+}
+
+void GCEventLog::deliverEvents()
+{
+    Vector<CString> events;
+    {
+        auto locker = holdLock(m_lock);
+        if (m_pendingEvents.isEmpty())
+            return;
+        events = WTFMove(m_pendingEvents);
+    }
+    
+    if (Options::logGCEvents()) {
+        PrintStream* out = &WTF::dataFile();
+        if (const char* filename = Options::gcEventLogFile()) {
+            if (!m_file)
+                m_file = FilePrintStream::open(filename, "a");
+            if (m_file)
+                out = m_file.get();
+        }
+        for (const CString& event : events)
+            out->print(event, "\n");
+        out->flush();
+    }
+    
+    // The callback is only ever set and run by threads that hold the API lock.
+    if (!m_callback)
+        return;
+    for (const CString& event : events)
+        m_callback(event.data());
+}
+
+GCEventLog::PauseStatistics GCEventLog::pauseStatistics()
+{
+    Vector<double> pauses;
+    {
+        auto locker = holdLock(m_lock);
+        pauses = m_recentPauses;
+    }
+    
+    PauseStatistics result;
+    if (pauses.isEmpty())
+        return result;
+    
+    std::sort(pauses.begin(), pauses.end());
+    auto percentile = [&] (double fraction) -> double {
+        size_t index = static_cast<size_t>(fraction * (pauses.size() - 1) + 0.5);
+        return pauses[std::min(index, pauses.size() - 1)];
+    };
+    result.count = pauses.size();
+    result.p50 = percentile(0.50);
+    result.p99 = percentile(0.99);
+    result.max = pauses.last();
+    return result;
+}
+
+} // namespace JSC
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CollectionScope.h"
+#include "CollectorPhase.h"
+#include "GCConductor.h"
+#include <wtf/Function.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/Optional.h>
+#include <wtf/PrintStream.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class Heap;
+class Subspace;
+
+// Describes each collection as one line of JSON: its scope, the phases it went through with the
+// conductor that ran each of them, the times the mutator was paused, how many bytes were visited
+// and how many bytes each Subspace freed. The lines are built by the collector and handed to the
+// data file (or Options::gcEventLogFile()) and to the client's callback when the mutator finalizes
+// the collection.
+//
+// It also keeps the lengths of the most recent pauses, whether or not anyone is listening for
+// events, so that clients can ask for pause percentiles at any time.
+class GCEventLog {
+    WTF_MAKE_NONCOPYABLE(GCEventLog);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    typedef WTF::Function<void(const char*)> Callback;
+    
+    struct PauseStatistics {
+        unsigned count { 0 };
+        double p50 { 0 };
+        double p99 { 0 };
+        double max { 0 };
+    };
+    
+    GCEventLog(Heap&);
+    ~GCEventLog();
+    
+    void setCallback(Callback&&);
+    
+    // These are called by the collector, from whichever thread has the conn.
+    void didChangePhase(GCConductor, CollectorPhase, MonotonicTime);
+    void willStartCollection(CollectionScope);
+    void didStopTheWorld(MonotonicTime);
+    void didResumeTheWorld(MonotonicTime);
+    void didFinishCollection(MonotonicTime, size_t bytesVisited);
+    
+    // Called by the mutator with heap access once the collection has been finalized.
+    void deliverEvents();
+    
+    // Pause lengths are in milliseconds.
+    PauseStatistics pauseStatistics();
+    
+private:
+    struct PhaseRecord {
+        CollectorPhase phase;
+        GCConductor conductor;
+        MonotonicTime start;
+        MonotonicTime end;
+    };
+    
+    struct PauseRecord {
+        MonotonicTime start;
+        MonotonicTime end;
+    };
+    
+    struct SubspaceRecord {
+        const char* name;
+        size_t liveBytes;
+        size_t allocatedBytes;
+        std::optional<size_t> freedBytes;
+    };
+    
+    struct CollectionRecord {
+        CollectionScope scope { CollectionScope::Eden };
+        MonotonicTime start;
+        MonotonicTime end;
+        Vector<PhaseRecord> phases;
+        Vector<PauseRecord> pauses;
+        unsigned handoffs { 0 };
+        size_t bytesVisited { 0 };
+        size_t committedBlocks { 0 };
+        size_t decommittedBlocks { 0 };
+        Vector<SubspaceRecord> subspaces;
+    };
+    
+    bool isEnabled();
+    void didPause(MonotonicTime start, MonotonicTime end);
+    void recordSubspaces(CollectionRecord&);
+    CString toJSON(const CollectionRecord&);
+    
+    Heap& m_heap;
+    
+    // Only the thread that has the conn touches these.
+    std::unique_ptr<CollectionRecord> m_currentCollection;
+    std::optional<MonotonicTime> m_pauseStart;
+    HashMap<Subspace*, size_t> m_liveBytesAfterLastCollection;
+    unsigned m_collectionNumber { 0 };
+    
+    Lock m_lock;
+    Callback m_callback;
+    Vector<CString> m_pendingEvents;
+    Vector<double> m_recentPauses;
+    unsigned m_nextPauseIndex { 0 };
+    std::unique_ptr<PrintStream> m_file;
+};
+
+} // namespace JSC
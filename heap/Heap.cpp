@@ -21,15 +21,19 @@
 #include "config.h"
 #include "Heap.h"
 
+#include "AllocationSamplingProfiler.h"
+#include "BlockScavenger.h"
 #include "CodeBlock.h"
 #include "CodeBlockSetInlines.h"
 #include "CollectingScope.h"
+#include "ConcurrentSweeper.h"
 #include "ConservativeRoots.h"
 #include "DFGWorklistInlines.h"
 #include "EdenGCActivityCallback.h"
 #include "Exception.h"
 #include "FullGCActivityCallback.h"
 #include "GCActivityCallback.h"
+#include "GCEventLog.h"
 #include "GCIncomingRefCountedSetInlines.h"
 #include "GCSegmentedArrayInlines.h"
 #include "GCTypeMap.h"
@@ -52,6 +56,7 @@
 #include "MarkedAllocatorInlines.h"
 #include "MarkedSpaceInlines.h"
 #include "MarkingConstraintSet.h"
+#include "MegamorphicCache.h"
 #include "PreventCollectionScope.h"
 #include "SamplingProfiler.h"
 #include "ShadowChicken.h"
@@ -60,6 +65,7 @@
 #include "SuperSampler.h"
 #include "StochasticSpaceTimeMutatorScheduler.h"
 #include "StopIfNecessaryTimer.h"
+#include "StringDeduplicator.h"
 #include "SweepingScope.h"
 #include "SynchronousStopTheWorldMutatorScheduler.h"
 #include "TypeProfiler.h"
@@ -294,6 +300,10 @@ Heap::Heap(VM* vm, HeapType heapType)
     , m_fullActivityCallback(GCActivityCallback::createFullTimer(this))
     , m_edenActivityCallback(GCActivityCallback::createEdenTimer(this))
     , m_sweeper(adoptRef(new IncrementalSweeper(this)))
+    , m_blockScavenger(adoptRef(new BlockScavenger(this)))
+    , m_concurrentSweeper(std::make_unique<ConcurrentSweeper>(*this))
+    , m_eventLog(std::make_unique<GCEventLog>(*this))
+    , m_stringDeduplicator(std::make_unique<StringDeduplicator>(*this))
     , m_stopIfNecessaryTimer(adoptRef(new StopIfNecessaryTimer(vm)))
     , m_deferralDepth(0)
 #if USE(FOUNDATION)
@@ -307,6 +317,11 @@ Heap::Heap(VM* vm, HeapType heapType)
 {
     m_worldState.store(0);
     
+    // The collector and mutator visitors, plus one for each helper thread.
+    m_numberOfStealableSlotVisitors.store(0);
+    m_stealableSlotVisitorsCapacity = Options::numberOfGCMarkers() + 1;
+    m_stealableSlotVisitors = std::make_unique<SlotVisitor*[]>(m_stealableSlotVisitorsCapacity);
+    
     if (Options::useConcurrentGC()) {
         if (Options::useStochasticMutatorScheduler())
             m_scheduler = std::make_unique<StochasticSpaceTimeMutatorScheduler>(*this);
@@ -429,6 +444,8 @@ void Heap::lastChanceToFinalize()
     
     m_arrayBuffers.lastChanceToFinalize();
     m_codeBlocks->lastChanceToFinalize(*m_vm);
+    m_concurrentSweeper->stopSweeping();
+    m_blockScavenger->cancelTimer();
     m_objectSpace.stopAllocating();
     m_objectSpace.lastChanceToFinalize();
     releaseDelayedReleasedObjects();
@@ -740,6 +757,17 @@ void Heap::updateObjectCounts()
 
 void Heap::endMarking()
 {
+    if (Options::logMarkerUtilization()) {
+        CommaPrinter comma;
+        dataLog("[GC<", RawPointer(this), ">: marker utilization: ");
+        forEachSlotVisitor(
+            [&] (SlotVisitor& visitor) {
+                dataLog(comma);
+                visitor.dumpUtilization(WTF::dataFile());
+            });
+        dataLog("]\n");
+    }
+    
     forEachSlotVisitor(
         [&] (SlotVisitor& visitor) {
             visitor.reset();
@@ -747,6 +775,7 @@ void Heap::endMarking()
 
     assertSharedMarkStacksEmpty();
     m_weakReferenceHarvesters.removeAll();
+    m_ephemeronTables.removeAll();
 
     RELEASE_ASSERT(m_raceMarkStack->isEmpty());
     
@@ -1182,6 +1211,10 @@ NEVER_INLINE bool Heap::runBeginPhase(GCConductor conn)
     }
     
     willStartCollection();
+    m_eventLog->willStartCollection(*m_collectionScope);
+    
+    // Marking is about to change the mark bits that the prepared free lists were built from.
+    m_concurrentSweeper->stopSweeping();
         
     if (UNLIKELY(m_verifier)) {
         // Verify that live objects from the last GC cycle haven't been corrupted by
@@ -1428,6 +1461,8 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
         
     reapWeakHandles();
     pruneStaleEntriesFromWeakGCMaps();
+    if (AllocationSamplingProfiler* profiler = vm()->allocationSamplingProfiler())
+        profiler->pruneDeadSamples();
     sweepArrayBuffers();
     snapshotUnswept();
     finalizeUnconditionalFinalizers();
@@ -1441,6 +1476,7 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
     m_codeBlocks->clearCurrentlyExecuting();
         
     m_objectSpace.prepareForAllocation();
+    m_concurrentSweeper->startSweeping();
     updateAllocationLimits();
 
     if (UNLIKELY(m_verifier)) {
@@ -1449,6 +1485,7 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
     }
 
     didFinishCollection();
+    m_eventLog->didFinishCollection(m_afterGC, m_totalBytesVisitedThisCycle);
     
     if (m_currentRequest.didFinishEndPhase)
         m_currentRequest.didFinishEndPhase->run();
@@ -1533,6 +1570,7 @@ NEVER_INLINE bool Heap::finishChangingPhase(GCConductor conn)
     }
     
     m_currentPhase = m_nextPhase;
+    m_eventLog->didChangePhase(conn, m_currentPhase, MonotonicTime::now());
     return true;
 }
 
@@ -1573,6 +1611,7 @@ void Heap::stopThePeriphery(GCConductor conn)
     m_objectSpace.stopAllocating();
     
     m_stopTime = MonotonicTime::now();
+    m_eventLog->didStopTheWorld(m_stopTime);
 }
 
 NEVER_INLINE void Heap::resumeThePeriphery()
@@ -1582,6 +1621,7 @@ NEVER_INLINE void Heap::resumeThePeriphery()
     // - At end of collection cycle: it's a no-op because prepareForAllocation already cleared the
     //   last active block.
     // - During collection cycle: it reinstates the last active block.
+    m_eventLog->didResumeTheWorld(MonotonicTime::now());
     m_objectSpace.resumeAllocating();
     
     m_barriersExecuted = 0;
@@ -2005,9 +2045,18 @@ void Heap::finalize()
     if (HasOwnPropertyCache* cache = vm()->hasOwnPropertyCache())
         cache->clear();
     
+    if (MegamorphicCache* cache = vm()->megamorphicCache())
+        cache->clear();
+    
     for (const HeapFinalizerCallback& callback : m_heapFinalizerCallbacks)
         callback.run(*vm());
     
+    m_eventLog->deliverEvents();
+    
+    m_stringDeduplicator->didFinishCollection(*m_lastCollectionScope);
+    m_blockScavenger->didFinishCollection();
+    checkHeapLimits();
+    
     if (Options::sweepSynchronously())
         sweepSynchronously();
 
@@ -2241,6 +2290,14 @@ void Heap::updateAllocationLimits()
     m_sizeAfterLastCollect = currentHeapSize;
     if (verbose)
         dataLog("sizeAfterLastCollect = ", m_sizeAfterLastCollect, "\n");
+    
+    if (m_hardHeapLimit && currentHeapSize > m_hardHeapLimit) {
+        // An eden collection can't free old objects, so try a full one before giving up.
+        if (m_collectionScope == CollectionScope::Full)
+            m_didExceedHardHeapLimit = true;
+        else
+            m_shouldDoFullCollection = true;
+    }
     m_bytesAllocatedThisCycle = 0;
     m_webAssemblyFastMemoriesAllocatedThisCycle = 0;
 
@@ -2248,6 +2305,36 @@ void Heap::updateAllocationLimits()
         dataLog("=> ", currentHeapSize / 1024, "kb, ");
 }
 
+size_t Heap::bytesAllowedBeforeHardHeapLimit()
+{
+    // Collect more often as the heap approaches its hard limit, but not so often that a heap that
+    // stays over the limit does nothing but collect.
+    size_t minimum = m_hardHeapLimit / 16;
+    if (m_sizeAfterLastCollect >= m_hardHeapLimit)
+        return minimum;
+    return std::max(m_hardHeapLimit - m_sizeAfterLastCollect, minimum);
+}
+
+void Heap::setHeapLimits(size_t softLimit, size_t hardLimit, HeapLimitCallback&& softLimitCallback)
+{
+    m_softHeapLimit = softLimit;
+    m_hardHeapLimit = hardLimit;
+    m_softHeapLimitCallback = WTFMove(softLimitCallback);
+    m_wasOverSoftHeapLimit = false;
+    m_didExceedHardHeapLimit = false;
+}
+
+void Heap::checkHeapLimits()
+{
+    bool isOverSoftHeapLimit = m_softHeapLimit && m_sizeAfterLastCollect > m_softHeapLimit;
+    if (isOverSoftHeapLimit && !m_wasOverSoftHeapLimit && m_softHeapLimitCallback)
+        m_softHeapLimitCallback(m_sizeAfterLastCollect);
+    m_wasOverSoftHeapLimit = isOverSoftHeapLimit;
+    
+    if (std::exchange(m_didExceedHardHeapLimit, false))
+        m_vm->notifyNeedHeapLimitCheck();
+}
+
 void Heap::didFinishCollection()
 {
     m_afterGC = MonotonicTime::now();
@@ -2300,6 +2387,11 @@ IncrementalSweeper& Heap::sweeper()
     return *m_sweeper;
 }
 
+BlockScavenger& Heap::blockScavenger()
+{
+    return *m_blockScavenger;
+}
+
 void Heap::setGarbageCollectionTimerEnabled(bool enable)
 {
     if (m_fullActivityCallback)
@@ -2373,7 +2465,8 @@ bool Heap::shouldDoFullCollection()
         return true;
 
     if (!m_currentRequest.scope)
-        return m_shouldDoFullCollection || webAssemblyFastMemoriesThisCycleAtThreshold() || overCriticalMemoryThreshold();
+        return m_shouldDoFullCollection || webAssemblyFastMemoriesThisCycleAtThreshold() || overCriticalMemoryThreshold()
+            || (m_hardHeapLimit && m_bytesAllocatedThisCycle > bytesAllowedBeforeHardHeapLimit());
     return *m_currentRequest.scope == CollectionScope::Full;
 }
 
@@ -2508,6 +2601,7 @@ void Heap::collectIfNecessaryOrDefer(GCDeferralContext* deferralContext)
     case MutatorState::Collecting:
         return;
     }
+    m_concurrentSweeper->releaseHelpersIfDone();
     if (!Options::useGC())
         return;
     
@@ -2531,6 +2625,9 @@ void Heap::collectIfNecessaryOrDefer(GCDeferralContext* deferralContext)
             bytesAllowedThisCycle = std::min(m_maxEdenSizeWhenCritical, bytesAllowedThisCycle);
 #endif
 
+        if (m_hardHeapLimit)
+            bytesAllowedThisCycle = std::min(bytesAllowedBeforeHardHeapLimit(), bytesAllowedThisCycle);
+
         if (!webAssemblyFastMemoriesThisCycleAtThreshold()
             && m_bytesAllocatedThisCycle <= bytesAllowedThisCycle)
             return;
@@ -2600,6 +2697,8 @@ void Heap::addCoreConstraints()
             gatherStackRoots(conservativeRoots);
             gatherJSStackRoots(conservativeRoots);
             gatherScratchBufferRoots(conservativeRoots);
+            if (*m_collectionScope == CollectionScope::Full)
+                m_stringDeduplicator->didGatherConservativeRoots(conservativeRoots);
             slotVisitor.append(conservativeRoots);
         },
         ConstraintVolatility::GreyedByExecution);
@@ -2675,6 +2774,14 @@ void Heap::addCoreConstraints()
         },
         ConstraintVolatility::GreyedByMarking);
     
+    m_constraintSet->add(
+        "Et", "Ephemeron Tables",
+        [this] (SlotVisitor& slotVisitor, const VisitingTimeout&) {
+            for (EphemeronTable* current = m_ephemeronTables.head(); current; current = current->next())
+                current->visitEphemerons(slotVisitor);
+        },
+        ConstraintVolatility::GreyedByMarking);
+    
 #if ENABLE(DFG_JIT)
     m_constraintSet->add(
         "Dw", "DFG Worklists",
@@ -2818,6 +2925,22 @@ void Heap::forEachSlotVisitor(const Func& func)
         func(*slotVisitor);
 }
 
+bool Heap::addStealableSlotVisitor(SlotVisitor& visitor, unsigned& stealCursor)
+{
+    ASSERT(m_parallelSlotVisitorLock.isHeld());
+    
+    unsigned index = m_numberOfStealableSlotVisitors.load();
+    if (index >= m_stealableSlotVisitorsCapacity)
+        return false;
+    
+    m_stealableSlotVisitors[index] = &visitor;
+    m_numberOfStealableSlotVisitors.store(index + 1);
+    
+    // Spread the markers out so that they don't all go after the same victim first.
+    stealCursor = index + 1;
+    return true;
+}
+
 void Heap::setMutatorShouldBeFenced(bool value)
 {
     m_mutatorShouldBeFenced = value;
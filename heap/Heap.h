@@ -26,6 +26,7 @@
 #include "CollectionScope.h"
 #include "CollectorPhase.h"
 #include "DeleteAllCodeEffort.h"
+#include "EphemeronTable.h"
 #include "GCConductor.h"
 #include "GCIncomingRefCountedSet.h"
 #include "GCRequest.h"
@@ -45,6 +46,7 @@
 #include "WeakReferenceHarvester.h"
 #include <wtf/AutomaticThread.h>
 #include <wtf/Deque.h>
+#include <wtf/Function.h>
 #include <wtf/HashCountedSet.h>
 #include <wtf/HashSet.h>
 #include <wtf/ParallelHelperPool.h>
@@ -52,11 +54,14 @@
 
 namespace JSC {
 
+class BlockScavenger;
 class CodeBlock;
 class CodeBlockSet;
 class CollectingScope;
+class ConcurrentSweeper;
 class ConservativeRoots;
 class GCDeferralContext;
+class GCEventLog;
 class EdenGCActivityCallback;
 class ExecutableBase;
 class FullGCActivityCallback;
@@ -82,6 +87,7 @@ class RunningScope;
 class SlotVisitor;
 class SpaceTimeMutatorScheduler;
 class StopIfNecessaryTimer;
+class StringDeduplicator;
 class SweepingScope;
 class VM;
 struct CurrentThreadState;
@@ -146,6 +152,7 @@ public:
     JS_EXPORT_PRIVATE void setGarbageCollectionTimerEnabled(bool);
 
     JS_EXPORT_PRIVATE IncrementalSweeper& sweeper();
+    JS_EXPORT_PRIVATE BlockScavenger& blockScavenger();
 
     void addObserver(HeapObserver* observer) { m_observers.append(observer); }
     void removeObserver(HeapObserver* observer) { m_observers.removeFirst(observer); }
@@ -367,6 +374,18 @@ public:
 
     HeapVerifier* verifier() const { return m_verifier.get(); }
     
+    GCEventLog& eventLog() { return *m_eventLog; }
+    
+    // Per-VM memory budget, measured the way the collection heuristics measure the heap: the bytes
+    // that survived the last collection, including extra memory, plus the bytes allocated since.
+    // Crossing the soft limit after a collection calls the callback. Nearing the hard limit makes
+    // collections more frequent and full; if a full collection can't get the heap back under it,
+    // the VM throws an out of memory error at its next trap check. Zero means no limit.
+    typedef WTF::Function<void(size_t heapSize)> HeapLimitCallback;
+    JS_EXPORT_PRIVATE void setHeapLimits(size_t softLimit, size_t hardLimit, HeapLimitCallback&&);
+    size_t sizeForHeapLimits() const { return m_sizeAfterLastCollect + m_bytesAllocatedThisCycle; }
+    bool isOverHardHeapLimit() const { return m_hardHeapLimit && m_sizeAfterLastCollect > m_hardHeapLimit; }
+    
     void addHeapFinalizerCallback(const HeapFinalizerCallback&);
     void removeHeapFinalizerCallback(const HeapFinalizerCallback&);
 
@@ -391,6 +410,7 @@ private:
     friend class SlotVisitor;
     friend class SpaceTimeMutatorScheduler;
     friend class StochasticSpaceTimeMutatorScheduler;
+    friend class StringDeduplicator;
     friend class SweepingScope;
     friend class IncrementalSweeper;
     friend class HeapStatistics;
@@ -496,6 +516,8 @@ private:
     void deleteUnmarkedCompiledCode();
     JS_EXPORT_PRIVATE void addToRememberedSet(const JSCell*);
     void updateAllocationLimits();
+    size_t bytesAllowedBeforeHardHeapLimit();
+    void checkHeapLimits();
     void didFinishCollection();
     void resumeCompilerThreads();
     void gatherExtraHeapSnapshotData(HeapProfiler&);
@@ -556,6 +578,11 @@ private:
     bool m_shouldDoFullCollection;
     size_t m_totalBytesVisited;
     size_t m_totalBytesVisitedThisCycle;
+    size_t m_softHeapLimit { 0 };
+    size_t m_hardHeapLimit { 0 };
+    HeapLimitCallback m_softHeapLimitCallback;
+    bool m_wasOverSoftHeapLimit { false };
+    bool m_didExceedHardHeapLimit { false };
     double m_incrementBalance { 0 };
     
     std::optional<CollectionScope> m_collectionScope;
@@ -591,8 +618,17 @@ private:
     Vector<SlotVisitor*> m_availableParallelSlotVisitors;
     Lock m_parallelSlotVisitorLock;
     
+    // The slot visitors whose mark stack deques other markers may steal from. Visitors are only
+    // ever added, while holding m_parallelSlotVisitorLock, and the array never grows, so markers
+    // read it without locking.
+    std::unique_ptr<SlotVisitor*[]> m_stealableSlotVisitors;
+    unsigned m_stealableSlotVisitorsCapacity { 0 };
+    Atomic<unsigned> m_numberOfStealableSlotVisitors;
+    
     template<typename Func>
     void forEachSlotVisitor(const Func&);
+    
+    bool addStealableSlotVisitor(SlotVisitor&, unsigned& stealCursor);
 
     HandleSet m_handleSet;
     HandleStack m_handleStack;
@@ -617,6 +653,10 @@ private:
     RefPtr<FullGCActivityCallback> m_fullActivityCallback;
     RefPtr<GCActivityCallback> m_edenActivityCallback;
     RefPtr<IncrementalSweeper> m_sweeper;
+    RefPtr<BlockScavenger> m_blockScavenger;
+    std::unique_ptr<ConcurrentSweeper> m_concurrentSweeper;
+    std::unique_ptr<GCEventLog> m_eventLog;
+    std::unique_ptr<StringDeduplicator> m_stringDeduplicator;
     RefPtr<StopIfNecessaryTimer> m_stopIfNecessaryTimer;
 
     Vector<HeapObserver*> m_observers;
@@ -651,6 +691,7 @@ private:
     static const size_t s_blockFragmentLength = 32;
 
     ListableHandler<WeakReferenceHarvester>::List m_weakReferenceHarvesters;
+    ListableHandler<EphemeronTable>::List m_ephemeronTables;
     ListableHandler<UnconditionalFinalizer>::List m_unconditionalFinalizers;
 
     ParallelHelperClient m_helperClient;
@@ -30,11 +30,11 @@
 #include "Heap.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshot.h"
+#include "HeapSnapshotWriter.h"
 #include "JSCInlines.h"
 #include "JSCell.h"
 #include "PreventCollectionScope.h"
 #include "VM.h"
-#include <wtf/text/StringBuilder.h>
 
 namespace JSC {
     
@@ -131,75 +131,24 @@ bool HeapSnapshotBuilder::hasExistingNodeForCell(JSCell* cell)
     return !!m_snapshot->previous()->nodeForCell(cell);
 }
 
-
-// Heap Snapshot JSON Format:
-//
-//   {
-//      "version": 1.0,
-//      "nodes": [
-//          <nodeId>, <sizeInBytes>, <nodeClassNameIndex>, <internal>,
-//          <nodeId>, <sizeInBytes>, <nodeClassNameIndex>, <internal>,
-//          ...
-//      ],
-//      "nodeClassNames": [
-//          "string", "Structure", "Object", ...
-//      ],
-//      "edges": [
-//          <fromNodeId>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>,
-//          <fromNodeId>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>,
-//          ...
-//      ],
-//      "edgeTypes": [
-//          "Internal", "Property", "Index", "Variable"
-//      ],
-//      "edgeNames": [
-//          "propertyName", "variableName", ...
-//      ]
-//   }
-//
-// Notes:
-//
-//     <nodeClassNameIndex>
-//       - index into the "nodeClassNames" list.
-//
-//     <internal>
-//       - 0 = false, 1 = true.
-//
-//     <edgeTypeIndex>
-//       - index into the "edgeTypes" list.
-//
-//     <edgeExtraData>
-//       - for Internal edges this should be ignored (0).
-//       - for Index edges this is the index value.
-//       - for Property or Variable edges this is an index into the "edgeNames" list.
-
-static uint8_t edgeTypeToNumber(EdgeType type)
+String HeapSnapshotBuilder::json()
 {
-    return static_cast<uint8_t>(type);
+    return json([] (const HeapSnapshotNode&) { return true; });
 }
 
-static const char* edgeTypeToString(EdgeType type)
+String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> allowNodeCallback)
 {
-    switch (type) {
-    case EdgeType::Internal:
-        return "Internal";
-    case EdgeType::Property:
-        return "Property";
-    case EdgeType::Index:
-        return "Index";
-    case EdgeType::Variable:
-        return "Variable";
-    }
-    ASSERT_NOT_REACHED();
-    return "Internal";
+    HeapSnapshotJSONWriter writer;
+    write(writer, allowNodeCallback);
+    return writer.takeString();
 }
 
-String HeapSnapshotBuilder::json()
+bool HeapSnapshotBuilder::write(HeapSnapshotWriter& writer)
 {
-    return json([] (const HeapSnapshotNode&) { return true; });
+    return write(writer, [] (const HeapSnapshotNode&) { return true; });
 }
 
-String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> allowNodeCallback)
+bool HeapSnapshotBuilder::write(HeapSnapshotWriter& writer, std::function<bool (const HeapSnapshotNode&)> allowNodeCallback)
 {
     VM& vm = m_profiler.vm();
     DeferGCForAWhile deferGC(vm.heap);
@@ -210,24 +159,24 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
     // Build a list of used class names.
     HashMap<const char*, unsigned> classNameIndexes;
     classNameIndexes.set("<root>", 0);
+    writer.appendClassName(0, "<root>");
     unsigned nextClassNameIndex = 1;
 
     // Build a list of used edge names.
     HashMap<UniquedStringImpl*, unsigned> edgeNameIndexes;
     unsigned nextEdgeNameIndex = 0;
 
-    StringBuilder json;
-
-    auto appendNodeJSON = [&] (const HeapSnapshotNode& node) {
+    auto appendNode = [&] (const HeapSnapshotNode& node) {
         // Let the client decide if they want to allow or disallow certain nodes.
         if (!allowNodeCallback(node))
             return;
 
         allowedNodeIdentifiers.set(node.cell, node.identifier);
 
-        auto result = classNameIndexes.add(node.cell->classInfo(vm)->className, nextClassNameIndex);
+        const char* className = node.cell->classInfo(vm)->className;
+        auto result = classNameIndexes.add(className, nextClassNameIndex);
         if (result.isNewEntry)
-            nextClassNameIndex++;
+            writer.appendClassName(nextClassNameIndex++, className);
         unsigned classNameIndex = result.iterator->value;
 
         bool isInternal = false;
@@ -236,83 +185,37 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
             isInternal = !structure || !structure->globalObject();
         }
 
-        // <nodeId>, <sizeInBytes>, <className>, <optionalInternalBoolean>
-        json.append(',');
-        json.appendNumber(node.identifier);
-        json.append(',');
-        json.appendNumber(node.cell->estimatedSizeInBytes());
-        json.append(',');
-        json.appendNumber(classNameIndex);
-        json.append(',');
-        json.append(isInternal ? '1' : '0');
+        writer.appendNode(node.identifier, node.cell->estimatedSizeInBytes(), classNameIndex, isInternal);
     };
 
-    bool firstEdge = true;
-    auto appendEdgeJSON = [&] (const HeapSnapshotEdge& edge) {
-        if (!firstEdge)
-            json.append(',');
-        firstEdge = false;
-
-        // <fromNodeId>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>
-        json.appendNumber(edge.from.identifier);
-        json.append(',');
-        json.appendNumber(edge.to.identifier);
-        json.append(',');
-        json.appendNumber(edgeTypeToNumber(edge.type));
-        json.append(',');
+    auto appendEdge = [&] (const HeapSnapshotEdge& edge) {
+        unsigned extraData = 0;
         switch (edge.type) {
         case EdgeType::Property:
         case EdgeType::Variable: {
             auto result = edgeNameIndexes.add(edge.u.name, nextEdgeNameIndex);
             if (result.isNewEntry)
-                nextEdgeNameIndex++;
-            unsigned edgeNameIndex = result.iterator->value;
-            json.appendNumber(edgeNameIndex);
+                writer.appendEdgeName(nextEdgeNameIndex++, edge.u.name);
+            extraData = result.iterator->value;
             break;
         }
         case EdgeType::Index:
-            json.appendNumber(edge.u.index);
+            extraData = edge.u.index;
             break;
         default:
             // No data for this edge type.
-            json.append('0');
             break;
         }
+        writer.appendEdge(edge.from.identifier, edge.to.identifier, edge.type, extraData);
     };
 
-    json.append('{');
-
-    // version
-    json.appendLiteral("\"version\":1");
-
-    // nodes
-    json.append(',');
-    json.appendLiteral("\"nodes\":");
-    json.append('[');
-    json.appendLiteral("0,0,0,0"); // <root>
+    writer.appendNode(0, 0, 0, false); // <root>
     for (HeapSnapshot* snapshot = m_profiler.mostRecentSnapshot(); snapshot; snapshot = snapshot->previous()) {
         for (auto& node : snapshot->m_nodes)
-            appendNodeJSON(node);
+            appendNode(node);
     }
-    json.append(']');
-
-    // node class names
-    json.append(',');
-    json.appendLiteral("\"nodeClassNames\":");
-    json.append('[');
-    Vector<const char *> orderedClassNames(classNameIndexes.size());
-    for (auto& entry : classNameIndexes)
-        orderedClassNames[entry.value] = entry.key;
     classNameIndexes.clear();
-    bool firstClassName = true;
-    for (auto& className : orderedClassNames) {
-        if (!firstClassName)
-            json.append(',');
-        firstClassName = false;
-        json.appendQuotedJSONString(className);
-    }
-    orderedClassNames.clear();
-    json.append(']');
+    writer.didAppendNodes();
 
     // Process edges.
     // Replace pointers with identifiers.
@@ -347,47 +250,11 @@ String HeapSnapshotBuilder::json(std::function<bool (const HeapSnapshotNode&)> a
         return a.from.identifier < b.from.identifier;
     });
 
-    // edges
-    json.append(',');
-    json.appendLiteral("\"edges\":");
-    json.append('[');
     for (auto& edge : m_edges)
-        appendEdgeJSON(edge);
-    json.append(']');
-
-    // edge types
-    json.append(',');
-    json.appendLiteral("\"edgeTypes\":");
-    json.append('[');
-    json.appendQuotedJSONString(edgeTypeToString(EdgeType::Internal));
-    json.append(',');
-    json.appendQuotedJSONString(edgeTypeToString(EdgeType::Property));
-    json.append(',');
-    json.appendQuotedJSONString(edgeTypeToString(EdgeType::Index));
-    json.append(',');
-    json.appendQuotedJSONString(edgeTypeToString(EdgeType::Variable));
-    json.append(']');
-
-    // edge names
-    json.append(',');
-    json.appendLiteral("\"edgeNames\":");
-    json.append('[');
-    Vector<UniquedStringImpl*> orderedEdgeNames(edgeNameIndexes.size());
-    for (auto& entry : edgeNameIndexes)
-        orderedEdgeNames[entry.value] = entry.key;
-    edgeNameIndexes.clear();
-    bool firstEdgeName = true;
-    for (auto& edgeName : orderedEdgeNames) {
-        if (!firstEdgeName)
-            json.append(',');
-        firstEdgeName = false;
-        json.appendQuotedJSONString(edgeName);
-    }
-    orderedEdgeNames.clear();
-    json.append(']');
+        appendEdge(edge);
+    writer.didAppendEdges();
 
-    json.append('}');
-    return json.toString();
+    return !writer.didFail();
 }
 
 } // namespace JSC
@@ -35,6 +35,7 @@ namespace JSC {
 
 class HeapProfiler;
 class HeapSnapshot;
+class HeapSnapshotWriter;
 class JSCell;
 
 struct HeapSnapshotNode {
@@ -123,6 +124,11 @@ public:
     String json();
     String json(std::function<bool (const HeapSnapshotNode&)> allowNodeCallback);
 
+    // Hands the snapshot to the writer a node or an edge at a time. Returns false if the writer
+    // failed to write its output.
+    bool write(HeapSnapshotWriter&);
+    bool write(HeapSnapshotWriter&, std::function<bool (const HeapSnapshotNode&)> allowNodeCallback);
+
 private:
     // Finalized snapshots are not modified during building. So searching them
     // for an existing node can be done concurrently without a lock.
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshotWriter.h"
+
+#include <wtf/text/CString.h>
+
+#if OS(WINDOWS)
+#include <io.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+// Heap Snapshot JSON Format:
+//
+//   {
+//      "version": 1.0,
+//      "nodes": [
+//          <nodeId>, <sizeInBytes>, <nodeClassNameIndex>, <internal>,
+//          <nodeId>, <sizeInBytes>, <nodeClassNameIndex>, <internal>,
+//          ...
+//      ],
+//      "nodeClassNames": [
+//          "string", "Structure", "Object", ...
+//      ],
+//      "edges": [
+//          <fromNodeId>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>,
+//          <fromNodeId>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>,
+//          ...
+//      ],
+//      "edgeTypes": [
+//          "Internal", "Property", "Index", "Variable"
+//      ],
+//      "edgeNames": [
+//          "propertyName", "variableName", ...
+//      ]
+//   }
+//
+// Notes:
+//
+//     <nodeClassNameIndex>
+//       - index into the "nodeClassNames" list.
+//
+//     <internal>
+//       - 0 = false, 1 = true.
+//
+//     <edgeTypeIndex>
+//       - index into the "edgeTypes" list.
+//
+//     <edgeExtraData>
+//       - for Internal edges this should be ignored (0).
+//       - for Index edges this is the index value.
+//       - for Property or Variable edges this is an index into the "edgeNames" list.
+
+static uint8_t edgeTypeToNumber(EdgeType type)
+{
+    return static_cast<uint8_t>(type);
+}
+
+static const char* edgeTypeToString(EdgeType type)
+{
+    switch (type) {
+    case EdgeType::Internal:
+        return "Internal";
+    case EdgeType::Property:
+        return "Property";
+    case EdgeType::Index:
+        return "Index";
+    case EdgeType::Variable:
+        return "Variable";
+    }
+    ASSERT_NOT_REACHED();
+    return "Internal";
+}
+
+// Heap Snapshot Binary Format:
+//
+//   "JSCHeap\0" followed by the format version, then records that each start with a tag byte:
+//
+//      1 ClassName   <length>, <UTF-8 bytes>
+//      2 Node        <nodeIdDelta>, <sizeInBytes>, <nodeClassNameIndex and internal>
+//      3 EdgeName    <length>, <UTF-8 bytes>
+//      4 Edge        <fromNodeIdDelta>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>
+//      0 End
+//
+// Notes:
+//
+//     All numbers are unsigned LEB128, except <nodeIdDelta> which is signed LEB128.
+//
+//     ClassName and EdgeName records define the next index in their own list. They come before
+//     the first record that refers to them.
+//
+//     <nodeIdDelta>
+//       - the difference from the previous node's id, or from 0 for the first node.
+//
+//     <nodeClassNameIndex and internal>
+//       - the class name index shifted left by one, with the low bit set for internal nodes.
+//
+//     <fromNodeIdDelta>
+//       - edges are sorted by their from node, so this is the difference from the previous
+//         edge's from node id, or from 0 for the first edge.
+//
+//     <edgeTypeIndex> and <edgeExtraData> are as in the JSON format.
+
+static const char binaryMagic[] = { 'J', 'S', 'C', 'H', 'e', 'a', 'p', 0 };
+static const unsigned binaryVersion = 1;
+
+enum class BinaryTag : uint8_t {
+    End,
+    ClassName,
+    Node,
+    EdgeName,
+    Edge
+};
+
+HeapSnapshotWriter::HeapSnapshotWriter(Output&& output)
+    : m_output(WTFMove(output))
+{
+}
+
+HeapSnapshotWriter::~HeapSnapshotWriter()
+{
+}
+
+auto HeapSnapshotWriter::fileDescriptorOutput(int fileDescriptor) -> Output
+{
+    return [fileDescriptor] (const char* data, size_t length) -> bool {
+        while (length) {
+#if OS(WINDOWS)
+            int written = _write(fileDescriptor, data, static_cast<unsigned>(std::min<size_t>(length, INT_MAX)));
+#else
+            ssize_t written = write(fileDescriptor, data, length);
+            if (written < 0 && errno == EINTR)
+                continue;
+#endif
+            if (written <= 0)
+                return false;
+            data += written;
+            length -= written;
+        }
+        return true;
+    };
+}
+
+void HeapSnapshotWriter::output(const char* data, size_t length)
+{
+    ASSERT(hasOutput());
+    if (m_didFail || !length)
+        return;
+    m_didFail = !m_output(data, length);
+}
+
+HeapSnapshotJSONWriter::HeapSnapshotJSONWriter(Output&& output)
+    : HeapSnapshotWriter(WTFMove(output))
+{
+    m_json.appendLiteral("{\"version\":1,\"nodes\":[");
+}
+
+void HeapSnapshotJSONWriter::appendClassName(unsigned index, const char* className)
+{
+    ASSERT_UNUSED(index, index == m_classNames.size());
+    m_classNames.append(className);
+}
+
+void HeapSnapshotJSONWriter::appendNode(unsigned identifier, size_t sizeInBytes, unsigned classNameIndex, bool isInternal)
+{
+    if (!m_isFirstNode)
+        m_json.append(',');
+    m_isFirstNode = false;
+
+    // <nodeId>, <sizeInBytes>, <className>, <optionalInternalBoolean>
+    m_json.appendNumber(identifier);
+    m_json.append(',');
+    m_json.appendNumber(sizeInBytes);
+    m_json.append(',');
+    m_json.appendNumber(classNameIndex);
+    m_json.append(',');
+    m_json.append(isInternal ? '1' : '0');
+    flushIfNeeded();
+}
+
+void HeapSnapshotJSONWriter::didAppendNodes()
+{
+    m_json.append(']');
+
+    // node class names
+    m_json.append(',');
+    m_json.appendLiteral("\"nodeClassNames\":");
+    m_json.append('[');
+    bool firstClassName = true;
+    for (auto& className : m_classNames) {
+        if (!firstClassName)
+            m_json.append(',');
+        firstClassName = false;
+        m_json.appendQuotedJSONString(className);
+    }
+    m_classNames.clear();
+    m_json.append(']');
+
+    m_json.append(',');
+    m_json.appendLiteral("\"edges\":");
+    m_json.append('[');
+    flushIfNeeded();
+}
+
+void HeapSnapshotJSONWriter::appendEdgeName(unsigned index, UniquedStringImpl* edgeName)
+{
+    ASSERT_UNUSED(index, index == m_edgeNames.size());
+    m_edgeNames.append(edgeName);
+}
+
+void HeapSnapshotJSONWriter::appendEdge(unsigned fromIdentifier, unsigned toIdentifier, EdgeType type, unsigned extraData)
+{
+    if (!m_isFirstEdge)
+        m_json.append(',');
+    m_isFirstEdge = false;
+
+    // <fromNodeId>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>
+    m_json.appendNumber(fromIdentifier);
+    m_json.append(',');
+    m_json.appendNumber(toIdentifier);
+    m_json.append(',');
+    m_json.appendNumber(edgeTypeToNumber(type));
+    m_json.append(',');
+    m_json.appendNumber(extraData);
+    flushIfNeeded();
+}
+
+void HeapSnapshotJSONWriter::didAppendEdges()
+{
+    m_json.append(']');
+
+    // edge types
+    m_json.append(',');
+    m_json.appendLiteral("\"edgeTypes\":");
+    m_json.append('[');
+    m_json.appendQuotedJSONString(edgeTypeToString(EdgeType::Internal));
+    m_json.append(',');
+    m_json.appendQuotedJSONString(edgeTypeToString(EdgeType::Property));
+    m_json.append(',');
+    m_json.appendQuotedJSONString(edgeTypeToString(EdgeType::Index));
+    m_json.append(',');
+    m_json.appendQuotedJSONString(edgeTypeToString(EdgeType::Variable));
+    m_json.append(']');
+
+    // edge names
+    m_json.append(',');
+    m_json.appendLiteral("\"edgeNames\":");
+    m_json.append('[');
+    bool firstEdgeName = true;
+    for (auto& edgeName : m_edgeNames) {
+        if (!firstEdgeName)
+            m_json.append(',');
+        firstEdgeName = false;
+        m_json.appendQuotedJSONString(edgeName);
+    }
+    m_edgeNames.clear();
+    m_json.append(']');
+
+    m_json.append('}');
+
+    if (hasOutput())
+        flush();
+}
+
+String HeapSnapshotJSONWriter::takeString()
+{
+    ASSERT(!hasOutput());
+    String result = m_json.toString();
+    m_json.clear();
+    return result;
+}
+
+void HeapSnapshotJSONWriter::flushIfNeeded()
+{
+    if (hasOutput() && m_json.length() >= chunkSize)
+        flush();
+}
+
+void HeapSnapshotJSONWriter::flush()
+{
+    CString chunk = m_json.toString().utf8();
+    m_json.clear();
+    output(chunk.data(), chunk.length());
+}
+
+HeapSnapshotBinaryWriter::HeapSnapshotBinaryWriter(Output&& output)
+    : HeapSnapshotWriter(WTFMove(output))
+{
+    ASSERT(hasOutput());
+    m_buffer.reserveInitialCapacity(chunkSize + KB);
+    m_buffer.append(binaryMagic, sizeof(binaryMagic));
+    appendNumber(binaryVersion);
+}
+
+void HeapSnapshotBinaryWriter::appendTag(uint8_t tag)
+{
+    m_buffer.append(static_cast<char>(tag));
+}
+
+void HeapSnapshotBinaryWriter::appendNumber(uint64_t value)
+{
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value)
+            byte |= 0x80;
+        m_buffer.append(static_cast<char>(byte));
+    } while (value);
+}
+
+void HeapSnapshotBinaryWriter::appendSignedNumber(int64_t value)
+{
+    for (;;) {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        bool isLastByte = (!value && !(byte & 0x40)) || (value == -1 && (byte & 0x40));
+        if (!isLastByte)
+            byte |= 0x80;
+        m_buffer.append(static_cast<char>(byte));
+        if (isLastByte)
+            return;
+    }
+}
+
+void HeapSnapshotBinaryWriter::appendString(const CString& string)
+{
+    appendNumber(string.length());
+    m_buffer.append(string.data(), string.length());
+}
+
+void HeapSnapshotBinaryWriter::appendClassName(unsigned, const char* className)
+{
+    appendTag(static_cast<uint8_t>(BinaryTag::ClassName));
+    appendString(CString(className));
+    flushIfNeeded();
+}
+
+void HeapSnapshotBinaryWriter::appendNode(unsigned identifier, size_t sizeInBytes, unsigned classNameIndex, bool isInternal)
+{
+    appendTag(static_cast<uint8_t>(BinaryTag::Node));
+    appendSignedNumber(static_cast<int64_t>(identifier) - static_cast<int64_t>(m_lastNodeIdentifier));
+    appendNumber(sizeInBytes);
+    appendNumber((static_cast<uint64_t>(classNameIndex) << 1) | (isInternal ? 1 : 0));
+    m_lastNodeIdentifier = identifier;
+    flushIfNeeded();
+}
+
+void HeapSnapshotBinaryWriter::didAppendNodes()
+{
+}
+
+void HeapSnapshotBinaryWriter::appendEdgeName(unsigned, UniquedStringImpl* edgeName)
+{
+    appendTag(static_cast<uint8_t>(BinaryTag::EdgeName));
+    appendString(String(edgeName).utf8());
+    flushIfNeeded();
+}
+
+void HeapSnapshotBinaryWriter::appendEdge(unsigned fromIdentifier, unsigned toIdentifier, EdgeType type, unsigned extraData)
+{
+    ASSERT(fromIdentifier >= m_lastFromIdentifier);
+    appendTag(static_cast<uint8_t>(BinaryTag::Edge));
+    appendNumber(fromIdentifier - m_lastFromIdentifier);
+    appendNumber(toIdentifier);
+    appendNumber(edgeTypeToNumber(type));
+    appendNumber(extraData);
+    m_lastFromIdentifier = fromIdentifier;
+    flushIfNeeded();
+}
+
+void HeapSnapshotBinaryWriter::didAppendEdges()
+{
+    appendTag(static_cast<uint8_t>(BinaryTag::End));
+    flush();
+}
+
+void HeapSnapshotBinaryWriter::flushIfNeeded()
+{
+    if (m_buffer.size() >= chunkSize)
+        flush();
+}
+
+void HeapSnapshotBinaryWriter::flush()
+{
+    output(m_buffer.data(), m_buffer.size());
+    m_buffer.shrink(0);
+}
+
+} // namespace JSC
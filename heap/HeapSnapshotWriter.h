@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "HeapSnapshotBuilder.h"
+#include <wtf/Function.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+// Serializes the nodes and edges that HeapSnapshotBuilder::write() hands it. Writers buffer their
+// output and pass it on to their Output in chunks of about chunkSize bytes, so that a snapshot of
+// a large heap never has to be in memory all at once. Each chunk stands on its own: JSON chunks
+// never split a character.
+class JS_EXPORT_PRIVATE HeapSnapshotWriter {
+    WTF_MAKE_NONCOPYABLE(HeapSnapshotWriter);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Returns false if the data could not be written, after which the writer stops writing.
+    typedef WTF::Function<bool(const char* data, size_t length)> Output;
+    
+    static const size_t chunkSize = 64 * KB;
+    
+    // An Output that writes to a file descriptor, which the caller keeps ownership of.
+    static Output fileDescriptorOutput(int fileDescriptor);
+    
+    virtual ~HeapSnapshotWriter();
+    
+    // Class names are appended before the first node that uses them, and edge names before the
+    // first edge that uses them. Their indices count up from 0.
+    virtual void appendClassName(unsigned index, const char*) = 0;
+    virtual void appendNode(unsigned identifier, size_t sizeInBytes, unsigned classNameIndex, bool isInternal) = 0;
+    virtual void didAppendNodes() = 0;
+    virtual void appendEdgeName(unsigned index, UniquedStringImpl*) = 0;
+    virtual void appendEdge(unsigned fromIdentifier, unsigned toIdentifier, EdgeType, unsigned extraData) = 0;
+    virtual void didAppendEdges() = 0;
+    
+    bool didFail() const { return m_didFail; }
+    
+protected:
+    HeapSnapshotWriter(Output&&);
+    
+    bool hasOutput() const { return !!m_output; }
+    void output(const char* data, size_t length);
+    
+private:
+    Output m_output;
+    bool m_didFail { false };
+};
+
+// The format that HeapSnapshotBuilder::json() returns. Without an Output, the whole snapshot is
+// kept in memory and takeString() returns it.
+class JS_EXPORT_PRIVATE HeapSnapshotJSONWriter : public HeapSnapshotWriter {
+public:
+    HeapSnapshotJSONWriter(Output&& = nullptr);
+    
+    void appendClassName(unsigned index, const char*) override;
+    void appendNode(unsigned identifier, size_t sizeInBytes, unsigned classNameIndex, bool isInternal) override;
+    void didAppendNodes() override;
+    void appendEdgeName(unsigned index, UniquedStringImpl*) override;
+    void appendEdge(unsigned fromIdentifier, unsigned toIdentifier, EdgeType, unsigned extraData) override;
+    void didAppendEdges() override;
+    
+    String takeString();
+    
+private:
+    void flushIfNeeded();
+    void flush();
+    
+    StringBuilder m_json;
+    Vector<const char*> m_classNames;
+    Vector<UniquedStringImpl*> m_edgeNames;
+    bool m_isFirstNode { true };
+    bool m_isFirstEdge { true };
+};
+
+// A compact format for snapshots that are too large for JSON. Class names and edge names are
+// written once, the first time they are used, and everything else is a variable-length integer.
+class JS_EXPORT_PRIVATE HeapSnapshotBinaryWriter : public HeapSnapshotWriter {
+public:
+    HeapSnapshotBinaryWriter(Output&&);
+    
+    void appendClassName(unsigned index, const char*) override;
+    void appendNode(unsigned identifier, size_t sizeInBytes, unsigned classNameIndex, bool isInternal) override;
+    void didAppendNodes() override;
+    void appendEdgeName(unsigned index, UniquedStringImpl*) override;
+    void appendEdge(unsigned fromIdentifier, unsigned toIdentifier, EdgeType, unsigned extraData) override;
+    void didAppendEdges() override;
+    
+private:
+    void appendTag(uint8_t);
+    void appendNumber(uint64_t);
+    void appendSignedNumber(int64_t);
+    void appendString(const CString&);
+    void flushIfNeeded();
+    void flush();
+    
+    Vector<char> m_buffer;
+    unsigned m_lastNodeIdentifier { 0 };
+    unsigned m_lastFromIdentifier { 0 };
+};
+
+} // namespace JSC
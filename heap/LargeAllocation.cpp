@@ -34,16 +34,18 @@ namespace JSC {
 
 LargeAllocation* LargeAllocation::tryCreate(Heap& heap, size_t size, Subspace* subspace)
 {
-    void* space = tryFastAlignedMalloc(alignment, headerSize() + size);
+    size_t allocationSize = LargeObjectSpace::sizeFor(headerSize() + size);
+    void* space = heap.objectSpace().largeObjectSpace().tryAllocate(allocationSize);
     if (!space)
         return nullptr;
     if (scribbleFreeCells())
         scribble(space, size);
-    return new (NotNull, space) LargeAllocation(heap, size, subspace);
+    return new (NotNull, space) LargeAllocation(heap, size, allocationSize, subspace);
 }
 
-LargeAllocation::LargeAllocation(Heap& heap, size_t size, Subspace* subspace)
+LargeAllocation::LargeAllocation(Heap& heap, size_t size, size_t allocationSize, Subspace* subspace)
     : m_cellSize(size)
+    , m_allocationSize(allocationSize)
     , m_isNewlyAllocated(true)
     , m_hasValidCell(true)
     , m_attributes(subspace->attributes())
@@ -104,10 +106,31 @@ void LargeAllocation::sweep()
     }
 }
 
+bool LargeAllocation::tryGrow(size_t newCellSize)
+{
+    newCellSize = WTF::roundUpToMultipleOf<MarkedSpace::sizeStep>(newCellSize);
+    if (newCellSize <= m_cellSize)
+        return true;
+    
+    size_t newAllocationSize = headerSize() + newCellSize;
+    if (newAllocationSize > m_allocationSize) {
+        newAllocationSize = WTF::roundUpToMultipleOf<LargeObjectSpace::granule>(newAllocationSize);
+        if (!heap()->objectSpace().largeObjectSpace().tryGrow(this, m_allocationSize, newAllocationSize))
+            return false;
+        m_allocationSize = newAllocationSize;
+    }
+    
+    m_subspace->didGrowLargeAllocation(newCellSize - m_cellSize);
+    m_cellSize = newCellSize;
+    return true;
+}
+
 void LargeAllocation::destroy()
 {
+    Heap* heap = this->heap();
+    size_t allocationSize = m_allocationSize;
     this->~LargeAllocation();
-    fastAlignedFree(this);
+    heap->objectSpace().largeObjectSpace().deallocate(this, allocationSize);
 }
 
 void LargeAllocation::dump(PrintStream& out) const
@@ -32,10 +32,9 @@ namespace JSC {
 
 class SlotVisitor;
 
-// WebKit has a good malloc that already knows what to do for large allocations. The GC shouldn't
-// have to think about such things. That's where LargeAllocation comes in. We will allocate large
-// objects directly using malloc, and put the LargeAllocation header just before them. We can detect
-// when a HeapCell* is a LargeAllocation because it will have the MarkedBlock::atomSize / 2 bit set.
+// Large objects don't fit in MarkedBlocks, so each gets its own range of memory from the
+// LargeObjectSpace, with the LargeAllocation header just before the object. We can detect when a
+// HeapCell* is a LargeAllocation because it will have the MarkedBlock::atomSize / 2 bit set.
 
 class LargeAllocation : public BasicRawSentinelNode<LargeAllocation> {
 public:
@@ -85,6 +84,10 @@ public:
     
     size_t cellSize() const { return m_cellSize; }
     
+    // Makes the cell bigger without moving it, either by using the slack at the end of its range
+    // or by taking memory from the LargeObjectSpace. The new bytes are not initialized.
+    bool tryGrow(size_t newCellSize);
+    
     bool aboveLowerBound(const void* rawPtr)
     {
         char* ptr = bitwise_cast<char*>(rawPtr);
@@ -139,7 +142,7 @@ public:
     void dump(PrintStream&) const;
     
 private:
-    LargeAllocation(Heap&, size_t, Subspace*);
+    LargeAllocation(Heap&, size_t, size_t allocationSize, Subspace*);
     
     static const unsigned alignment = MarkedBlock::atomSize;
     static const unsigned halfAlignment = alignment / 2;
@@ -147,6 +150,7 @@ private:
     static unsigned headerSize();
     
     size_t m_cellSize;
+    size_t m_allocationSize;
     bool m_isNewlyAllocated;
     bool m_hasValidCell;
     Atomic<bool> m_isMarked;
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "LargeObjectSpace.h"
+
+#include "MarkedBlock.h"
+#include "Options.h"
+#include <wtf/FastMalloc.h>
+
+namespace JSC {
+
+LargeObjectSpace::LargeObjectSpace()
+{
+}
+
+LargeObjectSpace::~LargeObjectSpace()
+{
+    for (void* page : m_pages)
+        fastAlignedFree(page);
+}
+
+void* LargeObjectSpace::tryAllocate(size_t size)
+{
+    ASSERT(size == sizeFor(size));
+    
+    if (size > maximumSizeInPages || !Options::useLargeObjectSpace())
+        return tryFastAlignedMalloc(MarkedBlock::atomSize, size);
+    
+    FreeRange* range = takeFreeRange(size);
+    if (!range) {
+        void* page = tryFastAlignedMalloc(pageSize, pageSize);
+        if (!page)
+            return nullptr;
+        m_pages.add(page);
+        range = new (NotNull, page) FreeRange(pageSize);
+    }
+    
+    char* begin = range->begin();
+    size_t rangeSize = range->size();
+    if (rangeSize > size)
+        addFreeRange(begin + size, rangeSize - size);
+    return begin;
+}
+
+void LargeObjectSpace::deallocate(void* pointer, size_t size)
+{
+    if (!m_pages.contains(pageFor(pointer))) {
+        fastAlignedFree(pointer);
+        return;
+    }
+    
+    char* begin = static_cast<char*>(pointer);
+    char* end = begin + size;
+    
+    // Pages are allocated and released independently, so never coalesce across the edge of one.
+    if (!isPageAligned(end)) {
+        FreeRange* next = bitwise_cast<FreeRange*>(end);
+        if (m_freeRanges.contains(next)) {
+            size += next->size();
+            removeFreeRange(next);
+        }
+    }
+    
+    if (!isPageAligned(begin)) {
+        auto iter = m_freeRangeEndingAt.find(begin);
+        if (iter != m_freeRangeEndingAt.end()) {
+            FreeRange* previous = iter->value;
+            begin = previous->begin();
+            size += previous->size();
+            removeFreeRange(previous);
+        }
+    }
+    
+    addFreeRange(begin, size);
+}
+
+bool LargeObjectSpace::tryGrow(void* pointer, size_t oldSize, size_t newSize)
+{
+    ASSERT(newSize > oldSize);
+    ASSERT(!(newSize & (granule - 1)));
+    
+    char* end = static_cast<char*>(pointer) + oldSize;
+    if (isPageAligned(end) || !m_pages.contains(pageFor(pointer)))
+        return false;
+    
+    FreeRange* next = bitwise_cast<FreeRange*>(end);
+    if (!m_freeRanges.contains(next))
+        return false;
+    
+    size_t extraSize = newSize - oldSize;
+    size_t nextSize = next->size();
+    if (nextSize < extraSize)
+        return false;
+    
+    removeFreeRange(next);
+    if (nextSize > extraSize)
+        addFreeRange(end + extraSize, nextSize - extraSize);
+    return true;
+}
+
+size_t LargeObjectSpace::releaseEmptyPages()
+{
+    // A free range never spans pages, so the only ranges in the last bin are whole empty pages.
+    size_t numberOfReleasedPages = 0;
+    DoublyLinkedList<FreeRange>& bin = m_bins[binIndexFor(pageSize)];
+    while (FreeRange* range = bin.head()) {
+        ASSERT(range->size() == pageSize);
+        removeFreeRange(range);
+        m_pages.remove(range);
+        fastAlignedFree(range);
+        numberOfReleasedPages++;
+    }
+    return numberOfReleasedPages;
+}
+
+LargeObjectSpace::FreeRange* LargeObjectSpace::takeFreeRange(size_t size)
+{
+    for (size_t index = binIndexFor(size); index < numberOfBins; ++index) {
+        if (FreeRange* range = m_bins[index].head()) {
+            removeFreeRange(range);
+            return range;
+        }
+    }
+    return nullptr;
+}
+
+void LargeObjectSpace::addFreeRange(char* begin, size_t size)
+{
+    FreeRange* range = new (NotNull, begin) FreeRange(size);
+    m_bins[binIndexFor(size)].push(range);
+    m_freeRanges.add(range);
+    m_freeRangeEndingAt.add(range->end(), range);
+}
+
+void LargeObjectSpace::removeFreeRange(FreeRange* range)
+{
+    m_bins[binIndexFor(range->size())].remove(range);
+    m_freeRanges.remove(range);
+    m_freeRangeEndingAt.remove(range->end());
+}
+
+} // namespace JSC
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <array>
+#include <wtf/DoublyLinkedList.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/MathExtras.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/StdLibExtras.h>
+
+namespace JSC {
+
+// Hands out the memory of LargeAllocations. Requests are rounded up to size classes, eight per
+// power of two, and carved out of pageSize chunks. Freed ranges are coalesced with their free
+// neighbors and kept in one bin per size class, so a program that keeps allocating and dropping
+// large arrays or strings reuses the same address ranges instead of going to the system allocator
+// for every object. A live allocation can also grow into the free range right after it, which is
+// how arrays that keep growing avoid copying their butterflies. Requests that are too big to share
+// a page get their own malloc.
+//
+// This is only used by the mutator and while the world is stopped, so it does no locking.
+class LargeObjectSpace {
+    WTF_MAKE_NONCOPYABLE(LargeObjectSpace);
+public:
+    static const size_t pageSizeLog2 = 21;
+    static const size_t pageSize = static_cast<size_t>(1) << pageSizeLog2;
+    static const size_t maximumSizeInPages = pageSize / 4;
+    
+    static const size_t granuleLog2 = 8;
+    static const size_t granule = static_cast<size_t>(1) << granuleLog2;
+    static const size_t classesPerDoublingLog2 = 3;
+    static const size_t classesPerDoubling = static_cast<size_t>(1) << classesPerDoublingLog2;
+    
+    LargeObjectSpace();
+    ~LargeObjectSpace();
+    
+    // Rounds the size up to the size of the range that tryAllocate() would hand out for it.
+    static size_t sizeFor(size_t);
+    
+    void* tryAllocate(size_t);
+    void deallocate(void*, size_t);
+    
+    // Tries to extend the allocation in place. The new memory is not initialized.
+    bool tryGrow(void*, size_t oldSize, size_t newSize);
+    
+    // Gives the pages that have no live allocations back to the system allocator.
+    size_t releaseEmptyPages();
+    
+    size_t numberOfPages() const { return m_pages.size(); }
+
+private:
+    class FreeRange : public DoublyLinkedListNode<FreeRange> {
+    public:
+        FreeRange(size_t size)
+            : m_size(size)
+        {
+        }
+        
+        char* begin() { return bitwise_cast<char*>(this); }
+        char* end() { return begin() + m_size; }
+        size_t size() const { return m_size; }
+        
+        FreeRange* m_prev; // Required by DoublyLinkedListNode.
+        FreeRange* m_next; // Required by DoublyLinkedListNode.
+    private:
+        size_t m_size;
+    };
+    
+    static const size_t linearLimitLog2 = granuleLog2 + classesPerDoublingLog2;
+    static const size_t linearLimit = static_cast<size_t>(1) << linearLimitLog2;
+    static const size_t numberOfBins = classesPerDoubling + (pageSizeLog2 - linearLimitLog2) * classesPerDoubling;
+    
+    static size_t binIndexFor(size_t);
+    
+    static bool isPageAligned(const void* pointer) { return !(bitwise_cast<uintptr_t>(pointer) & (pageSize - 1)); }
+    static void* pageFor(const void* pointer) { return bitwise_cast<void*>(bitwise_cast<uintptr_t>(pointer) & ~(pageSize - 1)); }
+    
+    FreeRange* takeFreeRange(size_t);
+    void addFreeRange(char* begin, size_t);
+    void removeFreeRange(FreeRange*);
+    
+    std::array<DoublyLinkedList<FreeRange>, numberOfBins> m_bins;
+    HashSet<FreeRange*> m_freeRanges;
+    HashMap<char*, FreeRange*> m_freeRangeEndingAt;
+    HashSet<void*> m_pages;
+};
+
+// The index of the largest size class that is no bigger than the size. A free range lands in the
+// bin of the largest class it can satisfy, so any range in the bin of a class, or in a later bin,
+// is big enough for that class.
+inline size_t LargeObjectSpace::binIndexFor(size_t size)
+{
+    ASSERT(size >= granule && !(size & (granule - 1)));
+    if (size < linearLimit)
+        return (size >> granuleLog2) - 1;
+    unsigned log2 = 31 - WTF::clz32(static_cast<uint32_t>(size));
+    size_t offset = (size - (static_cast<size_t>(1) << log2)) >> (log2 - classesPerDoublingLog2);
+    return classesPerDoubling - 1 + (log2 - linearLimitLog2) * classesPerDoubling + offset;
+}
+
+inline size_t LargeObjectSpace::sizeFor(size_t size)
+{
+    size = roundUpToMultipleOf<granule>(size);
+    if (size <= linearLimit || size > maximumSizeInPages)
+        return size;
+    unsigned log2 = 31 - WTF::clz32(static_cast<uint32_t>(size - 1));
+    return roundUpToMultipleOf(static_cast<size_t>(1) << (log2 - classesPerDoublingLog2), size);
+}
+
+} // namespace JSC
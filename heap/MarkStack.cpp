@@ -156,4 +156,28 @@ void MarkStackArray::stealSomeCellsFrom(MarkStackArray& other, size_t idleThread
         append(other.removeLast());
 }
 
+GCArraySegment<const JSCell*>* MarkStackArray::takeFullSegment()
+{
+    RELEASE_ASSERT(m_numberOfSegments > 1);
+    
+    // The tail is the oldest work, which is what a marker that has run dry should get.
+    GCArraySegment<const JSCell*>* result = m_segments.tail();
+    ASSERT(result->m_top == s_segmentCapacity);
+    m_segments.remove(result);
+    m_numberOfSegments--;
+    
+    validatePrevious();
+    return result;
+}
+
+void MarkStackArray::addFullSegment(GCArraySegment<const JSCell*>* segment)
+{
+    ASSERT(segment->m_top == s_segmentCapacity);
+    
+    m_segments.append(segment);
+    m_numberOfSegments++;
+    
+    validatePrevious();
+}
+
 } // namespace JSC
@@ -39,6 +39,12 @@ public:
     size_t transferTo(MarkStackArray&, size_t limit); // Optimized for when `limit` is small.
     void donateSomeCellsTo(MarkStackArray&);
     void stealSomeCellsFrom(MarkStackArray&, size_t idleThreadCount);
+    
+    // Every segment but the head is full. These move such segments in and out of the array without
+    // copying, which is how marking shares work through MarkStackDeques.
+    size_t numberOfFullSegments() const { return m_numberOfSegments - 1; }
+    GCArraySegment<const JSCell*>* takeFullSegment();
+    void addFullSegment(GCArraySegment<const JSCell*>*);
 };
 
 } // namespace JSC
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "MarkStackDeque.h"
+
+#include "GCSegmentedArrayInlines.h"
+
+namespace JSC {
+
+MarkStackDeque::MarkStackDeque()
+{
+    m_top.store(0);
+    m_bottom.store(0);
+    m_buffers.append(std::make_unique<Buffer>(initialCapacity));
+    m_buffer.store(m_buffers.last().get());
+}
+
+MarkStackDeque::~MarkStackDeque()
+{
+    clear();
+}
+
+MarkStackDeque::Buffer* MarkStackDeque::grow(Buffer* buffer, int64_t top, int64_t bottom)
+{
+    std::unique_ptr<Buffer> newBuffer = std::make_unique<Buffer>(buffer->capacity * 2);
+    for (int64_t index = top; index < bottom; ++index)
+        newBuffer->set(index, buffer->get(index));
+    
+    Buffer* result = newBuffer.get();
+    m_buffers.append(WTFMove(newBuffer));
+    m_buffer.store(result, std::memory_order_release);
+    return result;
+}
+
+void MarkStackDeque::clear()
+{
+    while (Segment* segment = pop())
+        Segment::destroy(segment);
+    releaseRetiredBuffers();
+}
+
+void MarkStackDeque::releaseRetiredBuffers()
+{
+    if (m_buffers.size() == 1)
+        return;
+    
+    std::unique_ptr<Buffer> current = WTFMove(m_buffers.last());
+    m_buffers.clear();
+    m_buffers.append(WTFMove(current));
+}
+
+} // namespace JSC
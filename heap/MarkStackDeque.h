@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "GCSegmentedArray.h"
+#include <wtf/Atomics.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class JSCell;
+
+// A Chase-Lev work-stealing deque of full mark stack segments, following "Correct and Efficient
+// Work-Stealing for Weak Memory Models" by Lê, Pop, Cohen and Zappa Nardelli. The owning
+// SlotVisitor pushes and pops at the bottom without locking, and any other marker may steal from
+// the top. Buffers that the deque outgrows are kept until releaseRetiredBuffers() is called with
+// no thieves around, since a thief may still be reading from one.
+class MarkStackDeque {
+    WTF_MAKE_NONCOPYABLE(MarkStackDeque);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    typedef GCArraySegment<const JSCell*> Segment;
+    
+    MarkStackDeque();
+    ~MarkStackDeque();
+    
+    // Only the owner may call these.
+    void push(Segment*);
+    Segment* pop();
+    void clear();
+    void releaseRetiredBuffers();
+    
+    // This may be called from any thread. It returns null if the deque was empty or if it lost a
+    // race with another thief or with the owner.
+    Segment* steal();
+    
+    // These are racy unless the owner and the thieves are quiescent.
+    bool isEmpty() const;
+    size_t size() const;
+    
+private:
+    struct Buffer {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        Buffer(size_t capacity)
+            : capacity(capacity)
+            , entries(new Atomic<Segment*>[capacity])
+        {
+        }
+        
+        Segment* get(int64_t index) const { return entries[static_cast<size_t>(index) & (capacity - 1)].load(std::memory_order_relaxed); }
+        void set(int64_t index, Segment* segment) { entries[static_cast<size_t>(index) & (capacity - 1)].store(segment, std::memory_order_relaxed); }
+        
+        size_t capacity;
+        std::unique_ptr<Atomic<Segment*>[]> entries;
+    };
+    
+    Buffer* grow(Buffer*, int64_t top, int64_t bottom);
+    
+    static const size_t initialCapacity = 32;
+    
+    Atomic<int64_t> m_top;
+    Atomic<int64_t> m_bottom;
+    Atomic<Buffer*> m_buffer;
+    Vector<std::unique_ptr<Buffer>> m_buffers;
+};
+
+inline void MarkStackDeque::push(Segment* segment)
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<int64_t>(buffer->capacity) - 1)
+        buffer = grow(buffer, top, bottom);
+    buffer->set(bottom, segment);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+inline MarkStackDeque::Segment* MarkStackDeque::pop()
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    
+    Segment* segment = buffer->get(bottom);
+    if (top == bottom) {
+        // This is the last segment, so we race with the thieves for it.
+        if (!m_top.compareExchangeStrong(top, top + 1))
+            segment = nullptr;
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return segment;
+}
+
+inline MarkStackDeque::Segment* MarkStackDeque::steal()
+{
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+        return nullptr;
+    
+    Buffer* buffer = m_buffer.load(std::memory_order_acquire);
+    Segment* segment = buffer->get(top);
+    if (!m_top.compareExchangeStrong(top, top + 1))
+        return nullptr;
+    return segment;
+}
+
+inline bool MarkStackDeque::isEmpty() const
+{
+    return m_bottom.load() <= m_top.load();
+}
+
+inline size_t MarkStackDeque::size() const
+{
+    int64_t size = m_bottom.load() - m_top.load();
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+} // namespace JSC
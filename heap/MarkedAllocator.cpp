@@ -27,6 +27,7 @@
 #include "MarkedAllocator.h"
 
 #include "AllocatingScope.h"
+#include "AllocationSamplingProfiler.h"
 #include "GCActivityCallback.h"
 #include "Heap.h"
 #include "IncrementalSweeper.h"
@@ -140,6 +141,7 @@ void* MarkedAllocator::tryAllocateIn(MarkedBlock::Handle* block)
     ASSERT(block);
     ASSERT(!block->isFreeListed());
     
+    recommitIfNecessary(block);
     block->sweep(&m_freeList);
     
     // It's possible to stumble on a completely full block. Marking tries to retire these, but
@@ -180,6 +182,12 @@ ALWAYS_INLINE void MarkedAllocator::doTestCollectionsIfNeeded(GCDeferralContext*
         allocationCount = 0;
 }
 
+ALWAYS_INLINE void MarkedAllocator::sampleAllocationIfNecessary(void* result, size_t bytesAllocated)
+{
+    if (AllocationSamplingProfiler* profiler = m_heap->vm()->allocationSamplingProfiler())
+        profiler->didAllocate(static_cast<HeapCell*>(result), bytesAllocated);
+}
+
 void* MarkedAllocator::allocateSlowCase(GCDeferralContext* deferralContext)
 {
     bool crashOnFailure = true;
@@ -199,7 +207,9 @@ void* MarkedAllocator::allocateSlowCaseImpl(GCDeferralContext* deferralContext,
     doTestCollectionsIfNeeded(deferralContext);
 
     ASSERT(!markedSpace().isIterating());
-    m_heap->didAllocate(m_freeList.originalSize());
+    size_t bytesAllocated = m_freeList.originalSize();
+    m_heap->didAllocate(bytesAllocated);
+    m_subspace->didAllocateBytes(bytesAllocated);
     
     didConsumeFreeList();
     
@@ -217,8 +227,10 @@ void* MarkedAllocator::allocateSlowCaseImpl(GCDeferralContext* deferralContext,
     
     void* result = tryAllocateWithoutCollecting();
     
-    if (LIKELY(result != 0))
+    if (LIKELY(result != 0)) {
+        sampleAllocationIfNecessary(result, bytesAllocated);
         return result;
+    }
     
     MarkedBlock::Handle* block = tryAllocateBlock();
     if (!block) {
@@ -230,6 +242,7 @@ void* MarkedAllocator::allocateSlowCaseImpl(GCDeferralContext* deferralContext,
     addBlock(block);
     result = allocateIn(block);
     ASSERT(result);
+    sampleAllocationIfNecessary(result, bytesAllocated);
     return result;
 }
 
@@ -307,6 +320,8 @@ void MarkedAllocator::removeBlock(MarkedBlock::Handle* block)
     ASSERT(block->allocator() == this);
     ASSERT(m_blocks[block->index()] == block);
 
+    recommitIfNecessary(block);
+    
     m_blocks[block->index()] = nullptr;
     m_freeBlockIndices.append(block->index());
     
@@ -426,6 +441,22 @@ MarkedBlock::Handle* MarkedAllocator::findBlockToSweep()
     return m_blocks[m_unsweptCursor];
 }
 
+void MarkedAllocator::requestPreparedFreeLists(Vector<MarkedBlock::Handle*>& blocks)
+{
+    if (needsDestruction())
+        return;
+    
+    // These are the blocks that tryAllocateWithoutCollecting() will sweep to a free list next, in
+    // the order in which it will get to them. Empty blocks are left alone since they get
+    // bump-allocated.
+    m_canAllocateButNotEmpty.forEachSetBit(
+        [&] (size_t index) {
+            MarkedBlock::Handle* block = m_blocks[index];
+            block->requestPreparedFreeList();
+            blocks.append(block);
+        });
+}
+
 void MarkedAllocator::sweep()
 {
     m_unswept.forEachSetBit(
@@ -443,6 +474,37 @@ void MarkedAllocator::shrink()
         });
 }
 
+bool MarkedAllocator::scavenge(size_t& numberOfDecommittedBlocks, size_t& numberOfFreedBlocks)
+{
+    (m_empty & m_idle & ~m_decommitted).forEachSetBit(
+        [&] (size_t index) {
+            MarkedBlock::Handle* block = m_blocks[index];
+            if (block->decommitCells()) {
+                setIsDecommitted(NoLockingNecessary, index, true);
+                markedSpace().didDecommitBlock();
+                numberOfDecommittedBlocks++;
+                return;
+            }
+            // The cells share their pages with the MarkedBlock, so the only way to give them
+            // back is to free the whole block.
+            markedSpace().freeBlock(block);
+            numberOfFreedBlocks++;
+        });
+    
+    m_idle = m_empty & ~m_decommitted;
+    return !m_idle.isEmpty();
+}
+
+void MarkedAllocator::recommitIfNecessary(MarkedBlock::Handle* block)
+{
+    setIsIdle(NoLockingNecessary, block, false);
+    if (!isDecommitted(NoLockingNecessary, block))
+        return;
+    block->recommitCells();
+    setIsDecommitted(NoLockingNecessary, block, false);
+    markedSpace().didRecommitBlock();
+}
+
 void MarkedAllocator::assertNoUnswept()
 {
     if (ASSERT_DISABLED)
@@ -46,6 +46,8 @@ class LLIntOffsetsExtractor;
     macro(canAllocateButNotEmpty, CanAllocateButNotEmpty) /* The set of all blocks are neither empty nor retired (i.e. are more than minMarkedBlockUtilization full). */ \
     macro(eden, Eden) /* The set of all blocks that have new objects since the last GC. */\
     macro(unswept, Unswept) /* The set of all blocks that could be swept by the incremental sweeper. */\
+    macro(idle, Idle) /* The set of empty blocks that the block scavenger has seen and that haven't been allocated in since. */\
+    macro(decommitted, Decommitted) /* The set of empty blocks whose cell pages the block scavenger gave back to the OS. */\
     \
     /* These are computed during marking. */\
     macro(markingNotEmpty, MarkingNotEmpty) /* The set of all blocks that are not empty. */ \
@@ -146,6 +148,11 @@ public:
     void snapshotUnsweptForFullCollection();
     void sweep();
     void shrink();
+    
+    // Gives the cell pages of the blocks that have stayed idle since the previous call back to the
+    // OS, freeing the blocks for which that isn't possible, and makes the blocks that are empty
+    // now idle. Returns true if the next call would have blocks to give back.
+    bool scavenge(size_t& numberOfDecommittedBlocks, size_t& numberOfFreedBlocks);
     void assertNoUnswept();
     size_t cellSize() const { return m_cellSize; }
     const AllocatorAttributes& attributes() const { return m_attributes; }
@@ -206,6 +213,8 @@ public:
     
     MarkedBlock::Handle* findBlockToSweep();
     
+    void requestPreparedFreeLists(Vector<MarkedBlock::Handle*>&);
+    
     Subspace* subspace() const { return m_subspace; }
     MarkedSpace& markedSpace() const;
     
@@ -227,7 +236,9 @@ private:
     MarkedBlock::Handle* tryAllocateBlock();
     void* tryAllocateIn(MarkedBlock::Handle*);
     void* allocateIn(MarkedBlock::Handle*);
+    void recommitIfNecessary(MarkedBlock::Handle*);
     ALWAYS_INLINE void doTestCollectionsIfNeeded(GCDeferralContext*);
+    ALWAYS_INLINE void sampleAllocationIfNecessary(void* result, size_t bytesAllocated);
     
     FreeList m_freeList;
     
@@ -35,6 +35,12 @@
 #include "SuperSampler.h"
 #include "SweepingScope.h"
 #include <wtf/CommaPrinter.h>
+#include <wtf/PageBlock.h>
+
+#if OS(UNIX)
+#include <errno.h>
+#include <sys/mman.h>
+#endif
 
 namespace JSC {
 
@@ -63,6 +69,7 @@ MarkedBlock::Handle::Handle(Heap& heap, void* blockSpace)
     , m_newlyAllocatedVersion(MarkedSpace::nullVersion)
 {
     m_block = new (NotNull, blockSpace) MarkedBlock(*heap.vm(), *this);
+    m_preparedFreeListState.store(NoPreparedFreeList);
     
     m_weakSet.setContainer(*m_block);
     
@@ -352,6 +359,48 @@ void MarkedBlock::Handle::didAddToAllocator(MarkedAllocator* allocator, size_t i
     block().m_biasedMarkCount = block().m_markCountBias = static_cast<int16_t>(markCountBias);
 }
 
+#if OS(UNIX)
+static bool pagesHoldingOnlyCells(MarkedBlock& block, char*& begin, size_t& size)
+{
+    char* blockBegin = reinterpret_cast<char*>(&block);
+    char* blockEnd = blockBegin + MarkedBlock::blockSize;
+    begin = reinterpret_cast<char*>(roundUpToMultipleOf(pageSize(), reinterpret_cast<uintptr_t>(block.atoms() + MarkedBlock::firstAtom())));
+    if (begin >= blockEnd)
+        return false;
+    size = blockEnd - begin;
+    return true;
+}
+#endif
+
+bool MarkedBlock::Handle::decommitCells()
+{
+#if OS(UNIX)
+    char* begin;
+    size_t size;
+    if (!pagesHoldingOnlyCells(block(), begin, size))
+        return false;
+#if HAVE(MADV_FREE_REUSE)
+    while (madvise(begin, size, MADV_FREE_REUSABLE) == -1 && errno == EAGAIN) { }
+#else
+    madvise(begin, size, MADV_DONTNEED);
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MarkedBlock::Handle::recommitCells()
+{
+#if HAVE(MADV_FREE_REUSE)
+    char* begin;
+    size_t size;
+    if (!pagesHoldingOnlyCells(block(), begin, size))
+        return;
+    while (madvise(begin, size, MADV_FREE_REUSE) == -1 && errno == EAGAIN) { }
+#endif
+}
+
 void MarkedBlock::Handle::didRemoveFromAllocator()
 {
     ASSERT(m_index != std::numeric_limits<size_t>::max());
@@ -414,6 +463,11 @@ void MarkedBlock::Handle::sweep(FreeList* freeList)
     
     ASSERT(!m_allocator->isAllocated(NoLockingNecessary, this));
     
+    if (sweepMode == SweepToFreeList
+        && m_preparedFreeListState.load() != NoPreparedFreeList
+        && adoptPreparedFreeList(*freeList))
+        return;
+    
     if (space()->isMarking())
         block().m_lock.lock();
     
@@ -471,6 +525,75 @@ void MarkedBlock::Handle::sweep(FreeList* freeList)
     specializedSweep<false, IsEmpty, SweepOnly, BlockHasNoDestructors, DontScribble, HasNewlyAllocated, MarksStale>(freeList, emptyMode, sweepMode, BlockHasNoDestructors, scribbleMode, newlyAllocatedMode, marksMode, [] (VM&, JSCell*) { });
 }
 
+void MarkedBlock::Handle::requestPreparedFreeList()
+{
+    ASSERT(m_attributes.destruction == DoesNotNeedDestruction);
+    ASSERT(!m_isFreeListed);
+    m_preparedFreeListState.store(WantsPreparedFreeList);
+}
+
+void MarkedBlock::Handle::prepareFreeList()
+{
+    auto locker = holdLock(block().m_lock);
+    
+    // The mutator may have gotten to this block first, in which case it swept it itself.
+    if (m_preparedFreeListState.load() != WantsPreparedFreeList)
+        return;
+    
+    MarkedBlock& block = this->block();
+    MarksMode marksMode = this->marksMode();
+    NewlyAllocatedMode newlyAllocatedMode = this->newlyAllocatedMode();
+    
+    // This is the no-destructor, NotEmpty case of specializedSweep(). Blocks that are empty get
+    // bump-allocated, which is already cheap, so the sweeper never asks for those.
+    FreeCell* head = nullptr;
+    size_t count = 0;
+    uintptr_t secret;
+    cryptographicallyRandomValues(&secret, sizeof(uintptr_t));
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        if ((marksMode == MarksNotStale && block.m_marks.get(i))
+            || (newlyAllocatedMode == HasNewlyAllocated && m_newlyAllocated.get(i)))
+            continue;
+        
+        FreeCell* freeCell = reinterpret_cast_ptr<FreeCell*>(&block.atoms()[i]);
+        freeCell->setNext(head, secret);
+        head = freeCell;
+        ++count;
+    }
+    
+    m_preparedFreeListHead = head;
+    m_preparedFreeListSecret = secret;
+    m_preparedFreeListBytes = count * cellSize();
+    m_preparedFreeListState.store(HasPreparedFreeList);
+}
+
+void MarkedBlock::Handle::clearPreparedFreeList()
+{
+    auto locker = holdLock(block().m_lock);
+    m_preparedFreeListState.store(NoPreparedFreeList);
+    m_preparedFreeListHead = nullptr;
+}
+
+bool MarkedBlock::Handle::adoptPreparedFreeList(FreeList& freeList)
+{
+    auto locker = holdLock(block().m_lock);
+    
+    // Either way, the sweeper must leave this block alone from now on.
+    bool hasPreparedFreeList = m_preparedFreeListState.load() == HasPreparedFreeList;
+    m_preparedFreeListState.store(NoPreparedFreeList);
+    if (!hasPreparedFreeList)
+        return false;
+    
+    // Same as specializedSweep(): once there is a free list, the newlyAllocated bits are stale.
+    if (newlyAllocatedMode() == HasNewlyAllocated)
+        m_newlyAllocatedVersion = MarkedSpace::nullVersion;
+    
+    freeList.initializeList(m_preparedFreeListHead, m_preparedFreeListSecret, m_preparedFreeListBytes);
+    m_preparedFreeListHead = nullptr;
+    setIsFreeListed();
+    return true;
+}
+
 bool MarkedBlock::Handle::isFreeListedCell(const void* target) const
 {
     ASSERT(isFreeListed());
@@ -34,6 +34,7 @@
 namespace JSC {
     
 class FreeList;
+struct FreeCell;
 class Heap;
 class JSCell;
 class MarkedAllocator;
@@ -134,9 +135,24 @@ public:
         
         void unsweepWithNoNewlyAllocated();
         
+        // The ConcurrentSweeper builds free lists for blocks that don't need destruction on helper
+        // threads, so that sweep() can just pick them up. The request is made with the world
+        // stopped, the list is prepared on a helper thread, and it's cleared when the sweeper stops
+        // before the next collection. All of these synchronize with sweep() using the block's lock.
+        void requestPreparedFreeList();
+        void prepareFreeList();
+        void clearPreparedFreeList();
+        
         void zap(const FreeList&);
         
         void shrink();
+        
+        // The BlockScavenger gives the pages of blocks that have stayed empty back to the OS. The
+        // MarkedBlock itself stays committed, so only the pages that hold nothing but cells are
+        // given back. decommitCells() returns false if there are no such pages. The pages read
+        // as zero until they are recommitted, which makes every cell look zapped.
+        bool decommitCells();
+        void recommitCells();
             
         void visitWeakSet(SlotVisitor&);
         void reapWeakSet();
@@ -218,6 +234,8 @@ public:
         
         void setIsFreeListed();
         
+        bool adoptPreparedFreeList(FreeList&);
+        
         MarkedBlock::Handle* m_prev;
         MarkedBlock::Handle* m_next;
             
@@ -234,6 +252,12 @@ public:
         WeakSet m_weakSet;
         
         HeapVersion m_newlyAllocatedVersion;
+        
+        enum PreparedFreeListState : uint8_t { NoPreparedFreeList, WantsPreparedFreeList, HasPreparedFreeList };
+        Atomic<PreparedFreeListState> m_preparedFreeListState;
+        FreeCell* m_preparedFreeListHead { nullptr };
+        uintptr_t m_preparedFreeListSecret { 0 };
+        unsigned m_preparedFreeListBytes { 0 };
             
         MarkedBlock* m_block { nullptr };
     };
@@ -377,6 +377,19 @@ void MarkedSpace::shrink()
             allocator.shrink();
             return IterationStatus::Continue;
         });
+    m_largeObjectSpace.releaseEmptyPages();
+}
+
+bool MarkedSpace::scavenge(size_t& numberOfDecommittedBlocks, size_t& numberOfFreedBlocks)
+{
+    bool hasIdleBlocks = false;
+    forEachAllocator(
+        [&] (MarkedAllocator& allocator) -> IterationStatus {
+            hasIdleBlocks |= allocator.scavenge(numberOfDecommittedBlocks, numberOfFreedBlocks);
+            return IterationStatus::Continue;
+        });
+    m_largeObjectSpace.releaseEmptyPages();
+    return hasIdleBlocks;
 }
 
 void MarkedSpace::beginMarking()
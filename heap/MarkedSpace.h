@@ -23,6 +23,7 @@
 
 #include "IterationStatus.h"
 #include "LargeAllocation.h"
+#include "LargeObjectSpace.h"
 #include "MarkedAllocator.h"
 #include "MarkedBlock.h"
 #include "MarkedBlockSet.h"
@@ -119,10 +120,18 @@ public:
     template<typename Functor> void forEachLiveCell(HeapIterationScope&, const Functor&);
     template<typename Functor> void forEachDeadCell(HeapIterationScope&, const Functor&);
     template<typename Functor> void forEachBlock(const Functor&);
+    template<typename Functor> void forEachSubspace(const Functor&);
 
     void shrink();
     void freeBlock(MarkedBlock::Handle*);
     void freeOrShrinkBlock(MarkedBlock::Handle*);
+    
+    // See BlockScavenger.
+    bool scavenge(size_t& numberOfDecommittedBlocks, size_t& numberOfFreedBlocks);
+    void didDecommitBlock() { m_numberOfDecommittedBlocks++; }
+    void didRecommitBlock() { m_numberOfDecommittedBlocks--; }
+    size_t numberOfDecommittedBlocks() const { return m_numberOfDecommittedBlocks; }
+    size_t numberOfCommittedBlocks() const { return m_blocks.set().size() - m_numberOfDecommittedBlocks; }
 
     void didAddBlock(MarkedBlock::Handle*);
     void didConsumeFreeList(MarkedBlock::Handle*);
@@ -144,6 +153,7 @@ public:
     HeapVersion markingVersion() const { return m_markingVersion; }
     HeapVersion newlyAllocatedVersion() const { return m_newlyAllocatedVersion; }
 
+    LargeObjectSpace& largeObjectSpace() { return m_largeObjectSpace; }
     const Vector<LargeAllocation*>& largeAllocations() const { return m_largeAllocations; }
     unsigned largeAllocationsNurseryOffset() const { return m_largeAllocationsNurseryOffset; }
     unsigned largeAllocationsOffsetForThisCollection() const { return m_largeAllocationsOffsetForThisCollection; }
@@ -192,6 +202,7 @@ private:
 
     Vector<Subspace*> m_subspaces;
 
+    LargeObjectSpace m_largeObjectSpace;
     Vector<LargeAllocation*> m_largeAllocations;
     unsigned m_largeAllocationsNurseryOffset { 0 };
     unsigned m_largeAllocationsOffsetForThisCollection { 0 };
@@ -207,6 +218,7 @@ private:
     bool m_isIterating;
     bool m_isMarking { false };
     MarkedBlockSet m_blocks;
+    size_t m_numberOfDecommittedBlocks { 0 };
     
     SentinelLinkedList<WeakSet, BasicRawSentinelNode<WeakSet>> m_activeWeakSets;
     SentinelLinkedList<WeakSet, BasicRawSentinelNode<WeakSet>> m_newActiveWeakSets;
@@ -229,6 +241,13 @@ template <typename Functor> inline void MarkedSpace::forEachBlock(const Functor&
         });
 }
 
+template <typename Functor>
+void MarkedSpace::forEachSubspace(const Functor& functor)
+{
+    for (Subspace* subspace : m_subspaces)
+        functor(*subspace);
+}
+
 template <typename Functor>
 void MarkedSpace::forEachAllocator(const Functor& functor)
 {
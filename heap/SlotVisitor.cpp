@@ -107,6 +107,15 @@ void SlotVisitor::didStartMarking()
         m_heapSnapshotBuilder = heapProfiler->activeSnapshotBuilder();
     
     m_markingVersion = heap()->objectSpace().markingVersion();
+    
+    if (Options::useWorkStealingMarkStacks() && !m_isStealable)
+        m_isStealable = m_heap.addStealableSlotVisitor(*this, m_stealCursor);
+    
+    m_timeDraining = Seconds();
+    m_timeWaiting = Seconds();
+    m_segmentsDonated = 0;
+    m_segmentsStolen = 0;
+    m_failedSteals = 0;
 }
 
 void SlotVisitor::reset()
@@ -116,6 +125,11 @@ void SlotVisitor::reset()
     m_visitCount = 0;
     m_heapSnapshotBuilder = nullptr;
     RELEASE_ASSERT(!m_currentCell);
+    
+    ASSERT(m_collectorDeque.isEmpty());
+    ASSERT(m_mutatorDeque.isEmpty());
+    m_collectorDeque.releaseRetiredBuffers();
+    m_mutatorDeque.releaseRetiredBuffers();
 }
 
 void SlotVisitor::clearMarkStacks()
@@ -123,6 +137,7 @@ void SlotVisitor::clearMarkStacks()
     forEachMarkStack(
         [&] (MarkStackArray& stack) -> IterationStatus {
             stack.clear();
+            correspondingDeque(stack).clear();
             return IterationStatus::Continue;
         });
 }
@@ -403,6 +418,11 @@ void SlotVisitor::donateKnownParallel(MarkStackArray& from, MarkStackArray& to)
     // NOTE: Because we re-try often, we can afford to be conservative, and
     // assume that donating is not profitable.
 
+    if (m_isStealable && from.numberOfFullSegments()) {
+        donateToDeque(from, correspondingDeque(from));
+        return;
+    }
+
     // Avoid locking when a thread reaches a dead end in the object graph.
     if (from.size() < 2)
         return;
@@ -424,6 +444,85 @@ void SlotVisitor::donateKnownParallel(MarkStackArray& from, MarkStackArray& to)
     m_heap.m_markingConditionVariable.notifyAll();
 }
 
+void SlotVisitor::donateToDeque(MarkStackArray& from, MarkStackDeque& deque)
+{
+    // This is the lock-free version of donateSomeCellsTo(). If the other markers haven't taken
+    // what we donated last time, they don't need more.
+    if (deque.isEmpty()) {
+        size_t segmentsToDonate = (from.numberOfFullSegments() + 1) / 2;
+        m_segmentsDonated += segmentsToDonate;
+        while (segmentsToDonate--)
+            deque.push(from.takeFullSegment());
+    }
+    
+    // Reading this without the lock is racy, but missing a waiter only costs us parallelism: we
+    // will take our segments back if nobody steals them.
+    if (m_heap.m_numberOfWaitingParallelMarkers)
+        notifyWaitingMarkers();
+}
+
+bool SlotVisitor::takeFromOwnDeques()
+{
+    IterationStatus status = forEachMarkStack(
+        [&] (MarkStackArray& stack) -> IterationStatus {
+            MarkStackDeque::Segment* segment = correspondingDeque(stack).pop();
+            if (!segment)
+                return IterationStatus::Continue;
+            stack.addFullSegment(segment);
+            return IterationStatus::Done;
+        });
+    return status == IterationStatus::Done;
+}
+
+bool SlotVisitor::stealFromOtherSlotVisitors()
+{
+    if (!Options::useWorkStealingMarkStacks())
+        return false;
+    
+    unsigned count = m_heap.m_numberOfStealableSlotVisitors.load();
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned index = (m_stealCursor + i) % count;
+        SlotVisitor* victim = m_heap.m_stealableSlotVisitors[index];
+        if (victim == this)
+            continue;
+        
+        if (MarkStackDeque::Segment* segment = victim->m_collectorDeque.steal())
+            m_collectorStack.addFullSegment(segment);
+        else if (MarkStackDeque::Segment* segment = victim->m_mutatorDeque.steal())
+            m_mutatorStack.addFullSegment(segment);
+        else {
+            m_failedSteals++;
+            continue;
+        }
+        
+        // Start with the same victim next time, since it's the one that has work.
+        m_stealCursor = index;
+        m_segmentsStolen++;
+        return true;
+    }
+    return false;
+}
+
+bool SlotVisitor::hasStealableWork()
+{
+    unsigned count = m_heap.m_numberOfStealableSlotVisitors.load();
+    for (unsigned i = 0; i < count; ++i) {
+        SlotVisitor* visitor = m_heap.m_stealableSlotVisitors[i];
+        if (!visitor->m_collectorDeque.isEmpty() || !visitor->m_mutatorDeque.isEmpty())
+            return true;
+    }
+    return false;
+}
+
+void SlotVisitor::notifyWaitingMarkers()
+{
+    // Waiters check for stealable work with the lock held before they sleep, so taking the lock
+    // here means that each one either sees our segments or gets this notification. Skipping the
+    // notification when the lock is contended could leave them asleep with work available.
+    LockHolder locker(m_heap.m_markingMutex);
+    m_heap.m_markingConditionVariable.notifyAll();
+}
+
 void SlotVisitor::donateKnownParallel()
 {
     forEachMarkStack(
@@ -484,8 +583,11 @@ NEVER_INLINE void SlotVisitor::drain(MonotonicTime timeout)
                     visitChildren(stack.removeLast());
                 return IterationStatus::Done;
             });
-        if (status == IterationStatus::Continue)
+        if (status == IterationStatus::Continue) {
+            if (takeFromOwnDeques())
+                continue;
             break;
+        }
         
         m_rightToRun.safepoint();
         donateKnownParallel();
@@ -542,8 +644,11 @@ size_t SlotVisitor::performIncrementOfDraining(size_t bytesRequested)
                     }
                     return IterationStatus::Done;
                 });
-            if (status == IterationStatus::Continue)
+            if (status == IterationStatus::Continue) {
+                if (takeFromOwnDeques())
+                    continue;
                 break;
+            }
             m_rightToRun.safepoint();
             donateKnownParallel();
         }
@@ -566,13 +671,15 @@ bool SlotVisitor::didReachTermination(const AbstractLocker&)
     return isEmpty()
         && !m_heap.m_numberOfActiveParallelMarkers
         && m_heap.m_sharedCollectorMarkStack->isEmpty()
-        && m_heap.m_sharedMutatorMarkStack->isEmpty();
+        && m_heap.m_sharedMutatorMarkStack->isEmpty()
+        && !hasStealableWork();
 }
 
 bool SlotVisitor::hasWork(const AbstractLocker&)
 {
     return !m_heap.m_sharedCollectorMarkStack->isEmpty()
-        || !m_heap.m_sharedMutatorMarkStack->isEmpty();
+        || !m_heap.m_sharedMutatorMarkStack->isEmpty()
+        || hasStealableWork();
 }
 
 NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedDrainMode sharedDrainMode, MonotonicTime timeout)
@@ -583,6 +690,15 @@ NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedD
 
     bool isActive = false;
     while (true) {
+        // Stealing has to happen while we still count as active, since otherwise another marker
+        // could see an empty heap while we hold the segment that we just stole.
+        if (isActive && !hasElapsed(timeout) && stealFromOtherSlotVisitors()) {
+            MonotonicTime before = MonotonicTime::now();
+            drain(timeout);
+            m_timeDraining += MonotonicTime::now() - before;
+            continue;
+        }
+        
         {
             LockHolder locker(m_heap.m_markingMutex);
             if (isActive)
@@ -602,7 +718,9 @@ NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedD
                     if (hasWork(locker))
                         break;
 
+                    MonotonicTime before = MonotonicTime::now();
                     m_heap.m_markingConditionVariable.waitUntil(m_heap.m_markingMutex, timeout);
+                    m_timeWaiting += MonotonicTime::now() - before;
                 }
             } else {
                 ASSERT(sharedDrainMode == SlaveDrain);
@@ -632,7 +750,9 @@ NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedD
                         || m_heap.m_parallelMarkersShouldExit;
                 };
 
+                MonotonicTime before = MonotonicTime::now();
                 m_heap.m_markingConditionVariable.waitUntil(m_heap.m_markingMutex, timeout, isReady);
+                m_timeWaiting += MonotonicTime::now() - before;
                 
                 if (m_heap.m_parallelMarkersShouldExit)
                     return SharedDrainResult::Done;
@@ -650,7 +770,9 @@ NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedD
             m_heap.m_numberOfWaitingParallelMarkers--;
         }
         
+        MonotonicTime before = MonotonicTime::now();
         drain(timeout);
+        m_timeDraining += MonotonicTime::now() - before;
         isActive = true;
     }
 }
@@ -704,7 +826,11 @@ void SlotVisitor::donateAll(const AbstractLocker&)
 {
     forEachMarkStack(
         [&] (MarkStackArray& stack) -> IterationStatus {
-            stack.transferTo(correspondingGlobalStack(stack));
+            MarkStackArray& globalStack = correspondingGlobalStack(stack);
+            MarkStackDeque& deque = correspondingDeque(stack);
+            while (MarkStackDeque::Segment* segment = deque.pop())
+                globalStack.addFullSegment(segment);
+            stack.transferTo(globalStack);
             return IterationStatus::Continue;
         });
 
@@ -800,6 +926,11 @@ void SlotVisitor::addWeakReferenceHarvester(WeakReferenceHarvester* weakReferenc
     m_heap.m_weakReferenceHarvesters.addThreadSafe(weakReferenceHarvester);
 }
 
+void SlotVisitor::addEphemeronTable(EphemeronTable* table)
+{
+    m_heap.m_ephemeronTables.addThreadSafe(table);
+}
+
 void SlotVisitor::addUnconditionalFinalizer(UnconditionalFinalizer* unconditionalFinalizer)
 {
     m_heap.m_unconditionalFinalizers.addThreadSafe(unconditionalFinalizer);
@@ -821,6 +952,16 @@ void SlotVisitor::dump(PrintStream& out) const
     out.print("Collector: [", pointerListDump(collectorMarkStack()), "], Mutator: [", pointerListDump(mutatorMarkStack()), "]");
 }
 
+void SlotVisitor::dumpUtilization(PrintStream& out) const
+{
+    Seconds total = m_timeDraining + m_timeWaiting;
+    double utilization = total.value() ? m_timeDraining.value() / total.value() : 0;
+    out.print(
+        m_codeName, ":", static_cast<int>(utilization * 100), "% (", m_timeDraining.milliseconds(), "ms/",
+        total.milliseconds(), "ms, ", m_bytesVisited / 1024, "kb, donated ", m_segmentsDonated,
+        ", stole ", m_segmentsStolen, ", missed ", m_failedSteals, ")");
+}
+
 MarkStackArray& SlotVisitor::correspondingGlobalStack(MarkStackArray& stack)
 {
     if (&stack == &m_collectorStack)
@@ -829,4 +970,12 @@ MarkStackArray& SlotVisitor::correspondingGlobalStack(MarkStackArray& stack)
     return *m_heap.m_sharedMutatorMarkStack;
 }
 
+MarkStackDeque& SlotVisitor::correspondingDeque(MarkStackArray& stack)
+{
+    if (&stack == &m_collectorStack)
+        return m_collectorDeque;
+    RELEASE_ASSERT(&stack == &m_mutatorStack);
+    return m_mutatorDeque;
+}
+
 } // namespace JSC
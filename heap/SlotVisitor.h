@@ -28,6 +28,7 @@
 #include "HandleTypes.h"
 #include "IterationStatus.h"
 #include "MarkStack.h"
+#include "MarkStackDeque.h"
 #include "OpaqueRootSet.h"
 #include "VisitRaceKey.h"
 #include <wtf/MonotonicTime.h>
@@ -36,6 +37,7 @@
 namespace JSC {
 
 class ConservativeRoots;
+class EphemeronTable;
 class GCThreadSharedData;
 class Heap;
 class HeapCell;
@@ -100,7 +102,11 @@ public:
     JS_EXPORT_PRIVATE bool containsOpaqueRoot(void*) const;
     TriState containsOpaqueRootTriState(void*) const;
 
-    bool isEmpty() { return m_collectorStack.isEmpty() && m_mutatorStack.isEmpty(); }
+    bool isEmpty()
+    {
+        return m_collectorStack.isEmpty() && m_mutatorStack.isEmpty()
+            && m_collectorDeque.isEmpty() && m_mutatorDeque.isEmpty();
+    }
 
     void didStartMarking();
     void reset();
@@ -140,6 +146,7 @@ public:
 #endif
     
     void addWeakReferenceHarvester(WeakReferenceHarvester*);
+    void addEphemeronTable(EphemeronTable*);
     void addUnconditionalFinalizer(UnconditionalFinalizer*);
 
     void dump(PrintStream&) const;
@@ -172,6 +179,8 @@ public:
     void donateAll();
     
     const char* codeName() const { return m_codeName.data(); }
+    
+    void dumpUtilization(PrintStream&) const;
 
 private:
     friend class ParallelModeEnabler;
@@ -204,6 +213,12 @@ private:
     void donateKnownParallel(MarkStackArray& from, MarkStackArray& to);
 
     void donateAll(const AbstractLocker&);
+    
+    void donateToDeque(MarkStackArray&, MarkStackDeque&);
+    bool takeFromOwnDeques();
+    bool stealFromOtherSlotVisitors();
+    bool hasStealableWork();
+    void notifyWaitingMarkers();
 
     bool hasWork(const AbstractLocker&);
     bool didReachTermination(const AbstractLocker&);
@@ -212,9 +227,25 @@ private:
     IterationStatus forEachMarkStack(const Func&);
 
     MarkStackArray& correspondingGlobalStack(MarkStackArray&);
+    MarkStackDeque& correspondingDeque(MarkStackArray&);
 
     MarkStackArray m_collectorStack;
     MarkStackArray m_mutatorStack;
+    
+    // With useWorkStealingMarkStacks, we share full segments of our mark stacks through these
+    // rather than through the Heap's shared mark stacks. Only visitors that the Heap has registered
+    // as stealable push to them.
+    MarkStackDeque m_collectorDeque;
+    MarkStackDeque m_mutatorDeque;
+    bool m_isStealable { false };
+    unsigned m_stealCursor { 0 };
+    
+    // Utilization of this marker during the current cycle, for logMarkerUtilization.
+    Seconds m_timeDraining;
+    Seconds m_timeWaiting;
+    size_t m_segmentsDonated { 0 };
+    size_t m_segmentsStolen { 0 };
+    size_t m_failedSteals { 0 };
     OpaqueRootSet m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
     bool m_ignoreNewOpaqueRoots { false }; // Useful as a debugging mode.
     
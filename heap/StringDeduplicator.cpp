@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StringDeduplicator.h"
+
+#include "ConservativeRoots.h"
+#include "DFGWorklist.h"
+#include "Heap.h"
+#include "JSCInlines.h"
+#include "SubspaceInlines.h"
+
+namespace JSC {
+
+StringDeduplicator::StringDeduplicator(Heap& heap)
+    : m_heap(heap)
+{
+}
+
+StringDeduplicator::~StringDeduplicator()
+{
+}
+
+void StringDeduplicator::didGatherConservativeRoots(ConservativeRoots& roots)
+{
+    // The conservative scan may run more than once per collection, but constraints are executed one
+    // at a time, so this does not need a lock. It is only read once the collection is finalized.
+    if (!Options::useStringDeduplication())
+        return;
+    
+    HeapCell** cells = roots.roots();
+    for (size_t i = roots.size(); i--;)
+        m_conservativeRoots.add(cells[i]);
+}
+
+void StringDeduplicator::didFinishCollection(CollectionScope scope)
+{
+    if (scope != CollectionScope::Full) {
+        m_conservativeRoots.clear();
+        return;
+    }
+    
+    MonotonicTime before;
+    if (Options::logGC())
+        before = MonotonicTime::now();
+    
+    m_lastStatistics = Statistics();
+    releaseReplacedStrings();
+    
+    if (Options::useStringDeduplication()) {
+        m_heap.suspendCompilerThreads();
+        if (!compilerPlansAreActive())
+            deduplicate();
+        m_heap.resumeCompilerThreads();
+    }
+    m_conservativeRoots.clear();
+    
+    m_totalStatistics.stringsVisited += m_lastStatistics.stringsVisited;
+    m_totalStatistics.stringsDeduplicated += m_lastStatistics.stringsDeduplicated;
+    m_totalStatistics.bytesSaved += m_lastStatistics.bytesSaved;
+    
+    if (Options::logGC()) {
+        dataLog(
+            "[GC<", RawPointer(&m_heap), ">: deduplicated ", m_lastStatistics.stringsDeduplicated, " of ",
+            m_lastStatistics.stringsVisited, " strings, saved ", m_lastStatistics.bytesSaved / 1024, "kb (",
+            m_totalStatistics.bytesSaved / 1024, "kb total), ", (MonotonicTime::now() - before).milliseconds(), "ms]\n");
+    }
+}
+
+bool StringDeduplicator::compilerPlansAreActive()
+{
+#if ENABLE(DFG_JIT)
+    // The compiler threads are suspended, so no plan can be added or finish while we look.
+    for (unsigned i = DFG::numberOfWorklists(); i--;) {
+        if (DFG::existingWorklistForIndex(i).isActiveForVM(*m_heap.vm()))
+            return true;
+    }
+#endif
+    return false;
+}
+
+void StringDeduplicator::releaseReplacedStrings()
+{
+    for (String& string : m_replacedStrings) {
+        StringImpl* impl = string.impl();
+        if (impl->hasOneRef() && !impl->isSubString())
+            m_lastStatistics.bytesSaved += impl->length() * (impl->is8Bit() ? sizeof(LChar) : sizeof(UChar));
+    }
+    m_replacedStrings.clear();
+}
+
+void StringDeduplicator::deduplicate()
+{
+    unsigned minimumLength = Options::minimumStringDeduplicationLength();
+    HashSet<String> canonicalStrings;
+    
+    m_heap.vm()->stringSpace.forEachMarkedCell(
+        [&] (HeapCell* heapCell, HeapCell::Kind) {
+            JSString* string = static_cast<JSString*>(heapCell);
+            if (string->isRope())
+                return;
+            
+            StringImpl* impl = string->m_value.impl();
+            if (impl->length() < minimumLength || impl->isAtomic() || impl->isSymbol() || impl->isStatic())
+                return;
+            
+            m_lastStatistics.stringsVisited++;
+            
+            auto result = canonicalStrings.add(string->m_value);
+            if (result.isNewEntry || result.iterator->impl() == impl)
+                return;
+            // Don't widen an 8-bit string just because it was seen second.
+            if (result.iterator->impl()->is8Bit() != impl->is8Bit())
+                return;
+            // Somebody other than this JSString might be using the characters, and replacing the
+            // StringImpl would not free them anyway.
+            if (!impl->hasOneRef() || impl->isSubString() || m_conservativeRoots.contains(heapCell))
+                return;
+            
+            m_lastStatistics.stringsDeduplicated++;
+            
+            m_replacedStrings.append(WTFMove(string->m_value));
+            string->m_value = *result.iterator;
+        });
+}
+
+} // namespace JSC
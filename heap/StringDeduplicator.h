@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "CollectionScope.h"
+#include <wtf/HashSet.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class ConservativeRoots;
+class Heap;
+class HeapCell;
+
+// After a full collection, every string that survived is old. The deduplicator walks the resolved
+// JSStrings that are marked, hashes their contents, and points the ones that have the same contents
+// as an earlier string at that string's StringImpl, so that the duplicates' buffers can be freed.
+// Atoms, symbols and static strings keep their identity.
+//
+// It runs on the mutator when the collection is finalized, with the compiler threads suspended,
+// since StringImpl's reference count is not thread safe. Nothing may be left pointing at a
+// StringImpl that we replace, so we only replace StringImpls whose last owner is the JSString, and
+// we leave alone:
+//
+// - Every string while a DFG or FTL plan for this VM is in flight, since plans hold raw StringImpl
+//   pointers (see LazyJSValue::KnownStringImpl) from the moment they are created until they are
+//   finalized.
+// - Strings that the conservative scan found, since native code that holds a StringView or a
+//   character pointer across an allocation keeps the JSString alive from its stack.
+//
+// As a last line of defense, the StringImpls that we replace are kept until the next full
+// collection is finalized. That is also when we count the bytes that deduplication saved.
+class StringDeduplicator {
+    WTF_MAKE_NONCOPYABLE(StringDeduplicator);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Statistics {
+        size_t stringsVisited { 0 };
+        size_t stringsDeduplicated { 0 };
+        size_t bytesSaved { 0 };
+    };
+    
+    StringDeduplicator(Heap&);
+    ~StringDeduplicator();
+    
+    void didGatherConservativeRoots(ConservativeRoots&);
+    void didFinishCollection(CollectionScope);
+    
+    const Statistics& lastStatistics() const { return m_lastStatistics; }
+    const Statistics& totalStatistics() const { return m_totalStatistics; }
+    
+private:
+    bool compilerPlansAreActive();
+    void releaseReplacedStrings();
+    void deduplicate();
+    
+    Heap& m_heap;
+    Vector<String> m_replacedStrings;
+    HashSet<HeapCell*> m_conservativeRoots;
+    Statistics m_lastStatistics;
+    Statistics m_totalStatistics;
+};
+
+} // namespace JSC
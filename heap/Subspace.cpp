@@ -26,6 +26,7 @@
 #include "config.h"
 #include "Subspace.h"
 
+#include "AllocationSamplingProfiler.h"
 #include "JSCInlines.h"
 #include "MarkedAllocatorInlines.h"
 #include "MarkedBlockInlines.h"
@@ -201,13 +202,24 @@ void* Subspace::tryAllocateSlow(GCDeferralContext* deferralContext, size_t size)
     
     m_space.m_largeAllocations.append(allocation);
     m_space.m_heap->didAllocate(size);
+    didAllocateBytes(size);
     m_space.m_capacity += size;
     
     m_largeAllocations.append(allocation);
+    
+    if (AllocationSamplingProfiler* profiler = m_space.m_heap->vm()->allocationSamplingProfiler())
+        profiler->didAllocate(allocation->cell(), size);
         
     return allocation->cell();
 }
 
+void Subspace::didGrowLargeAllocation(size_t bytes)
+{
+    m_space.m_heap->didAllocate(bytes);
+    didAllocateBytes(bytes);
+    m_space.m_capacity += bytes;
+}
+
 ALWAYS_INLINE void Subspace::didAllocate(void* ptr)
 {
     UNUSED_PARAM(ptr);
@@ -83,6 +83,14 @@ public:
     template<typename Func>
     void forEachLiveCell(const Func&);
     
+    // Counts the bytes handed out to the mutator since the GC event log last took the count, so that
+    // the log can tell how much each collection freed.
+    void didAllocateBytes(size_t bytes) { m_bytesAllocatedSinceLastCollection += bytes; }
+    size_t takeBytesAllocatedSinceLastCollection() { return std::exchange(m_bytesAllocatedSinceLastCollection, 0); }
+    
+    // Accounts for a LargeAllocation of this subspace growing in place.
+    void didGrowLargeAllocation(size_t bytes);
+    
     static ptrdiff_t offsetOfAllocatorForSizeStep() { return OBJECT_OFFSETOF(Subspace, m_allocatorForSizeStep); }
     
     MarkedAllocator** allocatorForSizeStep() { return &m_allocatorForSizeStep[0]; }
@@ -104,6 +112,7 @@ private:
     std::array<MarkedAllocator*, MarkedSpace::numSizeClasses> m_allocatorForSizeStep;
     MarkedAllocator* m_firstAllocator { nullptr };
     SentinelLinkedList<LargeAllocation, BasicRawSentinelNode<LargeAllocation>> m_largeAllocations;
+    size_t m_bytesAllocatedSinceLastCollection { 0 };
 };
 
 ALWAYS_INLINE MarkedAllocator* Subspace::tryAllocatorFor(size_t size)
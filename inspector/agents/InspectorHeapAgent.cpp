@@ -26,14 +26,17 @@
 #include "config.h"
 #include "InspectorHeapAgent.h"
 
+#include "AllocationSamplingProfiler.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshot.h"
+#include "HeapSnapshotWriter.h"
 #include "InjectedScript.h"
 #include "InjectedScriptManager.h"
 #include "InspectorEnvironment.h"
 #include "JSCInlines.h"
 #include "VM.h"
 #include <wtf/Stopwatch.h>
+#include <wtf/text/Base64.h>
 
 using namespace JSC;
 
@@ -61,6 +64,12 @@ void InspectorHeapAgent::willDestroyFrontendAndBackend(DisconnectReason)
     // Stop tracking without taking a snapshot.
     m_tracking = false;
 
+    if (m_samplingAllocations) {
+        m_samplingAllocations = false;
+        JSLockHolder lock(m_environment.vm());
+        m_environment.vm().stopAllocationSamplingProfiler();
+    }
+
     ErrorString ignored;
     disable(ignored);
 }
@@ -115,6 +124,52 @@ void InspectorHeapAgent::snapshot(ErrorString&, double* timestamp, String* snaps
     });
 }
 
+void InspectorHeapAgent::streamSnapshot(ErrorString& errorString, const String* const optionalFormat, double* timestamp)
+{
+    bool isBinary = false;
+    if (optionalFormat) {
+        if (*optionalFormat == "binary")
+            isBinary = true;
+        else if (*optionalFormat != "json") {
+            errorString = ASCIILiteral("Unknown heap snapshot format");
+            return;
+        }
+    }
+
+    VM& vm = m_environment.vm();
+    JSLockHolder lock(vm);
+
+    HeapSnapshotBuilder snapshotBuilder(vm.ensureHeapProfiler());
+    snapshotBuilder.buildSnapshot();
+
+    *timestamp = m_environment.executionStopwatch()->elapsedTime();
+
+    auto allowNode = [&] (const HeapSnapshotNode& node) {
+        if (Structure* structure = node.cell->structure(vm)) {
+            if (JSGlobalObject* globalObject = structure->globalObject()) {
+                if (!m_environment.canAccessInspectedScriptState(globalObject->globalExec()))
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    if (isBinary) {
+        HeapSnapshotBinaryWriter writer([&] (const char* data, size_t length) {
+            m_frontendDispatcher->snapshotChunk(base64Encode(data, static_cast<unsigned>(length)));
+            return true;
+        });
+        snapshotBuilder.write(writer, allowNode);
+        return;
+    }
+
+    HeapSnapshotJSONWriter writer([&] (const char* data, size_t length) {
+        m_frontendDispatcher->snapshotChunk(String::fromUTF8(data, length));
+        return true;
+    });
+    snapshotBuilder.write(writer, allowNode);
+}
+
 void InspectorHeapAgent::startTracking(ErrorString& errorString)
 {
     if (m_tracking)
@@ -143,6 +198,48 @@ void InspectorHeapAgent::stopTracking(ErrorString& errorString)
     m_frontendDispatcher->trackingComplete(timestamp, snapshotData);
 }
 
+void InspectorHeapAgent::startAllocationSampling(ErrorString& errorString, const int* const optionalInterval)
+{
+    if (m_samplingAllocations) {
+        errorString = ASCIILiteral("Allocation sampling already started");
+        return;
+    }
+
+    size_t interval = Options::allocationSamplingInterval();
+    if (optionalInterval) {
+        if (*optionalInterval <= 0) {
+            errorString = ASCIILiteral("Allocation sampling interval must be positive");
+            return;
+        }
+        interval = *optionalInterval;
+    }
+
+    VM& vm = m_environment.vm();
+    JSLockHolder lock(vm);
+    if (vm.allocationSamplingProfiler()) {
+        errorString = ASCIILiteral("Allocations are already being sampled by another client");
+        return;
+    }
+
+    m_samplingAllocations = true;
+    vm.ensureAllocationSamplingProfiler(interval);
+}
+
+void InspectorHeapAgent::stopAllocationSampling(ErrorString& errorString, String* profileData)
+{
+    if (!m_samplingAllocations) {
+        errorString = ASCIILiteral("Allocation sampling not started");
+        return;
+    }
+
+    m_samplingAllocations = false;
+
+    VM& vm = m_environment.vm();
+    JSLockHolder lock(vm);
+    *profileData = vm.allocationSamplingProfiler()->json();
+    vm.stopAllocationSamplingProfiler();
+}
+
 std::optional<HeapSnapshotNode> InspectorHeapAgent::nodeForHeapObjectIdentifier(ErrorString& errorString, unsigned heapObjectIdentifier)
 {
     HeapProfiler* heapProfiler = m_environment.vm().heapProfiler();
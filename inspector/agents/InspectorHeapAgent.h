@@ -55,8 +55,11 @@ public:
     void disable(ErrorString&) override;
     void gc(ErrorString&) final;
     void snapshot(ErrorString&, double* timestamp, String* snapshotData) final;
+    void streamSnapshot(ErrorString&, const String* const optionalFormat, double* timestamp) final;
     void startTracking(ErrorString&) final;
     void stopTracking(ErrorString&) final;
+    void startAllocationSampling(ErrorString&, const int* const optionalInterval) final;
+    void stopAllocationSampling(ErrorString&, String* profileData) final;
     void getPreview(ErrorString&, int heapObjectId, Inspector::Protocol::OptOutput<String>* resultString, RefPtr<Inspector::Protocol::Debugger::FunctionDetails>& functionDetails, RefPtr<Inspector::Protocol::Runtime::ObjectPreview>& objectPreview) final;
     void getRemoteObject(ErrorString&, int heapObjectId, const String* const optionalObjectGroup, RefPtr<Inspector::Protocol::Runtime::RemoteObject>& result) final;
 
@@ -79,6 +82,7 @@ private:
 
     bool m_enabled { false };
     bool m_tracking { false };
+    bool m_samplingAllocations { false };
     double m_gcStartTime { NAN };
 };
 
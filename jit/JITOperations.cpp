@@ -57,6 +57,7 @@
 #include "JSGlobalObjectFunctions.h"
 #include "JSLexicalEnvironment.h"
 #include "JSPropertyNameEnumerator.h"
+#include "MegamorphicCache.h"
 #include "ModuleProgramCodeBlock.h"
 #include "ObjectConstructor.h"
 #include "PolymorphicAccess.h"
@@ -218,6 +219,50 @@ EncodedJSValue JIT_OPERATION operationTryGetByIdOptimize(ExecState* exec, Struct
     return JSValue::encode(slot.getPureResult());
 }
 
+// The inline caches that gave up call the generic operations, which share the VM's MegamorphicCache.
+// A hit finds the offset of an own data property without looking it up.
+static JSValue getByIdMegamorphic(ExecState* exec, VM& vm, JSValue baseValue, const Identifier& ident)
+{
+    if (!Options::useMegamorphicCache() || !baseValue.isObject()) {
+        PropertySlot slot(baseValue, PropertySlot::InternalMethodType::Get);
+        return baseValue.get(exec, ident, slot);
+    }
+    
+    JSObject* object = asObject(baseValue);
+    MegamorphicCache* cache = vm.ensureMegamorphicCache();
+    PropertyOffset offset = cache->loadOffset(object->structureID(), ident.impl());
+    if (isValidOffset(offset))
+        return object->getDirect(offset);
+    
+    Structure* structure = object->structure(vm);
+    PropertySlot slot(baseValue, PropertySlot::InternalMethodType::Get);
+    JSValue result = baseValue.get(exec, ident, slot);
+    cache->tryAddLoad(vm, object, structure, ident.impl(), slot);
+    return result;
+}
+
+static void putByIdMegamorphic(ExecState* exec, VM& vm, JSValue baseValue, const Identifier& ident, JSValue value, bool isStrictMode)
+{
+    MegamorphicCache* cache = nullptr;
+    JSObject* object = nullptr;
+    Structure* structure = nullptr;
+    if (Options::useMegamorphicCache() && baseValue.isObject()) {
+        object = asObject(baseValue);
+        cache = vm.ensureMegamorphicCache();
+        PropertyOffset offset = cache->storeOffset(object->structureID(), ident.impl());
+        if (isValidOffset(offset)) {
+            object->putDirect(vm, offset, value);
+            return;
+        }
+        structure = object->structure(vm);
+    }
+    
+    PutPropertySlot slot(baseValue, isStrictMode, exec->codeBlock()->putByIdContext());
+    baseValue.putInline(exec, ident, value, slot);
+    if (cache)
+        cache->tryAddStore(vm, object, structure, ident.impl(), slot);
+}
+
 EncodedJSValue JIT_OPERATION operationGetById(ExecState* exec, StructureStubInfo* stubInfo, EncodedJSValue base, UniquedStringImpl* uid)
 {
     SuperSamplerScope superSamplerScope(false);
@@ -228,11 +273,10 @@ EncodedJSValue JIT_OPERATION operationGetById(ExecState* exec, StructureStubInfo
     stubInfo->tookSlowPath = true;
     
     JSValue baseValue = JSValue::decode(base);
-    PropertySlot slot(baseValue, PropertySlot::InternalMethodType::Get);
     Identifier ident = Identifier::fromUid(vm, uid);
     
     LOG_IC((ICEvent::OperationGetById, baseValue.classInfoOrNull(*vm), ident));
-    return JSValue::encode(baseValue.get(exec, ident, slot));
+    return JSValue::encode(getByIdMegamorphic(exec, *vm, baseValue, ident));
 }
 
 EncodedJSValue JIT_OPERATION operationGetByIdGeneric(ExecState* exec, EncodedJSValue base, UniquedStringImpl* uid)
@@ -376,8 +420,7 @@ void JIT_OPERATION operationPutByIdStrict(ExecState* exec, StructureStubInfo* st
     Identifier ident = Identifier::fromUid(vm, uid);
     LOG_IC((ICEvent::OperationPutByIdStrict, baseValue.classInfoOrNull(*vm), ident));
 
-    PutPropertySlot slot(baseValue, true, exec->codeBlock()->putByIdContext());
-    baseValue.putInline(exec, ident, JSValue::decode(encodedValue), slot);
+    putByIdMegamorphic(exec, *vm, baseValue, ident, JSValue::decode(encodedValue), true);
 }
 
 void JIT_OPERATION operationPutByIdNonStrict(ExecState* exec, StructureStubInfo* stubInfo, EncodedJSValue encodedValue, EncodedJSValue encodedBase, UniquedStringImpl* uid)
@@ -392,8 +435,7 @@ void JIT_OPERATION operationPutByIdNonStrict(ExecState* exec, StructureStubInfo*
     JSValue baseValue = JSValue::decode(encodedBase);
     Identifier ident = Identifier::fromUid(vm, uid);
     LOG_IC((ICEvent::OperationPutByIdNonStrict, baseValue.classInfoOrNull(*vm), ident));
-    PutPropertySlot slot(baseValue, false, exec->codeBlock()->putByIdContext());
-    baseValue.putInline(exec, ident, JSValue::decode(encodedValue), slot);
+    putByIdMegamorphic(exec, *vm, baseValue, ident, JSValue::decode(encodedValue), false);
 }
 
 void JIT_OPERATION operationPutByIdDirectStrict(ExecState* exec, StructureStubInfo* stubInfo, EncodedJSValue encodedValue, EncodedJSValue encodedBase, UniquedStringImpl* uid)
@@ -22,6 +22,7 @@
 
 #include "config.h"
 
+#include "AllocationSamplingProfiler.h"
 #include "ArrayBuffer.h"
 #include "ArrayPrototype.h"
 #include "BuiltinExecutableCreator.h"
@@ -29,8 +30,10 @@
 #include "ButterflyInlines.h"
 #include "CatchScope.h"
 #include "CodeBlock.h"
+#include "CodeCache.h"
 #include "Completion.h"
 #include "ConfigFile.h"
+#include "DFGWorklist.h"
 #include "DOMJITGetterSetter.h"
 #include "Disassembler.h"
 #include "Exception.h"
@@ -39,6 +42,7 @@
 #include "GetterSetter.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshotBuilder.h"
+#include "HeapSnapshotWriter.h"
 #include "InitializeThreading.h"
 #include "Interpreter.h"
 #include "JIT.h"
@@ -62,6 +66,7 @@
 #include "LLIntThunks.h"
 #include "ObjectConstructor.h"
 #include "ParserError.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "PromiseDeferredTimer.h"
 #include "ProtoCallFrame.h"
@@ -71,6 +76,7 @@
 #include "Snippet.h"
 #include "SnippetParams.h"
 #include "StackVisitor.h"
+#include "StreamingJSONParser.h"
 #include "StructureInlines.h"
 #include "StructureRareDataInlines.h"
 #include "SuperSampler.h"
@@ -573,6 +579,41 @@ private:
     WriteBarrier<JSC::Unknown> m_hiddenValue;
 };
 
+class StreamingJSONParserObject : public JSDestructibleObject {
+public:
+    StreamingJSONParserObject(VM& vm, Structure* structure)
+        : Base(vm, structure)
+    {
+    }
+
+    typedef JSDestructibleObject Base;
+
+    static StreamingJSONParserObject* create(VM& vm, JSGlobalObject* globalObject)
+    {
+        Structure* structure = createStructure(vm, globalObject, jsNull());
+        StreamingJSONParserObject* result = new (NotNull, allocateCell<StreamingJSONParserObject>(vm.heap, sizeof(StreamingJSONParserObject))) StreamingJSONParserObject(vm, structure);
+        result->finishCreation(vm);
+        return result;
+    }
+
+    static void destroy(JSCell* cell)
+    {
+        static_cast<StreamingJSONParserObject*>(cell)->StreamingJSONParserObject::~StreamingJSONParserObject();
+    }
+
+    static Structure* createStructure(VM& vm, JSGlobalObject* globalObject, JSValue prototype)
+    {
+        return Structure::create(vm, globalObject, prototype, TypeInfo(ObjectType, StructureFlags), info());
+    }
+
+    StreamingJSONParser& parser() { return m_parser; }
+
+    DECLARE_INFO;
+
+private:
+    StreamingJSONParser m_parser;
+};
+
 class DOMJITNode : public JSNonFinalObject {
 public:
     DOMJITNode(VM& vm, Structure* structure)
@@ -958,6 +999,7 @@ const ClassInfo DOMJITFunctionObject::s_info = { "DOMJITFunctionObject", &Base::
 const ClassInfo DOMJITCheckSubClassObject::s_info = { "DOMJITCheckSubClassObject", &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(DOMJITCheckSubClassObject) };
 const ClassInfo RuntimeArray::s_info = { "RuntimeArray", &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(RuntimeArray) };
 const ClassInfo SimpleObject::s_info = { "SimpleObject", &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(SimpleObject) };
+const ClassInfo StreamingJSONParserObject::s_info = { "StreamingJSONParser", &Base::s_info, nullptr, nullptr, CREATE_METHOD_TABLE(StreamingJSONParserObject) };
 static unsigned asyncTestPasses { 0 };
 static unsigned asyncTestExpectedPasses { 0 };
 
@@ -1061,6 +1103,9 @@ static EncodedJSValue JSC_HOST_CALL functionGetElement(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCreateSimpleObject(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGetHiddenValue(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionSetHiddenValue(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionCreateStreamingJSONParser(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionAppendToStreamingJSONParser(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionFinishStreamingJSONParser(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionPrintStdOut(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionPrintStdErr(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDebug(ExecState*);
@@ -1083,6 +1128,7 @@ static EncodedJSValue JSC_HOST_CALL functionRun(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionRunString(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionLoad(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionLoadString(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionPrecompile(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionReadFile(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionReadline(ExecState*);
@@ -1121,6 +1167,10 @@ static EncodedJSValue JSC_HOST_CALL functionLoadModule(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckModuleSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionPlatformSupportsSamplingProfiler(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionStartAllocationSampling(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionAllocationSamplingProfile(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionStopAllocationSampling(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionSaveProfileCache(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionResetSuperSamplerState(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionEnsureArrayStorage(ExecState*);
 #if ENABLE(SAMPLING_PROFILER)
@@ -1312,6 +1362,7 @@ protected:
         addFunction(vm, "runString", functionRunString, 1);
         addFunction(vm, "load", functionLoad, 1);
         addFunction(vm, "loadString", functionLoadString, 1);
+        addFunction(vm, "precompile", functionPrecompile, 3);
         addFunction(vm, "readFile", functionReadFile, 2);
         addFunction(vm, "read", functionReadFile, 2);
         addFunction(vm, "checkSyntax", functionCheckSyntax, 1);
@@ -1344,6 +1395,10 @@ protected:
         addConstructableFunction(vm, "SimpleObject", functionCreateSimpleObject, 0);
         addFunction(vm, "getHiddenValue", functionGetHiddenValue, 1);
         addFunction(vm, "setHiddenValue", functionSetHiddenValue, 2);
+
+        addConstructableFunction(vm, "StreamingJSONParser", functionCreateStreamingJSONParser, 0);
+        addFunction(vm, "appendToStreamingJSONParser", functionAppendToStreamingJSONParser, 2);
+        addFunction(vm, "finishStreamingJSONParser", functionFinishStreamingJSONParser, 1);
         
         putDirectNativeFunction(vm, this, Identifier::fromString(&vm, "DFGTrue"), 0, functionFalse1, DFGTrueIntrinsic, DontEnum);
         putDirectNativeFunction(vm, this, Identifier::fromString(&vm, "OSRExit"), 0, functionUndefined1, OSRExitIntrinsic, DontEnum);
@@ -1396,6 +1451,10 @@ protected:
 
         addFunction(vm, "platformSupportsSamplingProfiler", functionPlatformSupportsSamplingProfiler, 0);
         addFunction(vm, "generateHeapSnapshot", functionGenerateHeapSnapshot, 0);
+        addFunction(vm, "startAllocationSampling", functionStartAllocationSampling, 1);
+        addFunction(vm, "allocationSamplingProfile", functionAllocationSamplingProfile, 0);
+        addFunction(vm, "stopAllocationSampling", functionStopAllocationSampling, 0);
+        addFunction(vm, "saveProfileCache", functionSaveProfileCache, 0);
         addFunction(vm, "resetSuperSamplerState", functionResetSuperSamplerState, 0);
         addFunction(vm, "ensureArrayStorage", functionEnsureArrayStorage, 0);
 #if ENABLE(SAMPLING_PROFILER)
@@ -1974,6 +2033,54 @@ EncodedJSValue JSC_HOST_CALL functionSetHiddenValue(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
+EncodedJSValue JSC_HOST_CALL functionCreateStreamingJSONParser(ExecState* exec)
+{
+    JSLockHolder lock(exec);
+    return JSValue::encode(StreamingJSONParserObject::create(exec->vm(), exec->lexicalGlobalObject()));
+}
+
+// appendToStreamingJSONParser(parser, chunk) feeds the next piece of a JSON document to a parser made
+// with StreamingJSONParser(), and returns false once the document is known to be malformed.
+EncodedJSValue JSC_HOST_CALL functionAppendToStreamingJSONParser(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    JSLockHolder lock(vm);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    StreamingJSONParserObject* parserObject = jsDynamicCast<StreamingJSONParserObject*>(vm, exec->argument(0));
+    if (UNLIKELY(!parserObject)) {
+        throwTypeError(exec, scope, ASCIILiteral("Invalid use of appendToStreamingJSONParser test function"));
+        return encodedJSValue();
+    }
+    String chunk = exec->argument(1).toWTFString(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    bool result = parserObject->parser().append(exec, chunk);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    return JSValue::encode(jsBoolean(result));
+}
+
+// finishStreamingJSONParser(parser) returns the value of the document, or throws a SyntaxError like
+// JSON.parse() would.
+EncodedJSValue JSC_HOST_CALL functionFinishStreamingJSONParser(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    JSLockHolder lock(vm);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    StreamingJSONParserObject* parserObject = jsDynamicCast<StreamingJSONParserObject*>(vm, exec->argument(0));
+    if (UNLIKELY(!parserObject)) {
+        throwTypeError(exec, scope, ASCIILiteral("Invalid use of finishStreamingJSONParser test function"));
+        return encodedJSValue();
+    }
+
+    JSValue result = parserObject->parser().finish(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    if (!result)
+        return throwVMError(exec, scope, createSyntaxError(exec, parserObject->parser().errorMessage()));
+    return JSValue::encode(result);
+}
+
 EncodedJSValue JSC_HOST_CALL functionCreateProxy(ExecState* exec)
 {
     JSLockHolder lock(exec);
@@ -2254,6 +2361,27 @@ EncodedJSValue JSC_HOST_CALL functionLoadString(ExecState* exec)
     return JSValue::encode(result);
 }
 
+// precompile(source, [url], [isModule]) compiles the source on a helper thread, so that a later
+// loadString() or import of the same text does not have to parse it.
+EncodedJSValue JSC_HOST_CALL functionPrecompile(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    String sourceCode = exec->argument(0).toWTFString(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    String url;
+    if (!exec->argument(1).isUndefined()) {
+        url = exec->argument(1).toWTFString(exec);
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    }
+    bool isModule = exec->argument(2).toBoolean(exec);
+
+    SourceProviderSourceType sourceType = isModule ? SourceProviderSourceType::Module : SourceProviderSourceType::Program;
+    SourceCode source = makeSource(sourceCode, isModule ? SourceOrigin { url } : exec->callerSourceOrigin(), url, TextPosition(), sourceType);
+    return JSValue::encode(jsBoolean(vm.codeCache()->precompile(vm, source, isModule ? SourceCodeType::ModuleType : SourceCodeType::ProgramType)));
+}
+
 EncodedJSValue JSC_HOST_CALL functionReadFile(ExecState* exec)
 {
     VM& vm = exec->vm();
@@ -3061,6 +3189,41 @@ EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState* exec)
     JSLockHolder lock(vm);
     auto scope = DECLARE_THROW_SCOPE(vm);
 
+    // generateHeapSnapshot(path, ["json" | "binary"]) streams the snapshot to a file instead of
+    // returning it.
+    if (exec->argumentCount() >= 1) {
+        String fileName = exec->argument(0).toWTFString(exec);
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        String format = ASCIILiteral("json");
+        if (!exec->argument(1).isUndefined()) {
+            format = exec->argument(1).toWTFString(exec);
+            RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        }
+        if (format != "json" && format != "binary")
+            return throwVMError(exec, scope, "Heap snapshot format must be \"json\" or \"binary\".");
+
+        FILE* file = fopen(fileName.utf8().data(), "wb");
+        if (!file)
+            return throwVMError(exec, scope, "Could not open file.");
+
+        HeapSnapshotBuilder snapshotBuilder(vm.ensureHeapProfiler());
+        snapshotBuilder.buildSnapshot();
+
+        bool succeeded;
+        auto output = HeapSnapshotWriter::fileDescriptorOutput(fileno(file));
+        if (format == "binary") {
+            HeapSnapshotBinaryWriter writer(WTFMove(output));
+            succeeded = snapshotBuilder.write(writer);
+        } else {
+            HeapSnapshotJSONWriter writer(WTFMove(output));
+            succeeded = snapshotBuilder.write(writer);
+        }
+        fclose(file);
+        if (!succeeded)
+            return throwVMError(exec, scope, "Could not write heap snapshot.");
+        return JSValue::encode(jsUndefined());
+    }
+
     HeapSnapshotBuilder snapshotBuilder(exec->vm().ensureHeapProfiler());
     snapshotBuilder.buildSnapshot();
 
@@ -3070,6 +3233,50 @@ EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState* exec)
     return result;
 }
 
+// startAllocationSampling([interval]) starts charging allocations to stacks, taking a sample every
+// interval bytes.
+EncodedJSValue JSC_HOST_CALL functionStartAllocationSampling(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    size_t interval = Options::allocationSamplingInterval();
+    if (!exec->argument(0).isUndefined()) {
+        interval = exec->argument(0).toUInt32(exec);
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    }
+    vm.ensureAllocationSamplingProfiler(interval);
+    return JSValue::encode(jsUndefined());
+}
+
+EncodedJSValue JSC_HOST_CALL functionAllocationSamplingProfile(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!vm.allocationSamplingProfiler())
+        return JSValue::encode(throwException(exec, scope, createError(exec, ASCIILiteral("Allocation sampling was never started"))));
+
+    String jsonString = vm.allocationSamplingProfiler()->json();
+    EncodedJSValue result = JSValue::encode(JSONParse(exec, jsonString));
+    scope.releaseAssertNoException();
+    return result;
+}
+
+EncodedJSValue JSC_HOST_CALL functionStopAllocationSampling(ExecState* exec)
+{
+    exec->vm().stopAllocationSamplingProfiler();
+    return JSValue::encode(jsUndefined());
+}
+
+// saveProfileCache() writes the profile cache now rather than at exit, and returns whether it did.
+EncodedJSValue JSC_HOST_CALL functionSaveProfileCache(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    ProfileCache* profileCache = vm.profileCache();
+    return JSValue::encode(jsBoolean(profileCache && profileCache->write(vm)));
+}
+
 EncodedJSValue JSC_HOST_CALL functionResetSuperSamplerState(ExecState*)
 {
     resetSuperSamplerState();
@@ -3741,6 +3948,15 @@ int runJSC(CommandLine options, bool isWorker, const Func& func)
         std::sort(compileTimeKeys.begin(), compileTimeKeys.end());
         for (CString key : compileTimeKeys)
             printf("%40s: %.3lf ms\n", key.data(), compileTimeStats.get(key));
+
+#if ENABLE(DFG_JIT)
+        if (Options::reportCompilationQueueStatistics()) {
+            for (unsigned i = 0; i < DFG::numberOfWorklists(); ++i) {
+                if (DFG::Worklist* worklist = DFG::existingWorklistForIndexOrNull(i))
+                    worklist->dumpStatistics(WTF::dataFile());
+            }
+        }
+#endif
     }
 #endif
 
@@ -34,6 +34,7 @@
 #include "Nodes.h"
 #include "ParseInt.h"
 #include "Parser.h"
+#include "SIMDCharacters.h"
 #include <ctype.h>
 #include <limits.h>
 #include <string.h>
@@ -592,6 +593,15 @@ ALWAYS_INLINE void Lexer<T>::shift()
         m_current = *m_code;
 }
 
+template <typename T>
+ALWAYS_INLINE void Lexer<T>::shiftTo(const T* position)
+{
+    // The skipped characters must not include line terminators, which update the line number.
+    ASSERT(position >= m_code && position <= m_codeEnd);
+    m_code = position;
+    m_current = LIKELY(m_code < m_codeEnd) ? *m_code : 0;
+}
+
 template <typename T>
 ALWAYS_INLINE bool Lexer<T>::atEnd() const
 {
@@ -607,6 +617,97 @@ ALWAYS_INLINE T Lexer<T>::peek(int offset) const
     return (code < m_codeEnd) ? *code : 0;
 }
 
+#if USE(SIMD_CHARACTER_SCANNING)
+
+// The scanners below return the first character that the scalar loop they precede has to look
+// at. Characters in a partial block at the end of the source are left to the scalar loop.
+template <typename T>
+static ALWAYS_INLINE __m128i notASCII(__m128i characters)
+{
+    return invertCharacterMask(SIMDCharacters<T>::lessThanOrEqual(characters, 0x7F));
+}
+
+// Line terminators other than CR and LF are not ASCII, so for 16-bit sources every non-ASCII
+// character is left to the scalar loop.
+template <typename T>
+static ALWAYS_INLINE __m128i lineTerminatorCandidates(__m128i characters)
+{
+    typedef SIMDCharacters<T> SIMD;
+    __m128i result = _mm_or_si128(SIMD::equal(characters, '\n'), SIMD::equal(characters, '\r'));
+    if (sizeof(T) == 2)
+        result = _mm_or_si128(result, notASCII<T>(characters));
+    return result;
+}
+
+template <typename T>
+static ALWAYS_INLINE const T* scanSingleLineComment(const T* position, const T* end)
+{
+    return scanCharacters(position, end, [] (__m128i characters) {
+        return lineTerminatorCandidates<T>(characters);
+    });
+}
+
+template <typename T>
+static ALWAYS_INLINE const T* scanMultilineComment(const T* position, const T* end)
+{
+    return scanCharacters(position, end, [] (__m128i characters) {
+        return _mm_or_si128(lineTerminatorCandidates<T>(characters), SIMDCharacters<T>::equal(characters, '*'));
+    });
+}
+
+// Stops at the characters parseString() handles specially: the quote, escapes and anything
+// characterRequiresParseStringSlowCase() is true for.
+template <typename T>
+static ALWAYS_INLINE const T* scanStringLiteral(const T* position, const T* end, T quoteCharacter)
+{
+    typedef SIMDCharacters<T> SIMD;
+    return scanCharacters(position, end, [quoteCharacter] (__m128i characters) {
+        __m128i result = _mm_or_si128(SIMD::equal(characters, quoteCharacter), SIMD::equal(characters, '\\'));
+        result = _mm_or_si128(result, SIMD::lessThanOrEqual(characters, 0xD));
+        if (sizeof(T) == 2)
+            result = _mm_or_si128(result, invertCharacterMask(SIMD::lessThanOrEqual(characters, 0xFF)));
+        return result;
+    });
+}
+
+template <typename T>
+static ALWAYS_INLINE const T* scanTemplateLiteral(const T* position, const T* end)
+{
+    typedef SIMDCharacters<T> SIMD;
+    return scanCharacters(position, end, [] (__m128i characters) {
+        __m128i result = _mm_or_si128(SIMD::equal(characters, '`'), SIMD::equal(characters, '\\'));
+        result = _mm_or_si128(result, SIMD::equal(characters, '$'));
+        result = _mm_or_si128(result, SIMD::lessThanOrEqual(characters, 0xD));
+        return _mm_or_si128(result, lineTerminatorCandidates<T>(characters));
+    });
+}
+
+// Skips ASCII identifier characters. Other Latin-1 and Unicode identifier parts are rare, and are
+// left to isIdentPart().
+template <typename T>
+static ALWAYS_INLINE const T* scanIdentifier(const T* position, const T* end)
+{
+    typedef SIMDCharacters<T> SIMD;
+    return scanCharacters(position, end, [] (__m128i characters) {
+        // Setting bit 5 maps upper case ASCII letters onto lower case ones, and no other ASCII character onto a letter.
+        __m128i result = SIMD::inRange(_mm_or_si128(characters, SIMD::splat(0x20)), 'a', 'z');
+        result = _mm_or_si128(result, SIMD::inRange(characters, '0', '9'));
+        result = _mm_or_si128(result, SIMD::equal(characters, '_'));
+        result = _mm_or_si128(result, SIMD::equal(characters, '$'));
+        return invertCharacterMask(result);
+    });
+}
+
+#else
+
+template <typename T> static ALWAYS_INLINE const T* scanSingleLineComment(const T* position, const T*) { return position; }
+template <typename T> static ALWAYS_INLINE const T* scanMultilineComment(const T* position, const T*) { return position; }
+template <typename T> static ALWAYS_INLINE const T* scanStringLiteral(const T* position, const T*, T) { return position; }
+template <typename T> static ALWAYS_INLINE const T* scanTemplateLiteral(const T* position, const T*) { return position; }
+template <typename T> static ALWAYS_INLINE const T* scanIdentifier(const T* position, const T*) { return position; }
+
+#endif // USE(SIMD_CHARACTER_SCANNING)
+
 struct ParsedUnicodeEscapeValue {
     ParsedUnicodeEscapeValue(UChar32 value)
         : m_value(value)
@@ -951,6 +1052,7 @@ template <bool shouldCreateIdentifier> ALWAYS_INLINE JSTokenType Lexer<LChar>::p
     const LChar* identifierStart = currentSourcePtr();
     unsigned identifierLineStart = currentLineStartOffset();
     
+    shiftTo(scanIdentifier(currentSourcePtr(), m_codeEnd));
     while (isIdentPart(m_current))
         shift();
     
@@ -1017,6 +1119,8 @@ template <bool shouldCreateIdentifier> ALWAYS_INLINE JSTokenType Lexer<UChar>::p
 
     UChar orAllChars = 0;
     
+    // The scanned characters are ASCII, so they do not contribute to orAllChars.
+    shiftTo(scanIdentifier(currentSourcePtr(), m_codeEnd));
     while (isIdentPart(m_current)) {
         orAllChars |= m_current;
         shift();
@@ -1200,6 +1304,7 @@ template <bool shouldBuildStrings> ALWAYS_INLINE typename Lexer<T>::StringParseR
         }
 
         shift();
+        shiftTo(scanStringLiteral(currentSourcePtr(), m_codeEnd, stringQuoteCharacter));
     }
 
     if (currentSourcePtr() != stringStart && shouldBuildStrings)
@@ -1459,6 +1564,7 @@ typename Lexer<T>::StringParseResult Lexer<T>::parseTemplateLiteral(JSTokenData*
         }
 
         shift();
+        shiftTo(scanTemplateLiteral(currentSourcePtr(), m_codeEnd));
     }
 
     bool isTail = m_current == '`';
@@ -1686,6 +1792,7 @@ template <typename T>
 ALWAYS_INLINE bool Lexer<T>::parseMultilineComment()
 {
     while (true) {
+        shiftTo(scanMultilineComment(currentSourcePtr(), m_codeEnd));
         while (UNLIKELY(m_current == '*')) {
             shift();
             if (m_current == '/') {
@@ -2273,6 +2380,7 @@ inSingleLineComment:
         auto lineStartOffset = currentLineStartOffset();
         auto endPosition = currentPosition();
 
+        shiftTo(scanSingleLineComment(currentSourcePtr(), m_codeEnd));
         while (!isLineTerminator(m_current)) {
             if (atEnd())
                 return EOFTOK;
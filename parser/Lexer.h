@@ -134,6 +134,7 @@ private:
     void append16(const UChar* characters, size_t length) { m_buffer16.append(characters, length); }
 
     ALWAYS_INLINE void shift();
+    ALWAYS_INLINE void shiftTo(const T*);
     ALWAYS_INLINE bool atEnd() const;
     ALWAYS_INLINE T peek(int offset) const;
 
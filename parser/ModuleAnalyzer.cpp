@@ -146,4 +146,95 @@ JSModuleRecord* ModuleAnalyzer::analyze(ModuleProgramNode& moduleProgramNode)
     return m_moduleRecord.get();
 }
 
+bool ModuleAnalysis::isolateName(VM& vm, UniquedStringImpl* uid, Name& name)
+{
+    if (!uid)
+        return true;
+    if (uid->isSymbol()) {
+        // The local name of "export default <expression>" is the only private name a module uses.
+        if (uid != vm.propertyNames->starDefaultPrivateName.impl())
+            return false;
+        name.isStarDefault = true;
+        return true;
+    }
+    name.string = String(uid).isolatedCopy();
+    return true;
+}
+
+Identifier ModuleAnalysis::identifierFor(VM& vm, const Name& name)
+{
+    if (name.isStarDefault)
+        return vm.propertyNames->starDefaultPrivateName;
+    if (name.string.isNull())
+        return Identifier();
+    return Identifier::fromString(&vm, name.string);
+}
+
+bool ModuleAnalysis::isolateVariables(VM& vm, const VariableEnvironment& environment, Variables& variables)
+{
+    variables.isEverythingCaptured = environment.isEverythingCaptured();
+    for (const auto& pair : environment) {
+        Name name;
+        if (!isolateName(vm, pair.key.get(), name))
+            return false;
+        variables.entries.append(std::make_pair(WTFMove(name), pair.value));
+    }
+    return true;
+}
+
+VariableEnvironment ModuleAnalysis::environmentFor(VM& vm, const Variables& variables)
+{
+    VariableEnvironment environment;
+    for (const auto& pair : variables.entries)
+        environment.add(identifierFor(vm, pair.first)).iterator->value = pair.second;
+    if (variables.isEverythingCaptured)
+        environment.markAllVariablesAsCaptured();
+    return environment;
+}
+
+std::unique_ptr<ModuleAnalysis> ModuleAnalysis::create(VM& vm, const JSModuleRecord& moduleRecord)
+{
+    std::unique_ptr<ModuleAnalysis> analysis(new ModuleAnalysis);
+    bool succeeded = true;
+    auto isolate = [&] (UniquedStringImpl* uid) {
+        Name name;
+        succeeded &= isolateName(vm, uid, name);
+        return name;
+    };
+
+    for (const auto& moduleName : moduleRecord.requestedModules())
+        analysis->m_requestedModules.append(isolate(moduleName.get()));
+    for (const auto& moduleName : moduleRecord.starExportEntries())
+        analysis->m_starExportEntries.append(isolate(moduleName.get()));
+    for (const auto& entry : moduleRecord.importEntries().values())
+        analysis->m_importEntries.append(ImportEntry { isolate(entry.moduleRequest.impl()), isolate(entry.importName.impl()), isolate(entry.localName.impl()) });
+    for (const auto& entry : moduleRecord.exportEntries().values())
+        analysis->m_exportEntries.append(ExportEntry { entry.type, isolate(entry.exportName.impl()), isolate(entry.moduleName.impl()), isolate(entry.importName.impl()), isolate(entry.localName.impl()) });
+
+    succeeded &= isolateVariables(vm, moduleRecord.declaredVariables(), analysis->m_declaredVariables);
+    succeeded &= isolateVariables(vm, moduleRecord.lexicalVariables(), analysis->m_lexicalVariables);
+    if (!succeeded)
+        return nullptr;
+    return analysis;
+}
+
+JSModuleRecord* ModuleAnalysis::createModuleRecord(ExecState* exec, const Identifier& moduleKey, const SourceCode& sourceCode) const
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSModuleRecord* moduleRecord = JSModuleRecord::create(exec, vm, exec->lexicalGlobalObject()->moduleRecordStructure(), moduleKey, sourceCode, environmentFor(vm, m_declaredVariables), environmentFor(vm, m_lexicalVariables));
+    RETURN_IF_EXCEPTION(scope, nullptr);
+
+    for (const auto& moduleName : m_requestedModules)
+        moduleRecord->appendRequestedModule(identifierFor(vm, moduleName));
+    for (const auto& moduleName : m_starExportEntries)
+        moduleRecord->addStarExportEntry(identifierFor(vm, moduleName));
+    for (const auto& entry : m_importEntries)
+        moduleRecord->addImportEntry({ identifierFor(vm, entry.moduleRequest), identifierFor(vm, entry.importName), identifierFor(vm, entry.localName) });
+    for (const auto& entry : m_exportEntries)
+        moduleRecord->addExportEntry({ entry.type, identifierFor(vm, entry.exportName), identifierFor(vm, entry.moduleName), identifierFor(vm, entry.importName), identifierFor(vm, entry.localName) });
+    return moduleRecord;
+}
+
 } // namespace JSC
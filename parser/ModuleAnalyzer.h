@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "AbstractModuleRecord.h"
 #include "Nodes.h"
 
 namespace JSC {
@@ -50,4 +51,56 @@ private:
     Strong<JSModuleRecord> m_moduleRecord;
 };
 
+// The result of analyzing a module on a helper thread, whose JSModuleRecord belongs to the helper's
+// VM. Names are kept as isolated strings and become identifiers again when the record is created
+// in the client VM, so the client thread does not have to parse the module to analyze it.
+class ModuleAnalysis {
+    WTF_MAKE_NONCOPYABLE(ModuleAnalysis);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Returns nullptr if the record uses a private name that cannot be carried to another VM.
+    static std::unique_ptr<ModuleAnalysis> create(VM&, const JSModuleRecord&);
+
+    JSModuleRecord* createModuleRecord(ExecState*, const Identifier& moduleKey, const SourceCode&) const;
+
+private:
+    ModuleAnalysis() = default;
+
+    struct Name {
+        String string;
+        bool isStarDefault { false };
+    };
+
+    struct ImportEntry {
+        Name moduleRequest;
+        Name importName;
+        Name localName;
+    };
+
+    struct ExportEntry {
+        AbstractModuleRecord::ExportEntry::Type type;
+        Name exportName;
+        Name moduleName;
+        Name importName;
+        Name localName;
+    };
+
+    struct Variables {
+        Vector<std::pair<Name, VariableEnvironmentEntry>> entries;
+        bool isEverythingCaptured { false };
+    };
+
+    static bool isolateName(VM&, UniquedStringImpl*, Name&);
+    static Identifier identifierFor(VM&, const Name&);
+    static bool isolateVariables(VM&, const VariableEnvironment&, Variables&);
+    static VariableEnvironment environmentFor(VM&, const Variables&);
+
+    Vector<Name> m_requestedModules;
+    Vector<Name> m_starExportEntries;
+    Vector<ImportEntry> m_importEntries;
+    Vector<ExportEntry> m_exportEntries;
+    Variables m_declaredVariables;
+    Variables m_lexicalVariables;
+};
+
 } // namespace JSC
@@ -41,9 +41,10 @@ void ScopeNode::analyzeModule(ModuleAnalyzer& analyzer)
 void SourceElements::analyzeModule(ModuleAnalyzer& analyzer)
 {
     // In the module analyzer phase, only module declarations are included in the top-level SourceElements.
+    // The parser worklist analyzes the full tree it generates bytecode from, so skip everything else.
     for (StatementNode* statement = m_head; statement; statement = statement->next()) {
-        ASSERT(statement->isModuleDeclarationNode());
-        static_cast<ModuleDeclarationNode*>(statement)->analyzeModule(analyzer);
+        if (statement->isModuleDeclarationNode())
+            static_cast<ModuleDeclarationNode*>(statement)->analyzeModule(analyzer);
     }
 }
 
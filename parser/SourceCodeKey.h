@@ -63,7 +63,7 @@ public:
         return m_flags == rhs.m_flags;
     }
 
-    unsigned bits() { return m_flags; }
+    unsigned bits() const { return m_flags; }
 
 private:
     unsigned m_flags { 0 };
@@ -97,6 +97,10 @@ public:
 
     size_t length() const { return m_sourceCode.length(); }
 
+    const UnlinkedSourceCode& source() const { return m_sourceCode; }
+    const String& name() const { return m_name; }
+    SourceCodeFlags flags() const { return m_flags; }
+
     bool isNull() const { return m_sourceCode.isNull(); }
 
     // To save memory, we compute our string on demand. It's expected that source
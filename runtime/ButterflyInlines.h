@@ -148,6 +148,11 @@ inline Butterfly* Butterfly::growArrayRight(
     void* theBase = base(0, propertyCapacity);
     size_t oldSize = totalSize(0, propertyCapacity, hadIndexingHeader, oldIndexingPayloadSizeInBytes);
     size_t newSize = totalSize(0, propertyCapacity, true, newIndexingPayloadSizeInBytes);
+    // When this grows in place, the butterfly may be visible to the concurrent collector, so the
+    // caller has to initialize the new part before it publishes the new vector length.
+    if (LargeAllocation::isLargeAllocation(static_cast<HeapCell*>(theBase))
+        && LargeAllocation::fromCell(theBase)->tryGrow(newSize))
+        return this;
     void* newBase = vm.auxiliarySpace.tryAllocate(newSize);
     if (!newBase)
         return nullptr;
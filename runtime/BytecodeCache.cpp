@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "BytecodeCache.h"
+
+#include "CachedTypes.h"
+#include "JSCInlines.h"
+#include "SourceCodeKey.h"
+#include "UnlinkedCodeBlock.h"
+#include <wtf/text/StringBuilder.h>
+
+#if OS(UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+BytecodeCache::BytecodeCache(const String& directory)
+    : m_directory(directory)
+{
+}
+
+SHA1::Digest BytecodeCache::digest(const SourceCodeKey& key)
+{
+    SHA1 sha1;
+    uint32_t flags = key.flags().bits();
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(&flags), sizeof(flags));
+    sha1.addBytes(key.name().utf8());
+
+    // Hash the length too, so that no two distinct (name, source) pairs feed SHA1 the same bytes.
+    StringView source = key.string();
+    uint32_t length = source.length();
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(&length), sizeof(length));
+    if (source.is8Bit())
+        sha1.addBytes(source.characters8(), length * sizeof(LChar));
+    else
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters16()), length * sizeof(UChar));
+
+    SHA1::Digest digest;
+    sha1.computeHash(digest);
+    return digest;
+}
+
+CString BytecodeCache::pathFor(const SHA1::Digest& digest) const
+{
+    StringBuilder builder;
+    builder.append(m_directory);
+    builder.append('/');
+    builder.append(SHA1::hexDigest(digest).data());
+    builder.appendLiteral(".jsbc");
+    return builder.toString().utf8();
+}
+
+UnlinkedCodeBlock* BytecodeCache::load(VM& vm, const SourceCodeKey& key, const SourceCode& source)
+{
+#if OS(UNIX)
+    SHA1::Digest digest = this->digest(key);
+    CString path = pathFor(digest);
+
+    int fd = open(path.data(), O_RDONLY);
+    if (fd == -1) {
+        m_statistics.misses++;
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || fileStat.st_size <= 0) {
+        close(fd);
+        m_statistics.failures++;
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        m_statistics.failures++;
+        return nullptr;
+    }
+
+    // Executables decoded from the entry keep the mapping alive until they are destroyed.
+    Ref<CachedBytecode> bytecode = CachedBytecode::adoptMappedFile(source, data, size);
+    UnlinkedCodeBlock* codeBlock = decodeCodeBlock(vm, digest, bytecode.get());
+    if (!codeBlock) {
+        m_statistics.failures++;
+        return nullptr;
+    }
+    m_statistics.hits++;
+    return codeBlock;
+#else
+    UNUSED_PARAM(vm);
+    UNUSED_PARAM(key);
+    UNUSED_PARAM(source);
+    m_statistics.misses++;
+    return nullptr;
+#endif
+}
+
+bool BytecodeCache::store(VM& vm, const SourceCodeKey& key, UnlinkedCodeBlock* codeBlock)
+{
+#if OS(UNIX)
+    SHA1::Digest digest = this->digest(key);
+    Vector<uint8_t> data = encodeCodeBlock(vm, digest, key.source(), codeBlock);
+    if (data.isEmpty()) {
+        m_statistics.failures++;
+        return false;
+    }
+
+    // Write to a private temporary file and rename it into place, so that a concurrent reader
+    // never sees a partially written entry.
+    CString path = pathFor(digest);
+    CString temporaryPath = String::format("%s.%d.tmp", path.data(), static_cast<int>(getpid())).utf8();
+    int fd = open(temporaryPath.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        m_statistics.failures++;
+        return false;
+    }
+
+    const uint8_t* cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining) {
+        ssize_t written = write(fd, cursor, remaining);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        cursor += written;
+        remaining -= written;
+    }
+
+    if (close(fd) || remaining || rename(temporaryPath.data(), path.data())) {
+        unlink(temporaryPath.data());
+        m_statistics.failures++;
+        return false;
+    }
+
+    m_statistics.stores++;
+    return true;
+#else
+    UNUSED_PARAM(vm);
+    UNUSED_PARAM(key);
+    UNUSED_PARAM(codeBlock);
+    return false;
+#endif
+}
+
+void BytecodeCache::dumpStatistics(PrintStream& out) const
+{
+    out.print("Bytecode cache (", m_directory, "): ",
+        m_statistics.hits, " hits, ",
+        m_statistics.misses, " misses, ",
+        m_statistics.stores, " stores, ",
+        m_statistics.unchanged, " unchanged, ",
+        m_statistics.failures, " failures, ",
+        m_statistics.functionCodeBlocksDecoded, " function code blocks decoded\n");
+}
+
+} // namespace JSC
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <wtf/PrintStream.h>
+#include <wtf/SHA1.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class SourceCode;
+class SourceCodeKey;
+class UnlinkedCodeBlock;
+class VM;
+
+// An on-disk store of unlinked program and module code blocks, so that a fresh process can skip
+// parsing and bytecode generation for scripts it has seen before. Each entry lives in its own
+// file in the cache directory, named after the digest of its SourceCodeKey.
+class BytecodeCache {
+    WTF_MAKE_NONCOPYABLE(BytecodeCache);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Statistics {
+        unsigned hits { 0 };
+        unsigned misses { 0 };
+        unsigned stores { 0 };
+        unsigned failures { 0 };
+        unsigned unchanged { 0 };
+        unsigned functionCodeBlocksDecoded { 0 };
+    };
+
+    explicit BytecodeCache(const String& directory);
+
+    const String& directory() const { return m_directory; }
+
+    UnlinkedCodeBlock* load(VM&, const SourceCodeKey&, const SourceCode&);
+    bool store(VM&, const SourceCodeKey&, UnlinkedCodeBlock*);
+
+    // Entries that were loaded and have not generated any new code are not written back.
+    void didSkipUnchangedEntry() { m_statistics.unchanged++; }
+    void didDecodeFunctionCodeBlock() { m_statistics.functionCodeBlocksDecoded++; }
+
+    const Statistics& statistics() const { return m_statistics; }
+    void dumpStatistics(PrintStream&) const;
+
+    static SHA1::Digest digest(const SourceCodeKey&);
+
+private:
+    CString pathFor(const SHA1::Digest&) const;
+
+    String m_directory;
+    Statistics m_statistics;
+};
+
+} // namespace JSC
@@ -0,0 +1,1410 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "CachedTypes.h"
+
+#include "BuiltinNames.h"
+#include "JSCInlines.h"
+#include "JSTemplateRegistryKey.h"
+#include "ScopedArgumentsTable.h"
+#include "SourceCode.h"
+#include "SymbolTable.h"
+#include "UnlinkedFunctionCodeBlock.h"
+#include "UnlinkedInstructionStream.h"
+#include "UnlinkedModuleProgramCodeBlock.h"
+#include "UnlinkedProgramCodeBlock.h"
+#include <wtf/HashMap.h>
+
+#if OS(UNIX)
+#include <sys/mman.h>
+#endif
+
+namespace JSC {
+
+static const uint32_t cachedBytecodeMagic = 0x4243534a; // "JSCB"
+
+// Bump this whenever the layout of the stream changes.
+static const uint32_t cachedBytecodeFormatVersion = 2;
+
+enum class CachedStringTag : uint8_t { Null, EightBit, SixteenBit };
+enum class CachedUniquedStringTag : uint8_t { Null, String, PrivateName };
+enum class CachedConstantKind : uint8_t { Value, LinkTimeConstant, IdentifierSet };
+enum class CachedValueTag : uint8_t { Empty, Undefined, Null, True, False, Int32, Double, String, SymbolTable, TemplateRegistryKey, BackReference };
+
+// Folds the length of every opcode into the header so that a cache written by a build with a
+// different instruction set is rejected instead of misinterpreted.
+static uint32_t opcodeLayoutHash()
+{
+    uint32_t hash = numOpcodeIDs;
+    for (int i = 0; i < numOpcodeIDs; ++i)
+        hash = hash * 31 + opcodeLength(static_cast<OpcodeID>(i));
+    return hash;
+}
+
+// Private names and well-known symbols are VM-specific SymbolImpls. We encode them by the name
+// that CommonIdentifiers::lookUpPrivateName() maps back to the same symbol.
+static String lookUpKeyForPrivateName(VM& vm, UniquedStringImpl* uid)
+{
+    Identifier publicName = vm.propertyNames->lookUpPublicName(Identifier::fromUid(&vm, uid));
+    if (!publicName.isEmpty())
+        return publicName.string();
+#define RETURN_KEY_IF_WELL_KNOWN_SYMBOL(name) \
+    if (uid == vm.propertyNames->name##Symbol.impl()) \
+        return ASCIILiteral(#name "Symbol");
+    JSC_COMMON_PRIVATE_IDENTIFIERS_EACH_WELL_KNOWN_SYMBOL(RETURN_KEY_IF_WELL_KNOWN_SYMBOL)
+#undef RETURN_KEY_IF_WELL_KNOWN_SYMBOL
+    return String();
+}
+
+class BytecodeCacheEncoder {
+    WTF_MAKE_NONCOPYABLE(BytecodeCacheEncoder);
+public:
+    BytecodeCacheEncoder(VM& vm, const UnlinkedSourceCode& source)
+        : m_vm(vm)
+        , m_sourceStartOffset(source.startOffset())
+    {
+    }
+
+    bool failed() const { return m_failed; }
+    Vector<uint8_t> takeBuffer() { return WTFMove(m_buffer); }
+
+    void writeEntry(const SHA1::Digest&, UnlinkedCodeBlock*);
+
+private:
+    void fail() { m_failed = true; }
+
+    void writeHeader(const SHA1::Digest& digest)
+    {
+        write(cachedBytecodeMagic);
+        write(cachedBytecodeFormatVersion);
+        write(opcodeLayoutHash());
+        writeBytes(digest.data(), digest.size());
+    }
+
+    size_t reserveUInt32()
+    {
+        size_t position = m_buffer.size();
+        write<uint32_t>(0);
+        return position;
+    }
+
+    void patchUInt32(size_t position, size_t value)
+    {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            fail();
+            return;
+        }
+        uint32_t narrowValue = static_cast<uint32_t>(value);
+        memcpy(m_buffer.data() + position, &narrowValue, sizeof(narrowValue));
+    }
+
+    void writeBytes(const void* data, size_t size)
+    {
+        m_buffer.append(static_cast<const uint8_t*>(data), size);
+    }
+
+    template<typename T>
+    void write(T value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written verbatim");
+        writeBytes(&value, sizeof(T));
+    }
+
+    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    void writePODVector(const Vector<T, inlineCapacity, OverflowHandler>& vector)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written verbatim");
+        write<uint32_t>(vector.size());
+        writeBytes(vector.data(), vector.size() * sizeof(T));
+    }
+
+    void writeString(const String&);
+    void writeUniquedString(UniquedStringImpl*);
+    void writeIdentifier(const Identifier& identifier) { writeUniquedString(identifier.impl()); }
+    void writeVariableEnvironment(const VariableEnvironment&);
+    void writeSourceCode(const SourceCode&);
+    void writeBitVector(const BitVector&);
+    void writeValue(JSValue);
+    void writeSymbolTable(SymbolTable*);
+    void writeRareData(UnlinkedCodeBlock::RareData&);
+    void writeCodeBlock(UnlinkedCodeBlock*);
+    void writeFunctionExecutable(UnlinkedFunctionExecutable*);
+
+    struct PendingFunctionCodeBlock {
+        UnlinkedFunctionCodeBlock* codeBlock;
+        size_t locationPosition;
+    };
+
+    VM& m_vm;
+    int m_sourceStartOffset;
+    Vector<uint8_t> m_buffer;
+    // Cells are written once per code block; later occurrences become back references.
+    HashMap<JSCell*, unsigned> m_cellIndices;
+    // Function code blocks are written after the code block that refers to them.
+    Vector<PendingFunctionCodeBlock> m_pendingFunctionCodeBlocks;
+    bool m_failed { false };
+};
+
+class BytecodeCacheDecoder {
+    WTF_MAKE_NONCOPYABLE(BytecodeCacheDecoder);
+public:
+    BytecodeCacheDecoder(VM& vm, CachedBytecode& bytecode, const CachedCodeBlockLocation& location)
+        : m_vm(vm)
+        , m_bytecode(bytecode)
+        , m_source(bytecode.source())
+        , m_cursor(bytecode.data() + location.offset)
+        , m_end(m_cursor + location.size)
+    {
+        ASSERT(static_cast<uint64_t>(location.offset) + location.size <= bytecode.size());
+    }
+
+    bool readHeader(const SHA1::Digest& expectedDigest)
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t layoutHash;
+        SHA1::Digest digest;
+        if (!read(magic) || !read(version) || !read(layoutHash) || !readBytes(digest.data(), digest.size()))
+            return false;
+        return magic == cachedBytecodeMagic
+            && version == cachedBytecodeFormatVersion
+            && layoutHash == opcodeLayoutHash()
+            && digest == expectedDigest;
+    }
+
+    // The top-level code block is followed by the out of line function code blocks, which are
+    // not read until they are needed.
+    bool readTopLevelCodeBlockSize()
+    {
+        uint32_t size;
+        if (!readCount(size, 1))
+            return false;
+        m_end = m_cursor + size;
+        return true;
+    }
+
+    UnlinkedCodeBlock* readCodeBlock();
+
+    bool atEnd() const { return m_cursor == m_end; }
+
+private:
+    size_t remaining() const { return m_end - m_cursor; }
+
+    bool readBytes(void* result, size_t size)
+    {
+        if (size > remaining())
+            return false;
+        memcpy(result, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+
+    template<typename T>
+    bool read(T& result)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read verbatim");
+        return readBytes(&result, sizeof(T));
+    }
+
+    // Reads an element count, rejecting counts that could not possibly fit in the remaining data.
+    bool readCount(uint32_t& count, size_t minimumElementSize)
+    {
+        if (!read(count))
+            return false;
+        return static_cast<uint64_t>(count) * minimumElementSize <= remaining();
+    }
+
+    template<typename T, size_t inlineCapacity, typename OverflowHandler>
+    bool readPODVector(Vector<T, inlineCapacity, OverflowHandler>& vector)
+    {
+        uint32_t size;
+        if (!readCount(size, sizeof(T)))
+            return false;
+        vector.resize(size);
+        return readBytes(vector.data(), size * sizeof(T));
+    }
+
+    bool readString(String&);
+    bool readUniquedString(RefPtr<UniquedStringImpl>&);
+    bool readIdentifier(Identifier&);
+    bool readVariableEnvironment(VariableEnvironment&);
+    bool readSourceCode(SourceCode&);
+    bool readBitVector(BitVector&);
+    bool readValue(JSValue&);
+    SymbolTable* readSymbolTable();
+    bool readRareData(UnlinkedCodeBlock*);
+    UnlinkedFunctionExecutable* readFunctionExecutable();
+
+    VM& m_vm;
+    Ref<CachedBytecode> m_bytecode;
+    const SourceCode& m_source;
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    Vector<JSCell*> m_cells;
+};
+
+void BytecodeCacheEncoder::writeString(const String& string)
+{
+    if (string.isNull()) {
+        write(CachedStringTag::Null);
+        return;
+    }
+    write(string.is8Bit() ? CachedStringTag::EightBit : CachedStringTag::SixteenBit);
+    write<uint32_t>(string.length());
+    if (string.is8Bit())
+        writeBytes(string.characters8(), string.length() * sizeof(LChar));
+    else
+        writeBytes(string.characters16(), string.length() * sizeof(UChar));
+}
+
+bool BytecodeCacheDecoder::readString(String& result)
+{
+    CachedStringTag tag;
+    if (!read(tag))
+        return false;
+    if (tag == CachedStringTag::Null) {
+        result = String();
+        return true;
+    }
+
+    uint32_t length;
+    switch (tag) {
+    case CachedStringTag::EightBit:
+        if (!readCount(length, sizeof(LChar)))
+            return false;
+        result = String(m_cursor, length);
+        m_cursor += length * sizeof(LChar);
+        return true;
+    case CachedStringTag::SixteenBit: {
+        if (!readCount(length, sizeof(UChar)))
+            return false;
+        Vector<UChar> characters(length);
+        readBytes(characters.data(), length * sizeof(UChar));
+        result = String(characters.data(), length);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void BytecodeCacheEncoder::writeUniquedString(UniquedStringImpl* uid)
+{
+    if (!uid) {
+        write(CachedUniquedStringTag::Null);
+        return;
+    }
+    if (uid->isSymbol()) {
+        String key = lookUpKeyForPrivateName(m_vm, uid);
+        if (key.isNull()) {
+            fail();
+            return;
+        }
+        write(CachedUniquedStringTag::PrivateName);
+        writeString(key);
+        return;
+    }
+    write(CachedUniquedStringTag::String);
+    writeString(String(uid));
+}
+
+bool BytecodeCacheDecoder::readUniquedString(RefPtr<UniquedStringImpl>& result)
+{
+    Identifier identifier;
+    if (!readIdentifier(identifier))
+        return false;
+    result = identifier.impl();
+    return true;
+}
+
+bool BytecodeCacheDecoder::readIdentifier(Identifier& result)
+{
+    CachedUniquedStringTag tag;
+    String string;
+    if (!read(tag))
+        return false;
+    switch (tag) {
+    case CachedUniquedStringTag::Null:
+        result = Identifier();
+        return true;
+    case CachedUniquedStringTag::String:
+        if (!readString(string) || string.isNull())
+            return false;
+        result = Identifier::fromString(&m_vm, string);
+        return true;
+    case CachedUniquedStringTag::PrivateName: {
+        if (!readString(string) || string.isNull())
+            return false;
+        const Identifier* privateName = m_vm.propertyNames->lookUpPrivateName(Identifier::fromString(&m_vm, string));
+        if (!privateName)
+            return false;
+        result = *privateName;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void BytecodeCacheEncoder::writeVariableEnvironment(const VariableEnvironment& environment)
+{
+    write(environment.isEverythingCaptured());
+    write<uint32_t>(environment.size());
+    for (auto& entry : environment) {
+        writeUniquedString(entry.key.get());
+        write(entry.value.bits());
+    }
+}
+
+bool BytecodeCacheDecoder::readVariableEnvironment(VariableEnvironment& environment)
+{
+    bool isEverythingCaptured;
+    uint32_t size;
+    if (!read(isEverythingCaptured) || !readCount(size, sizeof(CachedUniquedStringTag) + sizeof(uint16_t)))
+        return false;
+    for (uint32_t i = 0; i < size; ++i) {
+        RefPtr<UniquedStringImpl> uid;
+        uint16_t bits;
+        if (!readUniquedString(uid) || !uid || !read(bits))
+            return false;
+        environment.add(uid).iterator->value.setBits(bits);
+    }
+    if (isEverythingCaptured)
+        environment.markAllVariablesAsCaptured();
+    return true;
+}
+
+// Nested source ranges (such as class sources) are stored relative to the start of the cached
+// source and relinked to the provider of the source being decoded.
+void BytecodeCacheEncoder::writeSourceCode(const SourceCode& sourceCode)
+{
+    write(sourceCode.isNull());
+    if (sourceCode.isNull())
+        return;
+    write<int32_t>(sourceCode.startOffset() - m_sourceStartOffset);
+    write<int32_t>(sourceCode.endOffset() - m_sourceStartOffset);
+    write<int32_t>(sourceCode.firstLine().oneBasedInt());
+    write<int32_t>(sourceCode.startColumn().oneBasedInt());
+}
+
+bool BytecodeCacheDecoder::readSourceCode(SourceCode& result)
+{
+    bool isNull;
+    if (!read(isNull))
+        return false;
+    if (isNull) {
+        result = SourceCode();
+        return true;
+    }
+
+    int32_t startOffset;
+    int32_t endOffset;
+    int32_t firstLine;
+    int32_t startColumn;
+    if (!read(startOffset) || !read(endOffset) || !read(firstLine) || !read(startColumn))
+        return false;
+    if (startOffset < 0 || endOffset < startOffset || endOffset > m_source.length())
+        return false;
+    startOffset += m_source.startOffset();
+    endOffset += m_source.startOffset();
+    result = SourceCode(RefPtr<SourceProvider>(m_source.provider()), startOffset, endOffset, firstLine, startColumn);
+    return true;
+}
+
+void BytecodeCacheEncoder::writeBitVector(const BitVector& bitVector)
+{
+    write<uint32_t>(bitVector.size());
+    for (size_t i = 0; i < bitVector.size(); i += 8) {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < 8 && i + j < bitVector.size(); ++j) {
+            if (bitVector.get(i + j))
+                byte |= 1 << j;
+        }
+        write(byte);
+    }
+}
+
+bool BytecodeCacheDecoder::readBitVector(BitVector& result)
+{
+    uint32_t size;
+    if (!readCount(size, 0))
+        return false;
+    result.ensureSize(size);
+    for (uint32_t i = 0; i < size; i += 8) {
+        uint8_t byte;
+        if (!read(byte))
+            return false;
+        for (uint32_t j = 0; j < 8 && i + j < size; ++j) {
+            if (byte & (1 << j))
+                result.set(i + j);
+        }
+    }
+    return true;
+}
+
+void BytecodeCacheEncoder::writeValue(JSValue value)
+{
+    if (!value) {
+        write(CachedValueTag::Empty);
+        return;
+    }
+    if (value.isUndefined()) {
+        write(CachedValueTag::Undefined);
+        return;
+    }
+    if (value.isNull()) {
+        write(CachedValueTag::Null);
+        return;
+    }
+    if (value.isBoolean()) {
+        write(value.asBoolean() ? CachedValueTag::True : CachedValueTag::False);
+        return;
+    }
+    if (value.isInt32()) {
+        write(CachedValueTag::Int32);
+        write(value.asInt32());
+        return;
+    }
+    if (value.isDouble()) {
+        write(CachedValueTag::Double);
+        write(bitwise_cast<uint64_t>(value.asDouble()));
+        return;
+    }
+
+    if (!value.isCell()) {
+        fail();
+        return;
+    }
+
+    JSCell* cell = value.asCell();
+    auto addResult = m_cellIndices.add(cell, m_cellIndices.size());
+    if (!addResult.isNewEntry) {
+        write(CachedValueTag::BackReference);
+        write<uint32_t>(addResult.iterator->value);
+        return;
+    }
+
+    if (JSString* string = jsDynamicCast<JSString*>(m_vm, cell)) {
+        if (string->isRope()) {
+            fail();
+            return;
+        }
+        write(CachedValueTag::String);
+        writeString(string->tryGetValue());
+        return;
+    }
+
+    if (SymbolTable* symbolTable = jsDynamicCast<SymbolTable*>(m_vm, cell)) {
+        write(CachedValueTag::SymbolTable);
+        writeSymbolTable(symbolTable);
+        return;
+    }
+
+    if (JSTemplateRegistryKey* templateRegistryKey = jsDynamicCast<JSTemplateRegistryKey*>(m_vm, cell)) {
+        const TemplateRegistryKey& key = templateRegistryKey->templateRegistryKey();
+        write(CachedValueTag::TemplateRegistryKey);
+        write<uint32_t>(key.rawStrings().size());
+        for (const String& rawString : key.rawStrings())
+            writeString(rawString);
+        write<uint32_t>(key.cookedStrings().size());
+        for (const std::optional<String>& cookedString : key.cookedStrings()) {
+            write(!!cookedString);
+            if (cookedString)
+                writeString(*cookedString);
+        }
+        return;
+    }
+
+    fail();
+}
+
+bool BytecodeCacheDecoder::readValue(JSValue& result)
+{
+    CachedValueTag tag;
+    if (!read(tag))
+        return false;
+
+    switch (tag) {
+    case CachedValueTag::Empty:
+        result = JSValue();
+        return true;
+    case CachedValueTag::Undefined:
+        result = jsUndefined();
+        return true;
+    case CachedValueTag::Null:
+        result = jsNull();
+        return true;
+    case CachedValueTag::True:
+        result = jsBoolean(true);
+        return true;
+    case CachedValueTag::False:
+        result = jsBoolean(false);
+        return true;
+    case CachedValueTag::Int32: {
+        int32_t value;
+        if (!read(value))
+            return false;
+        result = jsNumber(value);
+        return true;
+    }
+    case CachedValueTag::Double: {
+        uint64_t bits;
+        if (!read(bits))
+            return false;
+        result = JSValue(JSValue::EncodeAsDouble, bitwise_cast<double>(bits));
+        return true;
+    }
+    case CachedValueTag::BackReference: {
+        uint32_t index;
+        if (!read(index) || index >= m_cells.size() || !m_cells[index])
+            return false;
+        result = m_cells[index];
+        return true;
+    }
+    case CachedValueTag::String: {
+        String string;
+        if (!readString(string) || string.isNull())
+            return false;
+        JSString* jsStringValue = jsString(&m_vm, string);
+        m_cells.append(jsStringValue);
+        result = jsStringValue;
+        return true;
+    }
+    case CachedValueTag::SymbolTable: {
+        // Claim the index before decoding so that it matches the order the encoder assigned.
+        size_t index = m_cells.size();
+        m_cells.append(nullptr);
+        SymbolTable* symbolTable = readSymbolTable();
+        if (!symbolTable)
+            return false;
+        m_cells[index] = symbolTable;
+        result = symbolTable;
+        return true;
+    }
+    case CachedValueTag::TemplateRegistryKey: {
+        uint32_t rawStringsCount;
+        if (!readCount(rawStringsCount, sizeof(CachedStringTag)))
+            return false;
+        TemplateRegistryKey::StringVector rawStrings;
+        for (uint32_t i = 0; i < rawStringsCount; ++i) {
+            String rawString;
+            if (!readString(rawString))
+                return false;
+            rawStrings.append(rawString);
+        }
+        uint32_t cookedStringsCount;
+        if (!readCount(cookedStringsCount, sizeof(bool)))
+            return false;
+        TemplateRegistryKey::OptionalStringVector cookedStrings;
+        for (uint32_t i = 0; i < cookedStringsCount; ++i) {
+            bool hasCookedString;
+            if (!read(hasCookedString))
+                return false;
+            if (!hasCookedString) {
+                cookedStrings.append(std::nullopt);
+                continue;
+            }
+            String cookedString;
+            if (!readString(cookedString))
+                return false;
+            cookedStrings.append(cookedString);
+        }
+        JSTemplateRegistryKey* templateRegistryKey = JSTemplateRegistryKey::create(m_vm, m_vm.templateRegistryKeyTable().createKey(WTFMove(rawStrings), WTFMove(cookedStrings)));
+        m_cells.append(templateRegistryKey);
+        result = templateRegistryKey;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void BytecodeCacheEncoder::writeSymbolTable(SymbolTable* symbolTable)
+{
+    ConcurrentJSLocker locker(symbolTable->m_lock);
+
+    write(symbolTable->usesNonStrictEval());
+    write(symbolTable->isNestedLexicalScope());
+    write<uint8_t>(symbolTable->scopeType());
+    write<uint32_t>(symbolTable->maxScopeOffset().offsetUnchecked());
+
+    write<uint32_t>(symbolTable->size(locker));
+    for (auto iter = symbolTable->begin(locker), end = symbolTable->end(locker); iter != end; ++iter) {
+        const SymbolTableEntry& entry = iter->value;
+        VarOffset offset = entry.varOffset();
+        writeUniquedString(iter->key.get());
+        write(offset.kind());
+        write<uint32_t>(offset.rawOffset());
+        write<uint8_t>(entry.getAttributes());
+        write(entry.isWatchable());
+    }
+
+    ScopedArgumentsTable* arguments = symbolTable->arguments();
+    write<uint32_t>(arguments ? arguments->length() : 0);
+    if (arguments) {
+        for (uint32_t i = 0; i < arguments->length(); ++i)
+            write<uint32_t>(arguments->get(i).offsetUnchecked());
+    }
+}
+
+SymbolTable* BytecodeCacheDecoder::readSymbolTable()
+{
+    bool usesNonStrictEval;
+    bool isNestedLexicalScope;
+    uint8_t scopeType;
+    uint32_t maxScopeOffset;
+    uint32_t size;
+    if (!read(usesNonStrictEval) || !read(isNestedLexicalScope) || !read(scopeType) || !read(maxScopeOffset))
+        return nullptr;
+    if (scopeType > SymbolTable::FunctionNameScope)
+        return nullptr;
+
+    SymbolTable* symbolTable = SymbolTable::create(m_vm);
+    symbolTable->setUsesNonStrictEval(usesNonStrictEval);
+    symbolTable->setScopeType(static_cast<SymbolTable::ScopeType>(scopeType));
+    if (isNestedLexicalScope) {
+        if (scopeType != SymbolTable::LexicalScope)
+            return nullptr;
+        symbolTable->markIsNestedLexicalScope();
+    }
+
+    if (!readCount(size, sizeof(CachedUniquedStringTag) + sizeof(VarKind) + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(bool)))
+        return nullptr;
+    for (uint32_t i = 0; i < size; ++i) {
+        RefPtr<UniquedStringImpl> uid;
+        VarKind kind;
+        uint32_t rawOffset;
+        uint8_t attributes;
+        bool isWatchable;
+        if (!readUniquedString(uid) || !uid || !read(kind) || !read(rawOffset) || !read(attributes) || !read(isWatchable))
+            return nullptr;
+        if (kind != VarKind::Scope && kind != VarKind::Stack && kind != VarKind::DirectArgument)
+            return nullptr;
+        SymbolTableEntry entry(VarOffset::assemble(kind, rawOffset), attributes);
+        if (!isWatchable)
+            entry.disableWatching(m_vm);
+        symbolTable->add(uid.get(), WTFMove(entry));
+    }
+
+    // add() does not track the maximum offset, so restore the one the generator computed.
+    if (maxScopeOffset != ScopeOffset::invalidOffset)
+        symbolTable->didUseScopeOffset(ScopeOffset(maxScopeOffset));
+
+    uint32_t argumentsLength;
+    if (!readCount(argumentsLength, sizeof(uint32_t)))
+        return nullptr;
+    if (argumentsLength) {
+        symbolTable->setArgumentsLength(m_vm, argumentsLength);
+        for (uint32_t i = 0; i < argumentsLength; ++i) {
+            uint32_t offset;
+            if (!read(offset))
+                return nullptr;
+            symbolTable->setArgumentOffset(m_vm, i, ScopeOffset(offset));
+        }
+    }
+
+    return symbolTable;
+}
+
+void BytecodeCacheEncoder::writeFunctionExecutable(UnlinkedFunctionExecutable* executable)
+{
+    // Builtins are linked against their own source providers and are never cached.
+    if (executable->isBuiltinFunction() || !executable->m_parentSourceOverride.isNull()) {
+        fail();
+        return;
+    }
+
+    write<uint32_t>(executable->m_firstLineOffset);
+    write<uint32_t>(executable->m_lineCount);
+    write<uint32_t>(executable->m_unlinkedFunctionNameStart);
+    write<uint32_t>(executable->m_unlinkedBodyStartColumn);
+    write<uint32_t>(executable->m_unlinkedBodyEndColumn);
+    write<uint32_t>(executable->m_startOffset);
+    write<uint32_t>(executable->m_sourceLength);
+    write<uint32_t>(executable->m_parametersStartOffset);
+    write<uint32_t>(executable->m_typeProfilingStartOffset);
+    write<uint32_t>(executable->m_typeProfilingEndOffset);
+    write<uint32_t>(executable->m_parameterCount);
+    write(executable->m_features);
+    write(executable->m_sourceParseMode);
+    write<uint8_t>(executable->m_isInStrictContext);
+    write<uint8_t>(executable->m_hasCapturedVariables);
+    write<uint8_t>(executable->m_constructAbility);
+    write<uint8_t>(executable->m_constructorKind);
+    write<uint8_t>(executable->m_functionMode);
+    write<uint8_t>(executable->m_scriptMode);
+    write<uint8_t>(executable->m_superBinding);
+    write<uint8_t>(executable->m_derivedContextType);
+
+    writeIdentifier(executable->m_name);
+    writeIdentifier(executable->m_ecmaName);
+    writeIdentifier(executable->m_inferredName);
+    writeSourceCode(executable->m_classSource);
+    writeString(executable->m_sourceURLDirective);
+    writeString(executable->m_sourceMappingURLDirective);
+    writeVariableEnvironment(executable->m_parentScopeTDZVariables);
+
+    // Code blocks that were themselves loaded from a cache, but never used, still belong in the
+    // new entry.
+    executable->decodeCachedCodeBlocks(m_vm);
+
+    for (UnlinkedFunctionCodeBlock* codeBlock : { executable->m_unlinkedCodeBlockForCall.get(), executable->m_unlinkedCodeBlockForConstruct.get() }) {
+        write<bool>(codeBlock);
+        if (!codeBlock)
+            continue;
+        size_t locationPosition = reserveUInt32();
+        reserveUInt32();
+        m_pendingFunctionCodeBlocks.append({ codeBlock, locationPosition });
+    }
+}
+
+UnlinkedFunctionExecutable* BytecodeCacheDecoder::readFunctionExecutable()
+{
+    UnlinkedFunctionExecutable* executable = UnlinkedFunctionExecutable::createUninitialized(m_vm);
+
+    uint8_t isInStrictContext;
+    uint8_t hasCapturedVariables;
+    uint8_t constructAbility;
+    uint8_t constructorKind;
+    uint8_t functionMode;
+    uint8_t scriptMode;
+    uint8_t superBinding;
+    uint8_t derivedContextType;
+    bool ok = read(executable->m_firstLineOffset)
+        && read(executable->m_lineCount)
+        && read(executable->m_unlinkedFunctionNameStart)
+        && read(executable->m_unlinkedBodyStartColumn)
+        && read(executable->m_unlinkedBodyEndColumn)
+        && read(executable->m_startOffset)
+        && read(executable->m_sourceLength)
+        && read(executable->m_parametersStartOffset)
+        && read(executable->m_typeProfilingStartOffset)
+        && read(executable->m_typeProfilingEndOffset)
+        && read(executable->m_parameterCount)
+        && read(executable->m_features)
+        && read(executable->m_sourceParseMode)
+        && read(isInStrictContext)
+        && read(hasCapturedVariables)
+        && read(constructAbility)
+        && read(constructorKind)
+        && read(functionMode)
+        && read(scriptMode)
+        && read(superBinding)
+        && read(derivedContextType);
+    if (!ok)
+        return nullptr;
+
+    executable->m_isInStrictContext = isInStrictContext;
+    executable->m_hasCapturedVariables = hasCapturedVariables;
+    executable->m_constructAbility = constructAbility;
+    executable->m_constructorKind = constructorKind;
+    executable->m_functionMode = functionMode;
+    executable->m_scriptMode = scriptMode;
+    executable->m_superBinding = superBinding;
+    executable->m_derivedContextType = derivedContextType;
+    if (!isFunctionParseMode(executable->parseMode()))
+        return nullptr;
+
+    ok = readIdentifier(executable->m_name)
+        && readIdentifier(executable->m_ecmaName)
+        && readIdentifier(executable->m_inferredName)
+        && readSourceCode(executable->m_classSource)
+        && readString(executable->m_sourceURLDirective)
+        && readString(executable->m_sourceMappingURLDirective)
+        && readVariableEnvironment(executable->m_parentScopeTDZVariables);
+    if (!ok)
+        return nullptr;
+
+    for (CachedCodeBlockLocation* location : { &executable->m_cachedCodeBlockForCall, &executable->m_cachedCodeBlockForConstruct }) {
+        bool hasCodeBlock;
+        if (!read(hasCodeBlock))
+            return nullptr;
+        if (!hasCodeBlock)
+            continue;
+        if (!read(location->offset) || !read(location->size))
+            return nullptr;
+        if (!location->size || static_cast<uint64_t>(location->offset) + location->size > m_bytecode->size())
+            return nullptr;
+        executable->m_cachedBytecode = m_bytecode.ptr();
+    }
+
+    return executable;
+}
+
+void BytecodeCacheEncoder::writeRareData(UnlinkedCodeBlock::RareData& rareData)
+{
+    // Type profiling and control flow profiling data is keyed to the VM that generated it.
+    if (!rareData.m_typeProfilerInfoMap.isEmpty() || !rareData.m_opProfileControlFlowBytecodeOffsets.isEmpty()) {
+        fail();
+        return;
+    }
+
+    write<uint32_t>(rareData.m_exceptionHandlers.size());
+    for (const UnlinkedHandlerInfo& handler : rareData.m_exceptionHandlers) {
+        write<uint32_t>(handler.start);
+        write<uint32_t>(handler.end);
+        write<uint32_t>(handler.target);
+        write<uint8_t>(handler.typeBits);
+    }
+
+    write<uint32_t>(rareData.m_regexps.size());
+    for (const WriteBarrier<RegExp>& regExp : rareData.m_regexps) {
+        unsigned flags = NoFlags;
+        if (regExp->global())
+            flags |= FlagGlobal;
+        if (regExp->ignoreCase())
+            flags |= FlagIgnoreCase;
+        if (regExp->multiline())
+            flags |= FlagMultiline;
+        if (regExp->sticky())
+            flags |= FlagSticky;
+        if (regExp->unicode())
+            flags |= FlagUnicode;
+        writeString(regExp->pattern());
+        write<uint8_t>(flags);
+    }
+
+    // Array literal buffers only ever hold primitives and strings that already live in the
+    // constant pool, so every cell here is a back reference.
+    write<uint32_t>(rareData.m_constantBuffers.size());
+    for (const UnlinkedCodeBlock::ConstantBuffer& buffer : rareData.m_constantBuffers) {
+        write<uint32_t>(buffer.size());
+        for (JSValue value : buffer) {
+            if (value.isCell() && !m_cellIndices.contains(value.asCell())) {
+                fail();
+                return;
+            }
+            writeValue(value);
+        }
+    }
+
+    write<uint32_t>(rareData.m_switchJumpTables.size());
+    for (const UnlinkedSimpleJumpTable& table : rareData.m_switchJumpTables) {
+        write(table.min);
+        writePODVector(table.branchOffsets);
+    }
+
+    write<uint32_t>(rareData.m_stringSwitchJumpTables.size());
+    for (const UnlinkedStringJumpTable& table : rareData.m_stringSwitchJumpTables) {
+        write<uint32_t>(table.offsetTable.size());
+        for (auto& entry : table.offsetTable) {
+            writeString(String(entry.key.get()));
+            write(entry.value.branchOffset);
+        }
+    }
+
+    writePODVector(rareData.m_expressionInfoFatPositions);
+}
+
+bool BytecodeCacheDecoder::readRareData(UnlinkedCodeBlock* codeBlock)
+{
+    uint32_t count;
+    if (!readCount(count, 3 * sizeof(uint32_t) + sizeof(uint8_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t start;
+        uint32_t end;
+        uint32_t target;
+        uint8_t type;
+        if (!read(start) || !read(end) || !read(target) || !read(type))
+            return false;
+        if (type > static_cast<uint8_t>(HandlerType::SynthesizedFinally))
+            return false;
+        codeBlock->addExceptionHandler(UnlinkedHandlerInfo(start, end, target, static_cast<HandlerType>(type)));
+    }
+
+    if (!readCount(count, sizeof(CachedStringTag) + sizeof(uint8_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        String pattern;
+        uint8_t flags;
+        if (!readString(pattern) || pattern.isNull() || !read(flags) || flags >= InvalidFlags)
+            return false;
+        codeBlock->addRegExp(RegExp::create(m_vm, pattern, static_cast<RegExpFlags>(flags)));
+    }
+
+    if (!readCount(count, sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t length;
+        if (!readCount(length, sizeof(CachedValueTag)))
+            return false;
+        unsigned index = codeBlock->addConstantBuffer(length);
+        UnlinkedCodeBlock::ConstantBuffer& buffer = codeBlock->constantBuffer(index);
+        for (uint32_t j = 0; j < length; ++j) {
+            size_t cellCount = m_cells.size();
+            if (!readValue(buffer[j]))
+                return false;
+            // Anything but a back reference would not be kept alive by the constant pool.
+            if (m_cells.size() != cellCount)
+                return false;
+        }
+    }
+
+    if (!readCount(count, sizeof(int32_t) + sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        UnlinkedSimpleJumpTable& table = codeBlock->addSwitchJumpTable();
+        if (!read(table.min) || !readPODVector(table.branchOffsets))
+            return false;
+    }
+
+    if (!readCount(count, sizeof(uint32_t)))
+        return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        UnlinkedStringJumpTable& table = codeBlock->addStringSwitchJumpTable();
+        uint32_t size;
+        if (!readCount(size, sizeof(CachedStringTag) + sizeof(int32_t)))
+            return false;
+        for (uint32_t j = 0; j < size; ++j) {
+            String key;
+            UnlinkedStringJumpTable::OffsetLocation location;
+            if (!readString(key) || key.isNull() || !read(location.branchOffset))
+                return false;
+            table.offsetTable.add(AtomicString(key).impl(), location);
+        }
+    }
+
+    codeBlock->createRareDataIfNecessary();
+    return readPODVector(codeBlock->m_rareData->m_expressionInfoFatPositions);
+}
+
+void BytecodeCacheEncoder::writeCodeBlock(UnlinkedCodeBlock* codeBlock)
+{
+    if (m_failed)
+        return;
+
+    CodeType codeType = codeBlock->codeType();
+    if (codeType == EvalCode) {
+        fail();
+        return;
+    }
+
+    HashMap<JSCell*, unsigned> outerCellIndices = WTFMove(m_cellIndices);
+    m_cellIndices.clear();
+
+    write<uint8_t>(codeType);
+    write<uint8_t>(codeBlock->usesEval());
+    write<uint8_t>(codeBlock->isStrictMode());
+    write<uint8_t>(codeBlock->isConstructor());
+    write<uint8_t>(codeBlock->isBuiltinFunction());
+    write<uint8_t>(codeBlock->m_constructorKind);
+    write<uint8_t>(codeBlock->m_scriptMode);
+    write<uint8_t>(codeBlock->m_superBinding);
+    write(codeBlock->parseMode());
+    write<uint8_t>(codeBlock->m_derivedContextType);
+    write<uint8_t>(codeBlock->isArrowFunctionContext());
+    write<uint8_t>(codeBlock->isClassContext());
+    write<uint8_t>(codeBlock->m_evalContextType);
+    write<uint8_t>(codeBlock->wasCompiledWithDebuggingOpcodes());
+
+    write<int32_t>(codeBlock->m_numParameters);
+    write<int32_t>(codeBlock->m_numVars);
+    write<int32_t>(codeBlock->m_numCapturedVars);
+    write<int32_t>(codeBlock->m_numCalleeLocals);
+    write<int32_t>(codeBlock->m_thisRegister.offset());
+    write<int32_t>(codeBlock->m_scopeRegister.offset());
+    write<int32_t>(codeBlock->m_globalObjectRegister.offset());
+
+    write(codeBlock->codeFeatures());
+    write<uint8_t>(codeBlock->hasCapturedVariables());
+    write<uint32_t>(codeBlock->lineCount());
+    write<uint32_t>(codeBlock->endColumn());
+    writeString(codeBlock->sourceURLDirective());
+    writeString(codeBlock->sourceMappingURLDirective());
+
+    const UnlinkedInstructionStream& instructions = codeBlock->instructions();
+    write<uint32_t>(instructions.count());
+    write<uint32_t>(instructions.sizeInBytes());
+    writeBytes(instructions.packedData(), instructions.sizeInBytes());
+
+    writePODVector(codeBlock->m_jumpTargets);
+    writePODVector(codeBlock->m_propertyAccessInstructions);
+
+    write<uint32_t>(codeBlock->m_identifiers.size());
+    for (const Identifier& identifier : codeBlock->m_identifiers)
+        writeIdentifier(identifier);
+
+    write<uint32_t>(codeBlock->m_bitVectors.size());
+    for (const BitVector& bitVector : codeBlock->m_bitVectors)
+        writeBitVector(bitVector);
+
+    HashMap<unsigned, const IdentifierSet*> identifierSets;
+    for (const ConstantIndentifierSetEntry& entry : codeBlock->m_constantIdentifierSets)
+        identifierSets.add(entry.second + 1, &entry.first);
+    HashMap<unsigned, unsigned> linkTimeConstants;
+    for (unsigned type = 0; type < LinkTimeConstantCount; ++type) {
+        if (unsigned index = codeBlock->m_linkTimeConstants[type])
+            linkTimeConstants.add(index + 1, type);
+    }
+
+    write<uint32_t>(codeBlock->m_constantRegisters.size());
+    for (unsigned i = 0; i < codeBlock->m_constantRegisters.size(); ++i) {
+        auto linkTimeConstant = linkTimeConstants.find(i + 1);
+        if (linkTimeConstant != linkTimeConstants.end()) {
+            write(CachedConstantKind::LinkTimeConstant);
+            write<uint8_t>(linkTimeConstant->value);
+            continue;
+        }
+        auto identifierSet = identifierSets.find(i + 1);
+        if (identifierSet != identifierSets.end()) {
+            write(CachedConstantKind::IdentifierSet);
+            write<uint32_t>(identifierSet->value->size());
+            for (auto& uid : *identifierSet->value)
+                writeUniquedString(uid.get());
+            continue;
+        }
+        write(CachedConstantKind::Value);
+        write<uint8_t>(static_cast<uint8_t>(codeBlock->m_constantsSourceCodeRepresentation[i]));
+        writeValue(codeBlock->m_constantRegisters[i].get());
+    }
+
+    write<uint32_t>(codeBlock->m_functionDecls.size());
+    for (auto& executable : codeBlock->m_functionDecls)
+        writeFunctionExecutable(executable.get());
+    write<uint32_t>(codeBlock->m_functionExprs.size());
+    for (auto& executable : codeBlock->m_functionExprs)
+        writeFunctionExecutable(executable.get());
+
+    write<uint32_t>(codeBlock->m_arrayProfileCount);
+    write<uint32_t>(codeBlock->m_arrayAllocationProfileCount);
+    write<uint32_t>(codeBlock->m_objectAllocationProfileCount);
+    write<uint32_t>(codeBlock->m_valueProfileCount);
+    write<uint32_t>(codeBlock->m_llintCallLinkInfoCount);
+
+    writePODVector(codeBlock->m_expressionInfo);
+
+    write<bool>(codeBlock->m_rareData.get());
+    if (codeBlock->m_rareData)
+        writeRareData(*codeBlock->m_rareData);
+
+    if (UnlinkedProgramCodeBlock* programCodeBlock = jsDynamicCast<UnlinkedProgramCodeBlock*>(m_vm, codeBlock)) {
+        writeVariableEnvironment(programCodeBlock->variableDeclarations());
+        writeVariableEnvironment(programCodeBlock->lexicalDeclarations());
+    } else if (UnlinkedModuleProgramCodeBlock* moduleProgramCodeBlock = jsDynamicCast<UnlinkedModuleProgramCodeBlock*>(m_vm, codeBlock))
+        write<int32_t>(moduleProgramCodeBlock->moduleEnvironmentSymbolTableConstantRegisterOffset());
+
+    m_cellIndices = WTFMove(outerCellIndices);
+}
+
+UnlinkedCodeBlock* BytecodeCacheDecoder::readCodeBlock()
+{
+    uint8_t codeType;
+    uint8_t usesEval;
+    uint8_t isStrictMode;
+    uint8_t isConstructor;
+    uint8_t isBuiltinFunction;
+    uint8_t constructorKind;
+    uint8_t scriptMode;
+    uint8_t superBinding;
+    SourceParseMode parseMode;
+    uint8_t derivedContextType;
+    uint8_t isArrowFunctionContext;
+    uint8_t isClassContext;
+    uint8_t evalContextType;
+    uint8_t wasCompiledWithDebuggingOpcodes;
+    bool ok = read(codeType)
+        && read(usesEval)
+        && read(isStrictMode)
+        && read(isConstructor)
+        && read(isBuiltinFunction)
+        && read(constructorKind)
+        && read(scriptMode)
+        && read(superBinding)
+        && read(parseMode)
+        && read(derivedContextType)
+        && read(isArrowFunctionContext)
+        && read(isClassContext)
+        && read(evalContextType)
+        && read(wasCompiledWithDebuggingOpcodes);
+    if (!ok || isBuiltinFunction)
+        return nullptr;
+    if (constructorKind > static_cast<uint8_t>(ConstructorKind::Extends)
+        || scriptMode > static_cast<uint8_t>(JSParserScriptMode::Module)
+        || superBinding > static_cast<uint8_t>(SuperBinding::NotNeeded)
+        || derivedContextType > static_cast<uint8_t>(DerivedContextType::DerivedMethodContext)
+        || evalContextType > static_cast<uint8_t>(EvalContextType::FunctionEvalContext))
+        return nullptr;
+
+    ExecutableInfo info(usesEval, isStrictMode, isConstructor, false,
+        static_cast<ConstructorKind>(constructorKind), static_cast<JSParserScriptMode>(scriptMode),
+        static_cast<SuperBinding>(superBinding), parseMode, static_cast<DerivedContextType>(derivedContextType),
+        isArrowFunctionContext, isClassContext, static_cast<EvalContextType>(evalContextType));
+    DebuggerMode debuggerMode = wasCompiledWithDebuggingOpcodes ? DebuggerOn : DebuggerOff;
+
+    UnlinkedCodeBlock* codeBlock;
+    switch (codeType) {
+    case GlobalCode:
+        codeBlock = UnlinkedProgramCodeBlock::create(&m_vm, info, debuggerMode);
+        break;
+    case ModuleCode:
+        codeBlock = UnlinkedModuleProgramCodeBlock::create(&m_vm, info, debuggerMode);
+        break;
+    case FunctionCode:
+        codeBlock = UnlinkedFunctionCodeBlock::create(&m_vm, FunctionCode, info, debuggerMode);
+        break;
+    default:
+        return nullptr;
+    }
+    // Options::forceDebuggerBytecodeGeneration() may have forced debugging opcodes when the cache
+    // was written, so restore the recorded state rather than trusting the constructor.
+    codeBlock->m_wasCompiledWithDebuggingOpcodes = wasCompiledWithDebuggingOpcodes;
+
+    Vector<JSCell*> outerCells = WTFMove(m_cells);
+    m_cells.clear();
+
+    int32_t numParameters;
+    int32_t thisRegister;
+    int32_t scopeRegister;
+    int32_t globalObjectRegister;
+    CodeFeatures features;
+    uint8_t hasCapturedVariables;
+    uint32_t lineCount;
+    uint32_t endColumn;
+    ok = read(numParameters)
+        && read(codeBlock->m_numVars)
+        && read(codeBlock->m_numCapturedVars)
+        && read(codeBlock->m_numCalleeLocals)
+        && read(thisRegister)
+        && read(scopeRegister)
+        && read(globalObjectRegister)
+        && read(features)
+        && read(hasCapturedVariables)
+        && read(lineCount)
+        && read(endColumn)
+        && readString(codeBlock->m_sourceURLDirective)
+        && readString(codeBlock->m_sourceMappingURLDirective);
+    if (!ok)
+        return nullptr;
+    codeBlock->setNumParameters(numParameters);
+    codeBlock->setThisRegister(VirtualRegister(thisRegister));
+    codeBlock->setScopeRegister(VirtualRegister(scopeRegister));
+    codeBlock->setGlobalObjectRegister(VirtualRegister(globalObjectRegister));
+    codeBlock->recordParse(features, hasCapturedVariables, lineCount, endColumn);
+
+    uint32_t instructionCount;
+    uint32_t packedSize;
+    if (!read(instructionCount) || !readCount(packedSize, 1))
+        return nullptr;
+    if (!UnlinkedInstructionStream::isValidPackedData(m_cursor, packedSize, instructionCount))
+        return nullptr;
+    codeBlock->setInstructions(std::make_unique<UnlinkedInstructionStream>(m_cursor, packedSize, instructionCount));
+    m_cursor += packedSize;
+
+    if (!readPODVector(codeBlock->m_jumpTargets) || !readPODVector(codeBlock->m_propertyAccessInstructions))
+        return nullptr;
+
+    uint32_t count;
+    if (!readCount(count, sizeof(CachedUniquedStringTag)))
+        return nullptr;
+    for (uint32_t i = 0; i < count; ++i) {
+        Identifier identifier;
+        if (!readIdentifier(identifier))
+            return nullptr;
+        codeBlock->addIdentifier(identifier);
+    }
+
+    if (!readCount(count, sizeof(uint32_t)))
+        return nullptr;
+    for (uint32_t i = 0; i < count; ++i) {
+        BitVector bitVector;
+        if (!readBitVector(bitVector))
+            return nullptr;
+        codeBlock->addBitVector(WTFMove(bitVector));
+    }
+
+    if (!readCount(count, sizeof(CachedConstantKind) + sizeof(uint8_t)))
+        return nullptr;
+    for (uint32_t i = 0; i < count; ++i) {
+        CachedConstantKind kind;
+        if (!read(kind))
+            return nullptr;
+        switch (kind) {
+        case CachedConstantKind::LinkTimeConstant: {
+            uint8_t type;
+            if (!read(type) || type >= LinkTimeConstantCount || !i)
+                return nullptr;
+            codeBlock->addConstant(static_cast<LinkTimeConstant>(type));
+            break;
+        }
+        case CachedConstantKind::IdentifierSet: {
+            uint32_t size;
+            if (!readCount(size, sizeof(CachedUniquedStringTag)))
+                return nullptr;
+            IdentifierSet set;
+            for (uint32_t j = 0; j < size; ++j) {
+                RefPtr<UniquedStringImpl> uid;
+                if (!readUniquedString(uid) || !uid)
+                    return nullptr;
+                set.add(WTFMove(uid));
+            }
+            codeBlock->addSetConstant(set);
+            break;
+        }
+        case CachedConstantKind::Value: {
+            uint8_t sourceCodeRepresentation;
+            JSValue value;
+            if (!read(sourceCodeRepresentation) || sourceCodeRepresentation > static_cast<uint8_t>(SourceCodeRepresentation::Double))
+                return nullptr;
+            if (!readValue(value))
+                return nullptr;
+            codeBlock->addConstant(value, static_cast<SourceCodeRepresentation>(sourceCodeRepresentation));
+            break;
+        }
+        default:
+            return nullptr;
+        }
+    }
+
+    for (bool isDeclaration : { true, false }) {
+        if (!readCount(count, sizeof(uint32_t)))
+            return nullptr;
+        for (uint32_t i = 0; i < count; ++i) {
+            UnlinkedFunctionExecutable* executable = readFunctionExecutable();
+            if (!executable)
+                return nullptr;
+            if (isDeclaration)
+                codeBlock->addFunctionDecl(executable);
+            else
+                codeBlock->addFunctionExpr(executable);
+        }
+    }
+
+    ok = read(codeBlock->m_arrayProfileCount)
+        && read(codeBlock->m_arrayAllocationProfileCount)
+        && read(codeBlock->m_objectAllocationProfileCount)
+        && read(codeBlock->m_valueProfileCount)
+        && read(codeBlock->m_llintCallLinkInfoCount)
+        && readPODVector(codeBlock->m_expressionInfo);
+    if (!ok)
+        return nullptr;
+
+    bool hasRareData;
+    if (!read(hasRareData))
+        return nullptr;
+    if (hasRareData && !readRareData(codeBlock))
+        return nullptr;
+
+    if (UnlinkedProgramCodeBlock* programCodeBlock = jsDynamicCast<UnlinkedProgramCodeBlock*>(m_vm, codeBlock)) {
+        VariableEnvironment varDeclarations;
+        VariableEnvironment lexicalDeclarations;
+        if (!readVariableEnvironment(varDeclarations) || !readVariableEnvironment(lexicalDeclarations))
+            return nullptr;
+        programCodeBlock->setVariableDeclarations(varDeclarations);
+        programCodeBlock->setLexicalDeclarations(lexicalDeclarations);
+    } else if (UnlinkedModuleProgramCodeBlock* moduleProgramCodeBlock = jsDynamicCast<UnlinkedModuleProgramCodeBlock*>(m_vm, codeBlock)) {
+        int32_t offset;
+        if (!read(offset))
+            return nullptr;
+        moduleProgramCodeBlock->setModuleEnvironmentSymbolTableConstantRegisterOffset(offset);
+    }
+
+    m_cells = WTFMove(outerCells);
+    return codeBlock;
+}
+
+void BytecodeCacheEncoder::writeEntry(const SHA1::Digest& digest, UnlinkedCodeBlock* codeBlock)
+{
+    writeHeader(digest);
+
+    size_t sizePosition = reserveUInt32();
+    writeCodeBlock(codeBlock);
+    patchUInt32(sizePosition, m_buffer.size() - sizePosition - sizeof(uint32_t));
+
+    // Writing a function code block may queue up the code blocks of its own nested functions.
+    for (size_t i = 0; i < m_pendingFunctionCodeBlocks.size() && !m_failed; ++i) {
+        PendingFunctionCodeBlock pending = m_pendingFunctionCodeBlocks[i];
+        size_t offset = m_buffer.size();
+        writeCodeBlock(pending.codeBlock);
+        patchUInt32(pending.locationPosition, offset);
+        patchUInt32(pending.locationPosition + sizeof(uint32_t), m_buffer.size() - offset);
+    }
+}
+
+CachedBytecode::CachedBytecode(const SourceCode& source, Vector<uint8_t>&& data)
+    : m_source(source)
+    , m_ownedData(WTFMove(data))
+    , m_data(m_ownedData.data())
+    , m_size(m_ownedData.size())
+    , m_isMappedFile(false)
+{
+}
+
+CachedBytecode::CachedBytecode(const SourceCode& source, void* data, size_t size)
+    : m_source(source)
+    , m_data(static_cast<const uint8_t*>(data))
+    , m_size(size)
+    , m_isMappedFile(true)
+{
+}
+
+CachedBytecode::~CachedBytecode()
+{
+#if OS(UNIX)
+    if (m_isMappedFile)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+Vector<uint8_t> encodeCodeBlock(VM& vm, const SHA1::Digest& digest, const UnlinkedSourceCode& source, UnlinkedCodeBlock* codeBlock)
+{
+    BytecodeCacheEncoder encoder(vm, source);
+    encoder.writeEntry(digest, codeBlock);
+    if (encoder.failed())
+        return { };
+    return encoder.takeBuffer();
+}
+
+UnlinkedCodeBlock* decodeCodeBlock(VM& vm, const SHA1::Digest& digest, CachedBytecode& bytecode)
+{
+    if (bytecode.size() > std::numeric_limits<uint32_t>::max())
+        return nullptr;
+
+    // Nothing we allocate is reachable from the heap until the whole tree has been decoded.
+    DeferGC deferGC(vm.heap);
+
+    CachedCodeBlockLocation location;
+    location.size = static_cast<uint32_t>(bytecode.size());
+    BytecodeCacheDecoder decoder(vm, bytecode, location);
+    if (!decoder.readHeader(digest) || !decoder.readTopLevelCodeBlockSize())
+        return nullptr;
+    UnlinkedCodeBlock* codeBlock = decoder.readCodeBlock();
+    if (!codeBlock || !decoder.atEnd())
+        return nullptr;
+    return codeBlock;
+}
+
+UnlinkedFunctionCodeBlock* decodeFunctionCodeBlock(VM& vm, CachedBytecode& bytecode, const CachedCodeBlockLocation& location)
+{
+    DeferGC deferGC(vm.heap);
+
+    BytecodeCacheDecoder decoder(vm, bytecode, location);
+    UnlinkedCodeBlock* codeBlock = decoder.readCodeBlock();
+    if (!codeBlock || !decoder.atEnd() || codeBlock->codeType() != FunctionCode)
+        return nullptr;
+    return jsCast<UnlinkedFunctionCodeBlock*>(codeBlock);
+}
+
+} // namespace JSC
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "SourceCode.h"
+#include <wtf/RefCounted.h>
+#include <wtf/SHA1.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class UnlinkedCodeBlock;
+class UnlinkedFunctionCodeBlock;
+class UnlinkedSourceCode;
+class VM;
+
+// The bytecode cache serializes unlinked program and module code blocks, together with the
+// UnlinkedFunctionExecutables nested inside them, into a flat byte stream. The stream holds no
+// pointers, so it can be decoded directly out of an mmap'd file. The digest identifies the source
+// text and the parsing flags the code block was generated for; decoding fails if it does not match.
+//
+// Function code blocks are stored out of line, after the top-level code block, and located by an
+// offset table in their UnlinkedFunctionExecutable. They are only decoded the first time the
+// function is called, so functions that never run cost nothing beyond their executable.
+
+// The bytes of a single cache entry, and the source they were decoded for. Executables decoded
+// from the entry keep it alive so that they can decode their code blocks on demand.
+class CachedBytecode : public RefCounted<CachedBytecode> {
+public:
+    static Ref<CachedBytecode> create(const SourceCode& source, Vector<uint8_t>&& data)
+    {
+        return adoptRef(*new CachedBytecode(source, WTFMove(data)));
+    }
+
+#if OS(UNIX)
+    // Adopts a read-only mapping, which is unmapped when the last reference goes away.
+    static Ref<CachedBytecode> adoptMappedFile(const SourceCode& source, void* data, size_t size)
+    {
+        return adoptRef(*new CachedBytecode(source, data, size));
+    }
+#endif
+
+    ~CachedBytecode();
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    const SourceCode& source() const { return m_source; }
+
+private:
+    CachedBytecode(const SourceCode&, Vector<uint8_t>&&);
+    CachedBytecode(const SourceCode&, void* data, size_t);
+
+    SourceCode m_source;
+    Vector<uint8_t> m_ownedData;
+    const uint8_t* m_data;
+    size_t m_size;
+    bool m_isMappedFile;
+};
+
+struct CachedCodeBlockLocation {
+    uint32_t offset { 0 };
+    uint32_t size { 0 };
+
+    explicit operator bool() const { return size; }
+};
+
+// Returns an empty vector if the code block holds something the format cannot represent.
+Vector<uint8_t> encodeCodeBlock(VM&, const SHA1::Digest&, const UnlinkedSourceCode&, UnlinkedCodeBlock*);
+
+// Returns nullptr if the data is malformed, was written by an incompatible build, or was
+// generated for a different source.
+UnlinkedCodeBlock* decodeCodeBlock(VM&, const SHA1::Digest&, CachedBytecode&);
+
+// Decodes the code block of a function executable that was itself decoded from the entry.
+UnlinkedFunctionCodeBlock* decodeFunctionCodeBlock(VM&, CachedBytecode&, const CachedCodeBlockLocation&);
+
+} // namespace JSC
@@ -48,6 +48,24 @@ void CodeCacheMap::pruneSlowCase()
     }
 }
 
+template <class UnlinkedCodeBlockType, class ExecutableType>
+static void recordCachedParse(ExecutableType* executable, UnlinkedCodeBlockType* unlinkedCodeBlock, const SourceCode& source)
+{
+    unsigned lineCount = unlinkedCodeBlock->lineCount();
+    unsigned startColumn = unlinkedCodeBlock->startColumn() + source.startColumn().oneBasedInt();
+    bool endColumnIsOnStartLine = !lineCount;
+    unsigned endColumn = unlinkedCodeBlock->endColumn() + (endColumnIsOnStartLine ? startColumn : 1);
+    executable->recordParse(unlinkedCodeBlock->codeFeatures(), unlinkedCodeBlock->hasCapturedVariables(), source.firstLine().oneBasedInt() + lineCount, endColumn);
+    source.provider()->setSourceURLDirective(unlinkedCodeBlock->sourceURLDirective());
+    source.provider()->setSourceMappingURLDirective(unlinkedCodeBlock->sourceMappingURLDirective());
+}
+
+static bool canUseBytecodeCache(VM& vm)
+{
+    // Profiling bytecode is tied to the profiler state of the VM that generated it.
+    return !vm.typeProfiler() && !vm.controlFlowProfiler();
+}
+
 template <class UnlinkedCodeBlockType, class ExecutableType>
 UnlinkedCodeBlockType* CodeCache::getUnlinkedGlobalCodeBlock(VM& vm, ExecutableType* executable, const SourceCode& source, JSParserStrictMode strictMode, JSParserScriptMode scriptMode, DebuggerMode debuggerMode, ParserError& error, EvalContextType evalContextType)
 {
@@ -61,15 +79,21 @@ UnlinkedCodeBlockType* CodeCache::getUnlinkedGlobalCodeBlock(VM& vm, ExecutableT
     SourceCodeValue* cache = m_sourceCode.findCacheAndUpdateAge(key);
     if (cache && Options::useCodeCache()) {
         UnlinkedCodeBlockType* unlinkedCodeBlock = jsCast<UnlinkedCodeBlockType*>(cache->cell.get());
-        unsigned lineCount = unlinkedCodeBlock->lineCount();
-        unsigned startColumn = unlinkedCodeBlock->startColumn() + source.startColumn().oneBasedInt();
-        bool endColumnIsOnStartLine = !lineCount;
-        unsigned endColumn = unlinkedCodeBlock->endColumn() + (endColumnIsOnStartLine ? startColumn : 1);
-        executable->recordParse(unlinkedCodeBlock->codeFeatures(), unlinkedCodeBlock->hasCapturedVariables(), source.firstLine().oneBasedInt() + lineCount, endColumn);
-        source.provider()->setSourceURLDirective(unlinkedCodeBlock->sourceURLDirective());
-        source.provider()->setSourceMappingURLDirective(unlinkedCodeBlock->sourceMappingURLDirective());
+        recordCachedParse(executable, unlinkedCodeBlock, source);
         return unlinkedCodeBlock;
     }
+
+    if (Options::useCodeCache() && CacheTypes<UnlinkedCodeBlockType>::codeType != SourceCodeType::EvalType) {
+        bool loadedFromBytecodeCache = false;
+        UnlinkedCodeBlock* compiledCodeBlock = findCompiledCodeBlock(vm, key, source, loadedFromBytecodeCache);
+        if (UnlinkedCodeBlockType* unlinkedCodeBlock = compiledCodeBlock ? jsDynamicCast<UnlinkedCodeBlockType*>(vm, compiledCodeBlock) : nullptr) {
+            SourceCodeValue value(vm, unlinkedCodeBlock, m_sourceCode.age());
+            value.loadedFromBytecodeCache = loadedFromBytecodeCache;
+            m_sourceCode.addCache(key, value);
+            recordCachedParse(executable, unlinkedCodeBlock, source);
+            return unlinkedCodeBlock;
+        }
+    }
     
     VariableEnvironment variablesUnderTDZ;
     UnlinkedCodeBlockType* unlinkedCodeBlock = generateUnlinkedCodeBlock<UnlinkedCodeBlockType, ExecutableType>(vm, executable, source, strictMode, scriptMode, debuggerMode, error, evalContextType, &variablesUnderTDZ);
@@ -162,4 +186,69 @@ UnlinkedFunctionExecutable* CodeCache::getUnlinkedGlobalFunctionExecutable(VM& v
     return functionExecutable;
 }
 
+// Looks for a code block that was compiled ahead of time, either by the parser worklist or by an
+// earlier run that wrote it to the bytecode cache.
+UnlinkedCodeBlock* CodeCache::findCompiledCodeBlock(VM& vm, const SourceCodeKey& key, const SourceCode& source, bool& loadedFromBytecodeCache)
+{
+    if (!canUseBytecodeCache(vm))
+        return nullptr;
+    if (m_parserWorklist && !m_parserWorklist->isEmpty()) {
+        if (UnlinkedCodeBlock* unlinkedCodeBlock = m_parserWorklist->takeResult(vm, key, source))
+            return unlinkedCodeBlock;
+    }
+    if (m_bytecodeCache) {
+        UnlinkedCodeBlock* unlinkedCodeBlock = m_bytecodeCache->load(vm, key, source);
+        loadedFromBytecodeCache = unlinkedCodeBlock;
+        return unlinkedCodeBlock;
+    }
+    return nullptr;
+}
+
+bool CodeCache::precompile(VM& vm, const SourceCode& source, SourceCodeType codeType, const Identifier& moduleKey)
+{
+    if (!Options::useCodeCache() || !canUseBytecodeCache(vm))
+        return false;
+    if (m_sourceCode.contains(ParserWorklist::keyFor(source, codeType)))
+        return false;
+    return parserWorklist().enqueue(source, codeType, moduleKey);
+}
+
+ParserWorklist& CodeCache::parserWorklist()
+{
+    if (!m_parserWorklist)
+        m_parserWorklist = std::make_unique<ParserWorklist>(Options::numberOfParserWorklistThreads());
+    return *m_parserWorklist;
+}
+
+void CodeCache::setBytecodeCachePath(const String& path)
+{
+    if (path.isEmpty()) {
+        m_bytecodeCache = nullptr;
+        return;
+    }
+    m_bytecodeCache = std::make_unique<BytecodeCache>(path);
+}
+
+void CodeCache::writeBytecodeCache(VM& vm)
+{
+    if (!m_bytecodeCache || !canUseBytecodeCache(vm))
+        return;
+
+    for (auto& entry : m_sourceCode) {
+        JSCell* cell = entry.value.cell.get();
+        if (!jsDynamicCast<UnlinkedProgramCodeBlock*>(vm, cell) && !jsDynamicCast<UnlinkedModuleProgramCodeBlock*>(vm, cell))
+            continue;
+        UnlinkedCodeBlock* codeBlock = jsCast<UnlinkedCodeBlock*>(cell);
+
+        // The file already holds everything an entry we loaded from it has, unless a function
+        // generated new code since. Encoding it again would also decode every function code block
+        // that was never called, which is the work the lazy decoding saved us.
+        if (entry.value.loadedFromBytecodeCache && !codeBlock->hasFunctionCodeBlocksMissingFromCachedBytecode()) {
+            m_bytecodeCache->didSkipUnchangedEntry();
+            continue;
+        }
+        m_bytecodeCache->store(vm, entry.key, codeBlock);
+    }
+}
+
 }
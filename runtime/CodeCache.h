@@ -25,11 +25,13 @@
 
 #pragma once
 
+#include "BytecodeCache.h"
 #include "BytecodeGenerator.h"
 #include "ExecutableInfo.h"
 #include "JSCInlines.h"
 #include "Parser.h"
 #include "ParserModes.h"
+#include "ParserWorklist.h"
 #include "SourceCodeKey.h"
 #include "Strong.h"
 #include "StrongInlines.h"
@@ -72,12 +74,14 @@ struct SourceCodeValue {
 
     Strong<JSCell> cell;
     int64_t age;
+    bool loadedFromBytecodeCache { false };
 };
 
 class CodeCacheMap {
 public:
     typedef HashMap<SourceCodeKey, SourceCodeValue, SourceCodeKey::Hash, SourceCodeKey::HashTraits> MapType;
     typedef MapType::iterator iterator;
+    typedef MapType::const_iterator const_iterator;
     typedef MapType::AddResult AddResult;
 
     CodeCacheMap()
@@ -146,6 +150,11 @@ public:
 
     int64_t age() { return m_age; }
 
+    bool contains(const SourceCodeKey& key) const { return m_map.contains(key); }
+
+    const_iterator begin() const { return m_map.begin(); }
+    const_iterator end() const { return m_map.end(); }
+
 private:
     // This constant factor biases cache capacity toward allowing a minimum
     // working set to enter the cache before it starts evicting.
@@ -197,13 +206,36 @@ public:
     UnlinkedModuleProgramCodeBlock* getUnlinkedModuleProgramCodeBlock(VM&, ModuleProgramExecutable*, const SourceCode&, DebuggerMode, ParserError&);
     UnlinkedFunctionExecutable* getUnlinkedGlobalFunctionExecutable(VM&, const Identifier&, const SourceCode&, DebuggerMode, ParserError&);
 
-    void clear() { m_sourceCode.clear(); }
+    void clear()
+    {
+        m_sourceCode.clear();
+        if (m_parserWorklist)
+            m_parserWorklist->clear();
+    }
+
+    // Starts compiling a program or module on a helper thread. The result is used the next time
+    // the same source is evaluated. A module with a key is also analyzed for the module loader.
+    // Returns false if the source is already cached or queued.
+    bool precompile(VM&, const SourceCode&, SourceCodeType, const Identifier& moduleKey = Identifier());
+
+    // The helper threads that precompile() and the module loader's pipelined mode use.
+    JS_EXPORT_PRIVATE ParserWorklist& parserWorklist();
+
+    // Program and module code blocks missing from the in-memory cache are looked up in the
+    // on-disk cache at this path, if set. writeBytecodeCache() saves the current contents of
+    // the in-memory cache there.
+    void setBytecodeCachePath(const String&);
+    BytecodeCache* bytecodeCache() const { return m_bytecodeCache.get(); }
+    void writeBytecodeCache(VM&);
 
 private:
     template <class UnlinkedCodeBlockType, class ExecutableType> 
     UnlinkedCodeBlockType* getUnlinkedGlobalCodeBlock(VM&, ExecutableType*, const SourceCode&, JSParserStrictMode, JSParserScriptMode, DebuggerMode, ParserError&, EvalContextType);
+    UnlinkedCodeBlock* findCompiledCodeBlock(VM&, const SourceCodeKey&, const SourceCode&, bool& loadedFromBytecodeCache);
 
     CodeCacheMap m_sourceCode;
+    std::unique_ptr<BytecodeCache> m_bytecodeCache;
+    std::unique_ptr<ParserWorklist> m_parserWorklist;
 };
 
 template <typename T> struct CacheTypes { };
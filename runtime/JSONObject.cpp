@@ -39,6 +39,7 @@
 #include "ObjectConstructor.h"
 #include "JSCInlines.h"
 #include "PropertyNameArray.h"
+#include "StrongInlines.h"
 #include <wtf/MathExtras.h>
 #include <wtf/text/StringBuilder.h>
 
@@ -91,6 +92,19 @@ public:
     void visitAggregate(SlotVisitor&);
 
 private:
+    // Plain objects are serialized straight from their structure. The enumerable string keys,
+    // their offsets and the keys already quoted for output are collected once per structure.
+    struct CachedProperty {
+        Identifier propertyName;
+        PropertyOffset offset;
+        String quotedPropertyName;
+    };
+    struct CachedStructure {
+        Strong<Structure> structure;
+        Vector<CachedProperty> properties;
+    };
+    const CachedStructure* cachedStructure(JSObject*);
+
     class Holder {
     public:
         enum RootHolderTag { RootHolder };
@@ -109,6 +123,7 @@ private:
         unsigned m_index;
         unsigned m_size;
         RefPtr<PropertyNameArrayData> m_propertyNames;
+        const CachedStructure* m_cachedStructure { nullptr };
     };
 
     friend class Holder;
@@ -135,6 +150,9 @@ private:
     Vector<Holder, 16, UnsafeVectorOverflow> m_holderStack;
     String m_repeatedGap;
     String m_indent;
+
+    // A null entry means the structure has to be serialized through getOwnPropertyNames().
+    HashMap<Structure*, std::unique_ptr<CachedStructure>> m_cachedStructures;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -409,6 +427,46 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(StringBuilder&
     return StringifySucceeded;
 }
 
+auto Stringifier::cachedStructure(JSObject* object) -> const CachedStructure*
+{
+    if (!Options::useJSONStringifyStructureCache())
+        return nullptr;
+
+    VM& vm = m_exec->vm();
+    Structure* structure = object->structure(vm);
+    if (object->type() != FinalObjectType || hasIndexedProperties(object->indexingType()) || structure->isDictionary())
+        return nullptr;
+
+    auto addResult = m_cachedStructures.add(structure, nullptr);
+    if (!addResult.isNewEntry)
+        return addResult.iterator->value.get();
+
+    auto cachedStructure = std::make_unique<CachedStructure>();
+    bool hasAccessors = false;
+    structure->forEachProperty(vm, [&] (const PropertyMapEntry& entry) -> bool {
+        if (entry.attributes & (Accessor | CustomAccessor)) {
+            hasAccessors = true;
+            return false;
+        }
+        if ((entry.attributes & DontEnum) || entry.key->isSymbol())
+            return true;
+
+        StringBuilder quotedPropertyName;
+        quotedPropertyName.appendQuotedJSONString(String(entry.key));
+        quotedPropertyName.append(':');
+        if (willIndent())
+            quotedPropertyName.append(' ');
+        cachedStructure->properties.append(CachedProperty { Identifier::fromUid(&vm, entry.key), entry.offset, quotedPropertyName.toString() });
+        return true;
+    });
+    if (hasAccessors)
+        return nullptr;
+
+    cachedStructure->structure.set(vm, structure);
+    addResult.iterator->value = WTFMove(cachedStructure);
+    return addResult.iterator->value.get();
+}
+
 inline bool Stringifier::willIndent() const
 {
     return !m_gap.isEmpty();
@@ -483,13 +541,13 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
-            else {
+            else if (!(m_cachedStructure = stringifier.cachedStructure(m_object.get()))) {
                 PropertyNameArray objectPropertyNames(exec, PropertyNameMode::Strings);
                 m_object->methodTable()->getOwnPropertyNames(m_object.get(), exec, objectPropertyNames, EnumerationMode());
                 RETURN_IF_EXCEPTION(scope, false);
                 m_propertyNames = objectPropertyNames.releaseData();
             }
-            m_size = m_propertyNames->propertyNameVector().size();
+            m_size = m_cachedStructure ? m_cachedStructure->properties.size() : m_propertyNames->propertyNameVector().size();
             builder.append('{');
         }
         stringifier.indent();
@@ -531,13 +589,21 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         stringifyResult = stringifier.appendStringifiedValue(builder, value, *this, index);
         ASSERT(stringifyResult != StringifyFailedDueToUndefinedOrSymbolValue);
     } else {
-        // Get the value.
-        PropertySlot slot(m_object.get(), PropertySlot::InternalMethodType::Get);
-        Identifier& propertyName = m_propertyNames->propertyNameVector()[index];
-        if (!m_object->methodTable()->getOwnPropertySlot(m_object.get(), exec, propertyName, slot))
-            return true;
-        JSValue value = slot.getValue(exec, propertyName);
-        RETURN_IF_EXCEPTION(scope, false);
+        // Get the value. The names were collected when this object was first reached, so a toJSON
+        // function or getter that ran since may have changed its structure; if so, look the
+        // property up the way getOwnPropertyNames() would have.
+        const CachedProperty* cachedProperty = m_cachedStructure ? &m_cachedStructure->properties[index] : nullptr;
+        const Identifier& propertyName = cachedProperty ? cachedProperty->propertyName : m_propertyNames->propertyNameVector()[index];
+        JSValue value;
+        if (cachedProperty && m_object->structure(vm) == m_cachedStructure->structure.get())
+            value = m_object->getDirect(cachedProperty->offset);
+        else {
+            PropertySlot slot(m_object.get(), PropertySlot::InternalMethodType::Get);
+            if (!m_object->methodTable()->getOwnPropertySlot(m_object.get(), exec, propertyName, slot))
+                return true;
+            value = slot.getValue(exec, propertyName);
+            RETURN_IF_EXCEPTION(scope, false);
+        }
 
         rollBackPoint = builder.length();
 
@@ -547,10 +613,14 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         stringifier.startNewLine(builder);
 
         // Append the property name.
-        builder.appendQuotedJSONString(propertyName.string());
-        builder.append(':');
-        if (stringifier.willIndent())
-            builder.append(' ');
+        if (cachedProperty)
+            builder.append(cachedProperty->quotedPropertyName);
+        else {
+            builder.appendQuotedJSONString(propertyName.string());
+            builder.append(':');
+            if (stringifier.willIndent())
+                builder.append(' ');
+        }
 
         // Append the stringified value.
         stringifyResult = stringifier.appendStringifiedValue(builder, value, *this, propertyName);
@@ -3077,7 +3077,9 @@ bool JSObject::increaseVectorLength(VM& vm, unsigned newLength)
     unsigned vectorLength = storage->vectorLength();
     unsigned availableVectorLength = storage->availableVectorLength(structure(vm), vectorLength); 
     if (availableVectorLength >= newLength) {
-        // The cell was already big enough for the desired length!
+        // The cell was already big enough for the desired length! The collector reads the vector
+        // length with the cell lock held, so hold it until the new part is initialized.
+        auto locker = holdLock(*this);
         for (unsigned i = vectorLength; i < availableVectorLength; ++i)
             storage->m_vector[i].clear();
         storage->setVectorLength(availableVectorLength);
@@ -3106,6 +3108,14 @@ bool JSObject::increaseVectorLength(VM& vm, unsigned newLength)
             ArrayStorage::sizeFor(vectorLength), ArrayStorage::sizeFor(newVectorLength));
         if (!newButterfly)
             return false;
+        if (newButterfly == storage->butterfly()) {
+            // It grew in place, so the collector may be scanning it. See above.
+            auto locker = holdLock(*this);
+            for (unsigned i = vectorLength; i < newVectorLength; ++i)
+                newButterfly->arrayStorage()->m_vector[i].clear();
+            newButterfly->arrayStorage()->setVectorLength(newVectorLength);
+            return true;
+        }
         for (unsigned i = vectorLength; i < newVectorLength; ++i)
             newButterfly->arrayStorage()->m_vector[i].clear();
         newButterfly->arrayStorage()->setVectorLength(newVectorLength);
@@ -3161,7 +3171,10 @@ bool JSObject::ensureLengthSlow(VM& vm, unsigned length)
             newVectorLength * sizeof(EncodedJSValue));
         if (!butterfly)
             return false;
-        newButterfly = butterfly;
+        // A butterfly that grew in place is already published, so it is treated like one that
+        // was big enough to begin with.
+        if (butterfly != m_butterfly.get())
+            newButterfly = butterfly;
     }
 
     if (hasDouble(indexingType())) {
@@ -79,6 +79,7 @@ public:
     friend class JSRopeString;
     friend class MarkStack;
     friend class SlotVisitor;
+    friend class StringDeduplicator;
     friend struct ThunkHelpers;
 
     typedef JSCell Base;
@@ -34,6 +34,7 @@
 #include "Lexer.h"
 #include "ObjectConstructor.h"
 #include "JSCInlines.h"
+#include "SIMDCharacters.h"
 #include "StrongInlines.h"
 #include <wtf/ASCIICType.h>
 #include <wtf/dtoa.h>
@@ -348,11 +349,33 @@ template <ParserMode mode, typename CharType, UChar terminator> static ALWAYS_IN
     return (c >= ' ' && (mode == StrictJSON || c <= 0xff) && c != '\\' && c != terminator) || (c == '\t' && mode != StrictJSON);
 }
 
+#if USE(SIMD_CHARACTER_SCANNING)
+// Skips ahead to the first character that isSafeStringCharacter() may reject. Tabs, which are
+// safe in non-strict mode, are rare enough to leave to the scalar loop.
+template <ParserMode mode, typename CharType, UChar terminator> static ALWAYS_INLINE const CharType* scanSafeStringCharacters(const CharType* position, const CharType* end)
+{
+    typedef SIMDCharacters<CharType> SIMD;
+    return scanCharacters(position, end, [] (__m128i characters) {
+        __m128i result = _mm_or_si128(SIMD::lessThanOrEqual(characters, 0x1F), SIMD::equal(characters, '\\'));
+        result = _mm_or_si128(result, SIMD::equal(characters, terminator));
+        if (mode != StrictJSON && sizeof(CharType) == 2)
+            result = _mm_or_si128(result, invertCharacterMask(SIMD::lessThanOrEqual(characters, 0xFF)));
+        return result;
+    });
+}
+#else
+template <ParserMode, typename CharType, UChar> static ALWAYS_INLINE const CharType* scanSafeStringCharacters(const CharType* position, const CharType*)
+{
+    return position;
+}
+#endif
+
 template <typename CharType>
 template <ParserMode mode, char terminator> ALWAYS_INLINE TokenType LiteralParser<CharType>::Lexer::lexString(LiteralParserToken<CharType>& token)
 {
     ++m_ptr;
     const CharType* runStart = m_ptr;
+    m_ptr = scanSafeStringCharacters<mode, CharType, terminator>(m_ptr, m_end);
     while (m_ptr < m_end && isSafeStringCharacter<mode, CharType, terminator>(*m_ptr))
         ++m_ptr;
     if (LIKELY(m_ptr < m_end && *m_ptr == terminator)) {
@@ -372,6 +395,7 @@ template <ParserMode mode, char terminator> TokenType LiteralParser<CharType>::L
     goto slowPathBegin;
     do {
         runStart = m_ptr;
+        m_ptr = scanSafeStringCharacters<mode, CharType, terminator>(m_ptr, m_end);
         while (m_ptr < m_end && isSafeStringCharacter<mode, CharType, terminator>(*m_ptr))
             ++m_ptr;
         if (!m_builder.isEmpty())
@@ -568,6 +592,57 @@ TokenType LiteralParser<CharType>::Lexer::lexNumber(LiteralParserToken<CharType>
     return TokNumber;
 }
 
+template <typename CharType>
+ALWAYS_INLINE auto LiteralParser<CharType>::propertyTransitionCacheEntry(JSObject* object) -> PropertyTransitionCacheEntry&
+{
+    return m_propertyTransitionCache[object->structureID() % propertyTransitionCacheSize];
+}
+
+template <typename CharType>
+template <typename TokenCharType>
+ALWAYS_INLINE const Identifier LiteralParser<CharType>::makePropertyName(JSObject* object, const TokenCharType* characters, size_t length)
+{
+    PropertyTransitionCacheEntry& entry = propertyTransitionCacheEntry(object);
+    if (entry.structure.get() == object->structure() && Identifier::equal(entry.propertyName.impl(), characters, length))
+        return entry.propertyName;
+    return makeIdentifier(characters, length);
+}
+
+template <typename CharType>
+ALWAYS_INLINE void LiteralParser<CharType>::putDirectWithTransitionCache(VM& vm, JSObject* object, const Identifier& propertyName, JSValue value)
+{
+    Structure* structure = object->structure(vm);
+    PropertyTransitionCacheEntry& entry = propertyTransitionCacheEntry(object);
+    if (entry.structure.get() == structure && entry.propertyName == propertyName) {
+        // This mirrors the existing transition case of JSObject::putDirectInternal(), except that
+        // growing the butterfly is left to it.
+        Structure* newStructure = entry.newStructure.get();
+        if (newStructure->outOfLineCapacity() == structure->outOfLineCapacity()) {
+            newStructure->willStoreValueForExistingTransition(vm, propertyName, value, false);
+            object->putDirect(vm, entry.offset, value);
+            object->setStructure(vm, newStructure);
+            return;
+        }
+    }
+
+    if (std::optional<uint32_t> index = parseIndex(propertyName)) {
+        object->putDirectIndex(m_exec, index.value(), value);
+        return;
+    }
+
+    object->putDirect(vm, propertyName, value);
+
+    // Only remember transitions that added the property, rather than replacing a duplicate key or
+    // turning the object into a dictionary.
+    Structure* newStructure = object->structure(vm);
+    if (newStructure->isDictionary() || newStructure->previousID() != structure)
+        return;
+    entry.structure.set(vm, structure);
+    entry.newStructure.set(vm, newStructure);
+    entry.propertyName = propertyName;
+    entry.offset = newStructure->lastOffset();
+}
+
 template <typename CharType>
 JSValue LiteralParser<CharType>::parse(ParserState initialState)
 {
@@ -631,9 +706,9 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                 if (type == TokString || (m_mode != StrictJSON && type == TokIdentifier)) {
                     typename Lexer::LiteralParserTokenPtr identifierToken = m_lexer.currentToken();
                     if (identifierToken->stringIs8Bit)
-                        identifierStack.append(makeIdentifier(identifierToken->stringToken8, identifierToken->stringLength));
+                        identifierStack.append(makePropertyName(object, identifierToken->stringToken8, identifierToken->stringLength));
                     else
-                        identifierStack.append(makeIdentifier(identifierToken->stringToken16, identifierToken->stringLength));
+                        identifierStack.append(makePropertyName(object, identifierToken->stringToken16, identifierToken->stringLength));
 
                     // Check for colon
                     if (m_lexer.next() != TokColon) {
@@ -662,10 +737,11 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     return JSValue();
                 }
                 typename Lexer::LiteralParserTokenPtr identifierToken = m_lexer.currentToken();
+                JSObject* object = asObject(objectStack.last());
                 if (identifierToken->stringIs8Bit)
-                    identifierStack.append(makeIdentifier(identifierToken->stringToken8, identifierToken->stringLength));
+                    identifierStack.append(makePropertyName(object, identifierToken->stringToken8, identifierToken->stringLength));
                 else
-                    identifierStack.append(makeIdentifier(identifierToken->stringToken16, identifierToken->stringLength));
+                    identifierStack.append(makePropertyName(object, identifierToken->stringToken16, identifierToken->stringLength));
 
                 // Check for colon
                 if (m_lexer.next() != TokColon) {
@@ -689,12 +765,8 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     CodeBlock* codeBlock = m_exec->codeBlock();
                     PutPropertySlot slot(object, codeBlock ? codeBlock->isStrictMode() : false);
                     objectStack.last().put(m_exec, ident, lastValue, slot);
-                } else {
-                    if (std::optional<uint32_t> index = parseIndex(ident))
-                        object->putDirectIndex(m_exec, index.value(), lastValue);
-                    else
-                        object->putDirect(vm, ident, lastValue);
-                }
+                } else
+                    putDirectWithTransitionCache(vm, object, identifierStack.last(), lastValue);
                 identifierStack.removeLast();
                 if (m_lexer.currentToken()->type == TokComma)
                     goto doParseObjectStartExpression;
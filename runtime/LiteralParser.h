@@ -27,6 +27,8 @@
 
 #include "Identifier.h"
 #include "JSCJSValue.h"
+#include "PropertyOffset.h"
+#include "Strong.h"
 #include <array>
 #include <wtf/text/StringBuilder.h>
 #include <wtf/text/WTFString.h>
@@ -199,6 +201,21 @@ private:
     std::array<Identifier, MaximumCachableCharacter> m_recentIdentifiers;
     ALWAYS_INLINE const Identifier makeIdentifier(const LChar* characters, size_t length);
     ALWAYS_INLINE const Identifier makeIdentifier(const UChar* characters, size_t length);
+
+    // The objects in a JSON payload tend to share their sequence of keys. Remembering the
+    // transition that each structure last took lets objects with the same shape skip making
+    // identifiers for their keys, and skip the transition table when the property is put.
+    struct PropertyTransitionCacheEntry {
+        Strong<Structure> structure;
+        Strong<Structure> newStructure;
+        Identifier propertyName;
+        PropertyOffset offset { invalidOffset };
+    };
+    static const unsigned propertyTransitionCacheSize = 32;
+    std::array<PropertyTransitionCacheEntry, propertyTransitionCacheSize> m_propertyTransitionCache;
+    ALWAYS_INLINE PropertyTransitionCacheEntry& propertyTransitionCacheEntry(JSObject*);
+    template <typename TokenCharType> ALWAYS_INLINE const Identifier makePropertyName(JSObject*, const TokenCharType* characters, size_t length);
+    ALWAYS_INLINE void putDirectWithTransitionCache(VM&, JSObject*, const Identifier&, JSValue);
 };
 
 } // namespace JSC
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "JSObject.h"
+#include "PropertySlot.h"
+#include "PutPropertySlot.h"
+#include "Structure.h"
+
+namespace JSC {
+
+// Once a get_by_id or put_by_id inline cache has seen too many structures, it gives up and calls
+// the generic operation for every access. This cache is shared by all such sites in the VM. It maps
+// (StructureID, uid) to the offset of an own data property, so that the generic operations can skip
+// the property lookup when some other site, or an earlier execution of the same site, has already
+// seen that structure and name. Loads and stores have separate tables, since a store can only be
+// cached for a writable property without an inferred type, and caching it gives up on watching
+// that property's replacement, the way a replace access case does. Objects whose property lookup
+// is impure are never cached, since we couldn't install the watchpoints an inline cache would.
+//
+// Structures don't change their properties unless they are dictionaries, which we don't cache, but
+// StructureIDs are reused once their structure dies, so the cache is cleared after every collection.
+//
+// Unlike HasOwnPropertyCache, nothing probes this cache from JIT code yet: the sites still make the
+// call to the generic operation, and only the property lookup is saved.
+class MegamorphicCache {
+    WTF_MAKE_NONCOPYABLE(MegamorphicCache);
+    WTF_MAKE_FAST_ALLOCATED;
+    static const uint32_t size = 2 * 1024;
+    static_assert(!(size & (size - 1)), "size should be a power of two.");
+public:
+    static const uint32_t mask = size - 1;
+
+    struct Entry {
+        RefPtr<UniquedStringImpl> impl { };
+        StructureID structureID { 0 };
+        PropertyOffset offset { invalidOffset };
+    };
+
+    MegamorphicCache() = default;
+
+    ALWAYS_INLINE static uint32_t hash(StructureID structureID, UniquedStringImpl* impl)
+    {
+        return bitwise_cast<uint32_t>(structureID) + impl->hash();
+    }
+
+    ALWAYS_INLINE PropertyOffset loadOffset(StructureID structureID, UniquedStringImpl* impl)
+    {
+        return lookup(m_loadEntries, structureID, impl);
+    }
+
+    ALWAYS_INLINE PropertyOffset storeOffset(StructureID structureID, UniquedStringImpl* impl)
+    {
+        return lookup(m_storeEntries, structureID, impl);
+    }
+
+    // The structure must be the object's structure both before and after the lookup that filled
+    // the slot, since looking up a property may reify it.
+    void tryAddLoad(VM& vm, JSObject* object, Structure* structure, UniquedStringImpl* impl, const PropertySlot& slot)
+    {
+        if (!slot.isCacheableValue() || slot.isTaintedByOpaqueObject() || slot.slotBase() != object)
+            return;
+        if (!isCacheable(vm, object, structure, impl))
+            return;
+        add(m_loadEntries, structure->id(), impl, slot.cachedOffset());
+    }
+
+    void tryAddStore(VM& vm, JSObject* object, Structure* structure, UniquedStringImpl* impl, const PutPropertySlot& slot)
+    {
+        if (!slot.isCacheablePut() || slot.type() != PutPropertySlot::ExistingProperty || slot.base() != object)
+            return;
+        if (!isCacheable(vm, object, structure, impl))
+            return;
+        if (structure->inferredTypeFor(impl))
+            return;
+        structure->didCachePropertyReplacement(vm, slot.cachedOffset());
+        add(m_storeEntries, structure->id(), impl, slot.cachedOffset());
+    }
+
+    void clear()
+    {
+        for (Entry& entry : m_loadEntries)
+            entry = Entry();
+        for (Entry& entry : m_storeEntries)
+            entry = Entry();
+    }
+
+private:
+    ALWAYS_INLINE static PropertyOffset lookup(std::array<Entry, size>& entries, StructureID structureID, UniquedStringImpl* impl)
+    {
+        Entry& entry = entries[hash(structureID, impl) & mask];
+        if (entry.structureID == structureID && entry.impl.get() == impl)
+            return entry.offset;
+        return invalidOffset;
+    }
+
+    static bool isCacheable(VM& vm, JSObject* object, Structure* structure, UniquedStringImpl* impl)
+    {
+        if (parseIndex(PropertyName(impl)))
+            return false;
+        if (object->type() == PureForwardingProxyType || object->type() == ImpureProxyType)
+            return false;
+        if (object->structure(vm) != structure)
+            return false;
+        return !structure->typeInfo().prohibitsPropertyCaching()
+            && !structure->typeInfo().getOwnPropertySlotIsImpure()
+            && structure->propertyAccessesAreCacheable()
+            && !structure->isDictionary();
+    }
+
+    static void add(std::array<Entry, size>& entries, StructureID structureID, UniquedStringImpl* impl, PropertyOffset offset)
+    {
+        ASSERT(isValidOffset(offset));
+        Entry& entry = entries[hash(structureID, impl) & mask];
+        entry.impl = impl;
+        entry.structureID = structureID;
+        entry.offset = offset;
+    }
+
+    std::array<Entry, size> m_loadEntries;
+    std::array<Entry, size> m_storeEntries;
+};
+
+ALWAYS_INLINE MegamorphicCache* VM::ensureMegamorphicCache()
+{
+    if (UNLIKELY(!m_megamorphicCache))
+        m_megamorphicCache = std::make_unique<MegamorphicCache>();
+    return m_megamorphicCache.get();
+}
+
+} // namespace JSC
@@ -27,6 +27,7 @@
 #include "ModuleLoaderPrototype.h"
 
 #include "BuiltinNames.h"
+#include "CodeCache.h"
 #include "CodeProfiling.h"
 #include "Error.h"
 #include "Exception.h"
@@ -48,6 +49,7 @@
 namespace JSC {
 
 static EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeParseModule(ExecState*);
+static EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeParseModuleConcurrently(ExecState*);
 static EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeRequestedModules(ExecState*);
 static EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeEvaluate(ExecState*);
 static EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeModuleDeclarationInstantiation(ExecState*);
@@ -90,6 +92,7 @@ const ClassInfo ModuleLoaderPrototype::s_info = { "ModuleLoader", &Base::s_info,
     requestImportModule            JSBuiltin                                           DontEnum|Function 2
     getModuleNamespaceObject       moduleLoaderPrototypeGetModuleNamespaceObject       DontEnum|Function 1
     parseModule                    moduleLoaderPrototypeParseModule                    DontEnum|Function 2
+    parseModuleConcurrently        moduleLoaderPrototypeParseModuleConcurrently        DontEnum|Function 2
     requestedModules               moduleLoaderPrototypeRequestedModules               DontEnum|Function 1
     resolve                        moduleLoaderPrototypeResolve                        DontEnum|Function 2
     fetch                          moduleLoaderPrototypeFetch                          DontEnum|Function 2
@@ -119,6 +122,12 @@ EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeParseModule(ExecState* exec)
 
     CodeProfiling profile(sourceCode);
 
+    if (Options::usePipelinedModuleLoading()) {
+        if (JSModuleRecord* moduleRecord = vm.codeCache()->parserWorklist().takeModuleRecord(exec, moduleKey, sourceCode))
+            return JSValue::encode(moduleRecord);
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    }
+
     ParserError error;
     std::unique_ptr<ModuleProgramNode> moduleProgramNode = parse<ModuleProgramNode>(
         &vm, sourceCode, Identifier(), JSParserBuiltinMode::NotBuiltin,
@@ -137,6 +146,32 @@ EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeParseModule(ExecState* exec)
     return JSValue::encode(moduleRecord);
 }
 
+// Starts parsing a fetched module on the parser worklist, which analyzes it and generates its
+// bytecode from the one parse, so that the modules a module requests are parsed in parallel by
+// the time the loader asks parseModule() for their records. Linking still happens on this thread.
+EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeParseModuleConcurrently(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!Options::usePipelinedModuleLoading())
+        return JSValue::encode(jsUndefined());
+
+    const Identifier moduleKey = exec->argument(0).toPropertyKey(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    auto* jsSourceCode = jsDynamicCast<JSSourceCode*>(vm, exec->argument(1));
+    if (!jsSourceCode)
+        return JSValue::encode(jsUndefined());
+    SourceCode sourceCode = jsSourceCode->sourceCode();
+
+    if (Options::dumpModuleLoadingState())
+        dataLog("Loader [parse concurrently] ", moduleKey, "\n");
+
+    vm.codeCache()->precompile(vm, sourceCode, SourceCodeType::ModuleType, moduleKey);
+    return JSValue::encode(jsUndefined());
+}
+
 EncodedJSValue JSC_HOST_CALL moduleLoaderPrototypeRequestedModules(ExecState* exec)
 {
     VM& vm = exec->vm();
@@ -152,6 +152,8 @@ typedef const char* optionString;
     v(bool, asyncDisassembly, false, Normal, nullptr) \
     v(bool, dumpDFGDisassembly, false, Normal, "dumps disassembly of DFG function upon compilation") \
     v(bool, dumpFTLDisassembly, false, Normal, "dumps disassembly of FTL function upon compilation") \
+    v(bool, logJITCodeForPerf, false, Normal, "writes the address, size and name of all JIT compiled code to /tmp/perf-<pid>.map for Linux perf") \
+    v(bool, dumpJITCodeForPerf, false, Normal, "writes all JIT compiled code with its name and source location to /tmp/jit-<pid>.dump for \"perf inject --jit\"") \
     v(bool, dumpAllDFGNodes, false, Normal, nullptr) \
     v(optionRange, bytecodeRangeToJITCompile, 0, Normal, "bytecode size range to allow compilation on, e.g. 1:100") \
     v(optionRange, bytecodeRangeToDFGCompile, 0, Normal, "bytecode size range to allow DFG compilation on, e.g. 1:100") \
@@ -181,6 +183,7 @@ typedef const char* optionString;
     v(bool, verboseFTLOSRExit, false, Normal, nullptr) \
     v(bool, verboseCallLink, false, Normal, nullptr) \
     v(bool, verboseCompilationQueue, false, Normal, nullptr) \
+    v(bool, reportCompilationQueueStatistics, false, Normal, "Reports how long DFG and FTL plans waited to start and to be installed, when the shell exits.") \
     v(bool, reportCompileTimes, false, Normal, "dumps JS function signature and the time it took to compile in all tiers") \
     v(bool, reportBaselineCompileTimes, false, Normal, "dumps JS function signature and the time it took to BaselineJIT compile") \
     v(bool, reportDFGCompileTimes, false, Normal, "dumps JS function signature and the time it took to DFG and FTL compile") \
@@ -227,6 +230,7 @@ typedef const char* optionString;
     v(unsigned, largeAllocationCutoff, 100000, Normal, nullptr) \
     v(bool, dumpSizeClasses, false, Normal, nullptr) \
     v(bool, useBumpAllocator, true, Normal, nullptr) \
+    v(bool, useConcurrentSweeping, false, Normal, "build free lists for blocks without destructors on the GC helper threads once marking finishes") \
     v(bool, stealEmptyBlocksFromOtherAllocators, true, Normal, nullptr) \
     v(bool, eagerlyUpdateTopCallFrame, false, Normal, nullptr) \
     \
@@ -265,6 +269,7 @@ typedef const char* optionString;
     v(int32, priorityDeltaOfDFGCompilerThreads, computePriorityDeltaOfWorkerThreads(-1, 0), Normal, nullptr) \
     v(int32, priorityDeltaOfFTLCompilerThreads, computePriorityDeltaOfWorkerThreads(-2, 0), Normal, nullptr) \
     v(int32, priorityDeltaOfWasmCompilerThreads, computePriorityDeltaOfWorkerThreads(-1, 0), Normal, nullptr) \
+    v(double, compilationPlanColdMilliseconds, 500, Normal, "A queued DFG or FTL plan whose code has not asked to tier up for this long is compiled after all plans whose code has.") \
     \
     v(bool, useProfiler, false, Normal, nullptr) \
     v(bool, disassembleBaselineForProfiler, true, Normal, nullptr) \
@@ -345,6 +350,8 @@ typedef const char* optionString;
     \
     v(unsigned, minimumNumberOfScansBetweenRebalance, 100, Normal, nullptr) \
     v(unsigned, numberOfGCMarkers, computeNumberOfGCMarkers(8), Normal, nullptr) \
+    v(bool, useWorkStealingMarkStacks, false, Normal, "share marking work through per-marker work-stealing deques instead of the shared mark stacks") \
+    v(bool, logMarkerUtilization, false, Normal, "log how much of its time each marker spent marking at the end of each collection") \
     v(unsigned, opaqueRootMergeThreshold, 1000, Normal, nullptr) \
     v(double, minHeapUtilization, 0.8, Normal, nullptr) \
     v(double, minMarkedBlockUtilization, 0.9, Normal, nullptr) \
@@ -360,6 +367,15 @@ typedef const char* optionString;
     v(bool, useZombieMode, false, Normal, "debugging option to scribble over dead objects with 0xbadbeef0") \
     v(bool, useImmortalObjects, false, Normal, "debugging option to keep all objects alive forever") \
     v(bool, sweepSynchronously, false, Normal, "debugging option to sweep all dead objects synchronously at GC end before resuming mutator") \
+    v(bool, useLargeObjectSpace, true, Normal, "If true, large objects are carved out of shared pages with size classes instead of getting a malloc each.") \
+    v(bool, useBlockScavenger, true, Normal, "If true, the pages of MarkedBlocks that stay empty after a collection are given back to the OS.") \
+    v(double, blockScavengerDelay, 5, Normal, "seconds between the block scavenger's visits. A block has to stay empty from one visit to the next for its pages to be given back.") \
+    v(bool, useStringDeduplication, false, Normal, "If true, full collections make the resolved strings that have the same contents share one StringImpl.") \
+    v(unsigned, minimumStringDeduplicationLength, 8, Normal, "strings shorter than this are not deduplicated.") \
+    v(unsigned, allocationSamplingInterval, 512 * KB, Normal, "bytes allocated between the allocation sampling profiler's samples, when the client does not choose an interval.") \
+    v(unsigned, allocationSamplingStackDepth, 16, Normal, "the number of frames the allocation sampling profiler records for each sample.") \
+    v(bool, useMegamorphicCache, true, Normal, "If true, get_by_id and put_by_id sites whose inline caches gave up look up own properties in a VM-wide cache keyed by structure and name.") \
+    v(bool, useJSONStringifyStructureCache, true, Normal, "If true, JSON.stringify serializes plain objects straight from their structure.") \
     v(unsigned, maxSingleAllocationSize, 0, Configurable, "debugging option to limit individual allocations to a max size (0 = limit not set, N = limit size in bytes)") \
     \
     v(gcLogLevel, logGC, GCLogging::None, Normal, "debugging option to log GC activity (0 = None, 1 = Basic, 2 = Verbose)") \
@@ -369,8 +385,13 @@ typedef const char* optionString;
     v(unsigned, gcMaxHeapSize, 0, Normal, nullptr) \
     v(unsigned, forceRAMSize, 0, Normal, nullptr) \
     v(bool, recordGCPauseTimes, false, Normal, nullptr) \
+    v(bool, logGCEvents, false, Normal, "logs one line of JSON per collection describing its phases, pauses, bytes visited and bytes freed per subspace") \
+    v(optionString, gcEventLogFile, nullptr, Normal, "file that logGCEvents appends to instead of the data file") \
+    v(unsigned, gcPauseHistogramSize, 1000, Normal, "number of recent GC pauses that the pause percentiles are computed over") \
     v(bool, logHeapStatisticsAtExit, false, Normal, nullptr) \
     v(bool, forceCodeBlockToJettisonDueToOldAge, false, Normal, "If true, this means that anytime we can jettison a CodeBlock due to old age, we do.") \
+    v(bool, useUnlinkedCodeBlockFlushing, false, Normal, "If true, full collections discard the bytecode of functions that have not run for a while, and it is generated again when they next run.") \
+    v(unsigned, maximumUnlinkedCodeBlockAge, 5, Normal, "Number of full collections that the bytecode of a function survives after its last CodeBlock died.") \
     v(bool, useEagerCodeBlockJettisonTiming, false, Normal, "If true, the time slices for jettisoning a CodeBlock due to old age are shrunk significantly.") \
     \
     v(bool, useTypeProfiler, false, Normal, nullptr) \
@@ -418,6 +439,10 @@ typedef const char* optionString;
     v(bool, logAirRegisterPressure, false, Normal, nullptr) \
     v(unsigned, maxB3TailDupBlockSize, 3, Normal, nullptr) \
     v(unsigned, maxB3TailDupBlockSuccessors, 3, Normal, nullptr) \
+    v(bool, useB3LoopInvariantCodeMotion, true, Normal, nullptr) \
+    v(bool, useB3LoopUnrolling, true, Normal, nullptr) \
+    v(unsigned, maxB3UnrollBlockSize, 12, Normal, nullptr) \
+    v(unsigned, b3UnrollFactor, 2, Normal, nullptr) \
     \
     v(bool, useDollarVM, false, Restricted, "installs the $vm debugging tool in global objects") \
     v(optionString, functionOverrides, nullptr, Restricted, "file with debugging overrides for function bodies") \
@@ -443,6 +468,12 @@ typedef const char* optionString;
     \
     v(bool, useSourceProviderCache, true, Normal, "If false, the parser will not use the source provider cache. It's good to verify everything works when this is false. Because the cache is so successful, it can mask bugs.") \
     v(bool, useCodeCache, true, Normal, "If false, the unlinked byte code cache will not be used.") \
+    v(optionString, bytecodeCachePath, nullptr, Normal, "The path to an existing directory in which to persist unlinked program and module bytecode across runs.") \
+    v(bool, reportBytecodeCacheStatistics, false, Normal, "Reports on-disk bytecode cache hits, misses, stores and failures when the VM is destroyed.") \
+    v(optionString, profileCachePath, nullptr, Normal, "The path of a file in which to persist value, array and arith profiles and tier-up history across runs.") \
+    v(bool, reportProfileCacheStatistics, false, Normal, "Reports profile cache loads, seeds, mismatches, stores and failures when the VM is destroyed.") \
+    v(unsigned, numberOfParserWorklistThreads, computeNumberOfWorkerThreads(4, 1), Normal, "The number of helper threads, each with its own VM, that compile precompiled scripts and modules.") \
+    v(bool, usePipelinedModuleLoading, false, Normal, "If true, the module loader parses, analyzes and compiles fetched modules on the parser worklist's helper threads.") \
     \
     v(bool, useWebAssembly, true, Normal, "Expose the WebAssembly global object.") \
     \
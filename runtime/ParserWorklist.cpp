@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "ParserWorklist.h"
+
+#include "BytecodeCache.h"
+#include "CachedTypes.h"
+#include "CodeCache.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "JSModuleRecord.h"
+#include "ModuleAnalyzer.h"
+#include "SourceProvider.h"
+#include "StrongInlines.h"
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace JSC {
+
+class ParserWorklist::Job : public ThreadSafeRefCounted<Job> {
+public:
+    enum class State { Queued, Running, Finished, Cancelled };
+
+    // The client's source is copied, so that the helper thread never touches its source provider
+    // or reference counts of its strings. A module with a non-null key is analyzed as well.
+    Job(const SourceCode& source, SourceCodeType codeType, const String& moduleKey = String())
+        : m_source(source.view().toString().isolatedCopy())
+        , m_url(source.provider()->url().isolatedCopy())
+        , m_moduleKey(moduleKey.isolatedCopy())
+        , m_firstLine(source.firstLine().oneBasedInt())
+        , m_startColumn(source.startColumn().oneBasedInt())
+        , m_codeType(codeType)
+    {
+    }
+
+    void run(VM&, Strong<JSGlobalObject>&);
+
+    State m_state { State::Queued };
+    SHA1::Digest m_digest;
+    Vector<uint8_t> m_bytecode;
+    std::unique_ptr<ModuleAnalysis> m_moduleAnalysis;
+
+private:
+    template<typename UnlinkedCodeBlockType>
+    UnlinkedCodeBlockType* generate(VM&, const SourceCode&, typename CacheTypes<UnlinkedCodeBlockType>::RootNode&, JSParserScriptMode);
+    void analyzeModule(VM&, JSGlobalObject*, const SourceCode&, ModuleProgramNode&);
+
+    String m_source;
+    String m_url;
+    String m_moduleKey;
+    int m_firstLine;
+    int m_startColumn;
+    SourceCodeType m_codeType;
+};
+
+template<typename RootNode>
+static std::unique_ptr<RootNode> parseRootNode(VM& vm, const SourceCode& source, JSParserScriptMode scriptMode)
+{
+    JSParserStrictMode strictMode = scriptMode == JSParserScriptMode::Module ? JSParserStrictMode::Strict : JSParserStrictMode::NotStrict;
+    SourceParseMode parseMode = scriptMode == JSParserScriptMode::Module ? SourceParseMode::ModuleEvaluateMode : SourceParseMode::ProgramMode;
+    ParserError error;
+    return parse<RootNode>(&vm, source, Identifier(), JSParserBuiltinMode::NotBuiltin, strictMode, scriptMode, parseMode, SuperBinding::NotNeeded, error);
+}
+
+// This mirrors generateUnlinkedCodeBlock(), which needs an executable that only the client VM has.
+template<typename UnlinkedCodeBlockType>
+UnlinkedCodeBlockType* ParserWorklist::Job::generate(VM& vm, const SourceCode& source, typename CacheTypes<UnlinkedCodeBlockType>::RootNode& rootNode, JSParserScriptMode scriptMode)
+{
+    SourceParseMode parseMode = CacheTypes<UnlinkedCodeBlockType>::parseMode;
+
+    CodeFeatures features = rootNode.features();
+    ExecutableInfo info(features & EvalFeature, features & StrictModeFeature, false, false, ConstructorKind::None, scriptMode, SuperBinding::NotNeeded, parseMode, DerivedContextType::None, false, false, EvalContextType::None);
+    unsigned lineCount = rootNode.lastLine() - rootNode.firstLine();
+
+    UnlinkedCodeBlockType* unlinkedCodeBlock = UnlinkedCodeBlockType::create(&vm, info, DebuggerOff);
+    unlinkedCodeBlock->recordParse(features, rootNode.hasCapturedVariables(), lineCount, rootNode.endColumn());
+    unlinkedCodeBlock->setSourceURLDirective(source.provider()->sourceURL());
+    unlinkedCodeBlock->setSourceMappingURLDirective(source.provider()->sourceMappingURL());
+
+    VariableEnvironment variablesUnderTDZ;
+    ParserError error = BytecodeGenerator::generate(vm, &rootNode, unlinkedCodeBlock, DebuggerOff, &variablesUnderTDZ);
+    if (error.isValid())
+        return nullptr;
+    return unlinkedCodeBlock;
+}
+
+// The analysis walks the same tree that bytecode is generated from, which ModuleAnalyzer only reads.
+void ParserWorklist::Job::analyzeModule(VM& vm, JSGlobalObject* globalObject, const SourceCode& source, ModuleProgramNode& moduleProgramNode)
+{
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+
+    ModuleAnalyzer moduleAnalyzer(globalObject->globalExec(), Identifier::fromString(&vm, m_moduleKey), source, moduleProgramNode.varDeclarations(), moduleProgramNode.lexicalVariables());
+    if (UNLIKELY(scope.exception())) {
+        scope.clearException();
+        return;
+    }
+    m_moduleAnalysis = ModuleAnalysis::create(vm, *moduleAnalyzer.analyze(moduleProgramNode));
+}
+
+void ParserWorklist::Job::run(VM& vm, Strong<JSGlobalObject>& globalObject)
+{
+    JSLockHolder locker(vm);
+
+    SourceProviderSourceType sourceType = m_codeType == SourceCodeType::ModuleType ? SourceProviderSourceType::Module : SourceProviderSourceType::Program;
+    Ref<SourceProvider> provider = StringSourceProvider::create(m_source, SourceOrigin { m_url }, m_url, TextPosition(), sourceType);
+    SourceCode source(WTFMove(provider), 0, m_source.length(), m_firstLine, m_startColumn);
+
+    UnlinkedCodeBlock* unlinkedCodeBlock = nullptr;
+    if (m_codeType == SourceCodeType::ModuleType) {
+        if (auto rootNode = parseRootNode<ModuleProgramNode>(vm, source, JSParserScriptMode::Module)) {
+            if (!m_moduleKey.isNull()) {
+                // Module records are created through a global object, which only module analysis needs.
+                if (!globalObject)
+                    globalObject.set(vm, JSGlobalObject::create(vm, JSGlobalObject::createStructure(vm, jsNull())));
+                analyzeModule(vm, globalObject.get(), source, *rootNode);
+            }
+            unlinkedCodeBlock = generate<UnlinkedModuleProgramCodeBlock>(vm, source, *rootNode, JSParserScriptMode::Module);
+        }
+    } else {
+        if (auto rootNode = parseRootNode<ProgramNode>(vm, source, JSParserScriptMode::Classic))
+            unlinkedCodeBlock = generate<UnlinkedProgramCodeBlock>(vm, source, *rootNode, JSParserScriptMode::Classic);
+    }
+
+    // A source that fails to compile is left for the client thread, which reports the error.
+    if (unlinkedCodeBlock) {
+        m_digest = BytecodeCache::digest(keyFor(source, m_codeType));
+        m_bytecode = encodeCodeBlock(vm, m_digest, source, unlinkedCodeBlock);
+    }
+
+    m_source = String();
+    m_url = String();
+}
+
+ParserWorklist::ParserWorklist(unsigned numberOfThreads)
+{
+    for (unsigned i = 0; i < std::max(numberOfThreads, 1u); ++i)
+        m_threads.append(Thread::create("JSC Parser Worklist Helper Thread", [this] { threadMain(); }));
+}
+
+ParserWorklist::~ParserWorklist()
+{
+    {
+        LockHolder locker(m_lock);
+        m_isShuttingDown = true;
+        m_condition.notifyAll();
+    }
+    for (auto& thread : m_threads)
+        thread->waitForCompletion();
+}
+
+SourceCodeKey ParserWorklist::keyFor(const SourceCode& source, SourceCodeType codeType)
+{
+    ASSERT(codeType == SourceCodeType::ProgramType || codeType == SourceCodeType::ModuleType);
+    bool isModule = codeType == SourceCodeType::ModuleType;
+    return SourceCodeKey(
+        source, String(), codeType,
+        isModule ? JSParserStrictMode::Strict : JSParserStrictMode::NotStrict,
+        isModule ? JSParserScriptMode::Module : JSParserScriptMode::Classic,
+        DerivedContextType::None, EvalContextType::None, false, DebuggerOff,
+        TypeProfilerEnabled::No, ControlFlowProfilerEnabled::No);
+}
+
+bool ParserWorklist::enqueue(const SourceCode& source, SourceCodeType codeType, const Identifier& moduleKey)
+{
+    ASSERT(moduleKey.isNull() || codeType == SourceCodeType::ModuleType);
+    auto addResult = m_jobs.add(keyFor(source, codeType), nullptr);
+    if (!addResult.isNewEntry)
+        return false;
+
+    // The key is only used to name the record when it is dumped on the helper thread.
+    String moduleKeyString;
+    if (!moduleKey.isNull())
+        moduleKeyString = moduleKey.string().isNull() ? emptyString() : moduleKey.string();
+    RefPtr<Job> job = adoptRef(new Job(source, codeType, moduleKeyString));
+    addResult.iterator->value = job;
+
+    LockHolder locker(m_lock);
+    m_queue.append(WTFMove(job));
+    m_condition.notifyOne();
+    return true;
+}
+
+bool ParserWorklist::waitForJob(Job& job, IfQueued ifQueued)
+{
+    LockHolder locker(m_lock);
+    if (job.m_state == Job::State::Queued) {
+        if (ifQueued == IfQueued::Cancel) {
+            job.m_state = Job::State::Cancelled;
+            return false;
+        }
+        // The job is still further back in the queue too, where helper threads skip it.
+        m_queue.prepend(&job);
+        m_condition.notifyOne();
+    }
+    while (job.m_state != Job::State::Finished)
+        m_condition.wait(m_lock);
+    return true;
+}
+
+JSModuleRecord* ParserWorklist::takeModuleRecord(ExecState* exec, const Identifier& moduleKey, const SourceCode& source)
+{
+    auto iter = m_jobs.find(keyFor(source, SourceCodeType::ModuleType));
+    if (iter == m_jobs.end())
+        return nullptr;
+    RefPtr<Job> job = iter->value;
+    waitForJob(*job, IfQueued::Prioritize);
+
+    // A module that failed to parse has neither product, and is left for the client to report.
+    std::unique_ptr<ModuleAnalysis> moduleAnalysis = WTFMove(job->m_moduleAnalysis);
+    if (job->m_bytecode.isEmpty())
+        m_jobs.remove(iter);
+    if (!moduleAnalysis)
+        return nullptr;
+
+    ++m_numberOfModuleRecordsFromHelperThreads;
+    return moduleAnalysis->createModuleRecord(exec, moduleKey, source);
+}
+
+UnlinkedCodeBlock* ParserWorklist::takeResult(VM& vm, const SourceCodeKey& key, const SourceCode& source)
+{
+    RefPtr<Job> job = m_jobs.take(key);
+    if (!job || !waitForJob(*job, IfQueued::Cancel))
+        return nullptr;
+
+    if (job->m_bytecode.isEmpty())
+        return nullptr;
+    Ref<CachedBytecode> bytecode = CachedBytecode::create(source, WTFMove(job->m_bytecode));
+    return decodeCodeBlock(vm, job->m_digest, bytecode.get());
+}
+
+void ParserWorklist::clear()
+{
+    {
+        LockHolder locker(m_lock);
+        for (auto& job : m_jobs.values()) {
+            if (job->m_state == Job::State::Queued)
+                job->m_state = Job::State::Cancelled;
+        }
+    }
+    m_jobs.clear();
+}
+
+void ParserWorklist::threadMain()
+{
+    RefPtr<VM> vm = VM::create(SmallHeap);
+    Strong<JSGlobalObject> globalObject;
+
+    while (true) {
+        RefPtr<Job> job;
+        {
+            LockHolder locker(m_lock);
+            while (!m_isShuttingDown && m_queue.isEmpty())
+                m_condition.wait(m_lock);
+            if (m_isShuttingDown)
+                break;
+            job = m_queue.takeFirst();
+            if (job->m_state != Job::State::Queued)
+                continue;
+            job->m_state = Job::State::Running;
+        }
+
+        job->run(*vm, globalObject);
+
+        // Drop this thread's reference before the client can see the result, since the client may
+        // atomize the strings of a module analysis in its own VM.
+        LockHolder locker(m_lock);
+        job->m_state = Job::State::Finished;
+        job = nullptr;
+        m_condition.notifyAll();
+    }
+
+    JSLockHolder locker(vm.get());
+    globalObject.clear();
+    vm = nullptr;
+}
+
+} // namespace JSC
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "Identifier.h"
+#include "SourceCodeKey.h"
+#include <wtf/Condition.h>
+#include <wtf/Deque.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class ExecState;
+class JSModuleRecord;
+class SourceCode;
+class UnlinkedCodeBlock;
+class VM;
+
+// Parses and generates bytecode for top-level programs and modules on a pool of helper threads,
+// each of which owns a private VM. A finished code block is serialized in the bytecode cache
+// format, and decoded into the client VM by CodeCache when the script is evaluated, so scripts
+// that are known ahead of time can be compiled in parallel without blocking the client thread.
+// The module loader also uses it to analyze the imports and exports of fetched modules, from the
+// same parse that generates their bytecode.
+//
+// Everything but the helper threads' own work happens on the client thread, with its JSLock held.
+class ParserWorklist {
+    WTF_MAKE_NONCOPYABLE(ParserWorklist);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit ParserWorklist(unsigned numberOfThreads);
+    ~ParserWorklist();
+
+    // The key CodeCache uses for a program or module compiled by the worklist.
+    static SourceCodeKey keyFor(const SourceCode&, SourceCodeType);
+
+    // Returns false if the source is already queued or compiled. A module with a key is analyzed
+    // as well, for takeModuleRecord().
+    bool enqueue(const SourceCode&, SourceCodeType, const Identifier& moduleKey = Identifier());
+
+    // Removes the job for the key and decodes its code block, waiting for it if a helper thread
+    // is working on it. A job that has not started yet is cancelled instead, since the client
+    // thread can compile it at least as quickly itself. Returns nullptr if there was no job, it
+    // was cancelled, or the source failed to compile.
+    UnlinkedCodeBlock* takeResult(VM&, const SourceCodeKey&, const SourceCode&);
+
+    // Creates the module record from the analysis of the module, waiting for the job if needed. A
+    // job that has not started yet is moved to the front of the queue rather than cancelled, since
+    // its bytecode is needed soon after. The job stays queued for takeResult(). Returns nullptr if
+    // there is no analysis, in which case the client thread parses the module itself and reports
+    // any syntax error.
+    JSModuleRecord* takeModuleRecord(ExecState*, const Identifier& moduleKey, const SourceCode&);
+
+    bool isEmpty() const { return m_jobs.isEmpty(); }
+    unsigned numberOfModuleRecordsFromHelperThreads() const { return m_numberOfModuleRecordsFromHelperThreads; }
+
+    // Forgets all jobs. Running jobs finish, but their results are dropped.
+    void clear();
+
+private:
+    class Job;
+
+    enum class IfQueued { Cancel, Prioritize };
+
+    // Returns false if the job was cancelled instead.
+    bool waitForJob(Job&, IfQueued);
+
+    void threadMain();
+
+    Lock m_lock;
+    Condition m_condition;
+    Deque<RefPtr<Job>> m_queue;
+    Vector<RefPtr<Thread>> m_threads;
+    bool m_isShuttingDown { false };
+
+    // Keys refer to the client's source providers, so only the client thread may touch this.
+    HashMap<SourceCodeKey, RefPtr<Job>, SourceCodeKey::Hash, SourceCodeKey::HashTraits> m_jobs;
+    unsigned m_numberOfModuleRecordsFromHelperThreads { 0 };
+};
+
+} // namespace JSC
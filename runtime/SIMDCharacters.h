@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <wtf/text/LChar.h>
+
+#if CPU(X86_64) && COMPILER(GCC_OR_CLANG)
+#define USE_SIMD_CHARACTER_SCANNING 1
+#include <emmintrin.h>
+#endif
+
+#if USE(SIMD_CHARACTER_SCANNING)
+
+namespace JSC {
+
+// Helpers for scanning 8-bit and 16-bit source text 16 bytes at a time. SSE2 is part of the
+// x86-64 baseline, so there is no need for a runtime check. A matcher takes a block of
+// characters and returns a mask with all bits of each matching character set.
+template <typename CharacterType> struct SIMDCharacters;
+
+template <> struct SIMDCharacters<LChar> {
+    static const unsigned charactersPerBlock = 16;
+    static __m128i splat(LChar character) { return _mm_set1_epi8(static_cast<char>(character)); }
+    static __m128i equal(__m128i characters, LChar character) { return _mm_cmpeq_epi8(characters, splat(character)); }
+    static __m128i lessThanOrEqual(__m128i characters, LChar character) { return _mm_cmpeq_epi8(_mm_min_epu8(characters, splat(character)), characters); }
+    static __m128i inRange(__m128i characters, LChar low, LChar high) { return lessThanOrEqual(_mm_sub_epi8(characters, splat(low)), high - low); }
+    static unsigned indexOfFirstMatch(int mask) { return __builtin_ctz(mask); }
+};
+
+template <> struct SIMDCharacters<UChar> {
+    static const unsigned charactersPerBlock = 8;
+    static __m128i splat(UChar character) { return _mm_set1_epi16(static_cast<short>(character)); }
+    static __m128i equal(__m128i characters, UChar character) { return _mm_cmpeq_epi16(characters, splat(character)); }
+    // SSE2 has no unsigned 16-bit compare, but a saturating subtraction leaves zero exactly when the character is small enough.
+    static __m128i lessThanOrEqual(__m128i characters, UChar character) { return _mm_cmpeq_epi16(_mm_subs_epu16(characters, splat(character)), _mm_setzero_si128()); }
+    static __m128i inRange(__m128i characters, UChar low, UChar high) { return lessThanOrEqual(_mm_sub_epi16(characters, splat(low)), high - low); }
+    // _mm_movemask_epi8() reports both bytes of each matching character.
+    static unsigned indexOfFirstMatch(int mask) { return __builtin_ctz(mask) / 2; }
+};
+
+inline __m128i invertCharacterMask(__m128i mask)
+{
+    return _mm_xor_si128(mask, _mm_set1_epi32(-1));
+}
+
+// Returns the first character in [position, end) that the matcher matches, or the start of the
+// partial block at the end, which the caller has to look at one character at a time. Never reads
+// past end.
+template <typename CharacterType, typename Matcher>
+ALWAYS_INLINE const CharacterType* scanCharacters(const CharacterType* position, const CharacterType* end, const Matcher& matcher)
+{
+    typedef SIMDCharacters<CharacterType> SIMD;
+    while (static_cast<size_t>(end - position) >= SIMD::charactersPerBlock) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+        if (int mask = _mm_movemask_epi8(matcher(block)))
+            return position + SIMD::indexOfFirstMatch(mask);
+        position += SIMD::charactersPerBlock;
+    }
+    return position;
+}
+
+} // namespace JSC
+
+#endif // USE(SIMD_CHARACTER_SCANNING)
@@ -0,0 +1,476 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StreamingJSONParser.h"
+
+#include "JSArray.h"
+#include "JSCInlines.h"
+#include "ObjectConstructor.h"
+#include "StrongInlines.h"
+#include <wtf/dtoa.h>
+#include <wtf/text/ASCIIFastPath.h>
+
+namespace JSC {
+
+template<typename CharType>
+static ALWAYS_INLINE bool isJSONWhiteSpace(CharType c)
+{
+    return c == ' ' || c == 0x9 || c == 0xA || c == 0xD;
+}
+
+template<typename CharType>
+static ALWAYS_INLINE bool isJSONNumberCharacter(CharType c)
+{
+    return isASCIIDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// -?(0 | [1-9][0-9]*) ('.' [0-9]+)? ([eE][+-]? [0-9]+)?
+static bool isValidJSONNumber(const LChar* position, const LChar* end)
+{
+    if (position < end && *position == '-')
+        ++position;
+
+    if (position < end && *position == '0')
+        ++position;
+    else if (position < end && *position >= '1' && *position <= '9') {
+        while (position < end && isASCIIDigit(*position))
+            ++position;
+    } else
+        return false;
+
+    if (position < end && *position == '.') {
+        ++position;
+        if (position >= end || !isASCIIDigit(*position))
+            return false;
+        while (position < end && isASCIIDigit(*position))
+            ++position;
+    }
+
+    if (position < end && (*position == 'e' || *position == 'E')) {
+        ++position;
+        if (position < end && (*position == '-' || *position == '+'))
+            ++position;
+        if (position >= end || !isASCIIDigit(*position))
+            return false;
+        while (position < end && isASCIIDigit(*position))
+            ++position;
+    }
+
+    return position == end;
+}
+
+static unsigned utf8SequenceLength(char leadByte)
+{
+    uint8_t byte = static_cast<uint8_t>(leadByte);
+    if (byte < 0xC0)
+        return 1;
+    if (byte < 0xE0)
+        return 2;
+    if (byte < 0xF0)
+        return 3;
+    return 4;
+}
+
+StreamingJSONParser::StreamingJSONParser()
+{
+}
+
+bool StreamingJSONParser::append(ExecState* exec, StringView characters)
+{
+    if (m_failed)
+        return false;
+    if (characters.is8Bit())
+        return appendCharacters(exec, characters.characters8(), characters.characters8() + characters.length());
+    return appendCharacters(exec, characters.characters16(), characters.characters16() + characters.length());
+}
+
+bool StreamingJSONParser::appendUTF8(ExecState* exec, const char* bytes, size_t length)
+{
+    if (m_failed)
+        return false;
+
+    // Finish the sequence that the previous piece ended in the middle of.
+    if (!m_partialUTF8Sequence.isEmpty()) {
+        unsigned sequenceLength = utf8SequenceLength(m_partialUTF8Sequence[0]);
+        size_t missingBytes = std::min<size_t>(sequenceLength - m_partialUTF8Sequence.size(), length);
+        m_partialUTF8Sequence.append(bytes, missingBytes);
+        bytes += missingBytes;
+        length -= missingBytes;
+        if (m_partialUTF8Sequence.size() < sequenceLength)
+            return true;
+        bool result = appendUTF8Sequence(exec, m_partialUTF8Sequence.data(), m_partialUTF8Sequence.size());
+        m_partialUTF8Sequence.clear();
+        if (!result)
+            return false;
+    }
+
+    // Hold back a sequence that this piece ends in the middle of.
+    for (size_t i = 1; i <= std::min<size_t>(3, length); ++i) {
+        uint8_t byte = static_cast<uint8_t>(bytes[length - i]);
+        if ((byte & 0xC0) == 0x80)
+            continue;
+        if (byte >= 0xC0 && utf8SequenceLength(byte) > i) {
+            m_partialUTF8Sequence.append(bytes + length - i, i);
+            length -= i;
+        }
+        break;
+    }
+
+    return appendUTF8Sequence(exec, bytes, length);
+}
+
+bool StreamingJSONParser::appendUTF8Sequence(ExecState* exec, const char* bytes, size_t length)
+{
+    const LChar* characters = reinterpret_cast<const LChar*>(bytes);
+    if (charactersAreAllASCII(characters, length))
+        return appendCharacters(exec, characters, characters + length);
+
+    String string = String::fromUTF8(characters, length);
+    if (string.isNull())
+        return fail(ASCIILiteral("Invalid UTF-8 sequence"));
+    return append(exec, string);
+}
+
+template<typename CharType>
+bool StreamingJSONParser::appendCharacters(ExecState* exec, const CharType* position, const CharType* end)
+{
+    while (position < end) {
+        switch (m_lexState) {
+        case LexState::BetweenTokens: {
+            CharType character = *position;
+            if (isJSONWhiteSpace(character)) {
+                ++position;
+                break;
+            }
+            if (character == '"') {
+                ++position;
+                m_lexState = LexState::InString;
+                break;
+            }
+            if (character == '-' || isASCIIDigit(character)) {
+                m_lexState = LexState::InNumber;
+                break;
+            }
+            if (isASCIIAlpha(character)) {
+                m_lexState = LexState::InLiteral;
+                break;
+            }
+            ++position;
+            switch (character) {
+            case '{':
+            case '[':
+                if (!startValue(exec, character))
+                    return false;
+                break;
+            case '}':
+            case ']':
+                if (!endContainer(exec, character))
+                    return false;
+                break;
+            case ':':
+                if (m_parseState != ParseState::Colon)
+                    return fail(ASCIILiteral("Unexpected token ':'"));
+                m_parseState = ParseState::StartValue;
+                break;
+            case ',':
+                if (m_parseState == ParseState::CommaOrEndArray)
+                    m_parseState = ParseState::StartValue;
+                else if (m_parseState == ParseState::CommaOrEndObject)
+                    m_parseState = ParseState::StartKey;
+                else
+                    return fail(ASCIILiteral("Unexpected comma"));
+                break;
+            default:
+                if (isASCIIPrintable(character))
+                    return fail(String::format("Unrecognized token '%c'", static_cast<char>(character)));
+                return fail(ASCIILiteral("Unrecognized token"));
+            }
+            break;
+        }
+
+        case LexState::InString: {
+            const CharType* runStart = position;
+            while (position < end && *position != '"' && *position != '\\' && *position >= 0x20)
+                ++position;
+            m_string.append(runStart, position - runStart);
+            if (position == end)
+                break;
+            if (*position == '"') {
+                ++position;
+                m_lexState = LexState::BetweenTokens;
+                if (!finishString(exec))
+                    return false;
+                break;
+            }
+            if (*position == '\\') {
+                ++position;
+                m_lexState = LexState::InStringEscape;
+                break;
+            }
+            return fail(ASCIILiteral("Unterminated string"));
+        }
+
+        case LexState::InStringEscape:
+            m_escape.append(*position++);
+            if (m_escape[0] == 'u' && m_escape.size() < 5)
+                break;
+            if (!finishEscape())
+                return false;
+            m_lexState = LexState::InString;
+            break;
+
+        case LexState::InNumber:
+        case LexState::InLiteral: {
+            bool isNumber = m_lexState == LexState::InNumber;
+            const CharType* runStart = position;
+            while (position < end && (isNumber ? isJSONNumberCharacter(*position) : isASCIIAlpha(*position)))
+                ++position;
+            for (const CharType* character = runStart; character < position; ++character)
+                m_token.append(static_cast<LChar>(*character));
+            // The token may carry on into the next piece.
+            if (position == end)
+                break;
+            m_lexState = LexState::BetweenTokens;
+            if (!(isNumber ? finishNumber(exec) : finishLiteral(exec)))
+                return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+JSValue StreamingJSONParser::finish(ExecState* exec)
+{
+    if (m_failed)
+        return JSValue();
+
+    if (!m_partialUTF8Sequence.isEmpty()) {
+        fail(ASCIILiteral("Invalid UTF-8 sequence"));
+        return JSValue();
+    }
+
+    switch (m_lexState) {
+    case LexState::BetweenTokens:
+        break;
+    case LexState::InString:
+    case LexState::InStringEscape:
+        fail(ASCIILiteral("Unterminated string"));
+        return JSValue();
+    case LexState::InNumber:
+        m_lexState = LexState::BetweenTokens;
+        if (!finishNumber(exec))
+            return JSValue();
+        break;
+    case LexState::InLiteral:
+        m_lexState = LexState::BetweenTokens;
+        if (!finishLiteral(exec))
+            return JSValue();
+        break;
+    }
+
+    if (m_parseState != ParseState::Done) {
+        fail(ASCIILiteral("Unexpected EOF"));
+        return JSValue();
+    }
+    return m_result.get();
+}
+
+String StreamingJSONParser::errorMessage() const
+{
+    if (m_errorMessage.isEmpty())
+        return ASCIILiteral("JSON Parse error: Unable to parse JSON string");
+    return String::format("JSON Parse error: %s", m_errorMessage.ascii().data());
+}
+
+bool StreamingJSONParser::fail(String&& message)
+{
+    m_failed = true;
+    m_errorMessage = WTFMove(message);
+    m_frames.clear();
+    m_result.clear();
+    return false;
+}
+
+bool StreamingJSONParser::startValue(ExecState* exec, char character)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!isExpectingValue())
+        return fail(String::format("Unexpected token '%c'", character));
+
+    Frame frame;
+    frame.isArray = character == '[';
+    if (frame.isArray) {
+        JSArray* array = constructEmptyArray(exec, nullptr);
+        if (UNLIKELY(scope.exception())) {
+            m_failed = true;
+            return false;
+        }
+        frame.object.set(vm, array);
+        m_parseState = ParseState::StartValueOrEndArray;
+    } else {
+        frame.object.set(vm, constructEmptyObject(exec));
+        m_parseState = ParseState::StartKeyOrEndObject;
+    }
+    m_frames.append(WTFMove(frame));
+    return true;
+}
+
+bool StreamingJSONParser::endContainer(ExecState* exec, char character)
+{
+    if (character == ']' && m_parseState != ParseState::StartValueOrEndArray && m_parseState != ParseState::CommaOrEndArray)
+        return fail(ASCIILiteral("Unexpected token ']'"));
+    if (character == '}' && m_parseState != ParseState::StartKeyOrEndObject && m_parseState != ParseState::CommaOrEndObject)
+        return fail(ASCIILiteral("Unexpected token '}'"));
+
+    JSObject* object = m_frames.last().object.get();
+    m_frames.removeLast();
+    return finishValue(exec, object);
+}
+
+bool StreamingJSONParser::finishString(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    String string = m_string.toString();
+    m_string.clear();
+
+    if (m_parseState == ParseState::StartKey || m_parseState == ParseState::StartKeyOrEndObject) {
+        m_frames.last().propertyName = Identifier::fromString(&vm, string);
+        m_parseState = ParseState::Colon;
+        return true;
+    }
+
+    if (!isExpectingValue())
+        return fail(ASCIILiteral("Unexpected string literal"));
+    return finishValue(exec, jsString(&vm, string));
+}
+
+bool StreamingJSONParser::finishEscape()
+{
+    UChar escape = m_escape[0];
+    switch (escape) {
+    case '"':
+    case '/':
+    case '\\':
+        m_string.append(escape);
+        break;
+    case 'b':
+        m_string.append('\b');
+        break;
+    case 'f':
+        m_string.append('\f');
+        break;
+    case 'n':
+        m_string.append('\n');
+        break;
+    case 'r':
+        m_string.append('\r');
+        break;
+    case 't':
+        m_string.append('\t');
+        break;
+    case 'u':
+        for (unsigned i = 1; i < 5; ++i) {
+            if (!isASCIIHexDigit(m_escape[i]))
+                return fail(String::format("\"\\%s\" is not a valid unicode escape", String(m_escape.data(), m_escape.size()).ascii().data()));
+        }
+        m_string.append(static_cast<UChar>(toASCIIHexValue(m_escape[1], m_escape[2]) << 8 | toASCIIHexValue(m_escape[3], m_escape[4])));
+        break;
+    default:
+        if (isASCIIPrintable(escape))
+            return fail(String::format("Invalid escape character %c", static_cast<char>(escape)));
+        return fail(ASCIILiteral("Invalid escape character"));
+    }
+    m_escape.clear();
+    return true;
+}
+
+bool StreamingJSONParser::finishNumber(ExecState* exec)
+{
+    if (!isExpectingValue())
+        return fail(ASCIILiteral("Unexpected number"));
+    if (!isValidJSONNumber(m_token.begin(), m_token.end()))
+        return fail(ASCIILiteral("Invalid number"));
+
+    size_t parsedLength;
+    double number = parseDouble(m_token.data(), m_token.size(), parsedLength);
+    ASSERT(parsedLength == m_token.size());
+    m_token.clear();
+    return finishValue(exec, jsNumber(number));
+}
+
+bool StreamingJSONParser::finishLiteral(ExecState* exec)
+{
+    StringView literal(m_token.data(), m_token.size());
+    JSValue value;
+    if (literal == "true")
+        value = jsBoolean(true);
+    else if (literal == "false")
+        value = jsBoolean(false);
+    else if (literal == "null")
+        value = jsNull();
+    else
+        return fail(String::format("Unexpected identifier \"%s\"", literal.toString().ascii().data()));
+
+    if (!isExpectingValue())
+        return fail(String::format("Unexpected token '%s'", literal.toString().ascii().data()));
+    m_token.clear();
+    return finishValue(exec, value);
+}
+
+bool StreamingJSONParser::finishValue(ExecState* exec, JSValue value)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (m_frames.isEmpty()) {
+        m_result.set(vm, value);
+        m_parseState = ParseState::Done;
+        return true;
+    }
+
+    Frame& frame = m_frames.last();
+    if (frame.isArray) {
+        frame.object->putDirectIndex(exec, frame.index++, value);
+        m_parseState = ParseState::CommaOrEndArray;
+    } else {
+        if (std::optional<uint32_t> index = parseIndex(frame.propertyName))
+            frame.object->putDirectIndex(exec, index.value(), value);
+        else
+            frame.object->putDirect(vm, frame.propertyName, value);
+        m_parseState = ParseState::CommaOrEndObject;
+    }
+
+    if (UNLIKELY(scope.exception())) {
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+} // namespace JSC
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "Identifier.h"
+#include "JSCJSValue.h"
+#include "Strong.h"
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+class JSObject;
+
+// Parses a strict JSON document that arrives in pieces, building the value as each piece is
+// appended. Only the unfinished token at the end of a piece is kept between calls, and strings
+// are decoded straight into their builder, so the document is never held in one buffer.
+//
+// Partially built objects and arrays are held through Strong handles, so a parser must be
+// destroyed while its VM is still alive, with the VM's lock held.
+class StreamingJSONParser {
+    WTF_MAKE_NONCOPYABLE(StreamingJSONParser);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    StreamingJSONParser();
+
+    // These return false once the document is known to be malformed, or if an exception was
+    // thrown while building it. Appending to a parser that has failed does nothing.
+    JS_EXPORT_PRIVATE bool append(ExecState*, StringView);
+    JS_EXPORT_PRIVATE bool appendUTF8(ExecState*, const char* bytes, size_t length);
+
+    // Returns the parsed value, or the empty value if the document is malformed or incomplete.
+    JS_EXPORT_PRIVATE JSValue finish(ExecState*);
+
+    bool hasFailed() const { return m_failed; }
+    JS_EXPORT_PRIVATE String errorMessage() const;
+
+private:
+    enum class LexState : uint8_t {
+        BetweenTokens,
+        InString,
+        InStringEscape,
+        InNumber,
+        InLiteral,
+    };
+
+    enum class ParseState : uint8_t {
+        StartValue,
+        StartValueOrEndArray,
+        CommaOrEndArray,
+        StartKeyOrEndObject,
+        StartKey,
+        Colon,
+        CommaOrEndObject,
+        Done,
+    };
+
+    struct Frame {
+        Strong<JSObject> object;
+        Identifier propertyName;
+        unsigned index { 0 };
+        bool isArray { false };
+    };
+
+    template<typename CharType> bool appendCharacters(ExecState*, const CharType*, const CharType* end);
+    bool appendUTF8Sequence(ExecState*, const char* bytes, size_t length);
+
+    bool fail(String&&);
+    bool startValue(ExecState*, char);
+    bool endContainer(ExecState*, char);
+    bool finishString(ExecState*);
+    bool finishEscape();
+    bool finishNumber(ExecState*);
+    bool finishLiteral(ExecState*);
+    bool finishValue(ExecState*, JSValue);
+
+    bool isExpectingValue() const { return m_parseState == ParseState::StartValue || m_parseState == ParseState::StartValueOrEndArray; }
+
+    LexState m_lexState { LexState::BetweenTokens };
+    ParseState m_parseState { ParseState::StartValue };
+    bool m_failed { false };
+
+    StringBuilder m_string;
+    Vector<UChar, 5> m_escape;
+    Vector<LChar, 32> m_token;
+    Vector<char, 4> m_partialUTF8Sequence;
+
+    Vector<Frame, 16> m_frames;
+    Strong<Unknown> m_result;
+    String m_errorMessage;
+};
+
+} // namespace JSC
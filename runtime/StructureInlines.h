@@ -106,6 +106,19 @@ ALWAYS_INLINE PropertyOffset Structure::get(VM& vm, PropertyName propertyName, u
     return entry->offset;
 }
 
+template<typename Functor>
+void Structure::forEachProperty(VM& vm, const Functor& functor)
+{
+    PropertyTable* table = ensurePropertyTableIfNotEmpty(vm);
+    if (!table)
+        return;
+
+    for (auto& entry : *table) {
+        if (!functor(entry))
+            return;
+    }
+}
+
 template<typename Functor>
 void Structure::forEachPropertyConcurrently(const Functor& functor)
 {
@@ -29,6 +29,7 @@
 #include "config.h"
 #include "VM.h"
 
+#include "AllocationSamplingProfiler.h"
 #include "ArgList.h"
 #include "ArrayBufferNeuteringWatchpoint.h"
 #include "BuiltinExecutables.h"
@@ -78,11 +79,13 @@
 #include "LLIntData.h"
 #include "Lexer.h"
 #include "Lookup.h"
+#include "MegamorphicCache.h"
 #include "MinimumReservedZoneSize.h"
 #include "ModuleProgramCodeBlock.h"
 #include "NativeStdFunctionCell.h"
 #include "Nodes.h"
 #include "Parser.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "PromiseDeferredTimer.h"
@@ -332,6 +335,12 @@ VM::VM(VMType vmType, HeapType heapType)
         watchdog.setTimeLimit(timeoutMillis);
     }
 
+    if (Options::bytecodeCachePath())
+        m_codeCache->setBytecodeCachePath(String::fromUTF8(Options::bytecodeCachePath()));
+
+    if (Options::profileCachePath())
+        m_profileCache = std::make_unique<ProfileCache>(String::fromUTF8(Options::profileCachePath()));
+
     VMInspector::instance().add(this);
 }
 
@@ -356,6 +365,18 @@ VM::~VM()
         m_samplingProfiler->shutdown();
     }
 #endif // ENABLE(SAMPLING_PROFILER)
+
+    if (BytecodeCache* bytecodeCache = m_codeCache->bytecodeCache()) {
+        m_codeCache->writeBytecodeCache(*this);
+        if (Options::reportBytecodeCacheStatistics())
+            bytecodeCache->dumpStatistics(WTF::dataFile());
+    }
+
+    if (m_profileCache) {
+        m_profileCache->write(*this);
+        if (Options::reportProfileCacheStatistics())
+            m_profileCache->dumpStatistics(WTF::dataFile());
+    }
     
 #if ENABLE(JIT)
     JITWorklist::instance()->completeAllForVM(*this);
@@ -459,6 +480,18 @@ HeapProfiler& VM::ensureHeapProfiler()
     return *m_heapProfiler;
 }
 
+AllocationSamplingProfiler& VM::ensureAllocationSamplingProfiler(size_t samplingInterval)
+{
+    if (!m_allocationSamplingProfiler)
+        m_allocationSamplingProfiler = std::make_unique<AllocationSamplingProfiler>(*this, samplingInterval);
+    return *m_allocationSamplingProfiler;
+}
+
+void VM::stopAllocationSamplingProfiler()
+{
+    m_allocationSamplingProfiler = nullptr;
+}
+
 #if ENABLE(SAMPLING_PROFILER)
 SamplingProfiler& VM::ensureSamplingProfiler(RefPtr<Stopwatch>&& stopwatch)
 {
@@ -86,6 +86,7 @@ using WTF::SimpleStats;
 
 namespace JSC {
 
+class AllocationSamplingProfiler;
 class BuiltinExecutables;
 class BytecodeIntrinsicRegistry;
 class CodeBlock;
@@ -108,7 +109,9 @@ class JSObject;
 class JSRunLoopTimer;
 class JSWebAssemblyInstance;
 class LLIntOffsetsExtractor;
+class MegamorphicCache;
 class NativeExecutable;
+class ProfileCache;
 class PromiseDeferredTimer;
 class RegExpCache;
 class Register;
@@ -269,6 +272,12 @@ public:
     HeapProfiler* heapProfiler() const { return m_heapProfiler.get(); }
     JS_EXPORT_PRIVATE HeapProfiler& ensureHeapProfiler();
 
+    AllocationSamplingProfiler* allocationSamplingProfiler() const { return m_allocationSamplingProfiler.get(); }
+    JS_EXPORT_PRIVATE AllocationSamplingProfiler& ensureAllocationSamplingProfiler(size_t samplingInterval);
+    JS_EXPORT_PRIVATE void stopAllocationSamplingProfiler();
+
+    ProfileCache* profileCache() const { return m_profileCache.get(); }
+
 #if ENABLE(SAMPLING_PROFILER)
     SamplingProfiler* samplingProfiler() { return m_samplingProfiler.get(); }
     JS_EXPORT_PRIVATE SamplingProfiler& ensureSamplingProfiler(RefPtr<Stopwatch>&&);
@@ -587,6 +596,10 @@ public:
     ALWAYS_INLINE HasOwnPropertyCache* hasOwnPropertyCache() { return m_hasOwnPropertyCache.get(); }
     HasOwnPropertyCache* ensureHasOwnPropertyCache();
 
+    std::unique_ptr<MegamorphicCache> m_megamorphicCache;
+    ALWAYS_INLINE MegamorphicCache* megamorphicCache() { return m_megamorphicCache.get(); }
+    MegamorphicCache* ensureMegamorphicCache();
+
 #if ENABLE(REGEXP_TRACING)
     typedef ListHashSet<RegExp*> RTTraceList;
     RTTraceList* m_rtTraceList;
@@ -665,6 +678,7 @@ public:
     void notifyNeedDebuggerBreak() { m_traps.fireTrap(VMTraps::NeedDebuggerBreak); }
     void notifyNeedTermination() { m_traps.fireTrap(VMTraps::NeedTermination); }
     void notifyNeedWatchdogCheck() { m_traps.fireTrap(VMTraps::NeedWatchdogCheck); }
+    void notifyNeedHeapLimitCheck() { m_traps.fireTrap(VMTraps::NeedHeapLimitCheck); }
 
 #if ENABLE(EXCEPTION_SCOPE_VERIFICATION)
     StackTrace* nativeStackTraceOfLastThrow() const { return m_nativeStackTraceOfLastThrow.get(); }
@@ -780,6 +794,8 @@ private:
     VMTraps m_traps;
     RefPtr<Watchdog> m_watchdog;
     std::unique_ptr<HeapProfiler> m_heapProfiler;
+    std::unique_ptr<AllocationSamplingProfiler> m_allocationSamplingProfiler;
+    std::unique_ptr<ProfileCache> m_profileCache;
 #if ENABLE(SAMPLING_PROFILER)
     RefPtr<SamplingProfiler> m_samplingProfiler;
 #endif
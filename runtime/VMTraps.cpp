@@ -323,7 +323,8 @@ void VMTraps::willDestroyVM()
 
 void VMTraps::fireTrap(VMTraps::EventType eventType)
 {
-    ASSERT(!vm().currentThreadIsHoldingAPILock());
+    // The heap checks its limits after finalizing a collection, which happens on the VM's own thread.
+    ASSERT(!vm().currentThreadIsHoldingAPILock() || eventType == NeedHeapLimitCheck);
     {
         auto locker = holdLock(*m_lock);
         ASSERT(!m_isShuttingDown);
@@ -378,6 +379,12 @@ void VMTraps::handleTraps(ExecState* exec, VMTraps::Mask mask)
             throwException(exec, scope, createTerminatedExecutionException(&vm));
             return;
 
+        case NeedHeapLimitCheck:
+            if (!vm.heap.isOverHardHeapLimit())
+                continue;
+            throwOutOfMemoryError(exec, scope);
+            return;
+
         default:
             RELEASE_ASSERT_NOT_REACHED();
         }
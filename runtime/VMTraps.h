@@ -53,6 +53,7 @@ public:
         NeedDebuggerBreak,
         NeedTermination,
         NeedWatchdogCheck,
+        NeedHeapLimitCheck,
         NumberOfEventTypes, // This entry must be last in this list.
         Invalid
     };
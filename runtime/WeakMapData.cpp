@@ -37,7 +37,7 @@ const ClassInfo WeakMapData::s_info = { "WeakMapData", nullptr, nullptr, nullptr
 
 WeakMapData::WeakMapData(VM& vm)
     : Base(vm, vm.weakMapDataStructure.get())
-    , m_deadKeyCleaner(this)
+    , m_ephemerons(this)
 {
 }
 
@@ -61,8 +61,10 @@ void WeakMapData::visitChildren(JSCell* cell, SlotVisitor& visitor)
 {
     Base::visitChildren(cell, visitor);
     WeakMapData* thisObj = jsCast<WeakMapData*>(cell);
-    visitor.addUnconditionalFinalizer(&thisObj->m_deadKeyCleaner);
-    visitor.addWeakReferenceHarvester(&thisObj->m_deadKeyCleaner);
+    {
+        auto locker = holdLock(*thisObj);
+        thisObj->m_ephemerons.visit(locker, visitor);
+    }
 
     // Rough approximation of the external storage needed for the hashtable.
     // This isn't exact, but it is close enough, and proportional to the actual
@@ -72,9 +74,11 @@ void WeakMapData::visitChildren(JSCell* cell, SlotVisitor& visitor)
 
 void WeakMapData::set(VM& vm, JSObject* key, JSValue value)
 {
+    auto locker = holdLock(*this);
     // Here we force the write barrier on the key.
     auto result = m_map.add(WriteBarrier<JSObject>(vm, this, key).get(), WriteBarrier<Unknown>());
     result.iterator->value.set(vm, this, value);
+    m_ephemerons.didAddKey(locker, key);
 }
 
 JSValue WeakMapData::get(JSObject* key)
@@ -91,6 +95,7 @@ bool WeakMapData::remove(JSObject* key)
     if (iter == m_map.end())
         return false;
 
+    auto locker = holdLock(*this);
     m_map.remove(iter);
     return true;
 }
@@ -102,46 +107,74 @@ bool WeakMapData::contains(JSObject* key)
 
 void WeakMapData::clear()
 {
+    auto locker = holdLock(*this);
     m_map.clear();
+    m_ephemerons.didClear(locker);
 }
 
-void WeakMapData::DeadKeyCleaner::visitWeakReferences(SlotVisitor& visitor)
+void WeakMapData::Ephemerons::visit(const AbstractLocker& locker, SlotVisitor& visitor)
 {
-    m_liveKeyCount = 0;
+    if (m_isVisitedInThisCollection) {
+        visitPendingKeys(locker, visitor);
+        return;
+    }
+    
+    m_isVisitedInThisCollection = true;
+    visitor.addUnconditionalFinalizer(this);
+    
+    ASSERT(m_pendingKeys.isEmpty());
     for (auto& pair : m_target->m_map) {
-        if (!Heap::isMarked(pair.key))
-            continue;
-        m_liveKeyCount++;
-        visitor.append(pair.value);
+        if (Heap::isMarkedConcurrently(pair.key))
+            visitor.append(pair.value);
+        else
+            m_pendingKeys.append(pair.key);
     }
-    RELEASE_ASSERT(m_liveKeyCount <= m_target->m_map.size());
+    if (!m_pendingKeys.isEmpty())
+        visitor.addEphemeronTable(this);
 }
 
-void WeakMapData::DeadKeyCleaner::finalizeUnconditionally()
+void WeakMapData::Ephemerons::didAddKey(const AbstractLocker&, JSObject* key)
 {
-    if (m_liveKeyCount > m_target->m_map.size() / 2) {
-        RELEASE_ASSERT(m_liveKeyCount <= m_target->m_map.size());
-        int deadCount = m_target->m_map.size() - m_liveKeyCount;
-        if (!deadCount)
-            return;
-        Vector<JSObject*> deadEntries;
-        deadEntries.reserveCapacity(deadCount);
-        for (auto& pair : m_target->m_map) {
-            if (Heap::isMarked(pair.key))
-                continue;
-            deadEntries.uncheckedAppend(pair.key);
-        }
-        for (auto& deadEntry : deadEntries)
-            m_target->m_map.remove(deadEntry);
-    } else {
-        MapType newMap;
-        for (auto& pair : m_target->m_map) {
-            if (!Heap::isMarked(pair.key))
-                continue;
-            newMap.add(pair.key, pair.value);
+    // Before the first visit there is nothing to do, since that visit looks at every entry. After
+    // it, the write barrier on the value makes us visit the table again, and that visit only looks
+    // at the pending keys.
+    if (m_isVisitedInThisCollection)
+        m_pendingKeys.append(key);
+}
+
+void WeakMapData::Ephemerons::visitPendingKeys(const AbstractLocker&, SlotVisitor& visitor)
+{
+    for (size_t i = 0; i < m_pendingKeys.size();) {
+        JSObject* key = m_pendingKeys[i];
+        if (!Heap::isMarkedConcurrently(key)) {
+            ++i;
+            continue;
         }
-        m_target->m_map.swap(newMap);
+        auto iter = m_target->m_map.find(key);
+        if (iter != m_target->m_map.end())
+            visitor.append(iter->value);
+        m_pendingKeys[i] = m_pendingKeys.last();
+        m_pendingKeys.removeLast();
+    }
+    if (!m_pendingKeys.isEmpty())
+        visitor.addEphemeronTable(this);
+}
+
+void WeakMapData::Ephemerons::visitEphemerons(SlotVisitor& visitor)
+{
+    auto locker = holdLock(*m_target);
+    visitPendingKeys(locker, visitor);
+}
+
+void WeakMapData::Ephemerons::finalizeUnconditionally()
+{
+    // Marking is over, so any key that is still pending is dead.
+    for (JSObject* key : m_pendingKeys) {
+        if (!Heap::isMarked(key))
+            m_target->m_map.remove(key);
     }
+    m_pendingKeys.clear();
+    m_isVisitedInThisCollection = false;
 }
 
 }
@@ -25,8 +25,10 @@
 
 #pragma once
 
+#include "EphemeronTable.h"
 #include "JSCell.h"
 #include "Structure.h"
+#include "UnconditionalFinalizer.h"
 #include <wtf/HashMap.h>
 #include <wtf/MathExtras.h>
 
@@ -72,19 +74,33 @@ private:
     static void visitChildren(JSCell*, SlotVisitor&);
     void finishCreation(VM&);
 
-    class DeadKeyCleaner : public UnconditionalFinalizer, public WeakReferenceHarvester {
+    // The entries are ephemerons. The first visit in a collection, which may run concurrently with
+    // the mutator, visits the values of the keys that are already marked and remembers the other
+    // keys. Later visits, and the marking constraint for ephemeron tables, only look at the keys
+    // that were remembered or that the mutator added since, so the table as a whole is scanned
+    // once per collection. Whatever keys are still unmarked at the end are dead, and their entries
+    // are removed. m_map and m_pendingKeys are guarded by the cell's lock.
+    class Ephemerons : public EphemeronTable, public UnconditionalFinalizer {
     public:
-        DeadKeyCleaner(WeakMapData* target)
+        Ephemerons(WeakMapData* target)
             : m_target(target)
         {
         }
+        
+        void visit(const AbstractLocker&, SlotVisitor&);
+        void didAddKey(const AbstractLocker&, JSObject*);
+        void didClear(const AbstractLocker&) { m_pendingKeys.clear(); }
+        
     private:
-        void visitWeakReferences(SlotVisitor&) override;
+        void visitPendingKeys(const AbstractLocker&, SlotVisitor&);
+        void visitEphemerons(SlotVisitor&) override;
         void finalizeUnconditionally() override;
-        unsigned m_liveKeyCount;
+        
         WeakMapData* m_target;
+        Vector<JSObject*> m_pendingKeys;
+        bool m_isVisitedInThisCollection { false };
     };
-    DeadKeyCleaner m_deadKeyCleaner;
+    Ephemerons m_ephemerons;
     MapType m_map;
 };
 